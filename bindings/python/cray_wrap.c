@@ -222,6 +222,19 @@ static PyObject *py_cr_renderer_get_result(PyObject *self, PyObject *args) {
 	return py_bitmap_wrap(bm);
 }
 
+static PyObject *py_cr_renderer_get_aov(PyObject *self, PyObject *args) {
+	(void)self;
+	PyObject *r_ext;
+	int aov;
+	if (!PyArg_ParseTuple(args, "Oi", &r_ext, &aov)) {
+		return NULL;
+	}
+	struct cr_renderer *r = PyCapsule_GetPointer(r_ext, "cray.cr_renderer");
+	struct cr_bitmap *bm = cr_renderer_get_aov(r, aov);
+	if (!bm) Py_RETURN_NONE;
+	return py_bitmap_wrap(bm);
+}
+
 static PyObject *py_cr_renderer_render(PyObject *self, PyObject *args) {
 	(void)self; (void)args;
 	PyObject *r_ext;
@@ -703,6 +716,7 @@ static PyMethodDef cray_methods[] = {
 	{ "renderer_get_str_pref", py_cr_renderer_get_str_pref, METH_VARARGS, "" },
 	{ "renderer_get_num_pref", py_cr_renderer_get_num_pref, METH_VARARGS, "" },
 	{ "renderer_get_result", py_cr_renderer_get_result, METH_VARARGS, "" },
+	{ "renderer_get_aov", py_cr_renderer_get_aov, METH_VARARGS, "" },
 	{ "renderer_render", py_cr_renderer_render, METH_VARARGS, "" },
 	{ "renderer_start_interactive", py_cr_renderer_start_interactive, METH_VARARGS, "" },
 	// { "bitmap_free", py_cr_bitmap_free, METH_VARARGS, "" },
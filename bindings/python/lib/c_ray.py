@@ -24,6 +24,32 @@ class _cr_rparam(IntEnum):
 	asset_path = 10
 	node_list = 11
 	blender_mode = 12
+	pixel_order = 13
+	pixel_major = 14
+	tile_auto = 15
+	pin_threads = 16
+	checkpoint_path = 17
+	checkpoint_interval = 18
+	resume_path = 19
+	denoise = 20
+	aovs = 21
+	path_guiding = 22
+	target_frame_ms = 23
+	reproject = 24
+	shader_cache = 25
+	sort_hits = 26
+	texture_cache = 27
+	texture_cache_size = 28
+
+class aov(IntEnum):
+	depth = 0
+	normal = 1
+	albedo = 2
+	instance_id = 3
+	sample_count = 4
+	variance = 5
+	light_emitters = 6
+	light_environment = 7
 
 def _r_set_num(ptr, param, value):
 	return _lib.renderer_set_num_pref(ptr, param, value)
@@ -188,6 +214,98 @@ class _pref:
 		_r_set_num(self.r_ptr, _cr_rparam.blender_mode, value)
 	blender_mode = property(_get_blender_mode, _set_blender_mode, None, "")
 
+	def _get_pixel_order(self):
+		return _r_get_str(self.r_ptr, _cr_rparam.pixel_order)
+	def _set_pixel_order(self, value):
+		_r_set_str(self.r_ptr, _cr_rparam.pixel_order, value)
+	pixel_order = property(_get_pixel_order, _set_pixel_order, None, "Order to render pixels in within a tile")
+
+	def _get_pixel_major(self):
+		return _r_get_num(self.r_ptr, _cr_rparam.pixel_major)
+	def _set_pixel_major(self, value):
+		_r_set_num(self.r_ptr, _cr_rparam.pixel_major, value)
+	pixel_major = property(_get_pixel_major, _set_pixel_major, None, "Render all samples of a pixel before moving on")
+
+	def _get_tile_auto(self):
+		return _r_get_num(self.r_ptr, _cr_rparam.tile_auto)
+	def _set_tile_auto(self, value):
+		_r_set_num(self.r_ptr, _cr_rparam.tile_auto, value)
+	tile_auto = property(_get_tile_auto, _set_tile_auto, None, "Pick tile dimensions automatically")
+
+	def _get_pin_threads(self):
+		return _r_get_num(self.r_ptr, _cr_rparam.pin_threads)
+	def _set_pin_threads(self, value):
+		_r_set_num(self.r_ptr, _cr_rparam.pin_threads, value)
+	pin_threads = property(_get_pin_threads, _set_pin_threads, None, "Pin render threads to cores, spread across NUMA nodes")
+
+	def _get_checkpoint_path(self):
+		return _r_get_str(self.r_ptr, _cr_rparam.checkpoint_path)
+	def _set_checkpoint_path(self, value):
+		_r_set_str(self.r_ptr, _cr_rparam.checkpoint_path, value)
+	checkpoint_path = property(_get_checkpoint_path, _set_checkpoint_path, None, "Periodically save render progress to this file")
+
+	def _get_checkpoint_interval(self):
+		return _r_get_num(self.r_ptr, _cr_rparam.checkpoint_interval)
+	def _set_checkpoint_interval(self, value):
+		_r_set_num(self.r_ptr, _cr_rparam.checkpoint_interval, value)
+	checkpoint_interval = property(_get_checkpoint_interval, _set_checkpoint_interval, None, "Seconds between checkpoints")
+
+	def _get_resume_path(self):
+		return _r_get_str(self.r_ptr, _cr_rparam.resume_path)
+	def _set_resume_path(self, value):
+		_r_set_str(self.r_ptr, _cr_rparam.resume_path, value)
+	resume_path = property(_get_resume_path, _set_resume_path, None, "Continue render from this checkpoint")
+
+	def _get_denoise(self):
+		return _r_get_num(self.r_ptr, _cr_rparam.denoise)
+	def _set_denoise(self, value):
+		_r_set_num(self.r_ptr, _cr_rparam.denoise, value)
+	denoise = property(_get_denoise, _set_denoise, None, "Denoise the result with the built-in albedo & normal guided filter")
+
+	def _get_aovs(self):
+		return _r_get_num(self.r_ptr, _cr_rparam.aovs)
+	def _set_aovs(self, value):
+		_r_set_num(self.r_ptr, _cr_rparam.aovs, value)
+	aovs = property(_get_aovs, _set_aovs, None, "Bitmask of AOVs to render, see aov")
+
+	def _get_path_guiding(self):
+		return _r_get_num(self.r_ptr, _cr_rparam.path_guiding)
+	def _set_path_guiding(self, value):
+		_r_set_num(self.r_ptr, _cr_rparam.path_guiding, value)
+	path_guiding = property(_get_path_guiding, _set_path_guiding, None, "Learn where light comes from before rendering, and sample towards it")
+
+	def _get_target_frame_ms(self):
+		return _r_get_num(self.r_ptr, _cr_rparam.target_frame_ms)
+	def _set_target_frame_ms(self, value):
+		_r_set_num(self.r_ptr, _cr_rparam.target_frame_ms, value)
+	target_frame_ms = property(_get_target_frame_ms, _set_target_frame_ms, None, "Interactive mode: lower the resolution after a restart to show something within this many milliseconds, 0 to disable")
+
+	def _get_reproject(self):
+		return _r_get_num(self.r_ptr, _cr_rparam.reproject)
+	def _set_reproject(self, value):
+		_r_set_num(self.r_ptr, _cr_rparam.reproject, value)
+	reproject = property(_get_reproject, _set_reproject, None, "Interactive mode: carry accumulated samples over to the new view when the camera moves")
+	def _get_shader_cache(self):
+		return _r_get_str(self.r_ptr, _cr_rparam.shader_cache)
+	def _set_shader_cache(self, value):
+		_r_set_str(self.r_ptr, _cr_rparam.shader_cache, value)
+	shader_cache = property(_get_shader_cache, _set_shader_cache, None, "Compile shaders to native code, and cache it in this directory. Set before adding shaders")
+	def _get_sort_hits(self):
+		return _r_get_num(self.r_ptr, _cr_rparam.sort_hits)
+	def _set_sort_hits(self, value):
+		_r_set_num(self.r_ptr, _cr_rparam.sort_hits, value)
+	sort_hits = property(_get_sort_hits, _set_sort_hits, None, "Shade the hits of each bounce in a tile grouped by material")
+	def _get_texture_cache(self):
+		return _r_get_str(self.r_ptr, _cr_rparam.texture_cache)
+	def _set_texture_cache(self, value):
+		_r_set_str(self.r_ptr, _cr_rparam.texture_cache, value)
+	texture_cache = property(_get_texture_cache, _set_texture_cache, None, "Page image textures in from files converted into this directory. Set before adding textures")
+	def _get_texture_cache_size(self):
+		return _r_get_num(self.r_ptr, _cr_rparam.texture_cache_size)
+	def _set_texture_cache_size(self, value):
+		_r_set_num(self.r_ptr, _cr_rparam.texture_cache_size, value)
+	texture_cache_size = property(_get_texture_cache_size, _set_texture_cache_size, None, "Megabytes of texture pages to keep in memory")
+
 class _version:
 	def _get_semantic(self):
 		return _lib.get_version()
@@ -506,6 +624,9 @@ class renderer:
 		self.ret_bitmap = _lib.renderer_get_result(self.obj_ptr)
 		return self.ret_bitmap
 
+	def get_aov(self, which):
+		return _lib.renderer_get_aov(self.obj_ptr, which)
+
 	def scene_get(self):
 		return scene(self.obj_ptr)
 
@@ -0,0 +1,15 @@
+//
+//  gitsha1.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 7.4.2019.
+//  Copyright © 2019-2020 Valtteri Koskivuori. All rights reserved.
+//
+
+// Autogenerated - Do not edit
+
+#define GIT_SHA1 "1244c1f1e46bd0ed3e60b5b2aa10dd49292ece2b"
+
+char *gitHash(void) {
+	return GIT_SHA1;
+}
@@ -59,6 +59,22 @@ enum cr_renderer_param {
 	cr_renderer_asset_path,
 	cr_renderer_node_list,
 	cr_renderer_blender_mode,
+	cr_renderer_pixel_order,
+	cr_renderer_pixel_major,
+	cr_renderer_tile_auto,
+	cr_renderer_pin_threads,
+	cr_renderer_checkpoint_path,
+	cr_renderer_checkpoint_interval,
+	cr_renderer_resume_path,
+	cr_renderer_denoise,
+	cr_renderer_aovs, // Bitmask of (1 << enum cr_aov)
+	cr_renderer_path_guiding,
+	cr_renderer_target_frame_ms, // Interactive mode: coarsen the first pass after a restart to fit this, 0 to disable
+	cr_renderer_reproject, // Interactive mode: carry accumulated samples over to the new view on restart
+	cr_renderer_shader_cache, // String, compile shaders to native code and cache it in this directory. Set before adding shaders
+	cr_renderer_sort_hits, // Shade the hits of each bounce in a tile grouped by material
+	cr_renderer_texture_cache, // String, page image textures in from files converted into this directory. Set before adding textures
+	cr_renderer_texture_cache_size, // Megabytes of texture pages to keep in memory, 1024 by default
 };
 
 enum cr_tile_state {
@@ -137,8 +153,27 @@ struct cr_bitmap {
 
 CR_EXPORT void cr_renderer_render(struct cr_renderer *r);
 CR_EXPORT void cr_renderer_start_interactive(struct cr_renderer *ext);
+// Returns the denoised image instead, if cr_renderer_denoise is set and it has been filtered at least once
 CR_EXPORT struct cr_bitmap *cr_renderer_get_result(struct cr_renderer *r);
 
+// Arbitrary output variables, rendered alongside the beauty pass when enabled with cr_renderer_aovs.
+// All of them are 4 channel float bitmaps, with values in the first 3 channels.
+enum cr_aov {
+	cr_aov_depth = 0, // Nearest first hit distance, 0 where nothing was hit
+	cr_aov_normal, // First hit shading normal, averaged
+	cr_aov_albedo, // First hit reflectance, averaged
+	cr_aov_instance_id, // Instance index + 1 of the first sample's first hit, 0 for background
+	cr_aov_sample_count,
+	cr_aov_variance, // Per-channel variance of the samples
+	cr_aov_light_emitters, // Light contributed by emissive geometry
+	cr_aov_light_environment, // Light contributed by the background
+	cr_aov_count
+};
+
+CR_EXPORT const char *cr_aov_name(enum cr_aov aov);
+// NULL if aov isn't enabled, or nothing was rendered yet
+CR_EXPORT struct cr_bitmap *cr_renderer_get_aov(struct cr_renderer *r, enum cr_aov aov);
+
 // -- Scene --
 
 struct cr_vector {
@@ -49,6 +49,7 @@ from . nodes.color import (
 from . nodes.convert import *
 
 from bpy.props import (
+	BoolProperty,
 	IntProperty,
 	PointerProperty,
 	StringProperty,
@@ -79,6 +80,17 @@ class CrayRenderSettings(bpy.types.PropertyGroup):
 		min=0, max=1024,
 		default=16,
 	)
+	frame_time: IntProperty(
+		name="Viewport Frame Time",
+		description="Lower the viewport resolution while navigating, to show something within this many milliseconds. 0 to disable",
+		min=0, max=10000,
+		default=33,
+	)
+	reproject: BoolProperty(
+		name="Reuse Samples",
+		description="Carry samples over to the new view while navigating, instead of starting over",
+		default=True,
+	)
 	node_list: StringProperty(
 		name="Worker node list",
 		description="comma-separated list of IP:port pairs",
@@ -437,6 +449,8 @@ class CrayRender(bpy.types.RenderEngine):
 		self.cr_renderer.prefs.bounces = depsgraph.scene.c_ray.bounces
 		self.cr_renderer.prefs.node_list = depsgraph.scene.c_ray.node_list
 		self.cr_renderer.prefs.is_iterative = 1
+		self.cr_renderer.prefs.target_frame_ms = depsgraph.scene.c_ray.frame_time
+		self.cr_renderer.prefs.reproject = depsgraph.scene.c_ray.reproject
 
 		# For reasons I can't fathom, depsgraph.updates doesn't let us know if the
 		# viewport camera changed, so we'll just assume that it did and fetch the whole
@@ -63,6 +63,19 @@ class C_RAY_RENDER_PT_performance_tiling(CrayButtonsPanel, Panel):
 		col = layout.column()
 		col.prop(context.scene.c_ray, "tile_size")
 
+class C_RAY_RENDER_PT_performance_viewport(CrayButtonsPanel, Panel):
+	bl_label = "Viewport"
+	bl_parent_id = "C_RAY_RENDER_PT_performance"
+
+	def draw(self, context):
+		layout = self.layout
+		layout.use_property_split = True
+		layout.use_property_decorate = False
+
+		col = layout.column()
+		col.prop(context.scene.c_ray, "frame_time")
+		col.prop(context.scene.c_ray, "reproject")
+
 class C_RAY_RENDER_PT_performance_clustering(CrayButtonsPanel, Panel):
 	bl_label = "Clustering"
 	bl_parent_id = "C_RAY_RENDER_PT_performance"
@@ -267,6 +280,7 @@ classes = (
 	C_RAY_RENDER_PT_performance,
 	C_RAY_RENDER_PT_performance_threads,
 	C_RAY_RENDER_PT_performance_tiling,
+	C_RAY_RENDER_PT_performance_viewport,
 	C_RAY_RENDER_PT_performance_clustering,
 	C_RAY_RENDER_PT_light_paths,
 	C_RAY_RENDER_PT_light_paths_bounces,
@@ -25,6 +25,14 @@
 #include "fileio.h"
 #include "timer.h"
 
+int aov_from_name(const char *name) {
+	if (!name) return -1;
+	for (int i = 0; i < cr_aov_count; ++i) {
+		if (stringEquals(name, cr_aov_name(i))) return i;
+	}
+	return -1;
+}
+
 static struct transform parse_tform(const cJSON *data) {
 	const cJSON *type = cJSON_GetObjectItem(data, "type");
 	if (!cJSON_IsString(type)) {
@@ -101,11 +109,91 @@ void parse_prefs(struct cr_renderer *ext, const cJSON *data) {
 	if (cJSON_IsNumber(tile_height) && tile_height->valueint > 0)
 		cr_renderer_set_num_pref(ext, cr_renderer_tile_height, tile_height->valueint);
 
+	const cJSON *checkpoint = cJSON_GetObjectItem(data, "checkpoint");
+	if (cJSON_IsString(checkpoint)) {
+		cr_renderer_set_str_pref(ext, cr_renderer_checkpoint_path, checkpoint->valuestring);
+	}
+
+	const cJSON *checkpoint_interval = cJSON_GetObjectItem(data, "checkpointInterval");
+	if (cJSON_IsNumber(checkpoint_interval) && checkpoint_interval->valueint > 0) {
+		cr_renderer_set_num_pref(ext, cr_renderer_checkpoint_interval, checkpoint_interval->valueint);
+	}
+
+	const cJSON *pin_threads = cJSON_GetObjectItem(data, "pinThreads");
+	if (cJSON_IsBool(pin_threads)) {
+		cr_renderer_set_num_pref(ext, cr_renderer_pin_threads, cJSON_IsTrue(pin_threads));
+	}
+
+	const cJSON *denoise = cJSON_GetObjectItem(data, "denoise");
+	if (cJSON_IsBool(denoise)) {
+		cr_renderer_set_num_pref(ext, cr_renderer_denoise, cJSON_IsTrue(denoise));
+	}
+
+	const cJSON *target_frame_time = cJSON_GetObjectItem(data, "targetFrameTime");
+	if (cJSON_IsNumber(target_frame_time) && target_frame_time->valueint >= 0) {
+		cr_renderer_set_num_pref(ext, cr_renderer_target_frame_ms, target_frame_time->valueint);
+	}
+
+	const cJSON *reproject = cJSON_GetObjectItem(data, "reproject");
+	if (cJSON_IsBool(reproject)) {
+		cr_renderer_set_num_pref(ext, cr_renderer_reproject, cJSON_IsTrue(reproject));
+	}
+
+	const cJSON *sort_hits = cJSON_GetObjectItem(data, "sortHits");
+	if (cJSON_IsBool(sort_hits)) {
+		cr_renderer_set_num_pref(ext, cr_renderer_sort_hits, cJSON_IsTrue(sort_hits));
+	}
+
+	const cJSON *texture_cache_size = cJSON_GetObjectItem(data, "textureCacheSize");
+	if (cJSON_IsNumber(texture_cache_size) && texture_cache_size->valueint > 0) {
+		cr_renderer_set_num_pref(ext, cr_renderer_texture_cache_size, texture_cache_size->valueint);
+	}
+
+	const cJSON *texture_cache = cJSON_GetObjectItem(data, "textureCache");
+	if (cJSON_IsString(texture_cache)) {
+		cr_renderer_set_str_pref(ext, cr_renderer_texture_cache, texture_cache->valuestring);
+	}
+
+	const cJSON *path_guiding = cJSON_GetObjectItem(data, "pathGuiding");
+	if (cJSON_IsBool(path_guiding)) {
+		cr_renderer_set_num_pref(ext, cr_renderer_path_guiding, cJSON_IsTrue(path_guiding));
+	}
+
+	const cJSON *aovs = cJSON_GetObjectItem(data, "aovs");
+	if (cJSON_IsArray(aovs)) {
+		uint64_t mask = 0;
+		const cJSON *aov = NULL;
+		cJSON_ArrayForEach(aov, aovs) {
+			const int idx = cJSON_IsString(aov) ? aov_from_name(aov->valuestring) : -1;
+			if (idx < 0) {
+				logr(warning, "Unknown AOV \"%s\", ignoring\n", cJSON_IsString(aov) ? aov->valuestring : "");
+				continue;
+			}
+			mask |= 1 << idx;
+		}
+		cr_renderer_set_num_pref(ext, cr_renderer_aovs, mask);
+	}
+
+	const cJSON *tile_auto = cJSON_GetObjectItem(data, "tileAuto");
+	if (cJSON_IsBool(tile_auto)) {
+		cr_renderer_set_num_pref(ext, cr_renderer_tile_auto, cJSON_IsTrue(tile_auto));
+	}
+
 	const cJSON *tile_order = cJSON_GetObjectItem(data, "tileOrder");
 	if (cJSON_IsString(tile_order)) {
 		cr_renderer_set_str_pref(ext, cr_renderer_tile_order, tile_order->valuestring);
 	}
 
+	const cJSON *pixel_order = cJSON_GetObjectItem(data, "pixelOrder");
+	if (cJSON_IsString(pixel_order)) {
+		cr_renderer_set_str_pref(ext, cr_renderer_pixel_order, pixel_order->valuestring);
+	}
+
+	const cJSON *pixel_major = cJSON_GetObjectItem(data, "pixelMajor");
+	if (cJSON_IsBool(pixel_major)) {
+		cr_renderer_set_num_pref(ext, cr_renderer_pixel_major, cJSON_IsTrue(pixel_major));
+	}
+
 	const cJSON *width = cJSON_GetObjectItem(data, "width");
 	if (cJSON_IsNumber(width)) {
 		cr_renderer_set_num_pref(ext, cr_renderer_override_width, width->valueint);
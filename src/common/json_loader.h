@@ -12,3 +12,6 @@ struct cr_renderer;
 struct cJSON;
 
 int parse_json(struct cr_renderer *r, struct cJSON *json);
+
+// enum cr_aov value for name, or -1 if unknown
+int aov_from_name(const char *name);
@@ -14,6 +14,7 @@
 #include "loaders/textureloader.h"
 #include "texture.h"
 #include "cr_string.h"
+#include "hashtable.h"
 #include "logging.h"
 #include "color.h"
 #include "vector.h"
@@ -820,6 +821,207 @@ void cr_shader_node_free(struct cr_shader_node *d) {
 	free(d);
 }
 
+// Hashes of node descriptions, stable across runs: pointers aren't hashed, only what they point to.
+
+#define HASH(h, x) hashBytes(h, &(x), sizeof(x))
+
+uint32_t cr_value_node_hash(uint32_t h, const struct cr_value_node *d) {
+	if (!d) return hashCombine(h, 0);
+	h = HASH(h, d->type);
+	switch (d->type) {
+		case cr_vn_unknown:
+			break;
+		case cr_vn_constant:
+			h = HASH(h, d->arg.constant);
+			break;
+		case cr_vn_fresnel:
+			h = cr_value_node_hash(h, d->arg.fresnel.IOR);
+			h = cr_vector_node_hash(h, d->arg.fresnel.normal);
+			break;
+		case cr_vn_map_range:
+			h = cr_value_node_hash(h, d->arg.map_range.input_value);
+			h = cr_value_node_hash(h, d->arg.map_range.from_min);
+			h = cr_value_node_hash(h, d->arg.map_range.from_max);
+			h = cr_value_node_hash(h, d->arg.map_range.to_min);
+			h = cr_value_node_hash(h, d->arg.map_range.to_max);
+			break;
+		case cr_vn_light_path:
+			h = HASH(h, d->arg.light_path.query);
+			break;
+		case cr_vn_alpha:
+			h = cr_color_node_hash(h, d->arg.alpha.color);
+			break;
+		case cr_vn_vec_to_value:
+			h = HASH(h, d->arg.vec_to_value.comp);
+			h = cr_vector_node_hash(h, d->arg.vec_to_value.vec);
+			break;
+		case cr_vn_math:
+			h = HASH(h, d->arg.math.op);
+			h = cr_value_node_hash(h, d->arg.math.A);
+			h = cr_value_node_hash(h, d->arg.math.B);
+			break;
+		case cr_vn_grayscale:
+			h = cr_color_node_hash(h, d->arg.grayscale.color);
+			break;
+	}
+	return h;
+}
+
+uint32_t cr_color_node_hash(uint32_t h, const struct cr_color_node *d) {
+	if (!d) return hashCombine(h, 0);
+	h = HASH(h, d->type);
+	switch (d->type) {
+		case cr_cn_unknown:
+			break;
+		case cr_cn_constant:
+			h = HASH(h, d->arg.constant);
+			break;
+		case cr_cn_image:
+			h = hashString(h, d->arg.image.full_path ? d->arg.image.full_path : "");
+			h = HASH(h, d->arg.image.options);
+			break;
+		case cr_cn_checkerboard:
+			h = cr_color_node_hash(h, d->arg.checkerboard.a);
+			h = cr_color_node_hash(h, d->arg.checkerboard.b);
+			h = cr_value_node_hash(h, d->arg.checkerboard.scale);
+			break;
+		case cr_cn_blackbody:
+			h = cr_value_node_hash(h, d->arg.blackbody.degrees);
+			break;
+		case cr_cn_split:
+			h = cr_value_node_hash(h, d->arg.split.node);
+			break;
+		case cr_cn_rgb:
+			h = cr_value_node_hash(h, d->arg.rgb.red);
+			h = cr_value_node_hash(h, d->arg.rgb.green);
+			h = cr_value_node_hash(h, d->arg.rgb.blue);
+			break;
+		case cr_cn_hsl:
+			h = cr_value_node_hash(h, d->arg.hsl.H);
+			h = cr_value_node_hash(h, d->arg.hsl.S);
+			h = cr_value_node_hash(h, d->arg.hsl.L);
+			break;
+		case cr_cn_hsv:
+			h = cr_value_node_hash(h, d->arg.hsv.H);
+			h = cr_value_node_hash(h, d->arg.hsv.S);
+			h = cr_value_node_hash(h, d->arg.hsv.V);
+			break;
+		case cr_cn_hsv_tform:
+			h = cr_color_node_hash(h, d->arg.hsv_tform.tex);
+			h = cr_value_node_hash(h, d->arg.hsv_tform.H);
+			h = cr_value_node_hash(h, d->arg.hsv_tform.S);
+			h = cr_value_node_hash(h, d->arg.hsv_tform.V);
+			h = cr_value_node_hash(h, d->arg.hsv_tform.f);
+			break;
+		case cr_cn_vec_to_color:
+			h = cr_vector_node_hash(h, d->arg.vec_to_color.vec);
+			break;
+		case cr_cn_gradient:
+			h = cr_color_node_hash(h, d->arg.gradient.a);
+			h = cr_color_node_hash(h, d->arg.gradient.b);
+			break;
+		case cr_cn_color_mix:
+			h = cr_color_node_hash(h, d->arg.color_mix.a);
+			h = cr_color_node_hash(h, d->arg.color_mix.b);
+			h = cr_value_node_hash(h, d->arg.color_mix.factor);
+			break;
+		case cr_cn_color_ramp:
+			h = cr_value_node_hash(h, d->arg.color_ramp.factor);
+			h = HASH(h, d->arg.color_ramp.color_mode);
+			h = HASH(h, d->arg.color_ramp.interpolation);
+			h = HASH(h, d->arg.color_ramp.element_count);
+			for (int i = 0; i < d->arg.color_ramp.element_count; ++i) {
+				h = HASH(h, d->arg.color_ramp.elements[i].color);
+				h = HASH(h, d->arg.color_ramp.elements[i].position);
+			}
+			break;
+	}
+	return h;
+}
+
+uint32_t cr_vector_node_hash(uint32_t h, const struct cr_vector_node *d) {
+	if (!d) return hashCombine(h, 0);
+	h = HASH(h, d->type);
+	switch (d->type) {
+		case cr_vec_unknown:
+		case cr_vec_normal:
+		case cr_vec_uv:
+			break;
+		case cr_vec_constant:
+			h = HASH(h, d->arg.constant);
+			break;
+		case cr_vec_vecmath:
+			h = HASH(h, d->arg.vecmath.op);
+			h = cr_vector_node_hash(h, d->arg.vecmath.A);
+			h = cr_vector_node_hash(h, d->arg.vecmath.B);
+			h = cr_vector_node_hash(h, d->arg.vecmath.C);
+			h = cr_value_node_hash(h, d->arg.vecmath.f);
+			break;
+		case cr_vec_mix:
+			h = cr_vector_node_hash(h, d->arg.vec_mix.A);
+			h = cr_vector_node_hash(h, d->arg.vec_mix.B);
+			h = cr_value_node_hash(h, d->arg.vec_mix.factor);
+			break;
+		case cr_vec_from_color:
+			h = cr_color_node_hash(h, d->arg.vec_from_color.C);
+			break;
+	}
+	return h;
+}
+
+uint32_t cr_shader_node_hash(uint32_t h, const struct cr_shader_node *d) {
+	if (!d) return hashCombine(h, 0);
+	h = HASH(h, d->type);
+	switch (d->type) {
+		case cr_bsdf_unknown:
+			break;
+		case cr_bsdf_diffuse:
+			h = cr_color_node_hash(h, d->arg.diffuse.color);
+			break;
+		case cr_bsdf_metal:
+			h = cr_color_node_hash(h, d->arg.metal.color);
+			h = cr_value_node_hash(h, d->arg.metal.roughness);
+			break;
+		case cr_bsdf_glass:
+			h = cr_color_node_hash(h, d->arg.glass.color);
+			h = cr_value_node_hash(h, d->arg.glass.roughness);
+			h = cr_value_node_hash(h, d->arg.glass.IOR);
+			break;
+		case cr_bsdf_plastic:
+			h = cr_color_node_hash(h, d->arg.plastic.color);
+			h = cr_value_node_hash(h, d->arg.plastic.roughness);
+			h = cr_value_node_hash(h, d->arg.plastic.IOR);
+			break;
+		case cr_bsdf_mix:
+			h = cr_shader_node_hash(h, d->arg.mix.A);
+			h = cr_shader_node_hash(h, d->arg.mix.B);
+			h = cr_value_node_hash(h, d->arg.mix.factor);
+			break;
+		case cr_bsdf_add:
+			h = cr_shader_node_hash(h, d->arg.add.A);
+			h = cr_shader_node_hash(h, d->arg.add.B);
+			break;
+		case cr_bsdf_transparent:
+			h = cr_color_node_hash(h, d->arg.transparent.color);
+			break;
+		case cr_bsdf_emissive:
+			h = cr_color_node_hash(h, d->arg.emissive.color);
+			h = cr_value_node_hash(h, d->arg.emissive.strength);
+			break;
+		case cr_bsdf_translucent:
+			h = cr_color_node_hash(h, d->arg.translucent.color);
+			break;
+		case cr_bsdf_background:
+			h = cr_color_node_hash(h, d->arg.background.color);
+			h = cr_vector_node_hash(h, d->arg.background.pose);
+			h = cr_value_node_hash(h, d->arg.background.strength);
+			break;
+	}
+	return h;
+}
+
+#undef HASH
+
 struct color color_parse(const cJSON *data) {
 	if (cJSON_IsArray(data)) {
 		const float r = cJSON_IsNumber(cJSON_GetArrayItem(data, 0)) ? (float)cJSON_GetArrayItem(data, 0)->valuedouble : 0.0f;
@@ -24,5 +24,12 @@ void cr_vector_node_free(struct cr_vector_node *d);
 struct cr_shader_node *cr_shader_node_build(const struct cJSON *node);
 void cr_shader_node_free(struct cr_shader_node *d);
 
+// Hash the contents of a node description into h, so equal descriptions hash
+// equal across runs. NULL nodes are fine.
+uint32_t cr_value_node_hash(uint32_t h, const struct cr_value_node *d);
+uint32_t cr_color_node_hash(uint32_t h, const struct cr_color_node *d);
+uint32_t cr_vector_node_hash(uint32_t h, const struct cr_vector_node *d);
+uint32_t cr_shader_node_hash(uint32_t h, const struct cr_shader_node *d);
+
 // TODO: Throw these extras in a separate file
 struct color color_parse(const struct cJSON *data);
@@ -0,0 +1,93 @@
+//
+//  atomic.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+// Platform-agnostic atomic loads, stores and fences, for the few places that
+// can't take a lock. We build as C99, so these wrap compiler intrinsics.
+
+#ifdef WINDOWS
+#include <Windows.h>
+
+static inline void *atomic_load_ptr(void *const *p) {
+	void *v = *(void *volatile const *)p;
+	MemoryBarrier();
+	return v;
+}
+
+static inline void atomic_store_ptr(void **p, void *v) {
+	MemoryBarrier();
+	*(void *volatile *)p = v;
+}
+
+static inline uint32_t atomic_load_u32(const uint32_t *p) {
+	uint32_t v = *(volatile const uint32_t *)p;
+	MemoryBarrier();
+	return v;
+}
+
+static inline uint32_t atomic_load_relaxed_u32(const uint32_t *p) {
+	return *(volatile const uint32_t *)p;
+}
+
+static inline void atomic_store_u32(uint32_t *p, uint32_t v) {
+	MemoryBarrier();
+	*(volatile uint32_t *)p = v;
+}
+
+static inline void atomic_store_relaxed_u32(uint32_t *p, uint32_t v) {
+	*(volatile uint32_t *)p = v;
+}
+
+static inline void atomic_fence_acquire(void) {
+	MemoryBarrier();
+}
+
+static inline void atomic_fence_release(void) {
+	MemoryBarrier();
+}
+
+#else
+
+/// Load with acquire ordering, later reads see what was written before the matching store
+static inline void *atomic_load_ptr(void *const *p) {
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+/// Store with release ordering
+static inline void atomic_store_ptr(void **p, void *v) {
+	__atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t atomic_load_u32(const uint32_t *p) {
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline uint32_t atomic_load_relaxed_u32(const uint32_t *p) {
+	return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+static inline void atomic_store_u32(uint32_t *p, uint32_t v) {
+	__atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+static inline void atomic_store_relaxed_u32(uint32_t *p, uint32_t v) {
+	__atomic_store_n(p, v, __ATOMIC_RELAXED);
+}
+
+static inline void atomic_fence_acquire(void) {
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+static inline void atomic_fence_release(void) {
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+#endif
@@ -6,6 +6,11 @@
 //  Copyright © 2020-2023 Valtteri Koskivuori. All rights reserved.
 //
 
+#if defined(__linux__) && !defined(__COSMOPOLITAN__)
+// For sched_getaffinity()
+#define _GNU_SOURCE
+#endif
+
 #include "capabilities.h"
 
 #ifdef __APPLE__
@@ -18,8 +23,16 @@ typedef unsigned short u_short;
 #include <windows.h>
 #elif __linux__ || __COSMOPOLITAN__
 #include <unistd.h>
+#include <stdio.h>
 #endif
 
+#if defined(__linux__) && !defined(__COSMOPOLITAN__)
+#include <sched.h>
+#endif
+
+#include <stdlib.h>
+#include "../../includes.h"
+
 int sys_get_cores(void) {
 #ifdef __APPLE__
 	int nm[2];
@@ -47,3 +60,132 @@ int sys_get_cores(void) {
 	return 1;
 #endif
 }
+
+int sys_get_numa_nodes(void) {
+#ifdef _WIN32
+	ULONG highest = 0;
+	if (!GetNumaHighestNodeNumber(&highest)) return 1;
+	return (int)highest + 1;
+#elif __linux__
+	// Nodes are numbered contiguously in sysfs, count them until one is missing.
+	int nodes = 0;
+	char path[64];
+	for (;;) {
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%i", nodes);
+		if (access(path, F_OK)) break;
+		nodes++;
+	}
+	return nodes ? nodes : 1;
+#else
+	return 1;
+#endif
+}
+
+int sys_get_core_numa_node(int core) {
+#ifdef _WIN32
+	UCHAR node = 0;
+	if (core < 0 || core > 255 || !GetNumaProcessorNode((UCHAR)core, &node) || node == 0xFF) return 0;
+	return node;
+#elif __linux__
+	const int nodes = sys_get_numa_nodes();
+	char path[80];
+	for (int n = 0; n < nodes; ++n) {
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%i/node%i", core, n);
+		if (!access(path, F_OK)) return n;
+	}
+	return 0;
+#else
+	(void)core;
+	return 0;
+#endif
+}
+
+// Fill allowed[] with the logical cores this process may run on, return how many
+static size_t get_allowed_cores(int *allowed, size_t max_cores) {
+	size_t count = 0;
+#ifdef _WIN32
+	DWORD_PTR process_mask = 0, system_mask = 0;
+	if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+		for (size_t core = 0; core < sizeof(DWORD_PTR) * 8 && count < max_cores; ++core) {
+			if (process_mask & ((DWORD_PTR)1 << core)) allowed[count++] = (int)core;
+		}
+		return count;
+	}
+#elif defined(__linux__) && !defined(__COSMOPOLITAN__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (!sched_getaffinity(0, sizeof(set), &set)) {
+		for (int core = 0; core < CPU_SETSIZE && count < max_cores; ++core) {
+			if (CPU_ISSET(core, &set)) allowed[count++] = core;
+		}
+		return count;
+	}
+#endif
+	for (size_t core = 0; core < max_cores; ++core) allowed[count++] = (int)core;
+	return count;
+}
+
+#ifdef __linux__
+// Mark cores listed in a sysfs cpulist, such as "0-3,8-11", as belonging to node
+static void parse_node_cpulist(int node, int *core_nodes, int max_core) {
+	char path[64];
+	snprintf(path, sizeof(path), "/sys/devices/system/node/node%i/cpulist", node);
+	FILE *f = fopen(path, "r");
+	if (!f) return;
+	int first, last;
+	while (fscanf(f, "%i", &first) == 1) {
+		last = first;
+		int c = fgetc(f);
+		if (c == '-') {
+			if (fscanf(f, "%i", &last) != 1) break;
+			c = fgetc(f);
+		}
+		for (int core = max(first, 0); core <= last && core < max_core; ++core) core_nodes[core] = node;
+		if (c != ',') break;
+	}
+	fclose(f);
+}
+#endif
+
+void sys_get_spread_cores(int *cores, size_t count) {
+	if (!cores) return;
+	for (size_t i = 0; i < count; ++i) cores[i] = -1;
+	const int system_cores = sys_get_cores();
+	if (system_cores < 1) return;
+	// The affinity mask may name cores above the online count, leave room for those
+	const size_t max_cores = (size_t)system_cores + 64;
+	int *allowed = calloc(max_cores, sizeof(*allowed));
+	const size_t allowed_count = get_allowed_cores(allowed, max_cores);
+	const int nodes = sys_get_numa_nodes();
+
+	// Node of each allowed core, looked up once
+	int *allowed_nodes = calloc(max(allowed_count, 1), sizeof(*allowed_nodes));
+	if (nodes > 1) {
+		int max_core = 0;
+		for (size_t a = 0; a < allowed_count; ++a) max_core = max(max_core, allowed[a] + 1);
+#ifdef __linux__
+		int *core_nodes = calloc(max_core, sizeof(*core_nodes));
+		for (int n = 0; n < nodes; ++n) parse_node_cpulist(n, core_nodes, max_core);
+		for (size_t a = 0; a < allowed_count; ++a) allowed_nodes[a] = core_nodes[allowed[a]];
+		free(core_nodes);
+#else
+		for (size_t a = 0; a < allowed_count; ++a) allowed_nodes[a] = sys_get_core_numa_node(allowed[a]);
+#endif
+	}
+
+	// Round-robin over nodes, taking the next unused core of each. Nodes that
+	// run out are skipped, and threads beyond the allowed core count aren't pinned.
+	size_t *next = calloc(nodes, sizeof(*next));
+	size_t assigned = 0;
+	int node = 0;
+	while (assigned < count && assigned < allowed_count) {
+		while (next[node] < allowed_count && allowed_nodes[next[node]] != node) next[node]++;
+		if (next[node] < allowed_count) {
+			cores[assigned++] = allowed[next[node]++];
+		}
+		node = (node + 1) % nodes;
+	}
+	free(next);
+	free(allowed_nodes);
+	free(allowed);
+}
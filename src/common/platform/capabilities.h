@@ -8,7 +8,25 @@
 
 #pragma once
 
+#include <stddef.h>
+
 /// Get amount of logical processing cores on the system
 /// @remark Is unaware of NUMA nodes on high core count systems
 /// @return Amount of logical processing cores
 int sys_get_cores(void);
+
+/// Get amount of NUMA nodes on the system
+/// @return Amount of NUMA nodes, 1 if the system isn't NUMA or topology is unknown
+int sys_get_numa_nodes(void);
+
+/// Get the NUMA node a logical processing core belongs to
+/// @param core Logical core index
+/// @return NUMA node index, 0 if unknown
+int sys_get_core_numa_node(int core);
+
+/// Pick logical cores for a group of threads, so that consecutive threads are
+/// spread evenly across NUMA nodes. Only cores in the process affinity mask are used.
+/// @param cores Output, cores[i] is the core for the i-th thread, or -1 if there
+///              are more threads than allowed cores and it shouldn't be pinned
+/// @param count Amount of threads
+void sys_get_spread_cores(int *cores, size_t count);
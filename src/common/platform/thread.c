@@ -6,6 +6,11 @@
 //  Copyright © 2020-2024 Valtteri Koskivuori. All rights reserved.
 //
 
+#if defined(__linux__) && !defined(__COSMOPOLITAN__)
+// For pthread_setaffinity_np()
+#define _GNU_SOURCE
+#endif
+
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -39,6 +44,23 @@ void thread_wait(struct cr_thread *t) {
 #endif
 }
 
+int thread_pin_current(int core) {
+	if (core < 0) return -1;
+#ifdef WINDOWS
+	if (core >= (int)(sizeof(DWORD_PTR) * 8)) return -1;
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) ? 0 : -1;
+#elif defined(__linux__) && !defined(__COSMOPOLITAN__)
+	if (core >= CPU_SETSIZE) return -1;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(core, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	// No affinity API (macOS only exposes affinity hints)
+	return -1;
+#endif
+}
+
 // NOTE: To be able to pass in a stack-local cr_thread struct, we do a temporary
 // allocation here to extend the lifetime.
 
@@ -64,6 +64,11 @@ int thread_start(struct cr_thread *t);
 /// @param t Pointer to the thread to be checked.
 void thread_wait(struct cr_thread *t);
 
+/// Restrict the calling thread to run on the given logical core only.
+/// @param core Logical core index
+/// @return 0 on success, nonzero if pinning failed or isn't supported on this platform
+int thread_pin_current(int core);
+
 int thread_cond_init(struct cr_cond *cond);
 
 int thread_cond_destroy(struct cr_cond *cond);
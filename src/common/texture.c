@@ -9,58 +9,174 @@
 #include "../includes.h"
 
 #include "texture.h"
+#include "texture_cache.h"
 #include "logging.h"
 #include "cr_assert.h"
+#include "platform/atomic.h"
 #include <string.h>
 
+// SRGBToLinear(i / 255.0f) for every 8-bit value, for textures with decode_srgb set
+static const float srgb_to_linear[256] = {
+	0.0f, 0.000303526991f, 0.000607053982f, 0.000910580973f, 0.00121410796f, 0.00151763496f, 0.00182116195f, 0.00212468882f,
+	0.00242821593f, 0.00273174304f, 0.00303526991f, 0.00334653561f, 0.00367650692f, 0.00402471703f, 0.00439144205f, 0.00477695325f,
+	0.00518151699f, 0.00560539169f, 0.00604883255f, 0.00651209103f, 0.00699541019f, 0.00749903172f, 0.00802319217f, 0.00856812485f,
+	0.00913405698f, 0.00972121768f, 0.010329823f, 0.0109600937f, 0.0116122449f, 0.012286487f, 0.0129830306f, 0.0137020806f,
+	0.0144438436f, 0.0152085144f, 0.0159962922f, 0.0168073755f, 0.0176419523f, 0.0185002182f, 0.0193823613f, 0.0202885624f,
+	0.0212190095f, 0.0221738834f, 0.0231533647f, 0.0241576303f, 0.0251868572f, 0.0262412224f, 0.0273208916f, 0.0284260381f,
+	0.0295568332f, 0.0307134409f, 0.0318960287f, 0.0331047624f, 0.0343398079f, 0.0356013142f, 0.036889445f, 0.0382043645f,
+	0.0395462364f, 0.0409151986f, 0.0423114114f, 0.0437350273f, 0.045186203f, 0.0466650836f, 0.048171822f, 0.0497065634f,
+	0.0512694679f, 0.0528606549f, 0.0544802807f, 0.0561284944f, 0.0578054339f, 0.0595112406f, 0.061246071f, 0.0630100295f,
+	0.0648032799f, 0.0666259527f, 0.068478182f, 0.0703601092f, 0.0722718611f, 0.0742135793f, 0.0761853904f, 0.0781874284f,
+	0.0802198276f, 0.0822827145f, 0.0843762159f, 0.0865004659f, 0.0886556059f, 0.0908417329f, 0.093058981f, 0.0953074843f,
+	0.0975873619f, 0.0998987406f, 0.102241747f, 0.104616493f, 0.107023112f, 0.109461717f, 0.111932434f, 0.114435382f,
+	0.116970673f, 0.119538434f, 0.122138798f, 0.124771841f, 0.127437696f, 0.13013649f, 0.132868335f, 0.135633349f,
+	0.138431624f, 0.141263306f, 0.144128487f, 0.147027284f, 0.149959803f, 0.152926162f, 0.155926466f, 0.158960864f,
+	0.1620294f, 0.165132225f, 0.168269396f, 0.171441093f, 0.174647391f, 0.177888408f, 0.181164235f, 0.18447499f,
+	0.187820762f, 0.191201672f, 0.194617808f, 0.198069304f, 0.201556236f, 0.205078706f, 0.20863685f, 0.212230727f,
+	0.215860531f, 0.219526231f, 0.223227978f, 0.226965889f, 0.23074007f, 0.234550655f, 0.238397658f, 0.242281199f,
+	0.246201396f, 0.25015837f, 0.254152179f, 0.258182913f, 0.262250721f, 0.266355664f, 0.270497859f, 0.274677366f,
+	0.278894335f, 0.283148795f, 0.287440896f, 0.291770697f, 0.296138316f, 0.300543845f, 0.304987371f, 0.309468955f,
+	0.313988745f, 0.318546832f, 0.323143244f, 0.327778131f, 0.332451582f, 0.337163657f, 0.341914445f, 0.346704096f,
+	0.351532698f, 0.356400251f, 0.361306876f, 0.366252691f, 0.371237785f, 0.376262218f, 0.381326109f, 0.386429518f,
+	0.391572565f, 0.396755308f, 0.401977867f, 0.407240301f, 0.412542701f, 0.417885154f, 0.423267752f, 0.428690553f,
+	0.434153706f, 0.439657241f, 0.445201248f, 0.450785846f, 0.456411064f, 0.462077051f, 0.467783839f, 0.473531544f,
+	0.479320228f, 0.48514998f, 0.491020888f, 0.496933043f, 0.502886593f, 0.50888145f, 0.514917791f, 0.520995677f,
+	0.527115226f, 0.533276498f, 0.539479613f, 0.545724571f, 0.55201149f, 0.55834049f, 0.56471163f, 0.571124911f,
+	0.577580512f, 0.584078491f, 0.590618908f, 0.597201884f, 0.603827417f, 0.610495627f, 0.617206633f, 0.623960435f,
+	0.630757213f, 0.637596965f, 0.644479752f, 0.651405692f, 0.658374846f, 0.665387332f, 0.672443211f, 0.679542542f,
+	0.686685443f, 0.693871915f, 0.701102018f, 0.708375931f, 0.715693653f, 0.723055243f, 0.730460882f, 0.737910569f,
+	0.745404363f, 0.752942324f, 0.760524631f, 0.768151283f, 0.775822341f, 0.783537924f, 0.791298032f, 0.799102843f,
+	0.806952357f, 0.814846694f, 0.822785854f, 0.830769956f, 0.838799119f, 0.846873283f, 0.854992688f, 0.863157272f,
+	0.871367216f, 0.87962234f, 0.887923181f, 0.896269381f, 0.904661357f, 0.913098693f, 0.921582043f, 0.930110872f,
+	0.938685894f, 0.947306573f, 0.955973506f, 0.964686275f, 0.973445475f, 0.982250571f, 0.991102219f, 1.0f,
+};
+
+// The byte that decodes closest to channel
+static unsigned char srgb_encode(float channel) {
+	size_t lo = 0, hi = 255;
+	while (lo < hi) {
+		const size_t mid = (lo + hi + 1) / 2;
+		if (srgb_to_linear[mid] <= channel) lo = mid;
+		else hi = mid - 1;
+	}
+	if (lo < 255 && srgb_to_linear[lo + 1] - channel < channel - srgb_to_linear[lo]) lo++;
+	return (unsigned char)lo;
+}
+
+static inline size_t tiles_across(const struct texture *t) {
+	return (t->width + TEX_TILE_SIZE - 1) / TEX_TILE_SIZE;
+}
+
+// Offset of the first channel of pixel (x, y) in t->data. Scanline textures are stored bottom-up,
+// tiled ones as a grid of TEX_TILE_SIZE^2 pixel tiles, rows of tiles top-down.
+static inline size_t texel_offset(const struct texture *t, size_t x, size_t y) {
+	if (!t->tiled) return (x + (t->height - (y + 1)) * t->width) * t->channels;
+	const size_t tile = (y / TEX_TILE_SIZE) * tiles_across(t) + x / TEX_TILE_SIZE;
+	return (tile * TEX_TILE_SIZE * TEX_TILE_SIZE + (y % TEX_TILE_SIZE) * TEX_TILE_SIZE + x % TEX_TILE_SIZE) * t->channels;
+}
+
+size_t tex_px_size(const struct texture *t) {
+	return t->channels * (t->precision == char_p ? sizeof(*t->data.byte_p) : sizeof(*t->data.float_p));
+}
+
+size_t tex_data_size(const struct texture *t) {
+	if (!t->tiled) return t->width * t->height * tex_px_size(t);
+	// Tiles on the right and bottom edges are padded
+	const size_t tiles_down = (t->height + TEX_TILE_SIZE - 1) / TEX_TILE_SIZE;
+	return tiles_across(t) * tiles_down * TEX_TILE_SIZE * TEX_TILE_SIZE * tex_px_size(t);
+}
+
+unsigned char *tex_px_ptr(const struct texture *t, size_t x, size_t y) {
+	return t->data.byte_p + texel_offset(t, x, y) / t->channels * tex_px_size(t);
+}
+
 //General-purpose setPixel function
 void tex_set_px(struct texture *t, struct color c, size_t x, size_t y) {
 	ASSERT(x < t->width); ASSERT(y < t->height);
-	if (t->precision == char_p) {
-		t->data.byte_p[(x + (t->height - (y + 1)) * t->width) * t->channels + 0] = (unsigned char)min(c.red * 255.0f, 255.0f);
-		t->data.byte_p[(x + (t->height - (y + 1)) * t->width) * t->channels + 1] = (unsigned char)min(c.green * 255.0f, 255.0f);
-		t->data.byte_p[(x + (t->height - (y + 1)) * t->width) * t->channels + 2] = (unsigned char)min(c.blue * 255.0f, 255.0f);
-		if (t->channels > 3) t->data.byte_p[(x + (t->height - (y + 1)) * t->width) * t->channels + 3] = (unsigned char)min(c.alpha * 255.0f, 255.0f);
+	const size_t offset = texel_offset(t, x, y);
+	if (t->precision == char_p && t->decode_srgb) {
+		t->data.byte_p[offset + 0] = srgb_encode(c.red);
+		t->data.byte_p[offset + 1] = srgb_encode(c.green);
+		t->data.byte_p[offset + 2] = srgb_encode(c.blue);
+		if (t->channels > 3) t->data.byte_p[offset + 3] = (unsigned char)min(c.alpha * 255.0f, 255.0f);
+	}
+	else if (t->precision == char_p) {
+		t->data.byte_p[offset + 0] = (unsigned char)min(c.red * 255.0f, 255.0f);
+		t->data.byte_p[offset + 1] = (unsigned char)min(c.green * 255.0f, 255.0f);
+		t->data.byte_p[offset + 2] = (unsigned char)min(c.blue * 255.0f, 255.0f);
+		if (t->channels > 3) t->data.byte_p[offset + 3] = (unsigned char)min(c.alpha * 255.0f, 255.0f);
 	}
 	else if (t->precision == float_p) {
-		t->data.float_p[(x + (t->height - (y + 1)) * t->width) * t->channels + 0] = c.red;
-		t->data.float_p[(x + (t->height - (y + 1)) * t->width) * t->channels + 1] = c.green;
-		t->data.float_p[(x + (t->height - (y + 1)) * t->width) * t->channels + 2] = c.blue;
-		if (t->channels > 3) t->data.float_p[(x + (t->height - (y + 1)) * t->width) * t->channels + 3] = c.alpha;
+		t->data.float_p[offset + 0] = c.red;
+		t->data.float_p[offset + 1] = c.green;
+		t->data.float_p[offset + 2] = c.blue;
+		if (t->channels > 3) t->data.float_p[offset + 3] = c.alpha;
 	}
 }
 
+// Format specific loads, for one pixel at offset
+
+static inline struct color load_byte(const struct texture *t, size_t offset) {
+	const unsigned char *p = t->data.byte_p + offset;
+	if (t->decode_srgb) {
+		if (t->channels == 1) return (struct color){ srgb_to_linear[p[0]], srgb_to_linear[p[0]], srgb_to_linear[p[0]], 1.0f };
+		return (struct color){ srgb_to_linear[p[0]], srgb_to_linear[p[1]], srgb_to_linear[p[2]], t->channels > 3 ? p[3] / 255.0f : 1.0f };
+	}
+	if (t->channels == 1) return (struct color){ p[0] / 255.0f, p[0] / 255.0f, p[0] / 255.0f, 1.0f };
+	return (struct color){ p[0] / 255.0f, p[1] / 255.0f, p[2] / 255.0f, t->channels > 3 ? p[3] / 255.0f : 1.0f };
+}
+
+static inline struct color load_float(const struct texture *t, size_t offset) {
+	const float *p = t->data.float_p + offset;
+	if (t->channels == 1) return (struct color){ p[0], p[0], p[0], 1.0f };
+	return (struct color){ p[0], p[1], p[2], t->channels > 3 ? p[3] : 1.0f };
+}
+
 static struct color textureGetPixelInternal(const struct texture *t, size_t x, size_t y) {
-	struct color output = {0.0f, 0.0f, 0.0f, 0.0f};
-	x = x % t->width;
-	y = y % t->height;
-	
-	if (t->channels == 1) {
-		if (t->precision == float_p) {
-			output.red   = t->data.float_p[(x + ((t->height - 1) - y) * t->width) * t->channels];
-			output.green = output.red;
-			output.blue  = output.red;
-			output.alpha = 1.0f;
-		} else {
-			output.red =   t->data.byte_p[(x + ((t->height - 1) - y) * t->width) * t->channels] / 255.0f;
-			output.green = output.red;
-			output.blue =  output.red;
-			output.alpha = 1.0f;
-		}
-	} else {
-		if (t->precision == float_p) {
-			output.red   = t->data.float_p[(x + ((t->height - 1) - y) * t->width) * t->channels + 0];
-			output.green = t->data.float_p[(x + ((t->height - 1) - y) * t->width) * t->channels + 1];
-			output.blue  = t->data.float_p[(x + ((t->height - 1) - y) * t->width) * t->channels + 2];
-			output.alpha = t->channels > 3 ? t->data.float_p[(x + ((t->height - 1) - y) * t->width) * t->channels + 3] : 1.0f;
-		} else {
-			output.red =   t->data.byte_p[(x + ((t->height - 1) - y) * t->width) * t->channels + 0] / 255.0f;
-			output.green = t->data.byte_p[(x + ((t->height - 1) - y) * t->width) * t->channels + 1] / 255.0f;
-			output.blue =  t->data.byte_p[(x + ((t->height - 1) - y) * t->width) * t->channels + 2] / 255.0f;
-			output.alpha = t->channels > 3 ? t->data.byte_p[(x + ((t->height - 1) - y) * t->width) * t->channels + 3] / 255.0f : 1.0f;
+	if (t->paged) return tex_paged_get_px(t, x % t->width, y % t->height);
+	const size_t offset = texel_offset(t, x % t->width, y % t->height);
+	return t->precision == float_p ? load_float(t, offset) : load_byte(t, offset);
+}
+
+// The four pixels around a bilinear sample, in the order top left, top right, bottom left, bottom right
+static inline void bilinear_offsets(const struct texture *t, int xint, int yint, size_t offsets[4]) {
+	const size_t x0 = (size_t)xint % t->width, x1 = (size_t)(xint + 1) % t->width;
+	const size_t y0 = (size_t)yint % t->height, y1 = (size_t)(yint + 1) % t->height;
+	offsets[0] = texel_offset(t, x0, y0);
+	offsets[1] = texel_offset(t, x1, y0);
+	offsets[2] = texel_offset(t, x0, y1);
+	offsets[3] = texel_offset(t, x1, y1);
+}
+
+// Weighted sum of the four pixels, as one multiply-add per channel the compiler can vectorize
+static inline struct color bilinear_blend(float px[4][4], float fx, float fy) {
+	const float w[4] = { (1.0f - fx) * (1.0f - fy), fx * (1.0f - fy), (1.0f - fx) * fy, fx * fy };
+	float out[4];
+	for (size_t c = 0; c < 4; ++c) out[c] = w[0] * px[0][c] + w[1] * px[1][c] + w[2] * px[2][c] + w[3] * px[3][c];
+	return (struct color){ out[0], out[1], out[2], out[3] };
+}
+
+static struct color bilinear_byte(const struct texture *t, const size_t offsets[4], float fx, float fy) {
+	// Widen all four pixels up front, so the blend doesn't depend on the format
+	float px[4][4];
+	for (size_t i = 0; i < 4; ++i) {
+		const unsigned char *p = t->data.byte_p + offsets[i];
+		for (size_t c = 0; c < 3; ++c) {
+			const unsigned char b = p[t->channels == 1 ? 0 : c];
+			px[i][c] = t->decode_srgb ? srgb_to_linear[b] : b / 255.0f;
 		}
+		px[i][3] = t->channels > 3 ? p[3] / 255.0f : 1.0f;
+	}
+	return bilinear_blend(px, fx, fy);
+}
+
+static struct color bilinear_float(const struct texture *t, const size_t offsets[4], float fx, float fy) {
+	float px[4][4];
+	for (size_t i = 0; i < 4; ++i) {
+		const struct color c = load_float(t, offsets[i]);
+		px[i][0] = c.red, px[i][1] = c.green, px[i][2] = c.blue, px[i][3] = c.alpha;
 	}
-	return output;
+	return bilinear_blend(px, fx, fy);
 }
 
 //FIXME: This API is confusing. The semantic meaning of x and y change completely based on the filtered flag.
@@ -72,11 +188,132 @@ struct color tex_get_px(const struct texture *t, float x, float y, bool filtered
 	float ycopy = y - 0.5f;
 	int xint = (int)xcopy;
 	int yint = (int)ycopy;
-	struct color topleft = textureGetPixelInternal(t, xint, yint);
-	struct color topright = textureGetPixelInternal(t, xint + 1, yint);
-	struct color botleft = textureGetPixelInternal(t, xint, yint + 1);
-	struct color botright = textureGetPixelInternal(t, xint + 1, yint + 1);
-	return colorLerp(colorLerp(topleft, topright, xcopy - xint), colorLerp(botleft, botright, xcopy - xint), ycopy - yint);
+	if (t->paged) {
+		float px[4][4];
+		for (int i = 0; i < 4; ++i) {
+			const struct color c = textureGetPixelInternal(t, xint + i % 2, yint + i / 2);
+			px[i][0] = c.red, px[i][1] = c.green, px[i][2] = c.blue, px[i][3] = c.alpha;
+		}
+		return bilinear_blend(px, xcopy - xint, ycopy - yint);
+	}
+	size_t offsets[4];
+	bilinear_offsets(t, xint, yint, offsets);
+	if (t->precision == float_p) return bilinear_float(t, offsets, xcopy - xint, ycopy - yint);
+	return bilinear_byte(t, offsets, xcopy - xint, ycopy - yint);
+}
+
+struct color tex_get_px_lod(const struct texture *t, float u, float v, float lod) {
+	if (!t->mip_count || !(lod > 0.0f)) return tex_get_px(t, u, v, true);
+	if (lod >= (float)t->mip_count) return tex_get_px(&t->mips[t->mip_count - 1], u, v, true);
+	const size_t level = (size_t)lod;
+	const struct texture *fine = level ? &t->mips[level - 1] : t;
+	const struct texture *coarse = &t->mips[level];
+	return colorLerp(tex_get_px(fine, u, v, true), tex_get_px(coarse, u, v, true), lod - (float)level);
+}
+
+const struct texture *tex_get_mip(const struct texture *t, float lod) {
+	if (!t->mip_count || !(lod >= 1.0f)) return t;
+	if (lod >= (float)t->mip_count) return &t->mips[t->mip_count - 1];
+	return &t->mips[(size_t)lod - 1];
+}
+
+static void downsample(const struct texture *src, struct texture *dst) {
+	for (size_t y = 0; y < dst->height; ++y) {
+		// Odd sizes fold the leftover row and column into the last texel, which becomes a 3 tap box
+		const size_t y0 = y * 2, y1 = y == dst->height - 1 ? src->height - 1 : y * 2 + 1;
+		for (size_t x = 0; x < dst->width; ++x) {
+			const size_t x0 = x * 2, x1 = x == dst->width - 1 ? src->width - 1 : x * 2 + 1;
+			const unsigned tap_count = (unsigned)((x1 - x0 + 1) * (y1 - y0 + 1));
+			const size_t out = texel_offset(dst, x, y);
+			for (size_t c = 0; c < dst->channels; ++c) {
+				float sum = 0.0f;
+				unsigned byte_sum = 0;
+				for (size_t ty = y0; ty <= y1; ++ty) {
+					for (size_t tx = x0; tx <= x1; ++tx) {
+						const size_t tap = texel_offset(src, tx, ty) + c;
+						if (src->precision == float_p) sum += src->data.float_p[tap];
+						// Average the light, not the encoded values
+						else if (src->decode_srgb && c < 3) sum += srgb_to_linear[src->data.byte_p[tap]];
+						else byte_sum += src->data.byte_p[tap];
+					}
+				}
+				if (src->precision == float_p) dst->data.float_p[out + c] = sum / (float)tap_count;
+				else if (src->decode_srgb && c < 3) dst->data.byte_p[out + c] = srgb_encode(sum / (float)tap_count);
+				else dst->data.byte_p[out + c] = (unsigned char)((byte_sum + tap_count / 2) / tap_count);
+			}
+		}
+	}
+}
+
+void tex_build_mips(struct texture *t) {
+	if (!t || t->mips || !t->data.byte_p || t->precision == none) return;
+	size_t count = 0;
+	for (size_t w = t->width, h = t->height; w > 1 || h > 1; w = max(w / 2, 1), h = max(h / 2, 1)) count++;
+	if (!count) return;
+	struct texture *mips = calloc(count, sizeof(*mips));
+	const struct texture *prev = t;
+	for (size_t i = 0; i < count; ++i) {
+		struct texture *level = tex_new(t->precision, max(prev->width / 2, 1), max(prev->height / 2, 1), t->channels);
+		if (!level) {
+			// Keep what we got, lookups clamp to the last level
+			count = i;
+			break;
+		}
+		level->colorspace = t->colorspace;
+		level->decode_srgb = t->decode_srgb;
+		downsample(prev, level);
+		if (t->tiled) tex_tile(level);
+		mips[i] = *level;
+		free(level);
+		prev = &mips[i];
+	}
+	if (!count) {
+		free(mips);
+		return;
+	}
+	t->mips = mips;
+	t->mip_count = count;
+}
+
+void tex_tile(struct texture *t) {
+	if (!t || t->tiled || !t->data.byte_p || t->precision == none) return;
+	struct texture tiled = *t;
+	tiled.tiled = true;
+	tiled.data.byte_p = calloc(1, tex_data_size(&tiled));
+	if (!tiled.data.byte_p) return;
+	for (size_t y = 0; y < t->height; ++y) {
+		for (size_t x = 0; x < t->width; ++x) {
+			memcpy(tex_px_ptr(&tiled, x, y), tex_px_ptr(t, x, y), tex_px_size(t));
+		}
+	}
+	free(t->data.byte_p);
+	t->data.byte_p = tiled.data.byte_p;
+	t->tiled = true;
+	for (size_t i = 0; i < t->mip_count; ++i) tex_tile(&t->mips[i]);
+}
+
+void tex_publish(struct texture *t, struct texture *src) {
+	if (!t || !src || (!src->data.byte_p && !src->paged)) return;
+	// Readers don't look at any of these before the pixels show up
+	t->colorspace = src->colorspace;
+	t->precision = src->precision;
+	t->channels = src->channels;
+	t->width = src->width;
+	t->height = src->height;
+	t->tiled = src->tiled;
+	t->decode_srgb = src->decode_srgb;
+	t->mips = src->mips;
+	t->mip_count = src->mip_count;
+	if (src->paged) {
+		atomic_store_ptr((void **)&t->paged, (void *)src->paged);
+	} else {
+		atomic_store_ptr((void **)&t->data.byte_p, src->data.byte_p);
+	}
+	*src = (struct texture){ 0 };
+}
+
+bool tex_ready(const struct texture *t) {
+	return atomic_load_ptr((void *const *)&t->data.byte_p) || atomic_load_ptr((void *const *)&t->paged);
 }
 
 struct texture *tex_new(enum precision p, size_t width, size_t height, size_t channels) {
@@ -116,6 +353,12 @@ struct texture *tex_new(enum precision p, size_t width, size_t height, size_t ch
 
 void tex_from_srgb(struct texture *t) {
 	if (t->colorspace == linear) return;
+	if (t->precision == char_p) {
+		// Converting 8-bit data in place would crush the darks, so it's decoded as it's read instead
+		t->decode_srgb = true;
+		t->colorspace = linear;
+		return;
+	}
 	for (unsigned x = 0; x < t->width; ++x) {
 		for (unsigned y = 0; y < t->height; ++y) {
 			tex_set_px(t, colorFromSRGB(tex_get_px(t, x, y, false)), x, y);
@@ -126,6 +369,12 @@ void tex_from_srgb(struct texture *t) {
 
 void tex_to_srgb(struct texture *t) {
 	if (t->colorspace == sRGB) return;
+	if (t->decode_srgb) {
+		// Still sRGB underneath
+		t->decode_srgb = false;
+		t->colorspace = sRGB;
+		return;
+	}
 	for (unsigned x = 0; x < t->width; ++x) {
 		for (unsigned y = 0; y < t->height; ++y) {
 			tex_set_px(t, colorToSRGB(tex_get_px(t, x, y, false)), x, y);
@@ -147,13 +396,14 @@ bool tex_uses_alpha(const struct texture *t) {
 
 void tex_clear(struct texture *t) {
 	if (!t) return;
-	size_t prim_size = t->precision == char_p ? sizeof(char) : sizeof(float);
-	size_t bytes = t->width * t->height * t->channels * prim_size;
-	memset(t->data.byte_p, 0, bytes);
+	memset(t->data.byte_p, 0, tex_data_size(t));
 }
 
 void tex_destroy(struct texture *t) {
 	if (t) {
+		tex_paged_release(t);
+		for (size_t i = 0; i < t->mip_count; ++i) free(t->mips[i].data.byte_p);
+		free(t->mips);
 		free(t->data.byte_p);
 		free(t);
 		t = NULL;
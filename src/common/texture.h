@@ -24,6 +24,8 @@ enum precision {
 	none
 };
 
+struct tex_level;
+
 struct texture {
 	enum colorspace colorspace;
 	enum precision precision;
@@ -34,6 +36,13 @@ struct texture {
 	size_t channels;
 	size_t width;
 	size_t height;
+	bool tiled; // See tex_tile()
+	bool decode_srgb; // 8-bit sRGB data, linearized through a table as it's read. See tex_from_srgb()
+	// Set if the pixels are paged in from a texture cache instead, see texture_cache.h
+	const struct tex_level *paged;
+	// MIP levels 1..n, each half the size of the one before. See tex_build_mips()
+	struct texture *mips;
+	size_t mip_count;
 };
 
 struct texture_asset {
@@ -48,6 +57,8 @@ dyn_array_def(texture_asset)
 #define SRGB_TRANSFORM 0x01
 #define NO_BILINEAR    0x02
 
+#define TEX_TILE_SIZE 8
+
 struct texture *tex_new(enum precision p, size_t width, size_t height, size_t channels);
 
 void tex_set_px(struct texture *t, struct color c, size_t x, size_t y);
@@ -56,8 +67,42 @@ void tex_set_px(struct texture *t, struct color c, size_t x, size_t y);
 /// @remarks When filtered == false, pass in the integer coordinates, otherwise pass in a 0.0f->1.0f coefficient
 struct color tex_get_px(const struct texture *t, float x, float y, bool filtered);
 
+/// Reorder the pixels of t (and its MIP levels) into TEX_TILE_SIZE^2 tiles, so filtered lookups
+/// mostly stay within a few cache lines. tex_get_px() & co. handle both layouts, but
+/// anything reading t->data directly won't, so only do this for textures that are only sampled.
+void tex_tile(struct texture *t);
+
+/// Size of the pixel data of t in bytes, including padding
+size_t tex_data_size(const struct texture *t);
+
+/// Size of one pixel of t in bytes
+size_t tex_px_size(const struct texture *t);
+
+/// Raw pixel (x, y) of t, for copying pixels around as they are. Not for paged textures.
+unsigned char *tex_px_ptr(const struct texture *t, size_t x, size_t y);
+
+/// Trilinear lookup between the two MIP levels around lod, with 0.0f being t itself
+/// @remarks Falls back to tex_get_px() when t has no MIP levels, or lod <= 0.0f
+struct color tex_get_px_lod(const struct texture *t, float u, float v, float lod);
+
+/// The MIP level lod rounds down to, clamped to the ones t has. t itself for lod < 1.0f
+const struct texture *tex_get_mip(const struct texture *t, float lod);
+
+/// Build the MIP pyramid of t with a 2x2 box filter, down to 1x1
+/// @remarks Call after the texture data is final, the levels are copies.
+void tex_build_mips(struct texture *t);
+
+/// Move src, built on the side, into t while render threads may already be sampling t.
+/// The pixels go in last with a single release store, so anything that saw them through
+/// tex_ready() sees the rest of the texture too. t must still be pending, src is emptied.
+/// @remarks Does nothing if src has no pixels, t then stays pending.
+void tex_publish(struct texture *t, struct texture *src);
+
+/// Does t have pixels yet? See tex_publish()
+bool tex_ready(const struct texture *t);
+
 /// Convert texture from sRGB to linear color space
-/// @remarks The texture data will be modified directly.
+/// @remarks Float data is modified directly. 8-bit data is kept as is, and decoded on lookup instead.
 /// @param t Texture to convert
 void tex_from_srgb(struct texture *t);
 
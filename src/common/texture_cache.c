@@ -0,0 +1,485 @@
+//
+//  texture_cache.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#if defined(__linux__)
+// For pread()
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../includes.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#if !defined(WINDOWS)
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+#include "texture.h"
+#include "texture_cache.h"
+#include "logging.h"
+#include "cr_string.h"
+#include "fileio.h"
+#include "hashtable.h"
+#include "dyn_array.h"
+#include "loaders/textureloader.h"
+#include "platform/mutex.h"
+#include "platform/thread.h"
+#include "platform/atomic.h"
+
+// Every page fits in a slot of this size. Pages are square, as big as fits.
+#define TEX_CACHE_SLOT_BYTES (64 * 1024)
+#define TEX_CACHE_MAGIC "CRTEX04"
+
+struct tex_slot {
+	uint32_t gen; // Odd while the slot is being refilled, see page_in()
+	uint32_t referenced; // Set by lookups, cleared as the clock hand passes
+	const struct tex_level *owner;
+	size_t page;
+	unsigned char data[];
+};
+
+typedef struct tex_slot *tex_slot_ptr;
+dyn_array_def(tex_slot_ptr)
+
+struct tex_cache {
+	char *path;
+	bool disabled;
+	struct cr_mutex *lock; // Everything below. Page reads happen without it
+	struct cr_cond page_loaded; // Broadcast whenever a page read finishes
+	size_t slot_limit;
+	struct tex_slot_ptr_arr slots;
+	size_t hand;
+	size_t pages_read;
+};
+
+// One MIP level of a cached file, pointed to by the struct texture for that level
+struct tex_level {
+	struct tex_file *file;
+	size_t width, height;
+	size_t pages_across;
+	size_t first_page; // Within the file
+	void **pages; // The struct tex_slot each page is resident in, or NULL. Accessed atomically
+};
+
+struct tex_file {
+	struct tex_cache *cache;
+	FILE *f;
+	size_t page_side;
+	size_t page_bytes;
+	size_t level_count;
+	struct tex_level levels[];
+};
+
+struct tex_header {
+	char magic[8];
+	uint64_t source_size;
+	int64_t source_mtime;
+	uint32_t width, height, channels, precision;
+	uint32_t page_side, level_count;
+	uint32_t decode_srgb; // See struct texture
+	char source[1024]; // File names only have a hash of this, so it's checked on open
+};
+
+static size_t page_side_for(size_t px_size) {
+	size_t side = TEX_TILE_SIZE;
+	while ((side * 2) * (side * 2) * px_size <= TEX_CACHE_SLOT_BYTES) side *= 2;
+	return side;
+}
+
+static size_t level_count_for(size_t width, size_t height) {
+	size_t count = 1;
+	for (size_t w = width, h = height; w > 1 || h > 1; w = max(w / 2, 1), h = max(h / 2, 1)) count++;
+	return count;
+}
+
+#if !defined(WINDOWS)
+static bool is_directory(const char *path) {
+	struct stat st;
+	if (stat(path, &st)) return false;
+	return S_ISDIR(st.st_mode);
+}
+#endif
+
+struct tex_cache *tex_cache_new(const char *path, size_t budget) {
+#if defined(WINDOWS)
+	(void)path; (void)budget;
+	logr(warning, "Texture caching isn't supported on this platform, loading textures into memory\n");
+	return NULL;
+#else
+	if (!path) return NULL;
+	if (mkdir(path, 0755) && !is_directory(path)) {
+		logr(warning, "Couldn't create texture cache directory %s, loading textures into memory\n", path);
+		return NULL;
+	}
+	struct tex_cache *cache = calloc(1, sizeof(*cache));
+	cache->path = stringCopy(path);
+	cache->lock = mutex_create();
+	thread_cond_init(&cache->page_loaded);
+	tex_cache_set_budget(cache, budget);
+	return cache;
+#endif
+}
+
+void tex_cache_set_budget(struct tex_cache *cache, size_t budget) {
+	if (!cache) return;
+	mutex_lock(cache->lock);
+	// Bilinear lookups can straddle four pages, keep enough around for that on every thread
+	cache->slot_limit = max(budget / TEX_CACHE_SLOT_BYTES, 64);
+	mutex_release(cache->lock);
+}
+
+void tex_cache_disable(struct tex_cache *cache) {
+	if (cache) cache->disabled = true;
+}
+
+const char *tex_cache_path(const struct tex_cache *cache) {
+	return cache && !cache->disabled ? cache->path : NULL;
+}
+
+void tex_cache_destroy(struct tex_cache *cache) {
+	if (!cache) return;
+	if (cache->pages_read) {
+		char buf[64];
+		logr(debug, "Texture cache read %zu pages, %s resident\n", cache->pages_read, human_file_size(cache->slots.count * TEX_CACHE_SLOT_BYTES, buf));
+	}
+	for (size_t i = 0; i < cache->slots.count; ++i) free(cache->slots.items[i]);
+	tex_slot_ptr_arr_free(&cache->slots);
+	thread_cond_destroy(&cache->page_loaded);
+	mutex_destroy(cache->lock);
+	free(cache->path);
+	free(cache);
+}
+
+// -- Conversion --
+
+static bool source_stamp(const char *path, uint64_t *size, int64_t *mtime) {
+	struct stat st;
+	if (stat(path, &st)) return false;
+	*size = (uint64_t)st.st_size;
+	*mtime = (int64_t)st.st_mtime;
+	return true;
+}
+
+static bool write_cache_file(const char *path, const struct texture *t, const struct tex_header *header) {
+	FILE *f = fopen(path, "wb");
+	if (!f) return false;
+	bool ok = fwrite(header, sizeof(*header), 1, f) == 1;
+	const size_t px_size = tex_px_size(t);
+	const size_t side = header->page_side;
+	// A page is laid out like a tiled texture of its own
+	struct texture page = { .precision = t->precision, .channels = t->channels, .width = side, .height = side, .tiled = true };
+	page.data.byte_p = malloc(tex_data_size(&page));
+	for (size_t l = 0; ok && l < header->level_count; ++l) {
+		const struct texture *level = l ? &t->mips[l - 1] : t;
+		for (size_t py = 0; ok && py < level->height; py += side) {
+			for (size_t px = 0; ok && px < level->width; px += side) {
+				memset(page.data.byte_p, 0, tex_data_size(&page));
+				for (size_t y = py; y < min(py + side, level->height); ++y) {
+					for (size_t x = px; x < min(px + side, level->width); ++x) {
+						memcpy(tex_px_ptr(&page, x - px, y - py), tex_px_ptr(level, x, y), px_size);
+					}
+				}
+				ok = fwrite(page.data.byte_p, tex_data_size(&page), 1, f) == 1;
+			}
+		}
+	}
+	free(page.data.byte_p);
+	return !fclose(f) && ok;
+}
+
+static bool convert(const char *source, const char *target, uint8_t options, const struct tex_header *stamp) {
+	file_data data = file_load(source);
+	struct texture *t = tex_new(none, 0, 0, 0);
+	const bool loaded = !load_texture(source, data, t);
+	file_free(&data);
+	if (!loaded || !t->data.byte_p) {
+		tex_destroy(t);
+		return false;
+	}
+	if (options & SRGB_TRANSFORM) tex_from_srgb(t);
+	tex_build_mips(t);
+
+	struct tex_header header = *stamp;
+	header.width = (uint32_t)t->width;
+	header.height = (uint32_t)t->height;
+	header.channels = (uint32_t)t->channels;
+	header.precision = (uint32_t)t->precision;
+	header.page_side = (uint32_t)page_side_for(tex_px_size(t));
+	header.level_count = (uint32_t)(1 + t->mip_count);
+	header.decode_srgb = t->decode_srgb;
+	// Written under a temporary name, so other renders never see half a file
+	char tmp[1024];
+#if defined(WINDOWS)
+	const int len = snprintf(tmp, sizeof(tmp), "%s.tmp", target);
+#else
+	const int len = snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", target, (long)getpid());
+#endif
+	if (len < 0 || (size_t)len >= sizeof(tmp)) {
+		tex_destroy(t);
+		return false;
+	}
+	bool ok = write_cache_file(tmp, t, &header);
+	tex_destroy(t);
+	if (ok) ok = !rename(tmp, target);
+	if (!ok) remove(tmp);
+	return ok;
+}
+
+static struct tex_file *open_cache_file(struct tex_cache *cache, const char *path, const struct tex_header *stamp, struct tex_header *header) {
+	FILE *f = fopen(path, "rb");
+	if (!f) return NULL;
+	if (fread(header, sizeof(*header), 1, f) != 1
+		|| memcmp(header->magic, stamp->magic, sizeof(header->magic))
+		|| header->source_size != stamp->source_size
+		|| header->source_mtime != stamp->source_mtime
+		|| strncmp(header->source, stamp->source, sizeof(header->source))
+		|| !header->width || !header->height
+		|| (header->precision != char_p && header->precision != float_p)
+		|| header->decode_srgb > 1
+		|| header->level_count != level_count_for(header->width, header->height)) {
+		fclose(f);
+		return NULL;
+	}
+	struct tex_file *file = calloc(1, sizeof(*file) + header->level_count * sizeof(*file->levels));
+	file->cache = cache;
+	file->f = f;
+	file->page_side = header->page_side;
+	const struct texture px = { .precision = header->precision, .channels = header->channels };
+	const struct texture page = { .precision = px.precision, .channels = px.channels, .width = file->page_side, .height = file->page_side, .tiled = true };
+	file->page_bytes = tex_data_size(&page);
+	if (page_side_for(tex_px_size(&px)) != file->page_side) {
+		fclose(f);
+		free(file);
+		return NULL;
+	}
+	file->level_count = header->level_count;
+	size_t first_page = 0;
+	size_t w = header->width, h = header->height;
+	for (size_t l = 0; l < file->level_count; ++l) {
+		struct tex_level *level = &file->levels[l];
+		level->file = file;
+		level->width = w;
+		level->height = h;
+		level->pages_across = (w + file->page_side - 1) / file->page_side;
+		const size_t page_count = level->pages_across * ((h + file->page_side - 1) / file->page_side);
+		level->first_page = first_page;
+		level->pages = calloc(page_count, sizeof(*level->pages));
+		first_page += page_count;
+		w = max(w / 2, 1);
+		h = max(h / 2, 1);
+	}
+	return file;
+}
+
+bool tex_cache_load(struct tex_cache *cache, const char *path, uint8_t options, struct texture *out) {
+	if (!cache || cache->disabled || !path || !out) return false;
+	struct tex_header stamp = { .magic = TEX_CACHE_MAGIC };
+	if (strlen(path) >= sizeof(stamp.source)) return false;
+	strcpy(stamp.source, path);
+	if (!source_stamp(path, &stamp.source_size, &stamp.source_mtime)) return false;
+	char target[1024];
+	const uint32_t h = hashString(hashInit(), path);
+	const int len = snprintf(target, sizeof(target), "%s/tex_%08x_%02x.crtex", cache->path, h, options & SRGB_TRANSFORM);
+	if (len < 0 || (size_t)len >= sizeof(target)) return false;
+
+	struct tex_header header;
+	struct tex_file *file = open_cache_file(cache, target, &stamp, &header);
+	if (!file) {
+		if (!convert(path, target, options, &stamp)) {
+			logr(warning, "Couldn't write %s to texture cache %s, loading it into memory\n", path, cache->path);
+			return false;
+		}
+		file = open_cache_file(cache, target, &stamp, &header);
+		if (!file) return false;
+	}
+
+	out->width = header.width;
+	out->height = header.height;
+	out->channels = header.channels;
+	out->precision = header.precision;
+	out->colorspace = linear;
+	out->decode_srgb = header.decode_srgb;
+	out->paged = &file->levels[0];
+	out->mip_count = file->level_count - 1;
+	out->mips = calloc(out->mip_count, sizeof(*out->mips));
+	for (size_t i = 0; i < out->mip_count; ++i) {
+		const struct tex_level *level = &file->levels[i + 1];
+		out->mips[i] = (struct texture){
+			.precision = out->precision,
+			.channels = out->channels,
+			.width = level->width,
+			.height = level->height,
+			.colorspace = linear,
+			.decode_srgb = out->decode_srgb,
+			.paged = level
+		};
+	}
+	return true;
+}
+
+// -- Lookups --
+
+// Returns a slot to fill, evicting the page in it if needed, or NULL if all of them are busy.
+// Called with the cache locked.
+static struct tex_slot *take_slot(struct tex_cache *cache) {
+	if (cache->slots.count < cache->slot_limit) {
+		struct tex_slot *slot = calloc(1, sizeof(*slot) + TEX_CACHE_SLOT_BYTES);
+		if (slot) {
+			tex_slot_ptr_arr_add(&cache->slots, slot);
+			return slot;
+		}
+	}
+	// Second chance: skip slots used since the hand last passed. Lookups keep setting
+	// the bits while we sweep, so give up after two rounds and take what's there.
+	// Slots still being read into are never taken.
+	struct tex_slot *slot = NULL;
+	for (size_t i = 0; i < 2 * cache->slots.count; ++i) {
+		struct tex_slot *candidate = cache->slots.items[cache->hand];
+		cache->hand = (cache->hand + 1) % cache->slots.count;
+		if (candidate->gen & 1) continue;
+		slot = candidate;
+		if (!slot->owner || !atomic_load_relaxed_u32(&slot->referenced)) break;
+		atomic_store_relaxed_u32(&slot->referenced, 0);
+	}
+	if (!slot) return NULL; // Every slot is being read into
+	if (slot->owner) atomic_store_ptr(&slot->owner->pages[slot->page], NULL);
+	return slot;
+}
+
+static bool read_page(const struct tex_file *file, size_t index, unsigned char *data) {
+	const size_t offset = sizeof(struct tex_header) + index * file->page_bytes;
+#if defined(WINDOWS)
+	(void)file; (void)offset; (void)data;
+	return false; // tex_cache_new() doesn't work here
+#else
+	// Other threads read other pages of the same file meanwhile, so no shared file position
+	return pread(fileno(file->f), data, file->page_bytes, (off_t)offset) == (ssize_t)file->page_bytes;
+#endif
+}
+
+// Loads the page into a slot. The page gets claimed under the lock with the slot generation
+// odd, then read in without the lock, so only lookups of this very page have to wait for it.
+static void page_in(const struct tex_level *level, size_t page) {
+	struct tex_file *file = level->file;
+	struct tex_cache *cache = file->cache;
+	mutex_lock(cache->lock);
+	struct tex_slot *slot;
+	for (;;) {
+		slot = atomic_load_ptr(&level->pages[page]);
+		if (slot && !(slot->gen & 1)) {
+			// Someone else got to it first
+			mutex_release(cache->lock);
+			return;
+		}
+		if (!slot && (slot = take_slot(cache))) break;
+		// Wait for whoever is reading this page in, or for any slot to free up
+		thread_cond_wait(&cache->page_loaded, cache->lock);
+	}
+	const uint32_t gen = slot->gen;
+	atomic_store_relaxed_u32(&slot->gen, gen + 1);
+	atomic_fence_release();
+	slot->owner = level;
+	slot->page = page;
+	atomic_store_ptr(&level->pages[page], slot);
+	mutex_release(cache->lock);
+
+	if (!read_page(file, level->first_page + page, slot->data)) {
+		logr(warning, "Failed to read texture cache page, the cache file may have been changed underneath us\n");
+		memset(slot->data, 0, file->page_bytes);
+	}
+
+	mutex_lock(cache->lock);
+	atomic_store_relaxed_u32(&slot->referenced, 1);
+	atomic_store_u32(&slot->gen, gen + 2);
+	cache->pages_read++;
+	thread_cond_broadcast(&cache->page_loaded);
+	mutex_release(cache->lock);
+}
+
+struct color tex_paged_get_px(const struct texture *t, size_t x, size_t y) {
+	const struct tex_level *level = t->paged;
+	const size_t side = level->file->page_side;
+	const size_t page = (y / side) * level->pages_across + x / side;
+	struct texture view = { .precision = t->precision, .channels = t->channels, .width = side, .height = side, .tiled = true, .decode_srgb = t->decode_srgb };
+	for (;;) {
+		struct tex_slot *slot = atomic_load_ptr(&level->pages[page]);
+		if (slot) {
+			const uint32_t gen = atomic_load_u32(&slot->gen);
+			if (!(gen & 1) && slot->owner == level && slot->page == page) {
+				view.data.byte_p = slot->data;
+				const struct color c = tex_get_px(&view, x % side, y % side, false);
+				// Only keep what we read if the slot wasn't refilled meanwhile
+				atomic_fence_acquire();
+				if (atomic_load_relaxed_u32(&slot->gen) == gen) {
+					if (!atomic_load_relaxed_u32(&slot->referenced)) atomic_store_relaxed_u32(&slot->referenced, 1);
+					return c;
+				}
+			}
+		}
+		page_in(level, page);
+	}
+}
+
+void tex_paged_release(struct texture *t) {
+	if (!t || !t->paged) return;
+	struct tex_file *file = t->paged->file;
+	struct tex_cache *cache = file->cache;
+	mutex_lock(cache->lock);
+	for (size_t i = 0; i < cache->slots.count; ++i) {
+		struct tex_slot *slot = cache->slots.items[i];
+		if (slot->owner && slot->owner->file == file) {
+			slot->owner = NULL;
+			slot->referenced = 0;
+		}
+	}
+	mutex_release(cache->lock);
+	for (size_t l = 0; l < file->level_count; ++l) free(file->levels[l].pages);
+	fclose(file->f);
+	free(file);
+	t->paged = NULL;
+	for (size_t i = 0; i < t->mip_count; ++i) t->mips[i].paged = NULL;
+}
+
+struct texture *tex_paged_copy(const struct texture *t) {
+	if (!t || !t->paged) return NULL;
+	struct texture *copy = tex_new(t->precision, t->width, t->height, t->channels);
+	if (!copy) return NULL;
+	copy->colorspace = t->colorspace;
+	copy->decode_srgb = t->decode_srgb;
+	copy->tiled = true;
+	free(copy->data.byte_p);
+	copy->data.byte_p = calloc(1, tex_data_size(copy));
+	// Go page by page, so each gets read in once
+	const size_t side = t->paged->file->page_side;
+	const size_t px_size = tex_px_size(t);
+	struct texture view = { .precision = t->precision, .channels = t->channels, .width = side, .height = side, .tiled = true };
+	for (size_t py = 0; py < t->height; py += side) {
+		for (size_t px = 0; px < t->width; px += side) {
+			const struct tex_level *level = t->paged;
+			const size_t page = (py / side) * level->pages_across + px / side;
+			mutex_lock(level->file->cache->lock);
+			struct tex_slot *slot = level->pages[page];
+			while (!slot || slot->gen & 1) {
+				mutex_release(level->file->cache->lock);
+				page_in(level, page);
+				mutex_lock(level->file->cache->lock);
+				slot = level->pages[page];
+			}
+			// Holding the lock keeps the slot from being refilled
+			view.data.byte_p = slot->data;
+			for (size_t y = py; y < min(py + side, t->height); ++y) {
+				for (size_t x = px; x < min(px + side, t->width); ++x) {
+					memcpy(tex_px_ptr(copy, x, y), tex_px_ptr(&view, x - px, y - py), px_size);
+				}
+			}
+			mutex_release(level->file->cache->lock);
+		}
+	}
+	return copy;
+}
@@ -0,0 +1,50 @@
+//
+//  texture_cache.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "color.h"
+
+// Out-of-core textures. Each image is converted once into a file in the cache directory,
+// with all its MIP levels split into fixed size pages. Textures backed by such a file
+// keep no pixels of their own: pages get read in when a lookup first touches them, into
+// slots shared by every texture in the cache. Once the memory budget is used up, slots
+// are reused in roughly least recently used order (CLOCK). Lookups that hit don't lock,
+// a slot being reused under them just makes them retry. Only misses take the lock.
+// Files are named after the source path & options, and redone when the source changes.
+
+struct tex_cache;
+struct texture;
+
+/// Cache converted images in the directory at path, which is created if needed.
+/// At most budget bytes of pages are kept in memory at a time.
+struct tex_cache *tex_cache_new(const char *path, size_t budget);
+/// Memory given back by lowering the budget is only released by tex_cache_destroy()
+void tex_cache_set_budget(struct tex_cache *cache, size_t budget);
+/// Stop loading new textures through the cache. Ones loaded already keep working.
+void tex_cache_disable(struct tex_cache *cache);
+const char *tex_cache_path(const struct tex_cache *cache);
+/// Textures loaded through the cache have to be destroyed before it
+void tex_cache_destroy(struct tex_cache *cache);
+
+/// Set up out to page the image at path in from the cache, converting it first if needed.
+/// options are the image node ones, SRGB_TRANSFORM is applied while converting.
+/// Returns false if the cache couldn't be used, out is left untouched then.
+bool tex_cache_load(struct tex_cache *cache, const char *path, uint8_t options, struct texture *out);
+
+// Used by texture.c for textures with t->paged set
+
+/// Pixel (x, y) of t, which must be within bounds
+struct color tex_paged_get_px(const struct texture *t, size_t x, size_t y);
+/// Drop the pages of t (and its MIP levels) and close its file
+void tex_paged_release(struct texture *t);
+/// Copy of the base level of t with all pixels in memory, for sending it elsewhere
+struct texture *tex_paged_copy(const struct texture *t);
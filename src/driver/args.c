@@ -31,12 +31,23 @@ static void printUsage(const char *progname) {
 	printf("    [-j <n>]         -> Override thread count to n\n");
 	printf("    [-s <n>]         -> Override sample count to n\n");
 	printf("    [-d <w>x<h>]     -> Override image dimensions to <w>x<h>\n");
-	printf("    [-t <w>x<h>]     -> Override tile  dimensions to <w>x<h>\n");
+	printf("    [-t <w>x<h>]     -> Override tile  dimensions to <w>x<h>, or 'auto' to pick automatically\n");
 	printf("    [-o <path>]      -> Override output file path to <path>\n");
 	printf("    [-c <cam_index>] -> Select camera. Defaults to 0\n");
 	printf("    [-v]             -> Enable verbose mode\n");
 	printf("    [-vv]            -> Enable very verbose mode\n");
 	printf("    [--iterative]    -> Start in iterative mode (Experimental)\n");
+	printf("    [--pin-threads]  -> Pin render threads to cores, spread across NUMA nodes\n");
+	printf("    [--denoise]      -> Denoise the result, guided by first hit albedo & normals\n");
+	printf("    [--guiding]      -> Learn where light comes from before rendering, and sample towards it\n");
+	printf("    [--sort-hits]    -> Shade the hits of each bounce in a tile grouped by material\n");
+	printf("    [--shader-cache <dir>] -> Compile shaders to native code with cc, and cache it in <dir>\n");
+	printf("    [--texture-cache <dir>] -> Page textures in from files converted into <dir>, instead of loading them whole\n");
+	printf("    [--texture-cache-size <MB>] -> Memory to keep texture pages in, 1024 by default\n");
+	printf("    [--aovs <list>]  -> Also output comma-separated AOVs: depth, normal, albedo, instance_id,\n");
+	printf("                        sample_count, variance, light_emitters, light_environment\n");
+	printf("    [--checkpoint <file>] -> Periodically save render progress to <file>, and when interrupted\n");
+	printf("    [--resume <file>]     -> Continue an interrupted render from checkpoint <file>, and keep checkpointing to it\n");
 	printf("    [--worker]       -> Start up as a network render worker (Experimental)\n");
 	printf("    [--nodes <list>] -> Use worker nodes in comma-separated ip:port list for a faster render (Experimental)\n");
 	printf("    [--shutdown]     -> Use in conjunction with a node list to send a shutdown command to a list of clients\n");
@@ -84,6 +95,50 @@ struct driver_args *args_parse(int argc, char **argv) {
 			}
 			continue;
 		}
+
+		if (stringEquals(argv[i], "--aovs")) {
+			if (i + 1 < argc) {
+				setDatabaseString(args, "aovs", argv[i + 1]);
+				++i;
+			}
+			continue;
+		}
+		
+		if (stringEquals(argv[i], "--shader-cache")) {
+			if (i + 1 < argc) {
+				setDatabaseString(args, "shader_cache", argv[i + 1]);
+				++i;
+			}
+			continue;
+		}
+
+		if (stringEquals(argv[i], "--texture-cache")) {
+			if (i + 1 < argc) {
+				setDatabaseString(args, "texture_cache", argv[i + 1]);
+				++i;
+			}
+			continue;
+		}
+
+		if (stringEquals(argv[i], "--texture-cache-size")) {
+			if (i + 1 < argc) {
+				int n = atoi(argv[i + 1]);
+				setDatabaseInt(args, "texture_cache_size", n < 1 ? 1 : n);
+				++i;
+			} else {
+				logr(warning, "Invalid --texture-cache-size parameter given!\n");
+			}
+			continue;
+		}
+
+		// Checkpoint files are valid files too, so skip over them before looking for the input file
+		if (stringEquals(argv[i], "--checkpoint") || stringEquals(argv[i], "--resume")) {
+			if (i + 1 < argc) {
+				setDatabaseString(args, stringEquals(argv[i], "--resume") ? "resume_path" : "checkpoint_path", argv[i + 1]);
+				++i;
+			}
+			continue;
+		}
 		
 		if (alternatePath) {
 			free(alternatePath);
@@ -143,7 +198,10 @@ struct driver_args *args_parse(int argc, char **argv) {
 			char *dimstr = argv[i + 1];
 			int width = 0;
 			int height = 0;
-			if (parseDims(dimstr, &width, &height)) {
+			if (dimstr && stringEquals(dimstr, "auto")) {
+				setDatabaseTag(args, "tiledims_override");
+				setDatabaseTag(args, "tiledims_auto");
+			} else if (parseDims(dimstr, &width, &height)) {
 				setDatabaseTag(args, "tiledims_override");
 				setDatabaseInt(args, "tile_width", width);
 				setDatabaseInt(args, "tile_height", height);
@@ -208,6 +266,22 @@ struct driver_args *args_parse(int argc, char **argv) {
 			setDatabaseTag(args, "interactive");
 		}
 		
+		if (stringEquals(argv[i], "--pin-threads")) {
+			setDatabaseTag(args, "pin_threads");
+		}
+		
+		if (stringEquals(argv[i], "--denoise")) {
+			setDatabaseTag(args, "denoise");
+		}
+		
+		if (stringEquals(argv[i], "--guiding")) {
+			setDatabaseTag(args, "path_guiding");
+		}
+		
+		if (stringEquals(argv[i], "--sort-hits")) {
+			setDatabaseTag(args, "sort_hits");
+		}
+		
 		if (stringEquals(argv[i], "--shutdown")) {
 			setDatabaseTag(args, "shutdown");
 		}
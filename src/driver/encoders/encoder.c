@@ -6,6 +6,7 @@
 //  Copyright © 2020-2025 Valtteri Koskivuori. All rights reserved.
 //
 
+#include "../../includes.h"
 #include "encoder.h"
 
 #include <imagefile.h>
@@ -45,7 +46,11 @@ void writeImage(struct imageFile *image) {
 			break;
 	}
 	char buf[2048];
-	snprintf(buf, 2048 - 1, "%s%s_%04d.%s", image->filePath, image->fileName, image->count, suffix);
+	if (image->pass) {
+		snprintf(buf, 2048 - 1, "%s%s_%04d_%s.%s", image->filePath, image->fileName, image->count, image->pass, suffix);
+	} else {
+		snprintf(buf, 2048 - 1, "%s%s_%04d.%s", image->filePath, image->fileName, image->count, suffix);
+	}
 	struct texture *tmp = tex_new(char_p, image->t->width, image->t->height, 3);
 	tex_to_srgb((struct texture *)image->t);
 	// FIXME: WTF? memcpy this, or just get rid of this seemingly useless copy?
@@ -71,3 +76,50 @@ void writeImage(struct imageFile *image) {
 	}
 	tex_destroy(tmp);
 }
+
+static float max_value(const struct texture *t) {
+	float highest = 0.0f;
+	for (size_t i = 0; i < t->width * t->height; ++i)
+		highest = max(highest, t->data.float_p[i * t->channels]);
+	return highest;
+}
+
+// Spread instance IDs out, so neighbouring ones are easy to tell apart
+static struct color id_color(unsigned id) {
+	if (!id) return g_black_color;
+	id *= 2654435761u;
+	return (struct color){ ((id >> 24) & 0xFF) / 255.0f, ((id >> 16) & 0xFF) / 255.0f, ((id >> 8) & 0xFF) / 255.0f, 1.0f };
+}
+
+struct cr_bitmap *aov_to_displayable(int aov, const struct cr_bitmap *in) {
+	const struct texture *src = (const struct texture *)in;
+	if (!src || aov < 0 || aov >= cr_aov_count) return NULL;
+	struct texture *out = tex_new(float_p, src->width, src->height, 4);
+	const float highest = aov == cr_aov_depth || aov == cr_aov_sample_count ? max_value(src) : 1.0f;
+	const float scale = highest > 0.0f ? 1.0f / highest : 1.0f;
+	for (size_t y = 0; y < src->height; ++y) {
+		for (size_t x = 0; x < src->width; ++x) {
+			struct color c = tex_get_px(src, x, y, false);
+			switch (aov) {
+				case cr_aov_depth:
+				case cr_aov_sample_count:
+					c = colorCoef(scale, c);
+					break;
+				case cr_aov_normal:
+					c = (struct color){ c.red * 0.5f + 0.5f, c.green * 0.5f + 0.5f, c.blue * 0.5f + 0.5f, 1.0f };
+					break;
+				case cr_aov_instance_id:
+					c = id_color((unsigned)c.red);
+					break;
+				default:
+					break;
+			}
+			c.alpha = 1.0f;
+			tex_set_px(out, c, x, y);
+		}
+	}
+	// Color AOVs still need the usual transfer function
+	const bool color = aov == cr_aov_albedo || aov == cr_aov_variance || aov == cr_aov_light_emitters || aov == cr_aov_light_environment;
+	out->colorspace = color ? linear : sRGB;
+	return (struct cr_bitmap *)out;
+}
@@ -13,3 +13,7 @@ struct renderInfo;
 
 //Writes image data to file
 void writeImage(struct imageFile *image);
+
+//Maps AOV data to a viewable image in a new bitmap, or NULL if aov is unknown.
+//Data AOVs like depth and normals are normalized and tagged as sRGB, so writeImage() won't re-encode them.
+struct cr_bitmap *aov_to_displayable(int aov, const struct cr_bitmap *in);
@@ -25,6 +25,7 @@ struct imageFile {
 	enum fileType type;
 	const char *filePath;
 	const char *fileName;
+	const char *pass; // Optional, appended to the file name for AOVs
 	int count;
 	struct renderInfo info;
 };
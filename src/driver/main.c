@@ -15,6 +15,7 @@
 #include <common/platform/terminal.h>
 #include <common/timer.h>
 #include <common/hashtable.h>
+#include <common/texture.h>
 #include <common/vendored/cJSON.h>
 #include <common/json_loader.h>
 #include <common/platform/capabilities.h>
@@ -23,6 +24,7 @@
 #include <encoders/encoder.h>
 #include <args.h>
 #include <sdl.h>
+#include <string.h>
 
 struct usr_data {
 	struct cr_renderer *r;
@@ -147,6 +149,19 @@ int main(int argc, char *argv[]) {
 		free(asset_path);
 	}
 
+	// Shaders get compiled as the scene is loaded, so this has to be set before that
+	if (args_is_set(opts, "shader_cache")) {
+		cr_renderer_set_str_pref(renderer, cr_renderer_shader_cache, args_string(opts, "shader_cache"));
+	}
+
+	// Same for textures
+	if (args_is_set(opts, "texture_cache_size")) {
+		cr_renderer_set_num_pref(renderer, cr_renderer_texture_cache_size, args_int(opts, "texture_cache_size"));
+	}
+	if (args_is_set(opts, "texture_cache")) {
+		cr_renderer_set_str_pref(renderer, cr_renderer_texture_cache, args_string(opts, "texture_cache"));
+	}
+
 	int ret = 0;
 	file_data input_bytes = args_is_set(opts, "inputFile") ? file_load(args_path(opts)) : read_stdin();
 	if (!input_bytes.count) {
@@ -222,13 +237,60 @@ int main(int argc, char *argv[]) {
 	if (args_is_set(opts, "tiledims_override")) {
 		if (args_is_set(opts, "is_worker")) {
 			logr(warning, "Can't override tile dimensions when in worker mode\n");
+		} else if (args_is_set(opts, "tiledims_auto")) {
+			logr(info, "Using automatic tile dimensions\n");
+			cr_renderer_set_num_pref(renderer, cr_renderer_tile_auto, 1);
 		} else {
 			int width = args_int(opts, "tile_width");
 			int height = args_int(opts, "tile_height");
 			logr(info, "Overriding tile  dimensions to %ix%i\n", width, height);
 			cr_renderer_set_num_pref(renderer, cr_renderer_tile_width, width);
 			cr_renderer_set_num_pref(renderer, cr_renderer_tile_height, height);
+			cr_renderer_set_num_pref(renderer, cr_renderer_tile_auto, 0);
+		}
+	}
+
+	if (args_is_set(opts, "checkpoint_path")) {
+		cr_renderer_set_str_pref(renderer, cr_renderer_checkpoint_path, args_string(opts, "checkpoint_path"));
+	}
+
+	if (args_is_set(opts, "resume_path")) {
+		char *resume_path = args_string(opts, "resume_path");
+		cr_renderer_set_str_pref(renderer, cr_renderer_resume_path, resume_path);
+		if (!args_is_set(opts, "checkpoint_path")) {
+			cr_renderer_set_str_pref(renderer, cr_renderer_checkpoint_path, resume_path);
+		}
+	}
+
+	if (args_is_set(opts, "pin_threads")) {
+		cr_renderer_set_num_pref(renderer, cr_renderer_pin_threads, 1);
+	}
+
+	if (args_is_set(opts, "denoise")) {
+		cr_renderer_set_num_pref(renderer, cr_renderer_denoise, 1);
+	}
+
+	if (args_is_set(opts, "path_guiding")) {
+		cr_renderer_set_num_pref(renderer, cr_renderer_path_guiding, 1);
+	}
+
+	if (args_is_set(opts, "sort_hits")) {
+		cr_renderer_set_num_pref(renderer, cr_renderer_sort_hits, 1);
+	}
+
+	if (args_is_set(opts, "aovs")) {
+		char *list = stringCopy(args_string(opts, "aovs"));
+		uint64_t mask = 0;
+		for (char *name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+			const int aov = aov_from_name(name);
+			if (aov < 0) {
+				logr(warning, "Unknown AOV \"%s\", ignoring\n", name);
+				continue;
+			}
+			mask |= 1 << aov;
 		}
+		free(list);
+		cr_renderer_set_num_pref(renderer, cr_renderer_aovs, mask);
 	}
 
 	if (args_is_set(opts, "interactive")) {
@@ -315,6 +377,16 @@ int main(int argc, char *argv[]) {
 			.t = cr_renderer_get_result(renderer)
 		};
 		writeImage(&file);
+		const uint64_t aovs = cr_renderer_get_num_pref(renderer, cr_renderer_aovs);
+		for (int aov = 0; aov < cr_aov_count; ++aov) {
+			if (!(aovs & (1 << aov))) continue;
+			struct cr_bitmap *displayable = aov_to_displayable(aov, cr_renderer_get_aov(renderer, aov));
+			if (!displayable) continue;
+			file.t = displayable;
+			file.pass = cr_aov_name(aov);
+			writeImage(&file);
+			tex_destroy((struct texture *)displayable);
+		}
 		logr(info, "Render finished, exiting.\n");
 	} else {
 		logr(info, "Abort pressed, image won't be saved.\n");
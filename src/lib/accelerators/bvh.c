@@ -660,6 +660,26 @@ struct bvh *build_top_level_bvh(const struct instance_arr instances) {
 	return build_bvh_generic(instances.items, get_instance_bbox_and_center, instances.count);
 }
 
+struct bvh *build_bvh(const void *user_data, bvh_bbox_and_center_fn_t get_bbox_and_center, size_t count) {
+	return build_bvh_generic(user_data, get_bbox_and_center, count);
+}
+
+size_t bvh_node_count(const struct bvh *bvh) {
+	return bvh->node_count;
+}
+
+bool bvh_get_node(const struct bvh *bvh, size_t idx, struct boundingBox *bbox, size_t *first, size_t *prim_count) {
+	const struct bvh_node *node = &bvh->nodes[idx];
+	if (bbox) *bbox = load_bbox_from_node(node);
+	*first = node->index.first_child_or_prim;
+	*prim_count = node->index.prim_count;
+	return node->index.prim_count != 0;
+}
+
+size_t bvh_prim_index(const struct bvh *bvh, size_t i) {
+	return bvh->prim_indices[i];
+}
+
 bool traverse_bottom_level_bvh(
 	const struct mesh *mesh,
 	const struct lightRay *ray,
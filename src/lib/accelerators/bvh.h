@@ -39,6 +39,24 @@ struct bvh *build_mesh_bvh(const struct mesh *mesh);
 /// @param instanceCount Amount of instances
 struct bvh *build_top_level_bvh(const struct instance_arr instances);
 
+typedef void (*bvh_bbox_and_center_fn_t)(const void *user_data, unsigned i, struct boundingBox *bbox, struct vector *center);
+
+/// Builds a BVH over arbitrary primitives, described only by their bounding boxes and centers
+/// @param user_data Passed to get_bbox_and_center
+/// @param count Amount of primitives
+struct bvh *build_bvh(const void *user_data, bvh_bbox_and_center_fn_t get_bbox_and_center, size_t count);
+
+/// Amount of nodes in the BVH, the root is node 0
+size_t bvh_node_count(const struct bvh *bvh);
+
+/// Look up a single node. For leaves, first and prim_count give the range of primitives
+/// to look up with bvh_prim_index(). For inner nodes, the children are first and first + 1.
+/// @return true if the node is a leaf
+bool bvh_get_node(const struct bvh *bvh, size_t idx, struct boundingBox *bbox, size_t *first, size_t *prim_count);
+
+/// Maps a primitive slot in a leaf back to the index it was given to build_bvh() with
+size_t bvh_prim_index(const struct bvh *bvh, size_t i);
+
 /// Intersect a ray with a scene top-level BVH
 bool traverse_top_level_bvh(
 	const struct instance *instances,
@@ -0,0 +1,208 @@
+//
+//  lighttree.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../../includes.h"
+#include "lighttree.h"
+
+#include "bvh.h"
+#include <stdlib.h>
+#include <math.h>
+
+static const struct light_bounds empty_bounds = {
+	.bbox = {
+		.min = {  FLT_MAX,  FLT_MAX,  FLT_MAX },
+		.max = { -FLT_MAX, -FLT_MAX, -FLT_MAX }
+	},
+	.cos_theta_o = 1.0f,
+	.power = 0.0f,
+};
+
+// Rotate v around the given unit axis (Rodrigues' formula)
+static inline struct vector vec_rotate(const struct vector v, const struct vector axis, float angle) {
+	const float c = cosf(angle);
+	const float s = sinf(angle);
+	return vec_add(vec_add(vec_scale(v, c), vec_scale(vec_cross(axis, v), s)), vec_scale(axis, vec_dot(axis, v) * (1.0f - c)));
+}
+
+// Smallest cone containing both a and b. Cones are symmetric (two-sided), so b may be flipped.
+static void merge_cones(struct vector *axis, float *cos_theta_o, struct vector b_axis, float b_cos) {
+	if (*cos_theta_o <= -1.0f || b_cos <= -1.0f) {
+		*cos_theta_o = -1.0f;
+		return;
+	}
+	if (vec_dot(*axis, b_axis) < 0.0f) b_axis = vec_negate(b_axis);
+	const float theta_a = acosf(clamp(*cos_theta_o, -1.0f, 1.0f));
+	const float theta_b = acosf(clamp(b_cos, -1.0f, 1.0f));
+	const float theta_d = acosf(clamp(vec_dot(*axis, b_axis), -1.0f, 1.0f));
+	if (min(theta_d + theta_b, PI) <= theta_a) return;
+	if (min(theta_d + theta_a, PI) <= theta_b) {
+		*axis = b_axis;
+		*cos_theta_o = b_cos;
+		return;
+	}
+	const float theta_o = (theta_a + theta_d + theta_b) * 0.5f;
+	const struct vector rot_axis = vec_cross(*axis, b_axis);
+	if (theta_o >= PI || vec_length_squared(rot_axis) == 0.0f) {
+		*cos_theta_o = -1.0f;
+		return;
+	}
+	*axis = vec_normalize(vec_rotate(*axis, vec_normalize(rot_axis), theta_o - theta_a));
+	*cos_theta_o = cosf(theta_o);
+}
+
+static struct light_bounds merge_bounds(const struct light_bounds *a, const struct light_bounds *b) {
+	if (a->power <= 0.0f) return *b;
+	if (b->power <= 0.0f) return *a;
+	struct light_bounds out = *a;
+	extendBBox(&out.bbox, &b->bbox);
+	merge_cones(&out.axis, &out.cos_theta_o, b->axis, b->cos_theta_o);
+	out.power = a->power + b->power;
+	return out;
+}
+
+// Estimate of how much light the bounds could contribute at p
+static float importance(const struct light_bounds *b, const struct vector p) {
+	if (b->power <= 0.0f) return 0.0f;
+	const struct vector center = bboxCenter(&b->bbox);
+	const struct vector to_p = vec_sub(p, center);
+	const float dist_sq = vec_length_squared(to_p);
+	const float radius_sq = vec_length_squared(vec_sub(b->bbox.max, center));
+	// Don't let the estimate blow up close to, or inside the bounds
+	const float clamped_dist_sq = max(dist_sq, radius_sq);
+	if (b->cos_theta_o <= -1.0f || dist_sq <= radius_sq) return b->power / clamped_dist_sq;
+
+	const float cos_theta_w = fabsf(vec_dot(b->axis, to_p)) / sqrtf(dist_sq);
+	const float theta_w = acosf(min(cos_theta_w, 1.0f));
+	const float theta_o = acosf(clamp(b->cos_theta_o, -1.0f, 1.0f));
+	const float theta_b = asinf(sqrtf(radius_sq / dist_sq));
+	const float theta = max(theta_w - theta_o - theta_b, 0.0f);
+	if (theta >= PI / 2.0f) return 0.0f;
+	return b->power * cosf(theta) / clamped_dist_sq;
+}
+
+static void get_prim_bbox_and_center(const void *user_data, unsigned i, struct boundingBox *bbox, struct vector *center) {
+	const struct light_bounds *prims = user_data;
+	*bbox = prims[i].bbox;
+	*center = bboxCenter(bbox);
+}
+
+static struct light_bounds build_recursive(struct light_tree *tree, const struct bvh *bvh, const struct light_bounds *prims, size_t idx, uint64_t trail, unsigned depth) {
+	size_t first, prim_count;
+	struct light_tree_node *node = &tree->nodes[idx];
+	if (bvh_get_node(bvh, idx, NULL, &first, &prim_count)) {
+		struct light_bounds bounds = empty_bounds;
+		for (size_t i = first; i < first + prim_count; ++i) {
+			const size_t prim = bvh_prim_index(bvh, i);
+			tree->prims[i] = prim;
+			tree->trails[prim] = trail;
+			bounds = merge_bounds(&bounds, &prims[prim]);
+		}
+		*node = (struct light_tree_node){ .bounds = bounds, .first = first, .prim_count = prim_count };
+		return bounds;
+	}
+	const uint64_t right = depth < 64 ? (uint64_t)1 << depth : 0;
+	const struct light_bounds left_bounds = build_recursive(tree, bvh, prims, first, trail, depth + 1);
+	const struct light_bounds right_bounds = build_recursive(tree, bvh, prims, first + 1, trail | right, depth + 1);
+	node = &tree->nodes[idx];
+	*node = (struct light_tree_node){ .bounds = merge_bounds(&left_bounds, &right_bounds), .first = first, .prim_count = 0 };
+	return node->bounds;
+}
+
+struct light_tree *light_tree_build(const struct light_bounds *prims, size_t count) {
+	if (!count) return NULL;
+	struct bvh *bvh = build_bvh(prims, get_prim_bbox_and_center, count);
+	struct light_tree *tree = calloc(1, sizeof(*tree));
+	tree->node_count = bvh_node_count(bvh);
+	tree->nodes = calloc(tree->node_count, sizeof(*tree->nodes));
+	tree->prims = calloc(count, sizeof(*tree->prims));
+	tree->trails = calloc(count, sizeof(*tree->trails));
+	build_recursive(tree, bvh, prims, 0, 0, 0);
+	destroy_bvh(bvh);
+	return tree;
+}
+
+void light_tree_destroy(struct light_tree *tree) {
+	if (!tree) return;
+	free(tree->nodes);
+	free(tree->prims);
+	free(tree->trails);
+	free(tree);
+}
+
+// Importance of every primitive in a leaf, returns the sum
+static float leaf_importance(const struct light_tree *tree, const struct light_tree_node *leaf, const struct light_bounds *prims, const struct vector p, float *out) {
+	float total = 0.0f;
+	for (size_t i = 0; i < leaf->prim_count; ++i) {
+		out[i] = importance(&prims[tree->prims[leaf->first + i]], p);
+		total += out[i];
+	}
+	return total;
+}
+
+int64_t light_tree_sample(const struct light_tree *tree, const struct light_bounds *prims, const struct vector p, float u, float *pmf) {
+	if (!tree) return -1;
+	float prob = 1.0f;
+	const struct light_tree_node *node = &tree->nodes[0];
+	while (!node->prim_count) {
+		const struct light_tree_node *left = &tree->nodes[node->first];
+		const struct light_tree_node *right = &tree->nodes[node->first + 1];
+		const float i_left = importance(&left->bounds, p);
+		const float i_right = importance(&right->bounds, p);
+		if (i_left + i_right <= 0.0f) return -1;
+		const float p_left = i_left / (i_left + i_right);
+		// Reuse u for the rest of the traversal
+		if (u < p_left) {
+			u = min(u / p_left, 0.99999994f);
+			prob *= p_left;
+			node = left;
+		} else {
+			u = min((u - p_left) / (1.0f - p_left), 0.99999994f);
+			prob *= 1.0f - p_left;
+			node = right;
+		}
+	}
+	float weights[16];
+	const float total = leaf_importance(tree, node, prims, p, weights);
+	if (total <= 0.0f) return -1;
+	float cdf = 0.0f;
+	for (size_t i = 0; i < node->prim_count; ++i) {
+		cdf += weights[i] / total;
+		if (u < cdf || i == node->prim_count - 1) {
+			if (weights[i] <= 0.0f) return -1;
+			*pmf = prob * weights[i] / total;
+			return tree->prims[node->first + i];
+		}
+	}
+	return -1;
+}
+
+float light_tree_pmf(const struct light_tree *tree, const struct light_bounds *prims, const struct vector p, size_t prim) {
+	if (!tree) return 0.0f;
+	const uint64_t trail = tree->trails[prim];
+	float prob = 1.0f;
+	unsigned depth = 0;
+	const struct light_tree_node *node = &tree->nodes[0];
+	while (!node->prim_count) {
+		const struct light_tree_node *left = &tree->nodes[node->first];
+		const struct light_tree_node *right = &tree->nodes[node->first + 1];
+		const float i_left = importance(&left->bounds, p);
+		const float i_right = importance(&right->bounds, p);
+		if (i_left + i_right <= 0.0f) return 0.0f;
+		const bool go_right = depth < 64 && (trail >> depth) & 1;
+		prob *= (go_right ? i_right : i_left) / (i_left + i_right);
+		node = go_right ? right : left;
+		depth++;
+	}
+	float weights[16];
+	const float total = leaf_importance(tree, node, prims, p, weights);
+	if (total <= 0.0f) return 0.0f;
+	for (size_t i = 0; i < node->prim_count; ++i) {
+		if (tree->prims[node->first + i] == prim) return prob * weights[i] / total;
+	}
+	return 0.0f;
+}
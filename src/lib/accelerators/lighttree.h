@@ -0,0 +1,55 @@
+//
+//  lighttree.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <common/vector.h>
+#include <datatypes/bbox.h>
+
+// Spatial and directional bounds of one emitter, or a group of them.
+// Emitters are two-sided, so the normal cone also covers its mirror image.
+struct light_bounds {
+	struct boundingBox bbox;
+	struct vector axis;
+	float cos_theta_o; // Normal cone half-angle, -1 for all directions
+	float power;
+};
+
+struct light_tree_node {
+	struct light_bounds bounds;
+	uint32_t first; // First child for inner nodes (second one follows it), first slot for leaves
+	uint32_t prim_count; // 0 for inner nodes
+};
+
+// A light BVH, in the spirit of Conty & Kulla's "Importance Sampling of Many Lights
+// with Adaptive Tree Splitting". Traversal picks a child with probability proportional
+// to an importance estimate based on power, distance and orientation, so the cost
+// of picking a light stays logarithmic in the amount of emitters.
+struct light_tree {
+	struct light_tree_node *nodes;
+	size_t node_count;
+	uint32_t *prims; // Leaf slot -> primitive index
+	uint64_t *trails; // Per primitive, the left/right decisions from the root to its leaf
+};
+
+/// Build a light tree over the given primitive bounds. The topology comes from the SAH BVH builder.
+struct light_tree *light_tree_build(const struct light_bounds *prims, size_t count);
+
+void light_tree_destroy(struct light_tree *tree);
+
+/// Stochastically pick a primitive for shading point p
+/// @param u Uniform random number in [0,1)
+/// @param pmf Probability of the returned primitive being picked
+/// @return Primitive index, or -1 if every primitive has zero importance at p
+int64_t light_tree_sample(const struct light_tree *tree, const struct light_bounds *prims, const struct vector p, float u, float *pmf);
+
+/// Probability of light_tree_sample() picking primitive prim for shading point p
+float light_tree_pmf(const struct light_tree *tree, const struct light_bounds *prims, const struct vector p, size_t prim);
@@ -17,6 +17,7 @@
 #include <common/fileio.h>
 #include <common/cr_assert.h>
 #include <common/texture.h>
+#include <common/texture_cache.h>
 #include <common/cr_string.h>
 #include <common/hashtable.h>
 #include <common/json_loader.h>
@@ -27,6 +28,7 @@
 #include <renderer/renderer.h>
 #include <datatypes/camera.h>
 #include <datatypes/scene.h>
+#include <nodes/native.h>
 #include <protocol/server.h>
 #include <protocol/worker.h>
 #include <protocol/protocol.h>
@@ -116,6 +118,52 @@ bool cr_renderer_set_num_pref(struct cr_renderer *ext, enum cr_renderer_param p,
 			r->prefs.blender_mode = num;
 			return true;
 		}
+		case cr_renderer_pixel_major: {
+			r->prefs.pixel_major = num;
+			return true;
+		}
+		case cr_renderer_tile_auto: {
+			r->prefs.tile_auto = num;
+			return true;
+		}
+		case cr_renderer_denoise: {
+			r->prefs.denoise = num;
+			return true;
+		}
+		case cr_renderer_aovs: {
+			r->prefs.aovs = num & ((1 << cr_aov_count) - 1);
+			return true;
+		}
+		case cr_renderer_path_guiding: {
+			r->prefs.path_guiding = num;
+			return true;
+		}
+		case cr_renderer_target_frame_ms: {
+			r->prefs.target_frame_ms = num;
+			return true;
+		}
+		case cr_renderer_reproject: {
+			r->prefs.reproject = num;
+			return true;
+		}
+		case cr_renderer_sort_hits: {
+			r->prefs.sort_hits = num;
+			return true;
+		}
+		case cr_renderer_pin_threads: {
+			r->prefs.pin_threads = num;
+			return true;
+		}
+		case cr_renderer_checkpoint_interval: {
+			r->prefs.checkpoint_interval = num;
+			return true;
+		}
+		case cr_renderer_texture_cache_size: {
+			if (!num) return false;
+			r->prefs.texture_cache_mb = num;
+			if (r->scene->tex_cache) tex_cache_set_budget(r->scene->tex_cache, num * 1024 * 1024);
+			return true;
+		}
 		default: return false;
 	}
 	return false;
@@ -134,11 +182,25 @@ bool cr_renderer_set_str_pref(struct cr_renderer *ext, enum cr_renderer_param p,
 				r->prefs.tileOrder = ro_from_middle;
 			} else if (stringEquals(str, "toMiddle")) {
 				r->prefs.tileOrder = ro_to_middle;
+			} else if (stringEquals(str, "morton")) {
+				r->prefs.tileOrder = ro_morton;
+			} else if (stringEquals(str, "hilbert")) {
+				r->prefs.tileOrder = ro_hilbert;
 			} else {
 				r->prefs.tileOrder = ro_normal;
 			}
 			return true;
 		}
+		case cr_renderer_pixel_order: {
+			if (stringEquals(str, "morton")) {
+				r->prefs.pixelOrder = po_morton;
+			} else if (stringEquals(str, "hilbert")) {
+				r->prefs.pixelOrder = po_hilbert;
+			} else {
+				r->prefs.pixelOrder = po_scanline;
+			}
+			return true;
+		}
 		case cr_renderer_asset_path: {
 			// TODO: we shouldn't really be touching anything but prefs in here.
 			if (r->scene->asset_path) free(r->scene->asset_path);
@@ -150,6 +212,39 @@ bool cr_renderer_set_str_pref(struct cr_renderer *ext, enum cr_renderer_param p,
 			r->prefs.node_list = stringCopy(str);
 			return true;
 		}
+		case cr_renderer_checkpoint_path: {
+			if (r->prefs.checkpoint_path) free(r->prefs.checkpoint_path);
+			r->prefs.checkpoint_path = str ? stringCopy(str) : NULL;
+			return true;
+		}
+		case cr_renderer_resume_path: {
+			if (r->prefs.resume_path) free(r->prefs.resume_path);
+			r->prefs.resume_path = str ? stringCopy(str) : NULL;
+			return true;
+		}
+		case cr_renderer_shader_cache: {
+			// Like asset_path, this lives in the scene. Shaders built so far may run code
+			// from the current cache, so it can only be switched off, not swapped.
+			struct native_cache **cache = &r->scene->storage.native;
+			if (!str) {
+				native_cache_disable(*cache);
+				return true;
+			}
+			if (*cache) return false;
+			*cache = native_cache_new(str);
+			return *cache != NULL;
+		}
+		case cr_renderer_texture_cache: {
+			// Same deal, textures loaded so far may be paged in from the current one
+			struct tex_cache **cache = &r->scene->tex_cache;
+			if (!str) {
+				tex_cache_disable(*cache);
+				return true;
+			}
+			if (*cache) return false;
+			*cache = tex_cache_new(str, r->prefs.texture_cache_mb * 1024 * 1024);
+			return *cache != NULL;
+		}
 		default: return false;
 	}
 	return false;
@@ -158,21 +253,36 @@ bool cr_renderer_set_str_pref(struct cr_renderer *ext, enum cr_renderer_param p,
 void cr_renderer_stop(struct cr_renderer *ext) {
 	if (!ext) return;
 	struct renderer *r = (struct renderer *)ext;
+	mutex_lock(r->state.stop_lock);
+	struct tile_set *set = r->state.current_set;
+	if (!set) {
+		r->state.s = r_exiting;
+		mutex_release(r->state.stop_lock);
+		return;
+	}
+	mutex_lock(set->tile_mutex);
 	r->state.s = r_exiting;
-	// TODO: use pthread_cond instead of silly busy-waiting loops like this
-	do {
-		timer_sleep_ms(10);
-	} while (r->prefs.iterative && r->state.s == r_exiting);
+	tile_set_wake(set);
+	mutex_release(set->tile_mutex);
+	// In interactive mode, renderer_render() runs on a thread of its own. Wait for it to wind down.
+	while (r->prefs.iterative && r->state.s == r_exiting)
+		thread_cond_wait(&r->state.stopped, r->state.stop_lock);
+	mutex_release(r->state.stop_lock);
 }
 
 void cr_renderer_toggle_pause(struct cr_renderer *ext) {
 	if (!ext) return;
 	struct renderer *r = (struct renderer *)ext;
-	for (size_t i = 0; i < r->prefs.threads; ++i) {
-		// FIXME: Use array for workers
-		// FIXME: What about network renderers?
-		r->state.workers.items[i].paused = !r->state.workers.items[i].paused;
+	struct tile_set *set = r->state.current_set;
+	if (!set) {
+		r->state.paused = !r->state.paused;
+		return;
 	}
+	// FIXME: What about network renderers?
+	mutex_lock(set->tile_mutex);
+	r->state.paused = !r->state.paused;
+	tile_set_wake(set);
+	mutex_release(set->tile_mutex);
 }
 
 const char *cr_renderer_get_str_pref(struct cr_renderer *ext, enum cr_renderer_param p) {
@@ -180,6 +290,10 @@ const char *cr_renderer_get_str_pref(struct cr_renderer *ext, enum cr_renderer_p
 	struct renderer *r = (struct renderer *)ext;
 	switch (p) {
 		case cr_renderer_asset_path: return r->scene->asset_path;
+		case cr_renderer_checkpoint_path: return r->prefs.checkpoint_path;
+		case cr_renderer_resume_path: return r->prefs.resume_path;
+		case cr_renderer_shader_cache: return native_cache_path(r->scene->storage.native);
+		case cr_renderer_texture_cache: return tex_cache_path(r->scene->tex_cache);
 		default: return NULL;
 	}
 	return NULL;
@@ -196,17 +310,35 @@ uint64_t cr_renderer_get_num_pref(struct cr_renderer *ext, enum cr_renderer_para
 		case cr_renderer_tile_height: return r->prefs.tileHeight;
 		case cr_renderer_override_width: return r->prefs.override_width;
 		case cr_renderer_override_height: return r->prefs.override_height;
+		case cr_renderer_pixel_major: return r->prefs.pixel_major;
+		case cr_renderer_tile_auto: return r->prefs.tile_auto;
+		case cr_renderer_pin_threads: return r->prefs.pin_threads;
+		case cr_renderer_denoise: return r->prefs.denoise;
+		case cr_renderer_aovs: return r->prefs.aovs;
+		case cr_renderer_path_guiding: return r->prefs.path_guiding;
+		case cr_renderer_target_frame_ms: return r->prefs.target_frame_ms;
+		case cr_renderer_reproject: return r->prefs.reproject;
+		case cr_renderer_sort_hits: return r->prefs.sort_hits;
+		case cr_renderer_checkpoint_interval: return r->prefs.checkpoint_interval;
+		case cr_renderer_texture_cache_size: return r->prefs.texture_cache_mb;
 		default: return 0; // TODO
 	}
 	return 0;
 }
 
+// Lights have to be rebuilt, and samples rendered so far show the old scene
+static void scene_changed(struct world *s) {
+	s->lights_dirty = true;
+	s->samples_stale = true;
+}
+
 bool cr_scene_set_background(struct cr_scene *s_ext, struct cr_shader_node *desc) {
 	if (!s_ext) return false;
 	struct world *s = (struct world *)s_ext;
 	s->background = desc ? build_bsdf_node(s_ext, desc) : newBackground(&s->storage, NULL, NULL, NULL, s->use_blender_coordinates);
 	if (s->bg_desc) cr_shader_node_free(s->bg_desc);
 	s->bg_desc = desc ? shader_deepcopy(desc) : NULL;
+	scene_changed(s);
 	return true;
 }
 
@@ -236,6 +368,7 @@ struct cr_scene_totals cr_scene_totals(struct cr_scene *s_ext) {
 cr_sphere cr_scene_add_sphere(struct cr_scene *s_ext, float radius) {
 	if (!s_ext) return -1;
 	struct world *scene = (struct world *)s_ext;
+	scene_changed(scene);
 	return sphere_arr_add(&scene->spheres, (struct sphere){ .radius = radius });
 }
 
@@ -292,6 +425,7 @@ void cr_mesh_bind_vertex_buf(struct cr_scene *s_ext, cr_mesh mesh, struct cr_ver
 		}
 	}
 	m->vbuf = new;
+	scene_changed(scene);
 }
 
 void cr_mesh_bind_faces(struct cr_scene *s_ext, cr_mesh mesh, struct cr_face *faces, size_t face_count) {
@@ -303,6 +437,7 @@ void cr_mesh_bind_faces(struct cr_scene *s_ext, cr_mesh mesh, struct cr_face *fa
 	for (size_t i = 0; i < face_count; ++i) {
 		poly_arr_add(&m->polygons, *(struct poly *)&faces[i]);
 	}
+	scene_changed(scene);
 }
 
 void cr_mesh_finalize(struct cr_scene *s_ext, cr_mesh mesh) {
@@ -314,6 +449,7 @@ void cr_mesh_finalize(struct cr_scene *s_ext, cr_mesh mesh) {
 	arg->mesh = *m;
 	arg->scene = scene;
 	arg->mesh_idx = mesh;
+	scene->samples_stale = true;
 	thread_pool_enqueue(scene->bg_worker, bvh_build_task, arg);
 }
 
@@ -354,6 +490,7 @@ cr_instance cr_instance_new(struct cr_scene *s_ext, cr_object object, enum cr_ob
 			return -1;
 	}
 	scene->top_level_dirty = true;
+	scene_changed(scene);
 	return instance_arr_add(&scene->instances, new);
 }
 
@@ -380,6 +517,7 @@ void cr_instance_set_transform(struct cr_scene *s_ext, cr_instance instance, flo
 		.Ainv = mat_invert(mtx)
 	};
 	scene->top_level_dirty = true;
+	scene_changed(scene);
 }
 
 void cr_instance_transform(struct cr_scene *s_ext, cr_instance instance, float row_major[4][4]) {
@@ -391,6 +529,7 @@ void cr_instance_transform(struct cr_scene *s_ext, cr_instance instance, float r
 	i->composite.A = mat_mul(i->composite.A, mtx);
 	i->composite.Ainv = mat_invert(i->composite.A);
 	scene->top_level_dirty = true;
+	scene_changed(scene);
 }
 
 bool cr_instance_bind_material_set(struct cr_scene *s_ext, cr_instance instance, cr_material_set set) {
@@ -400,6 +539,7 @@ bool cr_instance_bind_material_set(struct cr_scene *s_ext, cr_instance instance,
 	if ((size_t)set > scene->shader_buffers.count - 1) return false;
 	struct instance *i = &scene->instances.items[instance];
 	i->bbuf_idx = set;
+	scene_changed(scene);
 	return true;
 }
 
@@ -802,6 +942,7 @@ cr_material cr_material_set_add(struct cr_scene *s_ext, cr_material_set set, str
 	struct bsdf_buffer *buf = &s->shader_buffers.items[set];
 	const struct bsdfNode *node = build_bsdf_node(s_ext, desc);
 	cr_shader_node_ptr_arr_add(&buf->descriptions, shader_deepcopy(desc));
+	scene_changed(s);
 	return bsdf_node_ptr_arr_add(&buf->bsdfs, node);
 }
 
@@ -816,6 +957,7 @@ void cr_material_update(struct cr_scene *s_ext, cr_material_set set, cr_material
 	struct cr_shader_node *old_desc = buf->descriptions.items[mat];
 	cr_shader_node_free(old_desc);
 	buf->descriptions.items[mat] = shader_deepcopy(desc);
+	scene_changed(s);
 }
 
 void cr_renderer_render(struct cr_renderer *ext) {
@@ -850,61 +992,94 @@ void cr_renderer_restart_interactive(struct cr_renderer *ext) {
 	if (!r->state.result_buf) return;
 	if (!r->state.current_set) return;
 	struct camera *cam = &r->scene->cameras.items[r->prefs.selected_camera];
-	if (r->state.result_buf->width != (size_t)cam->width || r->state.result_buf->height != (size_t)cam->height) {
-		// Resize result buffer. First, pause render threads and wait for them to ack
-		cam_recompute_optics(cam);
-		logr(info, "Resizing result_buf (%zu,%zu) -> (%d,%d)\n", r->state.result_buf->width, r->state.result_buf->height, cam->width, cam->height);
-		/*
-			FIXME: Horrible, horrible hacks. Use proper pthreads primitives for this
-			instead of hacky signal flags and busy loops.
-		*/
-		cr_renderer_toggle_pause((struct cr_renderer *)r);
-		for (size_t i = 0; i < r->state.workers.count; ++i) {
-			while (!r->state.workers.items[i].in_pause_loop) {
-				timer_sleep_ms(1);
-				if (r->state.s != r_rendering) {
-					// Renderer stopped, bail out.
-					cr_renderer_toggle_pause((struct cr_renderer *)r);
-					return;
-				}
+	struct tile_set *set = r->state.current_set;
+	size_t local_threads = 0;
+	for (size_t i = 0; i < r->state.workers.count; ++i) {
+		if (!r->state.workers.items[i].client) local_threads++;
+	}
+	mutex_lock(set->tile_mutex);
+	const bool resize = r->state.result_buf->width != (size_t)cam->width || r->state.result_buf->height != (size_t)cam->height;
+	// Only re-pick the tile size when the frame changes size, not on every camera move
+	const bool retile = resize && renderer_auto_tile_dims(r, cam->width, cam->height, true);
+	// Samples can only be carried over if the camera is the only thing that changed.
+	// Reprojecting swaps out the buffers, so render threads have to get off them for that too
+	const bool reproject = r->state.weight_buf && !resize && !r->scene->samples_stale && cam_moved(&r->state.prev_cam, cam);
+	r->scene->samples_stale = false;
+	const bool was_paused = r->state.paused;
+	if (resize || retile || reproject) {
+		// Park render threads and wait for them to get off their tiles
+		r->state.paused = true;
+		r->state.restarting = true;
+		while (set->parked < local_threads) {
+			if (r->state.s != r_rendering) {
+				// Renderer stopped, bail out.
+				r->state.paused = was_paused;
+				r->state.restarting = false;
+				mutex_release(set->tile_mutex);
+				return;
 			}
+			thread_cond_wait(&set->thread_parked, set->tile_mutex);
+		}
+		// Okay, threads are now parked, swap the buffer
+		if (resize) {
+			cam_recompute_optics(cam);
+			logr(info, "Resizing result_buf (%zu,%zu) -> (%d,%d)\n", r->state.result_buf->width, r->state.result_buf->height, cam->width, cam->height);
+			tex_destroy(r->state.result_buf);
+			r->state.result_buf = tex_new(float_p, cam->width, cam->height, 4);
+			renderer_update_aov_buffers(r);
 		}
-		// Okay, threads are now paused, swap the buffer
-		tex_destroy(r->state.result_buf);
-		r->state.result_buf = tex_new(float_p, cam->width, cam->height, 4);
 
 		// And patch in a new set of tiles.
-		struct render_tile_arr new = tile_quantize(cam->width, cam->height, r->prefs.tileWidth, r->prefs.tileHeight, r->prefs.tileOrder);
-		mutex_lock(r->state.current_set->tile_mutex);
-		render_tile_arr_free(&r->state.current_set->tiles);
-		r->state.current_set->tiles = new;
-		r->state.current_set->finished = 0;
-		mutex_release(r->state.current_set->tile_mutex);
-
-		cr_renderer_toggle_pause((struct cr_renderer *)r);
+		if (resize || retile) tile_set_retile(set, tile_quantize(cam->width, cam->height, r->prefs.tileWidth, r->prefs.tileHeight, r->prefs.tileOrder));
 	}
-	// sus
 	r->state.finishedPasses = 1;
-	mutex_lock(r->state.current_set->tile_mutex);
-	tex_clear(r->state.result_buf);
-	r->state.current_set->finished = 0;
-	for (size_t i = 0; i < r->prefs.threads; ++i) {
-		// FIXME: Use array for workers
-		// FIXME: What about network renderers?
+	renderer_start_preview(r);
+	renderer_reset_accumulation(r, cam, reproject);
+	r->state.paused = was_paused;
+	r->state.restarting = false;
+	set->finished = 0;
+	for (size_t i = 0; i < r->state.workers.count; ++i) {
 		r->state.workers.items[i].totalSamples = 0;
 	}
 	update_toplevel_bvh(r->scene);
+	update_light_list(r->scene);
 	// Why are we waiting for bg_worker? update_toplevel_bvh() is synchronous.
 	thread_pool_wait(r->scene->bg_worker);
-	mutex_release(r->state.current_set->tile_mutex);
+	// Wake up threads that finished all passes and went idle
+	tile_set_wake(set);
+	mutex_release(set->tile_mutex);
 }
 
 struct cr_bitmap *cr_renderer_get_result(struct cr_renderer *ext) {
 	if (!ext) return NULL;
 	struct renderer *r = (struct renderer *)ext;
+	// Until the first denoise after a restart, denoised_buf still shows the old view
+	if (r->prefs.denoise && r->state.denoised_buf && r->state.denoised_valid) return (struct cr_bitmap *)r->state.denoised_buf;
 	return (struct cr_bitmap *)r->state.result_buf;
 }
 
+const char *cr_aov_name(enum cr_aov aov) {
+	switch (aov) {
+		case cr_aov_depth: return "depth";
+		case cr_aov_normal: return "normal";
+		case cr_aov_albedo: return "albedo";
+		case cr_aov_instance_id: return "instance_id";
+		case cr_aov_sample_count: return "sample_count";
+		case cr_aov_variance: return "variance";
+		case cr_aov_light_emitters: return "light_emitters";
+		case cr_aov_light_environment: return "light_environment";
+		case cr_aov_count: break;
+	}
+	return NULL;
+}
+
+struct cr_bitmap *cr_renderer_get_aov(struct cr_renderer *ext, enum cr_aov aov) {
+	if (!ext) return NULL;
+	struct renderer *r = (struct renderer *)ext;
+	if (aov >= cr_aov_count || !(r->prefs.aovs & (1 << aov))) return NULL;
+	return (struct cr_bitmap *)r->state.aovs[aov];
+}
+
 void cr_start_render_worker(int port, size_t thread_limit) {
 	worker_start(port, thread_limit);
 }
@@ -12,6 +12,7 @@
 #include <common/transforms.h>
 #include <common/vector.h>
 #include <renderer/samplers/vec.h>
+#include <string.h>
 
 void cam_recompute_optics(struct camera *cam) {
 	if (!cam) return;
@@ -51,6 +52,11 @@ void cam_update_pose(struct camera *cam, const struct euler_angles *orientation,
 	if (orientation || pos) recomputeComposite(cam);
 }
 
+bool cam_moved(const struct camera *a, const struct camera *b) {
+	if (a->FOV != b->FOV || a->focus_distance != b->focus_distance || a->fstops != b->fstops || a->aperture != b->aperture) return true;
+	return memcmp(&a->composite.A, &b->composite.A, sizeof(a->composite.A)) != 0;
+}
+
 static inline float sign(float v) {
 	return (v >= 0.0f) ? 1.0f : -1.0f;
 }
@@ -65,14 +71,20 @@ static inline float triangleDistribution(float v) {
 	return v;
 }
 
+// Camera space offsets between neighbouring pixels on the image plane
+static inline void pixel_axes(const struct camera *cam, struct vector *pix_x, struct vector *pix_y) {
+	*pix_x = vec_scale(cam->is_blender ? cam->right : vec_negate(cam->right), (cam->sensor_size.x / cam->width));
+	*pix_y = vec_scale(cam->up, (cam->sensor_size.y / cam->height));
+}
+
 struct lightRay cam_get_ray(const struct camera *cam, int x, int y, struct sampler *sampler) {
 	struct lightRay new_ray = { .type = rt_camera };
 	
 	const float jitter_x = triangleDistribution(sampler_dimension(sampler));
 	const float jitter_y = triangleDistribution(sampler_dimension(sampler));
 	
-	const struct vector pix_x = vec_scale(cam->is_blender ? cam->right : vec_negate(cam->right), (cam->sensor_size.x / cam->width));
-	const struct vector pix_y = vec_scale(cam->up, (cam->sensor_size.y / cam->height));
+	struct vector pix_x, pix_y;
+	pixel_axes(cam, &pix_x, &pix_y);
 	const struct vector pix_v = vec_add(
 							cam->forward,
 							vec_add(
@@ -81,6 +93,8 @@ struct lightRay cam_get_ray(const struct camera *cam, int x, int y, struct sampl
 							)
 						);
 	new_ray.direction = vec_normalize(pix_v);
+	// Roughly the angle one pixel covers, which is all texture filtering needs
+	new_ray.cone_spread = vec_length(pix_x) / vec_length(pix_v);
 	
 	// Unused if aperture == 0.0, but still computed to maintain the same
 	// prng sequence for both codepaths
@@ -97,3 +111,42 @@ struct lightRay cam_get_ray(const struct camera *cam, int x, int y, struct sampl
 	tform_ray(&new_ray, cam->composite.A);
 	return new_ray;
 }
+
+// These treat the camera as a pinhole, and ignore depth of field.
+
+struct vector cam_unproject(const struct camera *cam, float x, float y, float distance) {
+	struct vector pix_x, pix_y;
+	pixel_axes(cam, &pix_x, &pix_y);
+	const struct vector pix_v = vec_add(
+							cam->forward,
+							vec_add(
+								vec_scale(pix_x, x - cam->width  * 0.5f + 0.5f),
+								vec_scale(pix_y, y - cam->height * 0.5f + 0.5f)
+							)
+						);
+	if (distance <= 0.0f) {
+		struct vector dir = vec_normalize(pix_v);
+		tform_vector(&dir, cam->composite.A);
+		return dir;
+	}
+	struct vector point = vec_scale(vec_normalize(pix_v), distance);
+	tform_point(&point, cam->composite.A);
+	return point;
+}
+
+bool cam_project(const struct camera *cam, struct vector p, float distance, float *x, float *y, float *out_distance) {
+	if (distance <= 0.0f) {
+		tform_vector(&p, cam->composite.Ainv);
+	} else {
+		tform_point(&p, cam->composite.Ainv);
+	}
+	const float depth = vec_dot(p, cam->forward);
+	if (depth <= 0.0f) return false;
+	const struct vector on_plane = vec_scale(p, 1.0f / depth);
+	struct vector pix_x, pix_y;
+	pixel_axes(cam, &pix_x, &pix_y);
+	*x = vec_dot(on_plane, pix_x) / vec_dot(pix_x, pix_x) + cam->width  * 0.5f - 0.5f;
+	*y = vec_dot(on_plane, pix_y) / vec_dot(pix_y, pix_y) + cam->height * 0.5f - 0.5f;
+	if (out_distance) *out_distance = distance > 0.0f ? vec_length(p) : 0.0f;
+	return true;
+}
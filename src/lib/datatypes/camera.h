@@ -50,4 +50,15 @@ struct sampler;
 
 void cam_recompute_optics(struct camera *cam);
 void cam_update_pose(struct camera *cam, const struct euler_angles *orientation, const struct vector *pos);
+// Did the pose or the lens change between these two?
+bool cam_moved(const struct camera *a, const struct camera *b);
 struct lightRay cam_get_ray(const struct camera *cam, int x, int y, struct sampler *sampler);
+
+/// World space point at distance along the ray through the center of pixel (x, y).
+/// A distance of 0 stands for a point at infinity, and returns the ray direction instead.
+struct vector cam_unproject(const struct camera *cam, float x, float y, float distance);
+
+/// Pixel coordinates of a world space point, the inverse of cam_unproject().
+/// Pass distance 0 if p is a direction. out_distance receives the distance from this camera.
+/// Returns false if p is behind the camera.
+bool cam_project(const struct camera *cam, struct vector p, float distance, float *x, float *y, float *out_distance);
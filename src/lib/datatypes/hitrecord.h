@@ -11,6 +11,8 @@
 #include <common/vector.h>
 #include "lightray.h"
 
+struct node_memo;
+
 struct hitRecord {
 	struct lightRay *incident;		//Incident ray
 	struct vector hitPoint;			//Hit point vector in world space
@@ -20,4 +22,6 @@ struct hitRecord {
 	struct poly *polygon;			//ptr to polygon that was encountered
 	float distance;					//Distance to intersection point
 	int instIndex;					//Instance index, negative if no intersection
+	float uv_footprint;				//Width of the incident ray cone in texture space, 0 if unknown
+	struct node_memo *memo;			//Node results for this shading point, optional. See nodes/memo.h
 };
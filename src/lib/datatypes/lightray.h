@@ -26,6 +26,9 @@ struct lightRay {
 	struct vector start;
 	struct vector direction;
 	enum ray_type type : 8;
+	// Ray cone, a cheap stand-in for ray differentials. Used to pick texture MIP levels.
+	float cone_width; // At start, in world units
+	float cone_spread; // Added to the width per unit of distance travelled
 };
 
 static inline struct vector alongRay(const struct lightRay *ray, float t) {
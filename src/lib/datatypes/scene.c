@@ -10,11 +10,14 @@
 #include "scene.h"
 
 #include <accelerators/bvh.h>
+#include <renderer/guiding.h>
+#include <nodes/native.h>
 #include <common/hashtable.h>
 #include <common/textbuffer.h>
 #include <common/dyn_array.h>
 #include <common/node_parse.h>
 #include <common/texture.h>
+#include <common/texture_cache.h>
 #include "camera.h"
 #include "tile.h"
 #include "mesh.h"
@@ -29,16 +32,20 @@ void scene_destroy(struct world *scene) {
 	if (scene) {
 		scene->textures.elem_free = tex_asset_free;
 		texture_asset_arr_free(&scene->textures);
+		tex_cache_destroy(scene->tex_cache);
 		camera_arr_free(&scene->cameras);
 		scene->meshes.elem_free = mesh_free;
 		mesh_arr_free(&scene->meshes);
 
 		thread_rwlock_wrlock(&scene->bvh_lock);
 		destroy_bvh(scene->topLevel);
+		light_list_free(&scene->lights);
+		guide_destroy(scene->guide);
 		thread_rwlock_unlock(&scene->bvh_lock);
 
 		destroyHashtable(scene->storage.node_table);
 		destroyBlocks(scene->storage.node_pool);
+		native_cache_destroy(scene->storage.native);
 
 		// TODO: find out a nicer way to bind elem_free to the array init
 		scene->shader_buffers.elem_free = bsdf_buffer_free;
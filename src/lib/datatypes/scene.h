@@ -12,18 +12,24 @@
 #include <common/platform/thread.h>
 #include <common/texture.h>
 #include <renderer/instance.h>
+#include <renderer/lights.h>
 #include "camera.h"
 #include <nodes/bsdfnode.h>
 
 struct renderer;
 struct hashtable;
 struct file_cache;
+struct path_guide;
+struct native_cache;
+struct tex_cache;
 
 struct node_storage {
 	// Scene asset memory pool, currently used for nodes only.
 	struct block *node_pool;
 	// Used for hash consing. (preventing duplicate nodes)
 	struct hashtable *node_table;
+	// Optional, compiles node programs to native code. See nodes/native.h
+	struct native_cache *native;
 };
 
 struct world {
@@ -31,6 +37,8 @@ struct world {
 	const struct bsdfNode *background;
 	struct cr_shader_node *bg_desc;
 	struct texture_asset_arr textures;
+	// Optional, pages image textures in from disk as needed. See common/texture_cache.h
+	struct tex_cache *tex_cache;
 	struct bsdf_buffer_arr shader_buffers;
 	struct mesh_arr meshes;
 	struct instance_arr instances;
@@ -40,6 +48,12 @@ struct world {
 	struct cr_rwlock bvh_lock;
 	struct bvh *topLevel; // FIXME: Move to state?
 	bool top_level_dirty;
+	// Emissive primitives for next event estimation, also guarded by bvh_lock
+	struct light_list lights;
+	bool lights_dirty; // Emitters, materials or background changed, rebuild lights?
+	bool samples_stale; // Anything but the camera changed, so accumulated samples can't be reprojected
+	// Learned incident radiance for path guiding, optional. Also guarded by bvh_lock
+	struct path_guide *guide;
 	struct cr_thread_pool *bg_worker;
 
 	struct sphere_arr spheres;
@@ -11,10 +11,10 @@
 #include "tile.h"
 
 #include <common/logging.h>
-#include <common/timer.h>
 #include <common/platform/mutex.h>
 #include <vendored/pcg_basic.h>
 #include <string.h>
+#include <math.h>
 
 static void tiles_reorder(struct render_tile_arr *tiles, enum render_order tileOrder);
 
@@ -41,36 +41,77 @@ struct render_tile *tile_next(struct tile_set *set) {
 	return tile;
 }
 
+// Park the calling render thread until something changes.
+// Must be called with set->tile_mutex held.
+static void tile_set_park(struct tile_set *set) {
+	set->parked++;
+	thread_cond_signal(&set->thread_parked);
+	thread_cond_wait(&set->work_available, set->tile_mutex);
+	set->parked--;
+}
+
+void tile_set_wake(struct tile_set *set) {
+	thread_cond_broadcast(&set->work_available);
+	thread_cond_broadcast(&set->thread_parked);
+}
+
+void tile_wait_while_paused(struct renderer *r, struct tile_set *set) {
+	mutex_lock(set->tile_mutex);
+	while (r->state.paused && r->state.s == r_rendering)
+		tile_set_park(set);
+	mutex_release(set->tile_mutex);
+}
+
+static bool pass_finished(const struct tile_set *set) {
+	for (size_t t = 0; t < set->tiles.count; ++t) {
+		if (set->tiles.items[t].state != finished) return false;
+	}
+	return true;
+}
+
 struct render_tile *tile_next_interactive(struct renderer *r, struct tile_set *set) {
 	struct render_tile *tile = NULL;
 	mutex_lock(set->tile_mutex);
-	again:
-	if (r->state.finishedPasses < r->prefs.sampleCount + 1) {
+	while (!tile && r->state.s == r_rendering) {
+		if (r->state.paused || r->state.finishedPasses >= r->prefs.sampleCount + 1) {
+			// Sleep until resumed or restarted
+			tile_set_park(set);
+			continue;
+		}
 		if (set->finished < set->tiles.count) {
 			tile = &set->tiles.items[set->finished];
 			tile->state = rendering;
 			tile->index = set->finished++;
+			continue;
+		}
+		// Pass boundary. The running average depends on finishedPasses, so the
+		// last thread to finish a tile for this pass advances it, and the rest wait.
+		if (!pass_finished(set)) {
+			tile_set_park(set);
+			continue;
+		}
+		if (r->state.finishedPasses == 1 && r->state.preview_level) {
+			// Refine the first pass before starting to accumulate. The callback still
+			// fires, so viewports get to show the coarse levels right away.
+			r->state.preview_level--;
 		} else {
+			// The first pass is split up, and may have been restarted midway, so only time the rest
+			if (r->state.finishedPasses > 1) r->state.pass_us = timer_get_us(r->state.pass_timer);
 			r->state.finishedPasses++;
-			// FIXME: It's pretty confusing that we're firing this callback here instead of in the
-			// renderer main loop directly.
-			struct cr_renderer_cb_info cb_info = { 0 };
-			cb_info.finished_passes = r->state.finishedPasses - 1;
-			struct callback cb = r->state.callbacks[cr_cb_on_interactive_pass_finished];
-			if (cb.fn) cb.fn(&cb_info, cb.user_data);
-			set->finished = 0;
-			goto again;
-		}
-	}
-	if (!tile) {
-		// FIXME: shared state to indicate pause instead of accessing worker state
-		if (r->state.s != r_rendering || r->state.workers.items[0].paused) {
-			mutex_release(set->tile_mutex);
-			return NULL;
+			// Denoising every pass would eat into render time, so back off exponentially, and always do the last one
+			const size_t passes = r->state.finishedPasses - 1;
+			if (r->prefs.denoise && ((passes & (passes - 1)) == 0 || passes == r->prefs.sampleCount))
+				renderer_denoise(r);
 		}
-		// FIXME: Use an atomic conditional for this, instead of polling here
-		timer_sleep_ms(32);
-		goto again;
+		// FIXME: It's pretty confusing that we're firing this callback here instead of in the
+		// renderer main loop directly.
+		struct cr_renderer_cb_info cb_info = { 0 };
+		cb_info.finished_passes = r->state.finishedPasses - 1;
+		struct callback cb = r->state.callbacks[cr_cb_on_interactive_pass_finished];
+		if (cb.fn) cb.fn(&cb_info, cb.user_data);
+		set->finished = 0;
+		timer_start(&r->state.pass_timer);
+		tile_set_wake(set);
 	}
 	mutex_release(set->tile_mutex);
 	return tile;
@@ -124,10 +165,145 @@ struct render_tile_arr tile_quantize(unsigned width, unsigned height, unsigned t
 	return tiles;
 }
 
+#define AUTO_TILE_MIN 8
+#define AUTO_TILE_MAX 128
+// Enough tiles per thread that nobody starves at the tail end of a render
+#define AUTO_TILES_PER_THREAD 8
+// A single tile sample should take about this long, to amortize scheduling overhead
+#define AUTO_TILE_TARGET_US 10000.0
+
+void tile_auto_dims(unsigned width, unsigned height, size_t threads, double us_per_px_sample, unsigned *tile_w, unsigned *tile_h) {
+	if (!tile_w || !tile_h) return;
+	threads = max(threads, 1);
+	double area = ((double)width * (double)height) / (double)(threads * AUTO_TILES_PER_THREAD);
+	if (us_per_px_sample > 0.0) area = min(area, AUTO_TILE_TARGET_US / us_per_px_sample);
+	// Square tiles, rounded to a multiple of 8
+	unsigned side = (unsigned)(sqrt(area) / 8.0 + 0.5) * 8;
+	side = max(side, AUTO_TILE_MIN);
+	side = min(side, AUTO_TILE_MAX);
+	*tile_w = min(side, max(width, 1));
+	*tile_h = min(side, max(height, 1));
+}
+
+// Distance of (x, y) along a Hilbert curve filling an n*n grid, n being a power of two
+static uint32_t hilbert_index(uint32_t n, uint32_t x, uint32_t y) {
+	uint32_t d = 0;
+	for (uint32_t s = n / 2; s > 0; s /= 2) {
+		const uint32_t rx = (x & s) > 0;
+		const uint32_t ry = (y & s) > 0;
+		d += s * s * ((3 * rx) ^ ry);
+		// Rotate quadrant
+		if (ry == 0) {
+			if (rx == 1) {
+				x = n - 1 - x;
+				y = n - 1 - y;
+			}
+			const uint32_t t = x;
+			x = y;
+			y = t;
+		}
+	}
+	return d;
+}
+
+// Spread the low 16 bits of v out to even bit positions
+static uint32_t part_1_by_1(uint32_t v) {
+	v &= 0x0000ffff;
+	v = (v | (v << 8)) & 0x00ff00ff;
+	v = (v | (v << 4)) & 0x0f0f0f0f;
+	v = (v | (v << 2)) & 0x33333333;
+	v = (v | (v << 1)) & 0x55555555;
+	return v;
+}
+
+static uint32_t morton_index(uint32_t x, uint32_t y) {
+	return part_1_by_1(x) | (part_1_by_1(y) << 1);
+}
+
+static uint32_t next_pow2(uint32_t v) {
+	uint32_t n = 1;
+	while (n < v) n <<= 1;
+	return n;
+}
+
+struct curve_key {
+	uint32_t key;
+	size_t idx;
+};
+
+static int compare_curve_keys(const void *a, const void *b) {
+	const struct curve_key *A = a;
+	const struct curve_key *B = b;
+	return (A->key > B->key) - (A->key < B->key);
+}
+
+static uint32_t curve_index(bool hilbert, uint32_t n, uint32_t x, uint32_t y) {
+	return hilbert ? hilbert_index(n, x, y) : morton_index(x, y);
+}
+
+static void compute_pixel_order(struct tile_set *set) {
+	if (set->pixels) free(set->pixels);
+	set->pixels = NULL;
+	set->pixel_count = 0;
+	unsigned w = 0, h = 0;
+	for (size_t t = 0; t < set->tiles.count; ++t) {
+		w = max(w, set->tiles.items[t].width);
+		h = max(h, set->tiles.items[t].height);
+	}
+	if (!w || !h) return;
+	set->pixel_count = (size_t)w * h;
+	set->pixels = malloc(set->pixel_count * sizeof(*set->pixels));
+	if (set->pixel_order == po_scanline) {
+		// Top to bottom, like the renderer has always done
+		size_t i = 0;
+		for (int y = h - 1; y >= 0; --y) {
+			for (unsigned x = 0; x < w; ++x) {
+				set->pixels[i++] = (struct intCoord){ x, y };
+			}
+		}
+		return;
+	}
+	const bool hilbert = set->pixel_order == po_hilbert;
+	const uint32_t n = next_pow2(max(w, h));
+	struct curve_key *keys = malloc(set->pixel_count * sizeof(*keys));
+	for (unsigned y = 0; y < h; ++y) {
+		for (unsigned x = 0; x < w; ++x) {
+			keys[y * w + x] = (struct curve_key){ curve_index(hilbert, n, x, y), y * w + x };
+		}
+	}
+	qsort(keys, set->pixel_count, sizeof(*keys), compare_curve_keys);
+	for (size_t i = 0; i < set->pixel_count; ++i) {
+		set->pixels[i] = (struct intCoord){ keys[i].idx % w, keys[i].idx / w };
+	}
+	free(keys);
+}
+
+void tile_set_init(struct tile_set *set, struct render_tile_arr tiles, enum pixel_order order) {
+	*set = (struct tile_set){
+		.tiles = tiles,
+		.tile_mutex = mutex_create(),
+		.pixel_order = order,
+	};
+	thread_cond_init(&set->work_available);
+	thread_cond_init(&set->thread_parked);
+	compute_pixel_order(set);
+}
+
+void tile_set_retile(struct tile_set *set, struct render_tile_arr tiles) {
+	render_tile_arr_free(&set->tiles);
+	set->tiles = tiles;
+	set->finished = 0;
+	compute_pixel_order(set);
+}
+
 void tile_set_free(struct tile_set *set) {
 	render_tile_arr_free(&set->tiles);
+	if (set->pixels) free(set->pixels);
+	set->pixels = NULL;
 	mutex_destroy(set->tile_mutex);
 	set->tile_mutex = NULL;
+	thread_cond_destroy(&set->work_available);
+	thread_cond_destroy(&set->thread_parked);
 }
 
 static void reorder_top_to_bottom(struct render_tile_arr *tiles) {
@@ -216,6 +392,36 @@ static void reorder_to_middle(struct render_tile_arr *tiles) {
 	*tiles = temp;
 }
 
+// Sort tiles along a space-filling curve, so consecutive tiles are spatially coherent
+static void reorder_curve(struct render_tile_arr *tiles, bool hilbert) {
+	unsigned tile_w = 1, tile_h = 1;
+	for (size_t t = 0; t < tiles->count; ++t) {
+		tile_w = max(tile_w, tiles->items[t].width);
+		tile_h = max(tile_h, tiles->items[t].height);
+	}
+	uint32_t tiles_x = 0, tiles_y = 0;
+	for (size_t t = 0; t < tiles->count; ++t) {
+		tiles_x = max(tiles_x, tiles->items[t].begin.x / tile_w + 1);
+		tiles_y = max(tiles_y, tiles->items[t].begin.y / tile_h + 1);
+	}
+	const uint32_t n = next_pow2(max(tiles_x, tiles_y));
+	struct curve_key *keys = malloc(tiles->count * sizeof(*keys));
+	for (size_t t = 0; t < tiles->count; ++t) {
+		const uint32_t x = tiles->items[t].begin.x / tile_w;
+		const uint32_t y = tiles->items[t].begin.y / tile_h;
+		keys[t] = (struct curve_key){ curve_index(hilbert, n, x, y), t };
+	}
+	qsort(keys, tiles->count, sizeof(*keys), compare_curve_keys);
+
+	struct render_tile_arr temp = { 0 };
+	for (size_t t = 0; t < tiles->count; ++t) {
+		render_tile_arr_add(&temp, tiles->items[keys[t].idx]);
+	}
+	free(keys);
+	render_tile_arr_free(tiles);
+	*tiles = temp;
+}
+
 static void tiles_reorder(struct render_tile_arr *tiles, enum render_order tileOrder) {
 	switch (tileOrder) {
 		case ro_from_middle:
@@ -230,6 +436,12 @@ static void tiles_reorder(struct render_tile_arr *tiles, enum render_order tileO
 		case ro_random:
 			reorder_random(tiles);
 			break;
+		case ro_morton:
+			reorder_curve(tiles, false);
+			break;
+		case ro_hilbert:
+			reorder_curve(tiles, true);
+			break;
 		default:
 			break;
 	}
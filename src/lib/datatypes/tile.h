@@ -11,6 +11,7 @@
 #include "../../includes.h"
 #include <common/dyn_array.h>
 #include <common/platform/mutex.h>
+#include <common/platform/thread.h>
 
 #include <common/vector.h>
 
@@ -19,7 +20,16 @@ enum render_order {
 	ro_from_middle,
 	ro_to_middle,
 	ro_normal,
-	ro_random
+	ro_random,
+	ro_morton,
+	ro_hilbert,
+};
+
+// Order in which pixels are visited within a tile
+enum pixel_order {
+	po_scanline = 0,
+	po_morton,
+	po_hilbert,
 };
 
 struct renderer;
@@ -49,11 +59,40 @@ struct tile_set {
 	struct render_tile_arr tiles;
 	size_t finished;
 	struct cr_mutex *tile_mutex;
+	// Pixel offsets from tile begin, in the order render threads should visit
+	// them. Sized for the largest tile, so smaller edge tiles skip some.
+	enum pixel_order pixel_order;
+	struct intCoord *pixels;
+	size_t pixel_count;
+	// Render threads park on work_available when there is nothing to do
+	// (paused, waiting at a pass boundary or all passes done), and get woken
+	// up on pass boundaries, resume, restart and stop. thread_parked lets the
+	// API side wait for all threads to get off their tiles.
+	// These are all guarded by tile_mutex.
+	struct cr_cond work_available;
+	struct cr_cond thread_parked;
+	size_t parked;
 };
 
+// Pick tile dimensions for a width*height image rendered by threads workers.
+// us_per_px_sample is the measured cost of one pixel sample, or 0 if unknown.
+void tile_auto_dims(unsigned width, unsigned height, size_t threads, double us_per_px_sample, unsigned *tile_w, unsigned *tile_h);
+
 struct render_tile_arr tile_quantize(unsigned width, unsigned height, unsigned tile_w, unsigned tile_h, enum render_order order);
+void tile_set_init(struct tile_set *set, struct render_tile_arr tiles, enum pixel_order order);
 void tile_set_free(struct tile_set *set);
 
+/// Swap in a new set of tiles, e.g. after a resolution change
+/// @remarks Caller must hold set->tile_mutex, and no thread may be rendering a tile
+void tile_set_retile(struct tile_set *set, struct render_tile_arr tiles);
+
+/// Wake up all render threads parked on this set, so they can re-check renderer state.
+/// @remarks Caller must hold set->tile_mutex
+void tile_set_wake(struct tile_set *set);
+
+/// Block the calling render thread for as long as the renderer is paused.
+void tile_wait_while_paused(struct renderer *r, struct tile_set *set);
+
 struct render_tile *tile_next(struct tile_set *set);
 
 struct render_tile *tile_next_interactive(struct renderer *r, struct tile_set *set);
@@ -17,20 +17,44 @@
 #include "colornode.h"
 #include "../datatypes/hitrecord.h"
 #include "nodebase.h"
+#include "program.h"
 
 struct bsdfSample {
 	struct lightRay out;
-	float pdf;
+	float pdf; // Solid angle pdf of out, 0 if it came from a lobe eval() doesn't cover
 	struct color weight;
 	struct color emitted; // FIXME: Not really the right place for this
 };
 
-//TODO: Expand and refactor to match a standard bsdf signature with eval, sample and pdf
+// eval() and pdf() are optional, and only cover lobes that can be light sampled.
+// Singular and glossy lobes are left to sample(), and report a pdf of 0 there.
 struct bsdfNode {
 	struct nodeBase base;
 	struct bsdfSample (*sample)(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record);
+	// Returns bsdf * |cos| for light arriving from direction wi
+	struct color (*eval)(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi);
+	// Returns the solid angle pdf of sample() picking wi
+	float (*pdf)(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi);
+	// Optional, runs sample() for every lane of a batch of points that share this bsdf, see program.h
+	void (*sample_batch)(const struct bsdfNode *bsdf, const struct node_batch *batch, struct bsdfSample *out);
 };
 
+static inline struct color bsdf_eval(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi) {
+	return bsdf->eval ? bsdf->eval(bsdf, sampler, record, wi) : g_black_color;
+}
+
+static inline float bsdf_pdf(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi) {
+	return bsdf->pdf ? bsdf->pdf(bsdf, sampler, record, wi) : 0.0f;
+}
+
+static inline void bsdf_sample_batch(const struct bsdfNode *bsdf, const struct node_batch *batch, struct bsdfSample *out) {
+	if (bsdf->sample_batch) {
+		bsdf->sample_batch(bsdf, batch, out);
+		return;
+	}
+	for (size_t l = 0; l < batch->count; ++l) out[l] = bsdf->sample(bsdf, batch->samplers[l], batch->records[l]);
+}
+
 typedef const struct bsdfNode * bsdf_node_ptr;
 dyn_array_def(bsdf_node_ptr)
 
@@ -11,6 +11,7 @@
 #include <common/color.h>
 #include <common/vector.h>
 #include <common/loaders/textureloader.h>
+#include <common/texture_cache.h>
 #include <common/cr_string.h>
 #include <datatypes/poly.h>
 #include <datatypes/scene.h>
@@ -20,6 +21,7 @@
 #include "../../common/timer.h"
 
 #include "colornode.h"
+#include "memo.h"
 
 // const struct colorNode *unknownTextureNode(const struct node_storage *s) {
 // 	return newConstantTexture(s, g_black_color);
@@ -28,6 +30,7 @@
 struct decode_task_arg {
 	char *path;
 	struct texture *out;
+	struct tex_cache *cache; // Optional
 	uint8_t options;
 };
 
@@ -36,11 +39,20 @@ void tex_decode_task(void *arg) {
 	struct decode_task_arg *dt = (struct decode_task_arg *)arg;
 	struct timeval timer = { 0 };
 	timer_start(&timer);
-	file_data data = file_load(dt->path);
-	load_texture(dt->path, data, dt->out);
-	//Since the texture is probably srgb, transform it back to linear colorspace for rendering
-	if (dt->options & SRGB_TRANSFORM) tex_from_srgb(dt->out);
-	file_free(&data);
+	// Render threads may already be sampling dt->out, so it's built on the side and published once done
+	struct texture t = { .colorspace = linear, .precision = none };
+	// With a texture cache, pixels get paged in as they're needed instead
+	if (!tex_cache_load(dt->cache, dt->path, dt->options, &t)) {
+		file_data data = file_load(dt->path);
+		load_texture(dt->path, data, &t);
+		//Since the texture is probably srgb, transform it back to linear colorspace for rendering
+		if (dt->options & SRGB_TRANSFORM) tex_from_srgb(&t);
+		// Image textures are only ever sampled, so they can be tiled
+		tex_tile(&t);
+		tex_build_mips(&t);
+		file_free(&data);
+	}
+	tex_publish(dt->out, &t);
 	free(dt->path);
 	free(dt);
 	logr(debug, "Async decode task took %lums\n", timer_get_ms(timer));
@@ -84,11 +96,13 @@ const struct colorNode *build_color_node(struct cr_scene *s_ext, const struct cr
 				*arg = (struct decode_task_arg){
 					.path = stringCopy(path),
 					.out = tex,
+					.cache = scene->tex_cache,
 					.options = desc->arg.image.options
 				};
 				thread_pool_enqueue(scene->bg_worker, tex_decode_task, arg);
 			}
-			const struct colorNode *new = newImageTexture(&s, tex, desc->arg.image.options);
+			// Fetches are costly, and textures are often shared between inputs
+			const struct colorNode *new = memo_color_node(&s, newImageTexture(&s, tex, desc->arg.image.options));
 			if (full) free(full);
 			return new;
 		}
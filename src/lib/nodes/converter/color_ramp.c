@@ -7,13 +7,16 @@
 //
 
 #include <stdio.h>
+#include <string.h>
 #include <common/hashtable.h>
+#include <common/mempool.h>
 #include <common/vector.h>
 #include <datatypes/scene.h>
 #include <c-ray/node.h>
 #include "../colornode.h"
 
 #include "color_ramp.h"
+#include "../program.h"
 
 typedef struct ramp_element ramp_element;
 dyn_array_def(ramp_element)
@@ -71,10 +74,8 @@ static inline struct color convert(struct cr_color c) {
 }
 
 // TODO: This most certainly needs a bunch of tests to verify correctness
-static struct color eval(const struct colorNode *node, sampler *sampler, const struct hitRecord *record) {
+struct color color_ramp_apply(const struct colorNode *node, const float pos) {
 	const struct color_ramp_node *this = (const struct color_ramp_node *)node;
-	const float pos = this->input_value->eval(this->input_value, sampler, record);
-	
 	if (this->elements.count == 1)
 		return convert(this->elements.items[0].color);
 
@@ -109,6 +110,17 @@ static struct color eval(const struct colorNode *node, sampler *sampler, const s
 	return colorLerp(convert(left->color), convert(right->color), t);
 }
 
+static struct color eval(const struct colorNode *node, sampler *sampler, const struct hitRecord *record) {
+	const struct color_ramp_node *this = (const struct color_ramp_node *)node;
+	return color_ramp_apply(node, this->input_value->eval(this->input_value, sampler, record));
+}
+
+static unsigned compile(const void *node, struct node_compiler *c) {
+	const struct color_ramp_node *this = node;
+	const unsigned pos = node_compile(c, this->input_value, node_kind_value);
+	return node_compile_node_op(c, op_color_ramp, node, &pos, 1);
+}
+
 const struct colorNode *new_color_ramp(const struct node_storage *s,
                                        const struct valueNode *input_value,
                                        enum cr_color_mode color_mode,
@@ -119,10 +131,13 @@ const struct colorNode *new_color_ramp(const struct node_storage *s,
 		logr(warning, "color_ramp: No control points provided, bailing out\n");
 		return newConstantTexture(s, g_pink_color);
 	}
-	struct ramp_element_arr element_arr = { 0 };
-	for (int i = 0; i < element_count; ++i) {
-		ramp_element_arr_add(&element_arr, elements[i]);
-	}
+	// Kept in the node pool, so they're released along with the rest of the graph
+	struct ramp_element_arr element_arr = {
+		.items = allocBlock(s->node_table->pool, element_count * sizeof(*elements)),
+		.count = element_count,
+		.capacity = element_count,
+	};
+	memcpy(element_arr.items, elements, element_count * sizeof(*elements));
 	// Validate mode, interpolation and elements first
 	// Frankly, I don't even know what this mode does yet, need to look into that
 	// FIXME: Support HSV and HSL modes
@@ -153,7 +168,7 @@ const struct colorNode *new_color_ramp(const struct node_storage *s,
 		.elements = element_arr,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = NULL }
+			.base = { .compare = compare, .dump = NULL, .compile = compile }
 		}
 	});
 }
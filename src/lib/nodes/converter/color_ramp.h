@@ -19,3 +19,5 @@ const struct colorNode *new_color_ramp(const struct node_storage *s,
                                        struct ramp_element *elements,
                                        int element_count);
 
+/// Where pos falls on the ramp, for node programs
+struct color color_ramp_apply(const struct colorNode *node, const float pos);
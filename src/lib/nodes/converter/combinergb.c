@@ -15,6 +15,7 @@
 #include "../valuenode.h"
 
 #include "combinergb.h"
+#include "../program.h"
 
 struct combineRGB {
 	struct colorNode node;
@@ -60,14 +61,30 @@ static struct color eval(const struct colorNode *node, sampler *sampler, const s
 	};
 }
 
+static unsigned compile(const void *node, struct node_compiler *c) {
+	const struct combineRGB *this = node;
+	const unsigned args[] = {
+		node_compile(c, this->R, node_kind_value),
+		node_compile(c, this->G, node_kind_value),
+		node_compile(c, this->B, node_kind_value),
+	};
+	return node_compile_op(c, op_combine_rgb, 0, args, 3);
+}
+
 const struct colorNode *newCombineRGB(const struct node_storage *s, const struct valueNode *R, const struct valueNode *G, const struct valueNode *B) {
+	R = R ? R : newConstantValue(s, 0.0f);
+	G = G ? G : newConstantValue(s, 0.0f);
+	B = B ? B : newConstantValue(s, 0.0f);
+	if (R->constant && G->constant && B->constant) {
+		return newConstantTexture(s, (struct color){ R->eval(R, NULL, NULL), G->eval(G, NULL, NULL), B->eval(B, NULL, NULL), 1.0f });
+	}
 	HASH_CONS(s->node_table, hash, struct combineRGB, {
-		.R = R ? R : newConstantValue(s, 0.0f),
-		.G = G ? G : newConstantValue(s, 0.0f),
-		.B = B ? B : newConstantValue(s, 0.0f),
+		.R = R,
+		.G = G,
+		.B = B,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
@@ -17,6 +17,7 @@
 #include "../colornode.h"
 
 #include "grayscale.h"
+#include "../program.h"
 
 struct grayscale {
 	struct valueNode node;
@@ -41,6 +42,12 @@ static float eval(const struct valueNode *node, sampler *sampler, const struct h
 	return colorToGrayscale(this->input->eval(this->input, sampler, record)).red;
 }
 
+static unsigned compile(const void *node, struct node_compiler *c) {
+	const struct grayscale *this = node;
+	const unsigned input = node_compile(c, this->input, node_kind_color);
+	return node_compile_op(c, op_grayscale, 0, &input, 1);
+}
+
 static void dump(const void *node, char *dumpbuf, int len) {
 	struct grayscale *self = (struct grayscale *)node;
 	char color[DUMPBUF_SIZE / 2] = "";
@@ -49,11 +56,15 @@ static void dump(const void *node, char *dumpbuf, int len) {
 }
 
 const struct valueNode *newGrayscaleConverter(const struct node_storage *s, const struct colorNode *node) {
+	node = node ? node : newConstantTexture(s, g_black_color);
+	if (node->constant) {
+		return newConstantValue(s, colorToGrayscale(node->eval(node, NULL, NULL)).red);
+	}
 	HASH_CONS(s->node_table, hash, struct grayscale, {
-		.input = node ? node : newConstantTexture(s, g_black_color),
+		.input = node,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
@@ -14,6 +14,7 @@
 #include "../valuenode.h"
 
 #include "map_range.h"
+#include "../program.h"
 
 struct mapRangeNode {
 	struct valueNode node;
@@ -62,6 +63,12 @@ static void dump(const void *node, char *dumpbuf, int bufsize) {
 		input, from_min, from_max, to_min, to_max);
 }
 
+float map_range_apply(const float input_value, const float from_min, const float from_max, const float to_min, const float to_max) {
+	const float delta = from_max - from_min;
+	const float t = clamp(input_value / delta, 0.0f, 1.0f);
+	return lerp(to_min, to_max, t);
+}
+
 static float eval(const struct valueNode *node, sampler *sampler, const struct hitRecord *record) {
 	const struct mapRangeNode *this = (const struct mapRangeNode *)node;
 	const float input_value = this->input_value->eval(this->input_value, sampler, record);
@@ -69,13 +76,22 @@ static float eval(const struct valueNode *node, sampler *sampler, const struct h
 	const float from_min = this->from_min->eval(this->from_min, sampler, record);
 	const float from_max =  this->from_max->eval(this->from_max, sampler, record);
 	
-	const float delta = from_max - from_min;
-	const float t = clamp(input_value / delta, 0.0f, 1.0f);
-	
 	const float to_min = this->to_min->eval(this->to_min, sampler, record);
 	const float to_max = this->to_max->eval(this->to_max, sampler, record);
 	
-	return lerp(to_min, to_max, t);
+	return map_range_apply(input_value, from_min, from_max, to_min, to_max);
+}
+
+static unsigned compile(const void *node, struct node_compiler *c) {
+	const struct mapRangeNode *this = node;
+	const unsigned args[] = {
+		node_compile(c, this->input_value, node_kind_value),
+		node_compile(c, this->from_min, node_kind_value),
+		node_compile(c, this->from_max, node_kind_value),
+		node_compile(c, this->to_min, node_kind_value),
+		node_compile(c, this->to_max, node_kind_value),
+	};
+	return node_compile_op(c, op_map_range, 0, args, 5);
 }
 
 const struct valueNode *newMapRange(const struct node_storage *s,
@@ -84,15 +100,27 @@ const struct valueNode *newMapRange(const struct node_storage *s,
 									const struct valueNode *from_max,
 									const struct valueNode *to_min,
 									const struct valueNode *to_max) {
+	input_value = input_value ? input_value : newConstantValue(s, 1.0f);
+	from_min = from_min ? from_min : newConstantValue(s, 0.0f);
+	from_max = from_max ? from_max : newConstantValue(s, 1.0f);
+	to_min = to_min ? to_min : newConstantValue(s, 0.0f);
+	to_max = to_max ? to_max : newConstantValue(s, 1.0f);
+	if (input_value->constant && from_min->constant && from_max->constant && to_min->constant && to_max->constant) {
+		return newConstantValue(s, map_range_apply(input_value->eval(input_value, NULL, NULL),
+												   from_min->eval(from_min, NULL, NULL),
+												   from_max->eval(from_max, NULL, NULL),
+												   to_min->eval(to_min, NULL, NULL),
+												   to_max->eval(to_max, NULL, NULL)));
+	}
 	HASH_CONS(s->node_table, hash, struct mapRangeNode, {
-		.input_value = input_value ? input_value : newConstantValue(s, 1.0f),
-		.from_min = from_min ? from_min : newConstantValue(s, 0.0f),
-		.from_max = from_max ? from_max : newConstantValue(s, 1.0f),
-		.to_min = to_min ? to_min : newConstantValue(s, 0.0f),
-		.to_max = to_max ? to_max : newConstantValue(s, 1.0f),
+		.input_value = input_value,
+		.from_min = from_min,
+		.from_max = from_max,
+		.to_min = to_min,
+		.to_max = to_max,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
@@ -8,6 +8,8 @@
 
 #pragma once
 
+float map_range_apply(const float input_value, const float from_min, const float from_max, const float to_min, const float to_max);
+
 const struct valueNode *newMapRange(const struct node_storage *s,
 									const struct valueNode *input_value,
 									const struct valueNode *from_min,
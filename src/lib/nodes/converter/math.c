@@ -15,6 +15,7 @@
 #include <datatypes/hitrecord.h>
 
 #include "math.h"
+#include "../program.h"
 
 struct mathNode {
 	struct valueNode node;
@@ -138,11 +139,8 @@ float rough_compare(float a, float b) {
 	return true;
 }
 
-static float eval(const struct valueNode *node, sampler *sampler, const struct hitRecord *record) {
-	struct mathNode *this = (struct mathNode *)node;
-	const float a = this->A->eval(this->A, sampler, record);
-	const float b = this->B->eval(this->B, sampler, record);
-	switch (this->op) {
+float math_apply(const enum cr_math_op op, const float a, const float b) {
+	switch (op) {
 		case Add:
 			return a + b;
 		case Subtract:
@@ -203,14 +201,35 @@ static float eval(const struct valueNode *node, sampler *sampler, const struct h
 	return 0.0f;
 }
 
+static float eval(const struct valueNode *node, sampler *sampler, const struct hitRecord *record) {
+	struct mathNode *this = (struct mathNode *)node;
+	const float a = this->A->eval(this->A, sampler, record);
+	const float b = this->B->eval(this->B, sampler, record);
+	return math_apply(this->op, a, b);
+}
+
+static unsigned compile(const void *node, struct node_compiler *c) {
+	const struct mathNode *this = node;
+	const unsigned args[] = {
+		node_compile(c, this->A, node_kind_value),
+		node_compile(c, this->B, node_kind_value),
+	};
+	return node_compile_op(c, op_math, this->op, args, 2);
+}
+
 const struct valueNode *newMath(const struct node_storage *s, const struct valueNode *A, const struct valueNode *B, const enum cr_math_op op) {
+	A = A ? A : newConstantValue(s, 0.0f);
+	B = B ? B : newConstantValue(s, 0.0f);
+	if (A->constant && B->constant) {
+		return newConstantValue(s, math_apply(op, A->eval(A, NULL, NULL), B->eval(B, NULL, NULL)));
+	}
 	HASH_CONS(s->node_table, hash, struct mathNode, {
-		.A = A ? A : newConstantValue(s, 0.0f),
-		.B = B ? B : newConstantValue(s, 0.0f),
+		.A = A,
+		.B = B,
 		.op = op,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
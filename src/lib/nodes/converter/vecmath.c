@@ -17,6 +17,7 @@
 #include "../vectornode.h"
 
 #include "vecmath.h"
+#include "../program.h"
 
 struct vecMathNode {
 	struct vectorNode node;
@@ -135,15 +136,8 @@ static inline float wrap(float value, float max, float min) {
 	return (range != 0.0f) ? value - (range * floorf((value - min) / range)) : min;
 }
  
-static union vector_value eval(const struct vectorNode *node, sampler *sampler, const struct hitRecord *record) {
-	struct vecMathNode *this = (struct vecMathNode *)node;
-	
-	const struct vector a = this->A->eval(this->A, sampler, record).v;
-	const struct vector b = this->B->eval(this->B, sampler, record).v;
-	const struct vector c = this->C->eval(this->C, sampler, record).v;
-	const float f = this->f->eval(this->f, sampler, record);
-	
-	switch (this->op) {
+union vector_value vecmath_apply(const enum cr_vec_op op, const struct vector a, const struct vector b, const struct vector c, const float f) {
+	switch (op) {
 		case VecAdd:
 			return (union vector_value){ .v = vec_add(a, b) };
 		case VecSubtract:
@@ -197,16 +191,47 @@ static union vector_value eval(const struct vectorNode *node, sampler *sampler,
 	return (union vector_value){ 0 };
 }
 
+static union vector_value eval(const struct vectorNode *node, sampler *sampler, const struct hitRecord *record) {
+	struct vecMathNode *this = (struct vecMathNode *)node;
+	
+	const struct vector a = this->A->eval(this->A, sampler, record).v;
+	const struct vector b = this->B->eval(this->B, sampler, record).v;
+	const struct vector c = this->C->eval(this->C, sampler, record).v;
+	const float f = this->f->eval(this->f, sampler, record);
+	
+	return vecmath_apply(this->op, a, b, c, f);
+}
+
+static unsigned compile(const void *node, struct node_compiler *c) {
+	const struct vecMathNode *this = node;
+	const unsigned args[] = {
+		node_compile(c, this->A, node_kind_vector),
+		node_compile(c, this->B, node_kind_vector),
+		node_compile(c, this->C, node_kind_vector),
+		node_compile(c, this->f, node_kind_value),
+	};
+	return node_compile_op(c, op_vec_math, this->op, args, 4);
+}
+
 const struct vectorNode *newVecMath(const struct node_storage *s, const struct vectorNode *A, const struct vectorNode *B, const struct vectorNode *C, const struct valueNode *f, const enum cr_vec_op op) {
+	A = A ? A : newConstantVector(s, vec_zero());
+	B = B ? B : newConstantVector(s, vec_zero());
+	C = C ? C : newConstantVector(s, vec_zero());
+	f = f ? f : newConstantValue(s, 0.0f);
+	if (A->constant && B->constant && C->constant && f->constant) {
+		// The scalar & UV results alias the vector, so a constant vector holds any of them
+		const union vector_value result = vecmath_apply(op, A->eval(A, NULL, NULL).v, B->eval(B, NULL, NULL).v, C->eval(C, NULL, NULL).v, f->eval(f, NULL, NULL));
+		return newConstantVector(s, result.v);
+	}
 	HASH_CONS(s->node_table, hash, struct vecMathNode, {
-		.A = A ? A : newConstantVector(s, vec_zero()),
-		.B = B ? B : newConstantVector(s, vec_zero()),
-		.C = C ? C : newConstantVector(s, vec_zero()),
-		.f = f ? f : newConstantValue(s, 0.0f),
+		.A = A,
+		.B = B,
+		.C = C,
+		.f = f,
 		.op = op,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
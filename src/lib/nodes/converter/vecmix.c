@@ -14,6 +14,7 @@
 #include "../vectornode.h"
 
 #include "vecmix.h"
+#include "../program.h"
 
 struct vec_mix {
 	struct vectorNode node;
@@ -60,18 +61,32 @@ static union vector_value eval(const struct vectorNode *node, sampler *sampler,
 	}
 }
 
+static unsigned compile(const void *node, struct node_compiler *c) {
+	const struct vec_mix *this = node;
+	return node_compile_mix(c, this->A, this->B, this->f, node_kind_vector);
+}
+
 const struct vectorNode *new_vec_mix(const struct node_storage *s, const struct vectorNode *A, const struct vectorNode *B, const struct valueNode *f) {
+	A = A ? A : newConstantVector(s, vec_zero());
+	B = B ? B : newConstantVector(s, vec_zero());
+	f = f ? f : newConstantValue(s, 0.0f);
 	if (A == B) {
 		logr(debug, "A == B, pruning vec_mix node.\n");
 		return A;
 	}
+	// B gets picked with probability f, so a constant f outside (0, 1) always picks the same one
+	if (f->constant) {
+		const float lerp = f->eval(f, NULL, NULL);
+		if (lerp <= 0.0f) return A;
+		if (lerp >= 1.0f) return B;
+	}
 	HASH_CONS(s->node_table, hash, struct vec_mix, {
-		.A = A ? A : newConstantVector(s, vec_zero()),
-		.B = B ? B : newConstantVector(s, vec_zero()),
-		.f = f ? f : newConstantValue(s, 0.0f),
+		.A = A,
+		.B = B,
+		.f = f,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
@@ -15,6 +15,7 @@
 #include <datatypes/hitrecord.h>
 #include "../colornode.h"
 #include "../vectornode.h"
+#include "../program.h"
 
 #include "vectocolor.h"
 
@@ -51,12 +52,23 @@ static struct color eval(const struct colorNode *node, sampler *sampler, const s
 	return (struct color){ vec.x, vec.y, vec.z, 0.0f };
 }
 
+static unsigned compile(const void *node, struct node_compiler *c) {
+	const struct vecToColorNode *this = node;
+	const unsigned input = node_compile(c, this->vec, node_kind_vector);
+	return node_compile_op(c, op_vec_to_color, 0, &input, 1);
+}
+
 const struct colorNode *newVecToColor(const struct node_storage *s, const struct vectorNode *vec) {
+	vec = vec ? vec : newConstantVector(s, vec_zero());
+	if (vec->constant) {
+		const struct vector v = vec_max(vec->eval(vec, NULL, NULL).v, vec_zero());
+		return newConstantTexture(s, (struct color){ v.x, v.y, v.z, 0.0f });
+	}
 	HASH_CONS(s->node_table, hash, struct vecToColorNode, {
-		.vec = vec ? vec : newConstantVector(s, vec_zero()),
+		.vec = vec,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
@@ -15,6 +15,7 @@
 #include "../vectornode.h"
 
 #include "vectovalue.h"
+#include "../program.h"
 
 struct vecToValueNode {
 	struct valueNode node;
@@ -55,10 +56,8 @@ static void dump(const void *node, char *dumpbuf, int bufsize) {
 	snprintf(dumpbuf, bufsize, "vecToValueNode { vec: %s, component: %c }", vec, component_to_char(self->component_to_get));
 }
 
-static float eval(const struct valueNode *node, sampler *sampler, const struct hitRecord *record) {
-	struct vecToValueNode *this = (struct vecToValueNode *)node;
-	const union vector_value val = this->vec->eval(this->vec, sampler, record);
-	switch (this->component_to_get) {
+float vec_to_value_apply(const union vector_value val, const enum cr_vec_to_value_component component) {
+	switch (component) {
 		case X: return val.v.x;
 		case Y: return val.v.y;
 		case Z: return val.v.z;
@@ -70,13 +69,28 @@ static float eval(const struct valueNode *node, sampler *sampler, const struct h
 	return 0.0f;
 }
 
+static float eval(const struct valueNode *node, sampler *sampler, const struct hitRecord *record) {
+	struct vecToValueNode *this = (struct vecToValueNode *)node;
+	return vec_to_value_apply(this->vec->eval(this->vec, sampler, record), this->component_to_get);
+}
+
+static unsigned compile(const void *node, struct node_compiler *c) {
+	const struct vecToValueNode *this = node;
+	const unsigned vec = node_compile(c, this->vec, node_kind_vector);
+	return node_compile_op(c, op_vec_to_value, this->component_to_get, &vec, 1);
+}
+
 const struct valueNode *newVecToValue(const struct node_storage *s, const struct vectorNode *vec, enum cr_vec_to_value_component component) {
+	vec = vec ? vec : newConstantVector(s, vec_zero());
+	if (vec->constant) {
+		return newConstantValue(s, vec_to_value_apply(vec->eval(vec, NULL, NULL), component));
+	}
 	HASH_CONS(s->node_table, hash, struct vecToValueNode, {
-		.vec = vec ? vec : newConstantVector(s, vec_zero()),
+		.vec = vec,
 		.component_to_get = component,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
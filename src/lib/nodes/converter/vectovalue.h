@@ -9,5 +9,8 @@
 #pragma once
 
 #include <c-ray/c-ray.h>
+#include "../vectornode.h"
+
+float vec_to_value_apply(const union vector_value val, const enum cr_vec_to_value_component component);
 
 const struct valueNode *newVecToValue(const struct node_storage *s, const struct vectorNode *vec, enum cr_vec_to_value_component component);
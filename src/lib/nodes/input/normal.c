@@ -17,6 +17,7 @@
 #include "../bsdfnode.h"
 
 #include "normal.h"
+#include "../program.h"
 
 struct normalNode {
 	struct vectorNode node;
@@ -47,11 +48,16 @@ static union vector_value eval(const struct vectorNode *node, sampler *sampler,
 	return (union vector_value){ .v = record->surfaceNormal };
 }
 
+static unsigned compile(const void *node, struct node_compiler *c) {
+	(void)node;
+	return node_compile_op(c, op_normal, 0, NULL, 0);
+}
+
 const struct vectorNode *newNormal(const struct node_storage *s) {
 	HASH_CONS(s->node_table, hash, struct normalNode, {
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
@@ -17,6 +17,7 @@
 #include "../bsdfnode.h"
 
 #include "uv.h"
+#include "../program.h"
 
 struct uvNode {
 	struct vectorNode node;
@@ -47,11 +48,16 @@ static union vector_value eval(const struct vectorNode *node, sampler *sampler,
 	return (union vector_value){ .c = record->uv };
 }
 
+static unsigned compile(const void *node, struct node_compiler *c) {
+	(void)node;
+	return node_compile_op(c, op_uv, 0, NULL, 0);
+}
+
 const struct vectorNode *newUV(const struct node_storage *s) {
 	HASH_CONS(s->node_table, hash, struct uvNode, {
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
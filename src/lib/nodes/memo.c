@@ -0,0 +1,183 @@
+//
+//  memo.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include <stdio.h>
+#include <common/hashtable.h>
+#include <datatypes/scene.h>
+#include <datatypes/hitrecord.h>
+
+#include "colornode.h"
+#include "valuenode.h"
+#include "vectornode.h"
+#include "memo.h"
+
+struct memo_node {
+	union {
+		struct colorNode color;
+		struct valueNode value;
+		struct vectorNode vector;
+	} node;
+	const void *inner;
+};
+
+static bool compare(const void *A, const void *B) {
+	const struct memo_node *this = A;
+	const struct memo_node *other = B;
+	return this->inner == other->inner;
+}
+
+static uint32_t hash(const void *p) {
+	const struct memo_node *this = p;
+	uint32_t h = hashInit();
+	h = hashBytes(h, &this->inner, sizeof(this->inner));
+	return h;
+}
+
+static void dump(const void *node, char *dumpbuf, int bufsize) {
+	const struct memo_node *self = node;
+	const struct nodeBase *inner = self->inner;
+	char buf[DUMPBUF_SIZE / 2] = "";
+	if (inner->dump) inner->dump(inner, buf, sizeof(buf));
+	snprintf(dumpbuf, bufsize, "memo { %s }", buf);
+}
+
+static inline unsigned slot_for(const void *node) {
+	// Nodes are pool allocated a few dozen bytes apart, so mix the low bits in too
+	const uintptr_t p = (uintptr_t)node;
+	return (unsigned)(((p >> 4) ^ (p >> 10)) * 0x9e3779b1u) >> (32 - 6) & (NODE_MEMO_SLOTS - 1);
+}
+
+static inline union node_reg *lookup(struct node_memo *memo, const void *node) {
+	const unsigned slot = slot_for(node);
+	if ((memo->valid >> slot) & 1 && memo->slots[slot].node == node) return &memo->slots[slot].value;
+	return NULL;
+}
+
+static inline void store(struct node_memo *memo, const void *node, const union node_reg value) {
+	// Direct mapped, a collision just evicts the older result
+	const unsigned slot = slot_for(node);
+	memo->slots[slot].node = node;
+	memo->slots[slot].value = value;
+	memo->valid |= 1ull << slot;
+}
+
+static struct color eval_color(const struct colorNode *node, sampler *sampler, const struct hitRecord *record) {
+	const struct colorNode *inner = ((const struct memo_node *)node)->inner;
+	struct node_memo *memo = record ? record->memo : NULL;
+	if (!memo) return inner->eval(inner, sampler, record);
+	const union node_reg *cached = lookup(memo, node);
+	if (cached) return cached->c;
+	const struct color result = inner->eval(inner, sampler, record);
+	store(memo, node, (union node_reg){ .c = result });
+	return result;
+}
+
+static float eval_value(const struct valueNode *node, sampler *sampler, const struct hitRecord *record) {
+	const struct valueNode *inner = ((const struct memo_node *)node)->inner;
+	struct node_memo *memo = record ? record->memo : NULL;
+	if (!memo) return inner->eval(inner, sampler, record);
+	const union node_reg *cached = lookup(memo, node);
+	if (cached) return cached->f;
+	const float result = inner->eval(inner, sampler, record);
+	store(memo, node, (union node_reg){ .f = result });
+	return result;
+}
+
+static union vector_value eval_vector(const struct vectorNode *node, sampler *sampler, const struct hitRecord *record) {
+	const struct vectorNode *inner = ((const struct memo_node *)node)->inner;
+	struct node_memo *memo = record ? record->memo : NULL;
+	if (!memo) return inner->eval(inner, sampler, record);
+	const union node_reg *cached = lookup(memo, node);
+	if (cached) return cached->v;
+	const union vector_value result = inner->eval(inner, sampler, record);
+	store(memo, node, (union node_reg){ .v = result });
+	return result;
+}
+
+static void eval_batch(const void *node, enum node_kind kind, const struct node_batch *batch, union node_reg *out) {
+	const void *inner = ((const struct memo_node *)node)->inner;
+	// Lanes that have the result already sit this one out, the rest get a batch of their own
+	size_t lanes[NODE_BATCH_SIZE];
+	sampler *samplers[NODE_BATCH_SIZE];
+	const struct hitRecord *records[NODE_BATCH_SIZE];
+	size_t count = 0;
+	for (size_t l = 0; l < batch->count; ++l) {
+		struct node_memo *memo = batch->records[l] ? batch->records[l]->memo : NULL;
+		const union node_reg *cached = memo ? lookup(memo, node) : NULL;
+		if (cached) {
+			out[l] = *cached;
+			continue;
+		}
+		lanes[count] = l;
+		samplers[count] = batch->samplers[l];
+		records[count] = batch->records[l];
+		count++;
+	}
+	if (!count) return;
+	union node_reg results[NODE_BATCH_SIZE];
+	if (count == batch->count) {
+		node_eval_batch(inner, kind, batch, results);
+	} else {
+		struct node_batch misses;
+		node_batch_init(&misses, samplers, records, count);
+		node_eval_batch(inner, kind, &misses, results);
+	}
+	for (size_t i = 0; i < count; ++i) {
+		out[lanes[i]] = results[i];
+		if (records[i] && records[i]->memo) store(records[i]->memo, node, results[i]);
+	}
+}
+
+static void eval_color_batch(const void *node, const struct node_batch *batch, union node_reg *out) {
+	eval_batch(node, node_kind_color, batch, out);
+}
+
+static void eval_value_batch(const void *node, const struct node_batch *batch, union node_reg *out) {
+	eval_batch(node, node_kind_value, batch, out);
+}
+
+static void eval_vector_batch(const void *node, const struct node_batch *batch, union node_reg *out) {
+	eval_batch(node, node_kind_vector, batch, out);
+}
+
+static bool is_memo(const void *node) {
+	return ((const struct nodeBase *)node)->compare == compare;
+}
+
+const struct colorNode *memo_color_node(const struct node_storage *s, const struct colorNode *node) {
+	if (!node || node->constant || is_memo(node)) return node;
+	HASH_CONS(s->node_table, hash, struct memo_node, {
+		.inner = node,
+		.node.color = {
+			.eval = eval_color,
+			.base = { .compare = compare, .dump = dump, .eval_batch = eval_color_batch }
+		}
+	});
+}
+
+const struct valueNode *memo_value_node(const struct node_storage *s, const struct valueNode *node) {
+	if (!node || node->constant || is_memo(node)) return node;
+	HASH_CONS(s->node_table, hash, struct memo_node, {
+		.inner = node,
+		.node.value = {
+			.eval = eval_value,
+			.base = { .compare = compare, .dump = dump, .eval_batch = eval_value_batch }
+		}
+	});
+}
+
+const struct vectorNode *memo_vector_node(const struct node_storage *s, const struct vectorNode *node) {
+	if (!node || node->constant || is_memo(node)) return node;
+	HASH_CONS(s->node_table, hash, struct memo_node, {
+		.inner = node,
+		.node.vector = {
+			.eval = eval_vector,
+			.base = { .compare = compare, .dump = dump, .eval_batch = eval_vector_batch }
+		}
+	});
+}
@@ -0,0 +1,39 @@
+//
+//  memo.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include "program.h"
+
+// Node graphs are DAGs thanks to hash consing, and a bsdf evaluates its inputs again for
+// every sample(), eval() and pdf() call at the same shading point. Memo nodes remember
+// the result of the node they wrap for the rest of the shading point, in a small cache
+// that lives on the path tracer's stack and is reached through hitRecord.memo.
+// Records without a memo, like the ones BVH traversal hands to alpha tests, skip it.
+
+#define NODE_MEMO_SLOTS 64
+
+struct node_memo {
+	uint64_t valid; // Bit per slot, cleared for every shading point
+	struct {
+		const void *node;
+		union node_reg value;
+	} slots[NODE_MEMO_SLOTS];
+};
+
+static inline void node_memo_reset(struct node_memo *memo) {
+	memo->valid = 0;
+}
+
+struct node_storage;
+
+/// Returns a node that evaluates node at most once per shading point, or node itself if it's constant
+const struct colorNode *memo_color_node(const struct node_storage *s, const struct colorNode *node);
+const struct valueNode *memo_value_node(const struct node_storage *s, const struct valueNode *node);
+const struct vectorNode *memo_vector_node(const struct node_storage *s, const struct vectorNode *node);
@@ -0,0 +1,522 @@
+//
+//  native.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#if !defined(WINDOWS)
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+extern char **environ;
+#endif
+#include <common/dyn_array.h>
+#include <common/hashtable.h>
+#include <common/logging.h>
+#include <common/cr_string.h>
+#include <common/platform/dyn.h>
+#include <datatypes/scene.h>
+#include <datatypes/hitrecord.h>
+
+#include "colornode.h"
+#include "valuenode.h"
+#include "vectornode.h"
+#include "converter/math.h"
+#include "converter/vecmath.h"
+#include "native.h"
+
+// The generated code sees a register as 4 floats, which works because every member
+// of union node_reg starts at offset 0 and is made of floats.
+typedef char node_reg_is_4_floats[sizeof(union node_reg) == 4 * sizeof(float) ? 1 : -1];
+
+// Called from generated code for the instructions it doesn't translate
+struct native_host {
+	float (*dimension)(sampler *sampler);
+	void (*call)(const struct node_insn *insn, union node_reg *dst, sampler *sampler, const struct hitRecord *record);
+	float (*math)(int op, float a, float b);
+	void (*vec_math)(union node_reg *dst, int op, const union node_reg *a, const union node_reg *b, const union node_reg *c, float f);
+	void (*input)(int op, union node_reg *dst, const struct hitRecord *record);
+	void (*apply)(const struct node_insn *insn, union node_reg *dst, const union node_reg *a, const struct hitRecord *record);
+};
+
+static float host_dimension(sampler *sampler) {
+	return sampler_dimension(sampler);
+}
+
+static void host_call(const struct node_insn *insn, union node_reg *dst, sampler *sampler, const struct hitRecord *record) {
+	switch (insn->op) {
+		case op_call_color: {
+			const struct colorNode *node = insn->node;
+			dst->c = node->eval(node, sampler, record);
+			break;
+		}
+		case op_call_value: {
+			const struct valueNode *node = insn->node;
+			dst->f = node->eval(node, sampler, record);
+			break;
+		}
+		case op_call_vector: {
+			const struct vectorNode *node = insn->node;
+			dst->v = node->eval(node, sampler, record);
+			break;
+		}
+	}
+}
+
+static float host_math(int op, float a, float b) {
+	return math_apply(op, a, b);
+}
+
+static void host_vec_math(union node_reg *dst, int op, const union node_reg *a, const union node_reg *b, const union node_reg *c, float f) {
+	dst->v = vecmath_apply(op, a->v.v, b->v.v, c->v.v, f);
+}
+
+static void host_input(int op, union node_reg *dst, const struct hitRecord *record) {
+	if (op == op_uv) {
+		dst->v = (union vector_value){ .c = record->uv };
+	} else {
+		dst->v = (union vector_value){ .v = record->surfaceNormal };
+	}
+}
+
+static void host_apply(const struct node_insn *insn, union node_reg *dst, const union node_reg *a, const struct hitRecord *record) {
+	if (insn->op == op_checker) {
+		dst->f = checker_apply(record->uv, record->hitPoint, a->f);
+	} else {
+		dst->c = color_ramp_apply(insn->node, a->f);
+	}
+}
+
+static const struct native_host host = {
+	.dimension = host_dimension,
+	.call = host_call,
+	.math = host_math,
+	.vec_math = host_vec_math,
+	.input = host_input,
+	.apply = host_apply,
+};
+
+union node_reg native_run(node_native_fn fn, const struct node_program *p, sampler *sampler, const struct hitRecord *record) {
+	union node_reg out;
+	fn(&out, sampler, record, p->insns, &host);
+	return out;
+}
+
+typedef void * dyn_handle;
+dyn_array_def(dyn_handle)
+
+struct native_cache {
+	char *path;
+	struct dyn_handle_arr handles;
+	bool disabled; // Set when the compiler isn't there, so we only try once
+};
+
+#if !defined(WINDOWS)
+static bool exists(const char *path, bool directory) {
+	struct stat st;
+	if (stat(path, &st)) return false;
+	return directory ? S_ISDIR(st.st_mode) : S_ISREG(st.st_mode);
+}
+
+static bool write_file(const char *path, const char *buf, size_t len) {
+	FILE *f = fopen(path, "w");
+	if (!f) return false;
+	const bool ok = fwrite(buf, 1, len, f) == len;
+	return fclose(f) == 0 && ok;
+}
+
+static bool file_matches(const char *path, const char *buf, size_t len) {
+	FILE *f = fopen(path, "r");
+	if (!f) return false;
+	char chunk[4096];
+	size_t offset = 0, got;
+	bool same = true;
+	while (same && (got = fread(chunk, 1, sizeof(chunk), f))) {
+		same = offset + got <= len && !memcmp(chunk, buf + offset, got);
+		offset += got;
+	}
+	fclose(f);
+	return same && offset == len;
+}
+
+// Run directly with an argument list, not through a shell, so the paths are never interpreted
+static bool run_cc(const char *object, const char *source) {
+	// No contraction into FMAs, so results match the interpreter
+	char *const argv[] = { "cc", "-std=c99", "-O2", "-ffp-contract=off", "-fPIC", "-shared", "-w", "-o", (char *)object, (char *)source, "-lm", NULL };
+	posix_spawn_file_actions_t actions;
+	if (posix_spawn_file_actions_init(&actions)) return false;
+	posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+	posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+	pid_t pid;
+	const int err = posix_spawnp(&pid, argv[0], &actions, NULL, argv, environ);
+	posix_spawn_file_actions_destroy(&actions);
+	if (err) return false;
+	int status;
+	if (waitpid(pid, &status, 0) != pid) return false;
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+#endif
+
+struct native_cache *native_cache_new(const char *path) {
+#if defined(WINDOWS)
+	(void)path;
+	logr(warning, "Native shader compilation isn't supported on this platform, interpreting shaders\n");
+	return NULL;
+#else
+	if (!path) return NULL;
+	if (mkdir(path, 0755) && !exists(path, true)) {
+		logr(warning, "Couldn't create shader cache directory %s, interpreting shaders\n", path);
+		return NULL;
+	}
+	// Objects in here get loaded into the renderer, so nobody else may be able to put them there
+	struct stat st;
+	if (stat(path, &st) || st.st_uid != getuid() || (st.st_mode & (S_IWGRP | S_IWOTH))) {
+		logr(warning, "Shader cache directory %s has to be owned by you and not writable by others, interpreting shaders\n", path);
+		return NULL;
+	}
+	struct native_cache *cache = calloc(1, sizeof(*cache));
+	cache->path = stringCopy(path);
+	return cache;
+#endif
+}
+
+void native_cache_disable(struct native_cache *cache) {
+	if (cache) cache->disabled = true;
+}
+
+const char *native_cache_path(const struct native_cache *cache) {
+	return cache && !cache->disabled ? cache->path : NULL;
+}
+
+void native_cache_destroy(struct native_cache *cache) {
+	if (!cache) return;
+	for (size_t i = 0; i < cache->handles.count; ++i) {
+		dyn_close(cache->handles.items[i]);
+	}
+	dyn_handle_arr_free(&cache->handles);
+	free(cache->path);
+	free(cache);
+}
+
+struct source {
+	char *buf;
+	size_t len;
+	size_t cap;
+};
+
+static void emitf(struct source *s, const char *fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	int needed = vsnprintf(NULL, 0, fmt, args);
+	va_end(args);
+	if (s->len + needed + 1 > s->cap) {
+		s->cap = (s->len + needed + 1) * 2;
+		s->buf = realloc(s->buf, s->cap);
+	}
+	va_start(args, fmt);
+	vsnprintf(s->buf + s->len, needed + 1, fmt, args);
+	va_end(args);
+	s->len += needed;
+}
+
+// Exact, and valid C for the values %a doesn't print as a literal
+static void emit_float(struct source *s, float f) {
+	if (isnan(f)) {
+		emitf(s, "(0.0f / 0.0f)");
+	} else if (isinf(f)) {
+		emitf(s, f > 0.0f ? "(1.0f / 0.0f)" : "(-1.0f / 0.0f)");
+	} else {
+		emitf(s, "%af", (double)f);
+	}
+}
+
+// Scalar reads of constants become literals, so the C compiler can fold them
+static void emit_scalar(struct source *s, const struct node_program *p, unsigned reg, unsigned component) {
+	if (reg < p->constant_count) {
+		emit_float(s, ((const float *)&p->constants[reg])[component]);
+	} else {
+		emitf(s, "r%u.q[%u]", reg, component);
+	}
+}
+
+// Mirrors math_apply(), for the operations that are plain C
+static bool emit_math(struct source *s, const struct node_program *p, const struct node_insn *in) {
+	static const char *infix[] = {
+		[Add] = "+", [Subtract] = "-", [Multiply] = "*", [Divide] = "/",
+	};
+	static const char *unary[] = {
+		[Log] = "log10f", [SquareRoot] = "sqrtf", [Absolute] = "fabsf", [Round] = "roundf",
+		[Floor] = "floorf", [Ceil] = "ceilf", [Truncate] = "truncf", [Sine] = "sinf",
+		[Cosine] = "cosf", [Tangent] = "tanf",
+	};
+	static const char *binary[] = {
+		[Power] = "powf", [Modulo] = "fmodf",
+	};
+	const unsigned op = in->sub;
+	emitf(s, "\tr%u.q[0] = ", in->dst);
+	if (op < sizeof(infix) / sizeof(*infix) && infix[op]) {
+		emit_scalar(s, p, in->arg[0], 0);
+		emitf(s, " %s ", infix[op]);
+		emit_scalar(s, p, in->arg[1], 0);
+	} else if (op < sizeof(unary) / sizeof(*unary) && unary[op]) {
+		emitf(s, "%s(", unary[op]);
+		emit_scalar(s, p, in->arg[0], 0);
+		emitf(s, ")");
+	} else if (op < sizeof(binary) / sizeof(*binary) && binary[op]) {
+		emitf(s, "%s(", binary[op]);
+		emit_scalar(s, p, in->arg[0], 0);
+		emitf(s, ", ");
+		emit_scalar(s, p, in->arg[1], 0);
+		emitf(s, ")");
+	} else if (op == Min || op == Max || op == LessThan || op == GreaterThan) {
+		const char *cmp = op == Min || op == LessThan ? "<" : ">";
+		emitf(s, "(");
+		emit_scalar(s, p, in->arg[0], 0);
+		emitf(s, " %s ", cmp);
+		emit_scalar(s, p, in->arg[1], 0);
+		if (op == LessThan || op == GreaterThan) {
+			emitf(s, ") ? 1.0f : 0.0f");
+		} else {
+			emitf(s, ") ? ");
+			emit_scalar(s, p, in->arg[0], 0);
+			emitf(s, " : ");
+			emit_scalar(s, p, in->arg[1], 0);
+		}
+	} else if (op == Fraction) {
+		emit_scalar(s, p, in->arg[0], 0);
+		emitf(s, " - (int)");
+		emit_scalar(s, p, in->arg[0], 0);
+	} else {
+		return false;
+	}
+	emitf(s, ";\n");
+	return true;
+}
+
+static void emit_insn(struct source *s, const struct node_program *p, size_t i) {
+	const struct node_insn *in = &p->insns[i];
+	const uint16_t *a = in->arg;
+	switch (in->op) {
+		case op_call_color:
+		case op_call_value:
+		case op_call_vector:
+			emitf(s, "\th->call(&insns[%zu], &r%u, sampler, record);\n", i, in->dst);
+			break;
+		case op_move:
+			if (a[0] < p->constant_count) {
+				emitf(s, "\tr%u = k%u;\n", in->dst, a[0]);
+			} else {
+				emitf(s, "\tr%u = r%u;\n", in->dst, a[0]);
+			}
+			break;
+		case op_jump:
+			emitf(s, "\tgoto L%u;\n", a[0]);
+			break;
+		case op_mix:
+			emitf(s, "\tif (!(h->dimension(sampler) > ");
+			emit_scalar(s, p, a[0], 0);
+			emitf(s, ")) goto L%u;\n", a[1]);
+			break;
+		case op_select:
+			emitf(s, "\tif (");
+			emit_scalar(s, p, a[0], 0);
+			emitf(s, " == 0.0f) goto L%u;\n", a[1]);
+			break;
+		case op_math:
+			if (emit_math(s, p, in)) break;
+			emitf(s, "\tr%u.q[0] = h->math(%u, ", in->dst, in->sub);
+			emit_scalar(s, p, a[0], 0);
+			emitf(s, ", ");
+			emit_scalar(s, p, a[1], 0);
+			emitf(s, ");\n");
+			break;
+		case op_map_range:
+			// Mirrors map_range_apply()
+			emitf(s, "\t{\n\t\tfloat t = ");
+			emit_scalar(s, p, a[0], 0);
+			emitf(s, " / (");
+			emit_scalar(s, p, a[2], 0);
+			emitf(s, " - ");
+			emit_scalar(s, p, a[1], 0);
+			emitf(s, ");\n\t\tt = t > 0.0f ? t : 0.0f;\n\t\tt = t < 1.0f ? t : 1.0f;\n");
+			emitf(s, "\t\tr%u.q[0] = ((1.0f - t) * ", in->dst);
+			emit_scalar(s, p, a[3], 0);
+			emitf(s, ") + (t * ");
+			emit_scalar(s, p, a[4], 0);
+			emitf(s, ");\n\t}\n");
+			break;
+		case op_grayscale:
+			// Mirrors colorToGrayscale()
+			emitf(s, "\tr%u.q[0] = sqrtf(0.299f * powf(", in->dst);
+			emit_scalar(s, p, a[0], 0);
+			emitf(s, ", 2) + 0.587f * powf(");
+			emit_scalar(s, p, a[0], 1);
+			emitf(s, ", 2) + 0.114f * powf(");
+			emit_scalar(s, p, a[0], 2);
+			emitf(s, ", 2));\n");
+			break;
+		case op_combine_rgb:
+			for (unsigned c = 0; c < 3; ++c) {
+				emitf(s, "\tr%u.q[%u] = ", in->dst, c);
+				emit_scalar(s, p, a[c], 0);
+				emitf(s, ";\n");
+			}
+			emitf(s, "\tr%u.q[3] = 1.0f;\n", in->dst);
+			break;
+		case op_vec_math:
+			emitf(s, "\th->vec_math(&r%u, %u, ", in->dst, in->sub);
+			for (unsigned v = 0; v < 3; ++v) {
+				emitf(s, a[v] < p->constant_count ? "&k%u, " : "&r%u, ", a[v]);
+			}
+			emit_scalar(s, p, a[3], 0);
+			emitf(s, ");\n");
+			break;
+		case op_vec_to_value: {
+			// Mirrors vec_to_value_apply(), U & V alias X & Y
+			static const unsigned components[] = { [X] = 0, [Y] = 1, [Z] = 2, [U] = 0, [V] = 1, [F] = 0 };
+			emitf(s, "\tr%u.q[0] = ", in->dst);
+			emit_scalar(s, p, a[0], components[in->sub]);
+			emitf(s, ";\n");
+			break;
+		}
+		case op_vec_to_color:
+			// Mirrors vec_max() against zero
+			for (unsigned c = 0; c < 3; ++c) {
+				emitf(s, "\tr%u.q[%u] = (", in->dst, c);
+				emit_scalar(s, p, a[0], c);
+				emitf(s, " > 0.0f) ? ");
+				emit_scalar(s, p, a[0], c);
+				emitf(s, " : 0.0f;\n");
+			}
+			emitf(s, "\tr%u.q[3] = 0.0f;\n", in->dst);
+			break;
+		case op_uv:
+		case op_normal:
+			emitf(s, "\th->input(%u, &r%u, record);\n", in->op, in->dst);
+			break;
+		case op_checker:
+		case op_color_ramp:
+			emitf(s, "\th->apply(&insns[%zu], &r%u, &%c%u, record);\n", i, in->dst, a[0] < p->constant_count ? 'k' : 'r', a[0]);
+			break;
+	}
+}
+
+static void emit_program(struct source *s, const struct node_program *p) {
+	emitf(s, "#include <math.h>\n\n");
+	emitf(s, "typedef struct { float q[4]; } reg;\n");
+	emitf(s, "struct host {\n"
+			 "\tfloat (*dimension)(void *);\n"
+			 "\tvoid (*call)(const void *, reg *, void *, const void *);\n"
+			 "\tfloat (*math)(int, float, float);\n"
+			 "\tvoid (*vec_math)(reg *, int, const reg *, const reg *, const reg *, float);\n"
+			 "\tvoid (*input)(int, reg *, const void *);\n"
+			 "\tvoid (*apply)(const void *, reg *, const reg *, const void *);\n"
+			 "};\n\n");
+	emitf(s, "void node_program(reg *out, void *sampler, const void *record, const char *insns_, const struct host *h) {\n");
+	emitf(s, "\tconst char (*insns)[%zu] = (const char (*)[%zu])insns_;\n", sizeof(struct node_insn), sizeof(struct node_insn));
+	for (size_t k = 0; k < p->constant_count; ++k) {
+		const float *f = (const float *)&p->constants[k];
+		emitf(s, "\tconst reg k%zu = {{ ", k);
+		for (unsigned c = 0; c < 4; ++c) {
+			emit_float(s, f[c]);
+			emitf(s, c < 3 ? ", " : " }};\n");
+		}
+	}
+	for (size_t r = p->constant_count; r < p->register_count; ++r) {
+		emitf(s, "\treg r%zu;\n", r);
+	}
+	// Only the instructions jumped to need a label
+	bool *target = calloc(p->insn_count + 1, sizeof(*target));
+	for (size_t i = 0; i < p->insn_count; ++i) {
+		if (p->insns[i].op == op_jump) target[p->insns[i].arg[0]] = true;
+		if (p->insns[i].op == op_mix || p->insns[i].op == op_select) target[p->insns[i].arg[1]] = true;
+	}
+	for (size_t i = 0; i < p->insn_count; ++i) {
+		if (target[i]) emitf(s, "L%zu:\n", i);
+		emit_insn(s, p, i);
+	}
+	if (target[p->insn_count]) emitf(s, "L%zu:\n", p->insn_count);
+	free(target);
+	if (p->result < p->constant_count) {
+		emitf(s, "\t*out = k%u;\n}\n", p->result);
+	} else {
+		emitf(s, "\t*out = r%u;\n}\n", p->result);
+	}
+}
+
+node_native_fn native_compile(struct native_cache *cache, const struct node_program *p) {
+#if defined(WINDOWS)
+	(void)cache; (void)p;
+	return NULL;
+#else
+	if (!cache || cache->disabled) return NULL;
+	struct source src = { 0 };
+	emit_program(&src, p);
+	// Named by content, so identical programs share an object, also across runs. The name is
+	// only a hash, so the source is kept next to the object and compared before it's used.
+	uint32_t h = hashBytes(hashInit(), src.buf, src.len);
+	char object[1024], source[1024], tmp_source[1024], tmp_object[1024];
+	snprintf(object, sizeof(object), "%s/nodes_%08x_%zx.so", cache->path, h, src.len);
+	snprintf(source, sizeof(source), "%s/nodes_%08x_%zx.c", cache->path, h, src.len);
+	snprintf(tmp_source, sizeof(tmp_source), "%s/nodes_%08x.%ld.c", cache->path, h, (long)getpid());
+	snprintf(tmp_object, sizeof(tmp_object), "%s/nodes_%08x.%ld.so", cache->path, h, (long)getpid());
+
+	// A different program with the same name is compiled and loaded privately
+	bool shared = true;
+	if (!exists(object, false) || !file_matches(source, src.buf, src.len)) {
+		shared = !exists(source, false);
+		if (!write_file(tmp_source, src.buf, src.len)) {
+			logr(warning, "Couldn't write to shader cache %s, interpreting shaders\n", cache->path);
+			cache->disabled = true;
+			remove(tmp_source);
+			free(src.buf);
+			return NULL;
+		}
+		if (!run_cc(tmp_object, tmp_source)) {
+			logr(warning, "Couldn't compile shaders with cc, interpreting them instead\n");
+			cache->disabled = true;
+			remove(tmp_source);
+			remove(tmp_object);
+			free(src.buf);
+			return NULL;
+		}
+		// Renames are atomic, so concurrent renders sharing the cache never load a partial object.
+		// The object goes in first, so a source is never paired with an object built from another one.
+		if (shared && !rename(tmp_object, object)) {
+			if (rename(tmp_source, source)) remove(tmp_source);
+		} else {
+			shared = false;
+		}
+	}
+	free(src.buf);
+
+	void *handle = dyn_load(shared ? object : tmp_object);
+	if (!shared) {
+		// Still mapped after it's gone
+		remove(tmp_source);
+		remove(tmp_object);
+	}
+	if (!handle) {
+		logr(debug, "Couldn't load %s: %s\n", shared ? object : tmp_object, dyn_error());
+		return NULL;
+	}
+	// Through a union, ISO C has no cast from object to function pointers
+	union { void *sym; node_native_fn fn; } entry = { .sym = dyn_sym(handle, "node_program") };
+	node_native_fn fn = entry.fn;
+	if (!fn) {
+		dyn_close(handle);
+		return NULL;
+	}
+	dyn_handle_arr_add(&cache->handles, handle);
+	return fn;
+#endif
+}
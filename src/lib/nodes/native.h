@@ -0,0 +1,35 @@
+//
+//  native.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include "program.h"
+
+// Optional second stage for node programs: each program is emitted as C source with the
+// constants baked in, built into a shared object with the system C compiler, and loaded
+// with dyn_load(). Objects are named by a hash of their source, so they're reused across
+// runs. Instructions without a direct C translation call back into c-ray, so the result
+// matches the interpreter. Without a working compiler, programs stay interpreted.
+
+struct native_host;
+
+typedef void (*node_native_fn)(union node_reg *out, sampler *sampler, const struct hitRecord *record, const struct node_insn *insns, const struct native_host *host);
+
+struct native_cache;
+
+/// Cache compiled objects in the directory at path, which is created if needed
+struct native_cache *native_cache_new(const char *path);
+/// Stop compiling new programs. Ones already loaded stay valid until native_cache_destroy()
+void native_cache_disable(struct native_cache *cache);
+void native_cache_destroy(struct native_cache *cache);
+const char *native_cache_path(const struct native_cache *cache);
+
+/// Returns NULL if the program couldn't be compiled, evaluate it with node_program_run() then
+node_native_fn native_compile(struct native_cache *cache, const struct node_program *p);
+
+union node_reg native_run(node_native_fn fn, const struct node_program *p, sampler *sampler, const struct hitRecord *record);
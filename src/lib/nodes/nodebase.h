@@ -16,11 +16,18 @@
 // Magic for comparing two nodes
 
 struct node_storage;
+struct node_compiler;
+struct node_batch;
+union node_reg;
 
 // TODO: node_base
 struct nodeBase {
 	bool (*compare)(const void *, const void *);
 	void (*dump)(const void *, char *, int);
+	// Optional, emits instructions into a node program, see program.h
+	unsigned (*compile)(const void *, struct node_compiler *);
+	// Optional, evaluates every lane of a batch in one go, see program.h
+	void (*eval_batch)(const void *, const struct node_batch *, union node_reg *);
 };
 
 bool compareNodes(const void *A, const void *B);
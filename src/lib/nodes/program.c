@@ -0,0 +1,627 @@
+//
+//  program.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <common/hashtable.h>
+#include <common/mempool.h>
+#include <common/vector.h>
+#include <datatypes/scene.h>
+#include <datatypes/hitrecord.h>
+
+#include "colornode.h"
+#include "valuenode.h"
+#include "vectornode.h"
+#include "program.h"
+#include "native.h"
+
+struct node_compiler {
+	struct node_insn insns[NODE_PROGRAM_MAX_INSNS];
+	size_t insn_count;
+	union node_reg constants[NODE_PROGRAM_MAX_REGISTERS];
+	size_t constant_count;
+	// Constants and temporaries are numbered separately while compiling, and temporaries
+	// are moved after the constants at the end. TEMP_BIT marks the temporaries until then.
+	size_t temp_count;
+	bool failed;
+};
+
+#define TEMP_BIT 0x8000
+
+static unsigned new_temp(struct node_compiler *c) {
+	if (c->constant_count + c->temp_count >= NODE_PROGRAM_MAX_REGISTERS) {
+		c->failed = true;
+		return 0;
+	}
+	return TEMP_BIT | (unsigned)c->temp_count++;
+}
+
+static size_t emit(struct node_compiler *c, struct node_insn insn) {
+	if (c->insn_count >= NODE_PROGRAM_MAX_INSNS) {
+		c->failed = true;
+		return 0;
+	}
+	c->insns[c->insn_count] = insn;
+	return c->insn_count++;
+}
+
+static unsigned compile_constant(struct node_compiler *c, const union node_reg value) {
+	for (size_t i = 0; i < c->constant_count; ++i) {
+		if (!memcmp(&c->constants[i], &value, sizeof(value))) return (unsigned)i;
+	}
+	if (c->constant_count + c->temp_count >= NODE_PROGRAM_MAX_REGISTERS) {
+		c->failed = true;
+		return 0;
+	}
+	c->constants[c->constant_count] = value;
+	return (unsigned)c->constant_count++;
+}
+
+// Unused bytes are zeroed, so constants can be deduplicated with memcmp()
+
+unsigned node_compile_color_constant(struct node_compiler *c, const struct color value) {
+	union node_reg r = { 0 };
+	r.c = value;
+	return compile_constant(c, r);
+}
+
+unsigned node_compile_value_constant(struct node_compiler *c, float value) {
+	union node_reg r = { 0 };
+	r.f = value;
+	return compile_constant(c, r);
+}
+
+unsigned node_compile_vector_constant(struct node_compiler *c, const union vector_value value) {
+	union node_reg r = { 0 };
+	r.v = value;
+	return compile_constant(c, r);
+}
+
+unsigned node_compile_op(struct node_compiler *c, enum node_opcode op, uint8_t sub, const unsigned *args, size_t arg_count) {
+	struct node_insn insn = { .op = op, .sub = sub, .dst = new_temp(c) };
+	for (size_t i = 0; i < arg_count; ++i) insn.arg[i] = args[i];
+	emit(c, insn);
+	return insn.dst;
+}
+
+unsigned node_compile_node_op(struct node_compiler *c, enum node_opcode op, const void *node, const unsigned *args, size_t arg_count) {
+	struct node_insn insn = { .op = op, .dst = new_temp(c), .node = node };
+	for (size_t i = 0; i < arg_count; ++i) insn.arg[i] = args[i];
+	emit(c, insn);
+	return insn.dst;
+}
+
+unsigned node_compile(struct node_compiler *c, const void *node, enum node_kind kind) {
+	if (c->failed) return 0;
+	const struct nodeBase *base = node;
+	if (base->compile) return base->compile(node, c);
+	static const enum node_opcode calls[] = {
+		[node_kind_color] = op_call_color,
+		[node_kind_value] = op_call_value,
+		[node_kind_vector] = op_call_vector,
+	};
+	struct node_insn insn = { .op = calls[kind], .dst = new_temp(c), .node = node };
+	emit(c, insn);
+	return insn.dst;
+}
+
+// Both branches end up in the same register. A jumps over B, so the jump right before
+// B's first instruction always marks where A ends, which the batch runner relies on.
+static unsigned compile_branch(struct node_compiler *c, enum node_opcode op, unsigned cond, const void *A, const void *B, enum node_kind kind) {
+	const unsigned dst = new_temp(c);
+	const size_t pick = emit(c, (struct node_insn){ .op = op, .arg = { cond } });
+	emit(c, (struct node_insn){ .op = op_move, .dst = dst, .arg = { node_compile(c, A, kind) } });
+	const size_t skip = emit(c, (struct node_insn){ .op = op_jump });
+	if (c->failed) return 0;
+	c->insns[pick].arg[1] = (uint16_t)c->insn_count;
+	emit(c, (struct node_insn){ .op = op_move, .dst = dst, .arg = { node_compile(c, B, kind) } });
+	if (c->failed) return 0;
+	c->insns[skip].arg[0] = (uint16_t)c->insn_count;
+	return dst;
+}
+
+unsigned node_compile_mix(struct node_compiler *c, const void *A, const void *B, const struct valueNode *f, enum node_kind kind) {
+	const unsigned factor = node_compile(c, f, node_kind_value);
+	return compile_branch(c, op_mix, factor, A, B, kind);
+}
+
+unsigned node_compile_select(struct node_compiler *c, unsigned cond, const void *A, const void *B, enum node_kind kind) {
+	if (c->failed) return 0;
+	return compile_branch(c, op_select, cond, A, B, kind);
+}
+
+static inline uint16_t final_reg(const struct node_compiler *c, unsigned reg) {
+	return (uint16_t)((reg & TEMP_BIT) ? c->constant_count + (reg & ~TEMP_BIT) : reg);
+}
+
+static bool compile(const struct node_storage *s, const void *graph, enum node_kind kind, struct node_program *out) {
+	struct node_compiler *c = calloc(1, sizeof(*c));
+	const unsigned result = node_compile(c, graph, kind);
+	// A lone call or constant is just as fast as the graph itself
+	const bool trivial = c->insn_count == 0 || (c->insn_count == 1 && c->insns[0].op <= op_call_vector);
+	if (c->failed || trivial) {
+		if (c->failed) logr(debug, "Node graph too large to compile, evaluating it directly\n");
+		free(c);
+		return false;
+	}
+	for (size_t i = 0; i < c->insn_count; ++i) {
+		struct node_insn *insn = &c->insns[i];
+		insn->dst = final_reg(c, insn->dst);
+		if (insn->op == op_jump || insn->op == op_mix || insn->op == op_select) {
+			if (insn->op != op_jump) insn->arg[0] = final_reg(c, insn->arg[0]);
+			continue;
+		}
+		for (size_t a = 0; a < 5; ++a) insn->arg[a] = final_reg(c, insn->arg[a]);
+	}
+	struct node_insn *insns = allocBlock(s->node_table->pool, c->insn_count * sizeof(*insns));
+	memcpy(insns, c->insns, c->insn_count * sizeof(*insns));
+	union node_reg *constants = NULL;
+	if (c->constant_count) {
+		constants = allocBlock(s->node_table->pool, c->constant_count * sizeof(*constants));
+		memcpy(constants, c->constants, c->constant_count * sizeof(*constants));
+	}
+	*out = (struct node_program){
+		.insns = insns,
+		.insn_count = c->insn_count,
+		.constants = constants,
+		.constant_count = c->constant_count,
+		.register_count = c->constant_count + c->temp_count,
+		.result = final_reg(c, result),
+	};
+	free(c);
+	return true;
+}
+
+union node_reg node_program_run(const struct node_program *p, sampler *sampler, const struct hitRecord *record) {
+	union node_reg r[NODE_PROGRAM_MAX_REGISTERS];
+	memcpy(r, p->constants, p->constant_count * sizeof(*r));
+	const struct node_insn *insns = p->insns;
+	const size_t count = p->insn_count;
+	for (size_t i = 0; i < count; ++i) {
+		const struct node_insn *in = &insns[i];
+		const uint16_t *a = in->arg;
+		switch (in->op) {
+			case op_call_color: {
+				const struct colorNode *node = in->node;
+				r[in->dst].c = node->eval(node, sampler, record);
+				break;
+			}
+			case op_call_value: {
+				const struct valueNode *node = in->node;
+				r[in->dst].f = node->eval(node, sampler, record);
+				break;
+			}
+			case op_call_vector: {
+				const struct vectorNode *node = in->node;
+				r[in->dst].v = node->eval(node, sampler, record);
+				break;
+			}
+			case op_move:
+				r[in->dst] = r[a[0]];
+				break;
+			case op_jump:
+				i = a[0] - 1;
+				break;
+			case op_mix:
+				if (!(sampler_dimension(sampler) > r[a[0]].f)) i = a[1] - 1;
+				break;
+			case op_select:
+				if (r[a[0]].f == 0.0f) i = a[1] - 1;
+				break;
+			case op_math:
+				r[in->dst].f = math_apply(in->sub, r[a[0]].f, r[a[1]].f);
+				break;
+			case op_map_range:
+				r[in->dst].f = map_range_apply(r[a[0]].f, r[a[1]].f, r[a[2]].f, r[a[3]].f, r[a[4]].f);
+				break;
+			case op_grayscale:
+				r[in->dst].f = colorToGrayscale(r[a[0]].c).red;
+				break;
+			case op_combine_rgb:
+				r[in->dst].c = (struct color){ r[a[0]].f, r[a[1]].f, r[a[2]].f, 1.0f };
+				break;
+			case op_vec_math:
+				r[in->dst].v = vecmath_apply(in->sub, r[a[0]].v.v, r[a[1]].v.v, r[a[2]].v.v, r[a[3]].f);
+				break;
+			case op_vec_to_value:
+				r[in->dst].f = vec_to_value_apply(r[a[0]].v, in->sub);
+				break;
+			case op_vec_to_color: {
+				const struct vector v = vec_max(r[a[0]].v.v, vec_zero());
+				r[in->dst].c = (struct color){ v.x, v.y, v.z, 0.0f };
+				break;
+			}
+			case op_uv:
+				r[in->dst].v = (union vector_value){ .c = record->uv };
+				break;
+			case op_normal:
+				r[in->dst].v = (union vector_value){ .v = record->surfaceNormal };
+				break;
+			case op_checker:
+				r[in->dst].f = checker_apply(record->uv, record->hitPoint, r[a[0]].f);
+				break;
+			case op_color_ramp:
+				r[in->dst].c = color_ramp_apply(in->node, r[a[0]].f);
+				break;
+		}
+	}
+	return r[p->result];
+}
+
+// Batched programs. Instructions that are plain arithmetic run for every lane, active or not,
+// so the loops stay branch free. The register file is zeroed first, so idle lanes only ever
+// see harmless values. Anything with side effects only runs for the active lanes.
+
+typedef uint32_t lane_mask;
+typedef char batch_fits_lane_mask[NODE_BATCH_SIZE <= 32 ? 1 : -1];
+
+static inline lane_mask first_lanes(size_t count) {
+	return count >= 32 ? ~(lane_mask)0 : ((lane_mask)1 << count) - 1;
+}
+
+#define LANES(l) for (size_t l = 0; l < NODE_BATCH_SIZE; ++l)
+
+struct batch_reg {
+	float q[4][NODE_BATCH_SIZE]; // Component, then lane
+};
+
+static inline union node_reg lane_get(const struct batch_reg *r, size_t lane) {
+	const float q[4] = { r->q[0][lane], r->q[1][lane], r->q[2][lane], r->q[3][lane] };
+	union node_reg out;
+	memcpy(&out, q, sizeof(out));
+	return out;
+}
+
+static inline void lane_set(struct batch_reg *r, size_t lane, const union node_reg value) {
+	float q[4];
+	memcpy(q, &value, sizeof(q));
+	for (size_t c = 0; c < 4; ++c) r->q[c][lane] = q[c];
+}
+
+static void batch_math(uint8_t op, float *dst, const float *a, const float *b, lane_mask mask) {
+	switch (op) {
+		case Add: LANES(l) dst[l] = a[l] + b[l]; return;
+		case Subtract: LANES(l) dst[l] = a[l] - b[l]; return;
+		case Multiply: LANES(l) dst[l] = a[l] * b[l]; return;
+		case Divide: LANES(l) dst[l] = a[l] / b[l]; return;
+		case Min: LANES(l) dst[l] = min(a[l], b[l]); return;
+		case Max: LANES(l) dst[l] = max(a[l], b[l]); return;
+		case LessThan: LANES(l) dst[l] = a[l] < b[l] ? 1.0f : 0.0f; return;
+		case GreaterThan: LANES(l) dst[l] = a[l] > b[l] ? 1.0f : 0.0f; return;
+		default:
+			LANES(l) if (mask >> l & 1) dst[l] = math_apply(op, a[l], b[l]);
+			return;
+	}
+}
+
+static void batch_vec_math(uint8_t op, struct batch_reg *dst, const struct batch_reg *a, const struct batch_reg *b, const struct batch_reg *c, const float *f, lane_mask mask) {
+	switch (op) {
+		case VecAdd: for (size_t i = 0; i < 3; ++i) LANES(l) dst->q[i][l] = a->q[i][l] + b->q[i][l]; return;
+		case VecSubtract: for (size_t i = 0; i < 3; ++i) LANES(l) dst->q[i][l] = a->q[i][l] - b->q[i][l]; return;
+		case VecMultiply: for (size_t i = 0; i < 3; ++i) LANES(l) dst->q[i][l] = a->q[i][l] * b->q[i][l]; return;
+		case VecScale: for (size_t i = 0; i < 3; ++i) LANES(l) dst->q[i][l] = a->q[i][l] * f[l]; return;
+		default:
+			LANES(l) {
+				if (!(mask >> l & 1)) continue;
+				const union node_reg A = lane_get(a, l), B = lane_get(b, l), C = lane_get(c, l);
+				lane_set(dst, l, (union node_reg){ .v = vecmath_apply(op, A.v.v, B.v.v, C.v.v, f[l]) });
+			}
+			return;
+	}
+}
+
+static void call_batch(const void *node, enum node_kind kind, const struct node_batch *b, struct batch_reg *dst, lane_mask mask) {
+	union node_reg out[NODE_BATCH_SIZE];
+	if (mask == first_lanes(b->count)) {
+		node_eval_batch(node, kind, b, out);
+		for (size_t l = 0; l < b->count; ++l) lane_set(dst, l, out[l]);
+		return;
+	}
+	// Lanes that took the other branch sit this one out, the rest get a batch of their own
+	size_t lanes[NODE_BATCH_SIZE];
+	sampler *samplers[NODE_BATCH_SIZE] = { 0 };
+	const struct hitRecord *records[NODE_BATCH_SIZE] = { 0 };
+	size_t count = 0;
+	for (size_t l = 0; l < b->count; ++l) {
+		if (!(mask >> l & 1)) continue;
+		lanes[count] = l;
+		samplers[count] = b->samplers[l];
+		records[count] = b->records[l];
+		count++;
+	}
+	struct node_batch sub;
+	node_batch_init(&sub, samplers, records, count);
+	node_eval_batch(node, kind, &sub, out);
+	for (size_t i = 0; i < count; ++i) lane_set(dst, lanes[i], out[i]);
+}
+
+static void run_batch(const struct node_program *p, const struct node_batch *b, struct batch_reg *r, size_t begin, size_t end, lane_mask mask) {
+	const struct node_insn *insns = p->insns;
+	for (size_t i = begin; i < end; ++i) {
+		const struct node_insn *in = &insns[i];
+		const uint16_t *a = in->arg;
+		struct batch_reg *dst = &r[in->dst];
+		switch (in->op) {
+			case op_call_color:
+			case op_call_value:
+			case op_call_vector:
+				// The calls are in node_kind order
+				call_batch(in->node, (enum node_kind)(in->op - op_call_color), b, dst, mask);
+				break;
+			case op_move:
+				// Both sides of a branch write the same register, so only touch our lanes
+				for (size_t c = 0; c < 4; ++c) LANES(l) if (mask >> l & 1) dst->q[c][l] = r[a[0]].q[c][l];
+				break;
+			case op_jump:
+				// Only reached at the end of a branch, which the caller handles
+				return;
+			case op_mix:
+			case op_select: {
+				lane_mask take_b = 0;
+				LANES(l) {
+					if (!(mask >> l & 1)) continue;
+					const float f = r[a[0]].q[0][l];
+					const bool pick_b = in->op == op_mix ? !(sampler_dimension(b->samplers[l]) > f) : f == 0.0f;
+					take_b |= (lane_mask)pick_b << l;
+				}
+				const size_t b_begin = a[1];
+				const size_t b_end = insns[b_begin - 1].arg[0];
+				if (mask & ~take_b) run_batch(p, b, r, i + 1, b_begin - 1, mask & ~take_b);
+				if (take_b) run_batch(p, b, r, b_begin, b_end, take_b);
+				i = b_end - 1;
+				break;
+			}
+			case op_math:
+				batch_math(in->sub, dst->q[0], r[a[0]].q[0], r[a[1]].q[0], mask);
+				break;
+			case op_map_range:
+				// Mirrors map_range_apply()
+				LANES(l) {
+					const float t = clamp(r[a[0]].q[0][l] / (r[a[2]].q[0][l] - r[a[1]].q[0][l]), 0.0f, 1.0f);
+					dst->q[0][l] = lerp(r[a[3]].q[0][l], r[a[4]].q[0][l], t);
+				}
+				break;
+			case op_grayscale:
+				LANES(l) {
+					const struct color c = { r[a[0]].q[0][l], r[a[0]].q[1][l], r[a[0]].q[2][l], r[a[0]].q[3][l] };
+					dst->q[0][l] = colorToGrayscale(c).red;
+				}
+				break;
+			case op_combine_rgb:
+				for (size_t c = 0; c < 3; ++c) memcpy(dst->q[c], r[a[c]].q[0], sizeof(dst->q[c]));
+				LANES(l) dst->q[3][l] = 1.0f;
+				break;
+			case op_vec_math:
+				batch_vec_math(in->sub, dst, &r[a[0]], &r[a[1]], &r[a[2]], r[a[3]].q[0], mask);
+				break;
+			case op_vec_to_value: {
+				// Same component mapping as vec_to_value_apply(), U & V alias X & Y
+				static const unsigned components[] = { [X] = 0, [Y] = 1, [Z] = 2, [U] = 0, [V] = 1, [F] = 0 };
+				memcpy(dst->q[0], r[a[0]].q[components[in->sub]], sizeof(dst->q[0]));
+				break;
+			}
+			case op_vec_to_color:
+				for (size_t c = 0; c < 3; ++c) LANES(l) dst->q[c][l] = max(r[a[0]].q[c][l], 0.0f);
+				LANES(l) dst->q[3][l] = 0.0f;
+				break;
+			case op_uv:
+				memcpy(dst->q[0], b->u, sizeof(b->u));
+				memcpy(dst->q[1], b->v, sizeof(b->v));
+				memset(dst->q[2], 0, sizeof(dst->q[2]));
+				memset(dst->q[3], 0, sizeof(dst->q[3]));
+				break;
+			case op_normal:
+				memcpy(dst->q[0], b->nx, sizeof(b->nx));
+				memcpy(dst->q[1], b->ny, sizeof(b->ny));
+				memcpy(dst->q[2], b->nz, sizeof(b->nz));
+				memset(dst->q[3], 0, sizeof(dst->q[3]));
+				break;
+			case op_checker:
+				LANES(l) {
+					const coord uv = { b->u[l], b->v[l] };
+					const vector pt = { b->px[l], b->py[l], b->pz[l] };
+					dst->q[0][l] = checker_apply(uv, pt, r[a[0]].q[0][l]);
+				}
+				break;
+			case op_color_ramp:
+				LANES(l) lane_set(dst, l, (union node_reg){ .c = color_ramp_apply(in->node, r[a[0]].q[0][l]) });
+				break;
+		}
+	}
+}
+
+void node_batch_init(struct node_batch *batch, sampler *const *samplers, const struct hitRecord *const *records, size_t count) {
+	memset(batch, 0, sizeof(*batch));
+	batch->count = count;
+	for (size_t l = 0; l < count; ++l) {
+		const struct hitRecord *record = records[l];
+		batch->samplers[l] = samplers[l];
+		batch->records[l] = record;
+		batch->u[l] = record->uv.x;
+		batch->v[l] = record->uv.y;
+		batch->px[l] = record->hitPoint.x;
+		batch->py[l] = record->hitPoint.y;
+		batch->pz[l] = record->hitPoint.z;
+		batch->nx[l] = record->surfaceNormal.x;
+		batch->ny[l] = record->surfaceNormal.y;
+		batch->nz[l] = record->surfaceNormal.z;
+	}
+}
+
+void node_program_run_batch(const struct node_program *p, const struct node_batch *batch, union node_reg *out) {
+	struct batch_reg r[NODE_PROGRAM_MAX_REGISTERS];
+	for (size_t k = 0; k < p->constant_count; ++k) {
+		float q[4];
+		memcpy(q, &p->constants[k], sizeof(q));
+		for (size_t c = 0; c < 4; ++c) LANES(l) r[k].q[c][l] = q[c];
+	}
+	memset(&r[p->constant_count], 0, (p->register_count - p->constant_count) * sizeof(*r));
+	run_batch(p, batch, r, 0, p->insn_count, first_lanes(batch->count));
+	for (size_t l = 0; l < batch->count; ++l) out[l] = lane_get(&r[p->result], l);
+}
+
+// Compiled graphs are nodes too, so bsdfs don't have to know about them
+
+struct compiled_node {
+	union {
+		struct colorNode color;
+		struct valueNode value;
+		struct vectorNode vector;
+	} node;
+	const void *graph;
+	struct node_program program;
+	node_native_fn native; // Optional, see native.h
+};
+
+static bool compare(const void *A, const void *B) {
+	const struct compiled_node *this = A;
+	const struct compiled_node *other = B;
+	return this->graph == other->graph;
+}
+
+static uint32_t hash(const void *p) {
+	const struct compiled_node *this = p;
+	uint32_t h = hashInit();
+	h = hashBytes(h, &this->graph, sizeof(this->graph));
+	return h;
+}
+
+static void dump(const void *node, char *dumpbuf, int bufsize) {
+	const struct compiled_node *self = node;
+	const struct nodeBase *graph = self->graph;
+	char inner[DUMPBUF_SIZE / 2] = "";
+	if (graph->dump) graph->dump(graph, inner, sizeof(inner));
+	snprintf(dumpbuf, bufsize, "compiled_node { insns: %zu, graph: %s }", self->program.insn_count, inner);
+}
+
+static struct color eval_color(const struct colorNode *node, sampler *sampler, const struct hitRecord *record) {
+	const struct compiled_node *self = (const struct compiled_node *)node;
+	if (self->native) return native_run(self->native, &self->program, sampler, record).c;
+	return node_program_run(&self->program, sampler, record).c;
+}
+
+static float eval_value(const struct valueNode *node, sampler *sampler, const struct hitRecord *record) {
+	const struct compiled_node *self = (const struct compiled_node *)node;
+	if (self->native) return native_run(self->native, &self->program, sampler, record).f;
+	return node_program_run(&self->program, sampler, record).f;
+}
+
+static union vector_value eval_vector(const struct vectorNode *node, sampler *sampler, const struct hitRecord *record) {
+	const struct compiled_node *self = (const struct compiled_node *)node;
+	if (self->native) return native_run(self->native, &self->program, sampler, record).v;
+	return node_program_run(&self->program, sampler, record).v;
+}
+
+static void eval_batch(const void *node, const struct node_batch *batch, union node_reg *out) {
+	// Native code is built for one point at a time, the interpreter's batch loops beat calling it per lane
+	node_program_run_batch(&((const struct compiled_node *)node)->program, batch, out);
+}
+
+// Compiling and loading native code is costly, so a graph that was compiled already is only looked up
+static const void *find_compiled(const struct node_storage *s, const void *graph) {
+	const struct compiled_node key = { .node.color.base = { .compare = compare }, .graph = graph };
+	return findInHashtable(s->node_table, &key, hash(&key));
+}
+
+const struct colorNode *compile_color_node(const struct node_storage *s, const struct colorNode *graph) {
+	if (!graph) return NULL;
+	const struct colorNode *existing = find_compiled(s, graph);
+	if (existing) return existing;
+	struct node_program program;
+	if (!compile(s, graph, node_kind_color, &program)) return graph;
+	HASH_CONS(s->node_table, hash, struct compiled_node, {
+		.graph = graph,
+		.program = program,
+		.native = native_compile(s->native, &program),
+		.node.color = {
+			.eval = eval_color,
+			.base = { .compare = compare, .dump = dump, .eval_batch = eval_batch }
+		}
+	});
+}
+
+const struct valueNode *compile_value_node(const struct node_storage *s, const struct valueNode *graph) {
+	if (!graph) return NULL;
+	const struct valueNode *existing = find_compiled(s, graph);
+	if (existing) return existing;
+	struct node_program program;
+	if (!compile(s, graph, node_kind_value, &program)) return graph;
+	HASH_CONS(s->node_table, hash, struct compiled_node, {
+		.graph = graph,
+		.program = program,
+		.native = native_compile(s->native, &program),
+		.node.value = {
+			.eval = eval_value,
+			.constant = graph->constant,
+			.base = { .compare = compare, .dump = dump, .eval_batch = eval_batch }
+		}
+	});
+}
+
+const struct vectorNode *compile_vector_node(const struct node_storage *s, const struct vectorNode *graph) {
+	if (!graph) return NULL;
+	const struct vectorNode *existing = find_compiled(s, graph);
+	if (existing) return existing;
+	struct node_program program;
+	if (!compile(s, graph, node_kind_vector, &program)) return graph;
+	HASH_CONS(s->node_table, hash, struct compiled_node, {
+		.graph = graph,
+		.program = program,
+		.native = native_compile(s->native, &program),
+		.node.vector = {
+			.eval = eval_vector,
+			.base = { .compare = compare, .dump = dump, .eval_batch = eval_batch }
+		}
+	});
+}
+
+static union node_reg eval_lane(const void *node, enum node_kind kind, sampler *sampler, const struct hitRecord *record) {
+	switch (kind) {
+		case node_kind_color: {
+			const struct colorNode *n = node;
+			return (union node_reg){ .c = n->eval(n, sampler, record) };
+		}
+		case node_kind_value: {
+			const struct valueNode *n = node;
+			return (union node_reg){ .f = n->eval(n, sampler, record) };
+		}
+		case node_kind_vector: {
+			const struct vectorNode *n = node;
+			return (union node_reg){ .v = n->eval(n, sampler, record) };
+		}
+	}
+	return (union node_reg){ 0 };
+}
+
+void node_eval_batch(const void *node, enum node_kind kind, const struct node_batch *batch, union node_reg *out) {
+	const struct nodeBase *base = node;
+	if (base->eval_batch) {
+		base->eval_batch(node, batch, out);
+		return;
+	}
+	for (size_t l = 0; l < batch->count; ++l) out[l] = eval_lane(node, kind, batch->samplers[l], batch->records[l]);
+}
+
+void color_node_eval_batch(const struct colorNode *node, const struct node_batch *batch, struct color *out) {
+	union node_reg r[NODE_BATCH_SIZE];
+	node_eval_batch(node, node_kind_color, batch, r);
+	for (size_t l = 0; l < batch->count; ++l) out[l] = r[l].c;
+}
+
+void value_node_eval_batch(const struct valueNode *node, const struct node_batch *batch, float *out) {
+	union node_reg r[NODE_BATCH_SIZE];
+	node_eval_batch(node, node_kind_value, batch, r);
+	for (size_t l = 0; l < batch->count; ++l) out[l] = r[l].f;
+}
+
+void vector_node_eval_batch(const struct vectorNode *node, const struct node_batch *batch, union vector_value *out) {
+	union node_reg r[NODE_BATCH_SIZE];
+	node_eval_batch(node, node_kind_vector, batch, r);
+	for (size_t l = 0; l < batch->count; ++l) out[l] = r[l].v;
+}
@@ -0,0 +1,131 @@
+//
+//  program.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <common/color.h>
+#include <renderer/samplers/sampler.h>
+#include "vectornode.h"
+
+// Node graphs are evaluated with recursive indirect calls, one per node per hit. To avoid that,
+// the inputs of each bsdf get flattened into a node program: a list of instructions over a
+// register file, in the same order the recursive evaluation would run them, so results and
+// sampler use are identical. Common nodes are interpreted directly, the rest get called as usual.
+// Nodes opt in by setting base.compile.
+
+#define NODE_PROGRAM_MAX_REGISTERS 128
+#define NODE_PROGRAM_MAX_INSNS 1024
+
+union node_reg {
+	struct color c;
+	union vector_value v;
+	float f;
+};
+
+enum node_opcode {
+	op_call_color,
+	op_call_value,
+	op_call_vector,
+	op_move,
+	op_jump, // To arg[0]
+	op_mix, // Pick B at arg[1] with probability arg[0], otherwise fall through to A
+	op_select, // Go to B at arg[1] if arg[0] is zero, otherwise fall through to A
+	op_math,
+	op_map_range,
+	op_grayscale,
+	op_combine_rgb,
+	op_vec_math,
+	op_vec_to_value,
+	op_vec_to_color,
+	op_uv,
+	op_normal,
+	op_checker,
+	op_color_ramp, // For the ramp in node
+};
+
+struct node_insn {
+	uint8_t op;
+	uint8_t sub; // Operation for op_math & friends
+	uint16_t dst;
+	uint16_t arg[5]; // Source registers, or jump targets
+	const void *node; // For op_call_* and op_color_ramp
+};
+
+struct node_program {
+	const struct node_insn *insns;
+	size_t insn_count;
+	// Registers [0, constant_count) are loaded from here on every run, the rest are temporaries.
+	const union node_reg *constants;
+	size_t constant_count;
+	size_t register_count;
+	uint16_t result;
+};
+
+enum node_kind {
+	node_kind_color,
+	node_kind_value,
+	node_kind_vector,
+};
+
+struct node_compiler;
+
+/// Emit instructions to evaluate node into the program being compiled, returns the result register
+unsigned node_compile(struct node_compiler *c, const void *node, enum node_kind kind);
+unsigned node_compile_color_constant(struct node_compiler *c, const struct color value);
+unsigned node_compile_value_constant(struct node_compiler *c, float value);
+unsigned node_compile_vector_constant(struct node_compiler *c, const union vector_value value);
+/// Emit a single instruction writing to a new register, and return it
+unsigned node_compile_op(struct node_compiler *c, enum node_opcode op, uint8_t sub, const unsigned *args, size_t arg_count);
+/// Same, for instructions that refer back to the node they were compiled from
+unsigned node_compile_node_op(struct node_compiler *c, enum node_opcode op, const void *node, const unsigned *args, size_t arg_count);
+/// Emit a stochastic pick between A & B, evaluating only the one picked, like color_mix & vec_mix do
+unsigned node_compile_mix(struct node_compiler *c, const void *A, const void *B, const struct valueNode *f, enum node_kind kind);
+/// Emit a branch that evaluates A if the cond register is non-zero, B otherwise
+unsigned node_compile_select(struct node_compiler *c, unsigned cond, const void *A, const void *B, enum node_kind kind);
+
+union node_reg node_program_run(const struct node_program *p, sampler *sampler, const struct hitRecord *record);
+
+// Batched evaluation, for shading many points with the same material in one go. Registers
+// are kept as structures of arrays with a lane per point, so the common instructions become
+// plain loops the compiler can vectorize, and the dispatch is paid once per batch. At mixes
+// and checkers the lanes split up and each only runs its own branch, so every lane uses
+// its sampler exactly like node_program_run() would. Other nodes get called through their
+// base.eval_batch if they have one, or lane by lane otherwise.
+
+#define NODE_BATCH_SIZE 16
+
+struct node_batch {
+	size_t count;
+	sampler *samplers[NODE_BATCH_SIZE]; // One per lane, they can't be shared
+	const struct hitRecord *records[NODE_BATCH_SIZE];
+	// Hit data read by the instructions, copied out of the records
+	float u[NODE_BATCH_SIZE], v[NODE_BATCH_SIZE];
+	float px[NODE_BATCH_SIZE], py[NODE_BATCH_SIZE], pz[NODE_BATCH_SIZE];
+	float nx[NODE_BATCH_SIZE], ny[NODE_BATCH_SIZE], nz[NODE_BATCH_SIZE];
+};
+
+/// count must be at most NODE_BATCH_SIZE
+void node_batch_init(struct node_batch *batch, sampler *const *samplers, const struct hitRecord *const *records, size_t count);
+void node_program_run_batch(const struct node_program *p, const struct node_batch *batch, union node_reg *out);
+
+struct node_storage;
+
+/// Returns a node that evaluates graph through a node program, or graph itself
+/// if that wouldn't save anything. The graph is kept as is, as reference.
+const struct colorNode *compile_color_node(const struct node_storage *s, const struct colorNode *graph);
+const struct valueNode *compile_value_node(const struct node_storage *s, const struct valueNode *graph);
+const struct vectorNode *compile_vector_node(const struct node_storage *s, const struct vectorNode *graph);
+
+/// Evaluate node for every lane in batch. Nodes with base.eval_batch run batched, others get evaluated one lane at a time
+void node_eval_batch(const void *node, enum node_kind kind, const struct node_batch *batch, union node_reg *out);
+void color_node_eval_batch(const struct colorNode *node, const struct node_batch *batch, struct color *out);
+void value_node_eval_batch(const struct valueNode *node, const struct node_batch *batch, float *out);
+void vector_node_eval_batch(const struct vectorNode *node, const struct node_batch *batch, union vector_value *out);
@@ -57,7 +57,18 @@ static struct bsdfSample sample(const struct bsdfNode *bsdf, sampler *sampler, c
 	// we're not supposed to compute the out direction here.
 	// Cycles does the add with OSL shading closures, instead of at this stage, so we'd have to
 	// do something similar to that, probably.
-	return (struct bsdfSample){.out = B.out, .weight = colorAdd(A.weight, B.weight)};
+	return (struct bsdfSample){.out = B.out, .pdf = B.pdf, .weight = colorAdd(A.weight, B.weight)};
+}
+
+// Same hack as above, directions come from B only, so only B's pdf applies.
+static struct color eval(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi) {
+	struct addBsdf *addBsdf = (struct addBsdf *)bsdf;
+	return colorAdd(bsdf_eval(addBsdf->A, sampler, record, wi), bsdf_eval(addBsdf->B, sampler, record, wi));
+}
+
+static float pdf(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi) {
+	struct addBsdf *addBsdf = (struct addBsdf *)bsdf;
+	return bsdf_pdf(addBsdf->B, sampler, record, wi);
 }
 
 const struct bsdfNode *newAdd(const struct node_storage *s, const struct bsdfNode *A, const struct bsdfNode *B) {
@@ -70,6 +81,8 @@ const struct bsdfNode *newAdd(const struct node_storage *s, const struct bsdfNod
 		.B = B ? B : newDiffuse(s, newConstantTexture(s, g_black_color)),
 		.bsdf = {
 			.sample = sample,
+			.eval = eval,
+			.pdf = pdf,
 			.base = { .compare = compare, .dump = dump }
 		}
 	});
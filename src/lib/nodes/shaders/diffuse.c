@@ -49,15 +49,49 @@ static struct bsdfSample sample(const struct bsdfNode *bsdf, sampler *sampler, c
 	const struct vector scatterDir = vec_normalize(vec_add(record->surfaceNormal, vec_on_unit_sphere(sampler)));
 	return (struct bsdfSample){
 		.out = { .start = record->hitPoint, .direction = scatterDir, .type = rt_reflection | rt_diffuse },
+		.pdf = max(vec_dot(record->surfaceNormal, scatterDir), 0.0f) / PI,
 		.weight = diffBsdf->color->eval(diffBsdf->color, sampler, record)
 	};
 }
 
+static void sample_batch(const struct bsdfNode *bsdf, const struct node_batch *batch, struct bsdfSample *out) {
+	struct diffuseBsdf *diffBsdf = (struct diffuseBsdf *)bsdf;
+	// Directions first, so every lane draws from its sampler in the same order sample() does
+	for (size_t l = 0; l < batch->count; ++l) {
+		const struct hitRecord *record = batch->records[l];
+		const struct vector scatterDir = vec_normalize(vec_add(record->surfaceNormal, vec_on_unit_sphere(batch->samplers[l])));
+		out[l] = (struct bsdfSample){
+			.out = { .start = record->hitPoint, .direction = scatterDir, .type = rt_reflection | rt_diffuse },
+			.pdf = max(vec_dot(record->surfaceNormal, scatterDir), 0.0f) / PI,
+		};
+	}
+	struct color weights[NODE_BATCH_SIZE];
+	color_node_eval_batch(diffBsdf->color, batch, weights);
+	for (size_t l = 0; l < batch->count; ++l) out[l].weight = weights[l];
+}
+
+// sample() is cosine weighted around the normal, so weight works out to just color
+static struct color eval(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi) {
+	struct diffuseBsdf *diffBsdf = (struct diffuseBsdf *)bsdf;
+	const float cos_theta = vec_dot(record->surfaceNormal, wi);
+	if (cos_theta <= 0.0f) return g_black_color;
+	return colorCoef(cos_theta / PI, diffBsdf->color->eval(diffBsdf->color, sampler, record));
+}
+
+static float pdf(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi) {
+	(void)bsdf;
+	(void)sampler;
+	return max(vec_dot(record->surfaceNormal, wi), 0.0f) / PI;
+}
+
 const struct bsdfNode *newDiffuse(const struct node_storage *s, const struct colorNode *color) {
 	HASH_CONS(s->node_table, hash, struct diffuseBsdf, {
 		.color = color ? color : newConstantTexture(s, g_black_color),
 		.bsdf = {
 			.sample = sample,
+			.eval = eval,
+			.pdf = pdf,
+			.sample_batch = sample_batch,
 			.base = { .compare = compare, .dump = dump }
 		}
 	});
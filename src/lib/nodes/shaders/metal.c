@@ -63,12 +63,35 @@ static struct bsdfSample sample(const struct bsdfNode *bsdf, sampler *sampler, c
 	};
 }
 
+static void sample_batch(const struct bsdfNode *bsdf, const struct node_batch *batch, struct bsdfSample *out) {
+	struct metalBsdf *metalBsdf = (struct metalBsdf *)bsdf;
+	// Same sampler order per lane as sample(): roughness, fuzz, then color
+	float roughness[NODE_BATCH_SIZE];
+	value_node_eval_batch(metalBsdf->roughness, batch, roughness);
+	for (size_t l = 0; l < batch->count; ++l) {
+		const struct hitRecord *record = batch->records[l];
+		const struct vector normalizedDir = vec_normalize(record->incident->direction);
+		struct vector reflected = vec_reflect(normalizedDir, record->surfaceNormal);
+		if (roughness[l] > 0.0f) {
+			const struct vector fuzz = vec_scale(vec_on_unit_sphere(batch->samplers[l]), roughness[l]);
+			reflected = vec_add(reflected, fuzz);
+		}
+		out[l] = (struct bsdfSample){
+			.out = { .start = record->hitPoint, .direction = reflected, .type = rt_reflection | (roughness[l] == 0.0f ? rt_singular : rt_glossy) },
+		};
+	}
+	struct color weights[NODE_BATCH_SIZE];
+	color_node_eval_batch(metalBsdf->color, batch, weights);
+	for (size_t l = 0; l < batch->count; ++l) out[l].weight = weights[l];
+}
+
 const struct bsdfNode *newMetal(const struct node_storage *s, const struct colorNode *color, const struct valueNode *roughness) {
 	HASH_CONS(s->node_table, hash, struct metalBsdf, {
 		.color = color ? color : newConstantTexture(s, g_black_color),
 		.roughness = roughness ? roughness : newConstantValue(s, 0.0f),
 		.bsdf = {
 			.sample = sample,
+			.sample_batch = sample_batch,
 			.base = { .compare = compare, .dump = dump }
 		}
 	});
@@ -59,17 +59,45 @@ static struct bsdfSample sample(const struct bsdfNode *bsdf, sampler *sampler, c
 	}
 }
 
+// sample() picks A with probability 1 - factor, so eval and pdf are blended the same way
+static struct color eval(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi) {
+	struct mixBsdf *mixBsdf = (struct mixBsdf *)bsdf;
+	const float lerp = mixBsdf->factor->eval(mixBsdf->factor, sampler, record);
+	const struct color A = bsdf_eval(mixBsdf->A, sampler, record, wi);
+	const struct color B = bsdf_eval(mixBsdf->B, sampler, record, wi);
+	return colorAdd(colorCoef(1.0f - lerp, A), colorCoef(lerp, B));
+}
+
+static float pdf(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi) {
+	struct mixBsdf *mixBsdf = (struct mixBsdf *)bsdf;
+	const float lerp = mixBsdf->factor->eval(mixBsdf->factor, sampler, record);
+	const float A = bsdf_pdf(mixBsdf->A, sampler, record, wi);
+	const float B = bsdf_pdf(mixBsdf->B, sampler, record, wi);
+	return (1.0f - lerp) * A + lerp * B;
+}
+
 const struct bsdfNode *newMix(const struct node_storage *s, const struct bsdfNode *A, const struct bsdfNode *B, const struct valueNode *factor) {
+	A = A ? A : newDiffuse(s, newConstantTexture(s, g_black_color));
+	B = B ? B : newDiffuse(s, newConstantTexture(s, g_black_color));
+	factor = factor ? factor : newConstantValue(s, 0.5f);
 	if (A == B) {
 		logr(debug, "A == B, pruning mix node.\n");
 		return A;
 	}
+	// eval() & pdf() extrapolate outside [0, 1], so only the exact ends can be pruned
+	if (factor->constant) {
+		const float lerp = factor->eval(factor, NULL, NULL);
+		if (lerp == 0.0f) return A;
+		if (lerp == 1.0f) return B;
+	}
 	HASH_CONS(s->node_table, hash, struct mixBsdf, {
-		.A = A ? A : newDiffuse(s, newConstantTexture(s, g_black_color)),
-		.B = B ? B : newDiffuse(s, newConstantTexture(s, g_black_color)),
-		.factor = factor ? factor : newConstantValue(s, 0.5f),
+		.A = A,
+		.B = B,
+		.factor = factor,
 		.bsdf = {
 			.sample = sample,
+			.eval = eval,
+			.pdf = pdf,
 			.base = { .compare = compare, .dump = dump }
 		}
 	});
@@ -71,15 +71,13 @@ static struct bsdfSample sampleShiny(const struct bsdfNode *bsdf, sampler *sampl
 	};
 }
 
-static struct bsdfSample sample(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record) {
+// Probability of sampling the clear coat instead of the diffuse base
+static float coat_probability(const struct plasticBsdf *this, sampler *sampler, const struct hitRecord *record) {
 	struct vector outwardNormal;
 	float niOverNt;
 	struct vector refracted;
-	float reflectionProbability;
 	float cosine;
 	
-	struct plasticBsdf *this = (struct plasticBsdf *)bsdf;
-	
 	const float IOR = this->IOR->eval(this->IOR, sampler, record);
 	
 	if (vec_dot(record->incident->direction, record->surfaceNormal) > 0.0f) {
@@ -93,18 +91,34 @@ static struct bsdfSample sample(const struct bsdfNode *bsdf, sampler *sampler, c
 	}
 	
 	if (vec_refract(record->incident->direction, outwardNormal, niOverNt, &refracted)) {
-		reflectionProbability = schlick(cosine, IOR);
-	} else {
-		reflectionProbability = 1.0f;
+		return schlick(cosine, IOR);
 	}
+	return 1.0f;
+}
+
+static struct bsdfSample sample(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record) {
+	struct plasticBsdf *this = (struct plasticBsdf *)bsdf;
 	
-	if (sampler_dimension(sampler) < reflectionProbability) {
+	if (sampler_dimension(sampler) < coat_probability(this, sampler, record)) {
 		return sampleShiny(bsdf, sampler, record);
 	} else {
 		return this->diffuse->sample(this->diffuse, sampler, record);
 	}
 }
 
+// The clear coat is left to sample(), only the diffuse base gets evaluated
+static struct color eval(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi) {
+	struct plasticBsdf *this = (struct plasticBsdf *)bsdf;
+	const float base = 1.0f - coat_probability(this, sampler, record);
+	return colorCoef(base, bsdf_eval(this->diffuse, sampler, record, wi));
+}
+
+static float pdf(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record, const struct vector wi) {
+	struct plasticBsdf *this = (struct plasticBsdf *)bsdf;
+	const float base = 1.0f - coat_probability(this, sampler, record);
+	return base * bsdf_pdf(this->diffuse, sampler, record, wi);
+}
+
 // TODO: Separate clear coat + base colors
 const struct bsdfNode *newPlastic(const struct node_storage *s, const struct colorNode *color, const struct valueNode *roughness, const struct valueNode *IOR) {
 	HASH_CONS(s->node_table, hash, struct plasticBsdf, {
@@ -114,6 +128,8 @@ const struct bsdfNode *newPlastic(const struct node_storage *s, const struct col
 		.IOR = IOR ? IOR : newConstantValue(s, 1.45f),
 		.bsdf = {
 			.sample = sample,
+			.eval = eval,
+			.pdf = pdf,
 			.base = { .compare = compare, .dump = dump }
 		}
 	});
@@ -17,6 +17,7 @@
 #include "../colornode.h"
 
 #include "checker.h"
+#include "../program.h"
 
 struct checkerTexture {
 	struct colorNode node;
@@ -26,39 +27,29 @@ struct checkerTexture {
 };
 
 // UV-mapped variant
-static struct color mappedCheckerBoard(const struct hitRecord *isect, sampler *sampler, const struct colorNode *A, const struct colorNode *B, const struct valueNode *scale) {
-	const float coef = scale->eval(scale, sampler, isect);
-	const coord uv = coord_scale(coef, isect->uv);
+static bool mappedCheckerBoard(const coord uv_in, float coef) {
+	const coord uv = coord_scale(coef, uv_in);
 	float x_i = (uv.x + 0.000001) * 0.999999;
 	float y_i = (uv.y + 0.000001) * 0.999999;
 	x_i = (int)fabsf(floorf(x_i));
 	y_i = (int)fabsf(floorf(y_i));
-	if (fmodf(x_i, 2.0f) == fmodf(y_i, 2.0f)) {
-		return A->eval(A, sampler, isect);
-	} else {
-		return B->eval(B, sampler, isect);
-	}
+	return fmodf(x_i, 2.0f) == fmodf(y_i, 2.0f);
 }
 
 // Fallback axis-aligned checkerboard
-static struct color unmappedCheckerBoard(const struct hitRecord *isect, sampler *sampler, const struct colorNode *A, const struct colorNode *B, const struct valueNode *scale) {
-	const float coef = scale->eval(scale, sampler, isect);
-	const vector v = vec_scale(isect->hitPoint, coef);
+static bool unmappedCheckerBoard(const vector p, float coef) {
+	const vector v = vec_scale(p, coef);
 	float x_i = (v.x + 0.000001) * 0.999999;
 	float y_i = (v.y + 0.000001) * 0.999999;
 	float z_i = (v.z + 0.000001) * 0.999999;
 	x_i = (int)fabsf(floorf(x_i));
 	y_i = (int)fabsf(floorf(y_i));
 	z_i = (int)fabsf(floorf(z_i));
-	if ((fmodf(x_i, 2.0f) == fmodf(y_i, 2.0f)) == fmodf(z_i, 2.0f)) {
-		return A->eval(A, sampler, isect);
-	} else {
-		return B->eval(B, sampler, isect);
-	}
+	return (fmodf(x_i, 2.0f) == fmodf(y_i, 2.0f)) == fmodf(z_i, 2.0f);
 }
 
-static struct color checkerBoard(const struct hitRecord *isect, sampler *sampler, const struct colorNode *A, const struct colorNode *B, const struct valueNode *scale) {
-	return isect->uv.x >= 0 ? mappedCheckerBoard(isect, sampler, A, B, scale) : unmappedCheckerBoard(isect, sampler, A, B, scale);
+float checker_apply(const coord uv, const vector p, float scale) {
+	return (uv.x >= 0 ? mappedCheckerBoard(uv, scale) : unmappedCheckerBoard(p, scale)) ? 1.0f : 0.0f;
 }
 
 static bool compare(const void *A, const void *B) {
@@ -87,7 +78,19 @@ static void dump(const void *node, char *dumpbuf, int len) {
 
 static struct color eval(const struct colorNode *node, sampler *sampler, const struct hitRecord *record) {
 	struct checkerTexture *checker = (struct checkerTexture *)node;
-	return checkerBoard(record, sampler, checker->A, checker->B, checker->scale);
+	const float coef = checker->scale->eval(checker->scale, sampler, record);
+	if (checker_apply(record->uv, record->hitPoint, coef) != 0.0f) {
+		return checker->A->eval(checker->A, sampler, record);
+	} else {
+		return checker->B->eval(checker->B, sampler, record);
+	}
+}
+
+static unsigned compile(const void *node, struct node_compiler *c) {
+	const struct checkerTexture *this = node;
+	const unsigned scale = node_compile(c, this->scale, node_kind_value);
+	const unsigned pick = node_compile_op(c, op_checker, 0, &scale, 1);
+	return node_compile_select(c, pick, this->A, this->B, node_kind_color);
 }
 
 //TODO: Maybe a 'local' flag that would then remap UVs to be local to each checker square? That'd be neat. Blender doesn't have it.
@@ -98,7 +101,7 @@ const struct colorNode *newCheckerBoardTexture(const struct node_storage *s, con
 		.scale = scale ? scale : newConstantValue(s, 5.0f),
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
@@ -8,7 +8,12 @@
 
 #pragma once
 
+#include <common/vector.h>
+
 struct node_storage;
 struct valueNode;
 
 const struct colorNode *newCheckerBoardTexture(const struct node_storage *s, const struct colorNode *A, const struct colorNode *B, const struct valueNode *scale);
+
+/// 1.0f where the checkerboard shows A, 0.0f for B. UVs are used if the mesh has them, p otherwise
+float checker_apply(const coord uv, const vector p, float scale);
@@ -14,6 +14,7 @@
 #include "../colornode.h"
 
 #include "colormix.h"
+#include "../program.h"
 
 struct color_mix {
 	struct colorNode node;
@@ -60,18 +61,32 @@ static struct color eval(const struct colorNode *node, sampler *sampler, const s
 	}
 }
 
+static unsigned compile(const void *node, struct node_compiler *c) {
+	const struct color_mix *this = node;
+	return node_compile_mix(c, this->A, this->B, this->f, node_kind_color);
+}
+
 const struct colorNode *new_color_mix(const struct node_storage *s, const struct colorNode *A, const struct colorNode *B, const struct valueNode *f) {
+	A = A ? A : newConstantTexture(s, g_black_color);
+	B = B ? B : newConstantTexture(s, g_black_color);
+	f = f ? f : newConstantValue(s, 0.0f);
 	if (A == B) {
 		logr(debug, "A == B, pruning color_mix node.\n");
 		return A;
 	}
+	// B gets picked with probability f, so a constant f outside (0, 1) always picks the same one
+	if (f->constant) {
+		const float lerp = f->eval(f, NULL, NULL);
+		if (lerp <= 0.0f) return A;
+		if (lerp >= 1.0f) return B;
+	}
 	HASH_CONS(s->node_table, hash, struct color_mix, {
-		.A = A ? A : newConstantTexture(s, g_black_color),
-		.B = B ? B : newConstantTexture(s, g_black_color),
-		.f = f ? f : newConstantValue(s, 0.0f),
+		.A = A,
+		.B = B,
+		.f = f,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
@@ -16,6 +16,7 @@
 #include "../colornode.h"
 
 #include "constant.h"
+#include "../program.h"
 
 struct constantTexture {
 	struct colorNode node;
@@ -48,12 +49,22 @@ static struct color eval(const struct colorNode *node, sampler *sampler, const s
 	return ((struct constantTexture *)node)->color;
 }
 
+static unsigned compile(const void *node, struct node_compiler *c) {
+	return node_compile_color_constant(c, ((struct constantTexture *)node)->color);
+}
+
+static void eval_batch(const void *node, const struct node_batch *batch, union node_reg *out) {
+	const struct color color = ((struct constantTexture *)node)->color;
+	for (size_t l = 0; l < batch->count; ++l) out[l].c = color;
+}
+
 const struct colorNode *newConstantTexture(const struct node_storage *s, const struct color color) {
 	HASH_CONS(s->node_table, hash, struct constantTexture, {
 		.color = color,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.constant = true,
+			.base = { .compare = compare, .dump = dump, .compile = compile, .eval_batch = eval_batch }
 		}
 	});
 }
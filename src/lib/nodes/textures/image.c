@@ -18,6 +18,7 @@
 #include "../colornode.h"
 
 #include "image.h"
+#include "../program.h"
 
 struct imageTexture {
 	struct colorNode node;
@@ -28,15 +29,18 @@ struct imageTexture {
 //Transform the intersection coordinates to the texture coordinate space
 //And grab the color at that point. Texture mapping.
 static struct color internalColor(const struct texture *tex, const struct hitRecord *isect, uint8_t options) {
-	if (unlikely(!tex->data.byte_p)) return g_pink_color; // Async img decode fails -> we may get an empty texture
+	if (unlikely(!tex_ready(tex))) return g_pink_color; // Async img decode fails -> we may get an empty texture
+	// Pick the MIP level where a texel is about as wide as the ray footprint
+	const float lod = isect->uv_footprint > 0.0f ? log2f(isect->uv_footprint * max(tex->width, tex->height)) : 0.0f;
 	//Get the color value at these XY coordinates
 	struct color output;
 	if (options & NO_BILINEAR) {
-		float x = isect->uv.x * tex->width;
-		float y = isect->uv.y * tex->height;
-		output = tex_get_px(tex, x, y, false);
+		const struct texture *level = tex_get_mip(tex, lod + 0.5f);
+		float x = isect->uv.x * level->width;
+		float y = isect->uv.y * level->height;
+		output = tex_get_px(level, x, y, false);
 	} else {
-		output = tex_get_px(tex, isect->uv.x, isect->uv.y, true);
+		output = tex_get_px_lod(tex, isect->uv.x, isect->uv.y, lod);
 	}
 	
 	return output;
@@ -63,7 +67,7 @@ static void dump(const void *node, char *dumpbuf, int len) {
 		snprintf(dumpbuf, len, "imageTexture { tex: null }");
 		return;
 	}
-	if (!self->tex->data.byte_p) {
+	if (!tex_ready(self->tex)) {
 		snprintf(dumpbuf, len, "imageTexture { tex: pending }");
 		return;
 	}
@@ -83,6 +87,11 @@ static struct color eval(const struct colorNode *node, sampler *sampler, const s
 	return internalColor(image->tex, record, image->options);
 }
 
+static void eval_batch(const void *node, const struct node_batch *batch, union node_reg *out) {
+	const struct imageTexture *image = node;
+	for (size_t l = 0; l < batch->count; ++l) out[l].c = internalColor(image->tex, batch->records[l], image->options);
+}
+
 const struct colorNode *newImageTexture(const struct node_storage *s, const struct texture *texture, uint8_t options) {
 	if (!texture) return NULL;
 	HASH_CONS(s->node_table, hash, struct imageTexture, {
@@ -90,7 +99,7 @@ const struct colorNode *newImageTexture(const struct node_storage *s, const stru
 		.options = options,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .eval_batch = eval_batch }
 		}
 	});
 }
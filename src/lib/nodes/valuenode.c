@@ -17,6 +17,7 @@
 
 #include "vectornode.h"
 #include "valuenode.h"
+#include "program.h"
 
 struct constantValue {
 	struct valueNode node;
@@ -48,13 +49,22 @@ static float eval(const struct valueNode *node, sampler *sampler, const struct h
 	return this->value;
 }
 
+static unsigned compile(const void *node, struct node_compiler *c) {
+	return node_compile_value_constant(c, ((struct constantValue *)node)->value);
+}
+
+static void eval_batch(const void *node, const struct node_batch *batch, union node_reg *out) {
+	const float value = ((struct constantValue *)node)->value;
+	for (size_t l = 0; l < batch->count; ++l) out[l].f = value;
+}
+
 const struct valueNode *newConstantValue(const struct node_storage *s, float value) {
 	HASH_CONS(s->node_table, hash, struct constantValue, {
 		.value = value,
 		.node = {
 			.eval = eval,
 			.constant = true,
-			.base = { .compare = compare, .dump = dump }
+			.base = { .compare = compare, .dump = dump, .compile = compile, .eval_batch = eval_batch }
 		}
 	});
 }
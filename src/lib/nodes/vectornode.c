@@ -18,6 +18,7 @@
 
 #include "valuenode.h"
 #include "vectornode.h"
+#include "program.h"
 
 struct constantVector {
 	struct vectorNode node;
@@ -49,12 +50,17 @@ static union vector_value eval(const struct vectorNode *node, sampler *sampler,
 	return (union vector_value){ .v = this->vector };
 }
 
+static unsigned compile(const void *node, struct node_compiler *c) {
+	return node_compile_vector_constant(c, (union vector_value){ .v = ((struct constantVector *)node)->vector });
+}
+
 const struct vectorNode *newConstantVector(const struct node_storage *s, const struct vector vector) {
 	HASH_CONS(s->node_table, hash, struct constantVector, {
 		.vector = vector,
 		.node = {
 			.eval = eval,
-			.base = { .compare = compare, .dump = dump }
+			.constant = true,
+			.base = { .compare = compare, .dump = dump, .compile = compile }
 		}
 	});
 }
@@ -89,12 +95,17 @@ static union vector_value eval_uv(const struct vectorNode *node, sampler *sample
 	return (union vector_value){ .c = this->uv };
 }
 
+static unsigned compile_uv(const void *node, struct node_compiler *c) {
+	return node_compile_vector_constant(c, (union vector_value){ .c = ((struct constantUV *)node)->uv });
+}
+
 const struct vectorNode *newConstantUV(const struct node_storage *s, const struct coord c) {
 	HASH_CONS(s->node_table, hash_uv, struct constantUV, {
 		.uv = c,
 		.node = {
 			.eval = eval_uv,
-			.base = { .compare = compare_uv, .dump = dump_uv }
+			.constant = true,
+			.base = { .compare = compare_uv, .dump = dump_uv, .compile = compile_uv }
 		}
 	});
 }
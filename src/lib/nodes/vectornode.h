@@ -21,6 +21,7 @@ union vector_value {
 struct vectorNode {
 	struct nodeBase base;
 	union vector_value (*eval)(const struct vectorNode *node, sampler *sampler, const struct hitRecord *record);
+	bool constant;
 };
 
 #include "input/normal.h"
@@ -17,6 +17,7 @@
 #include <common/logging.h>
 #include <common/vector.h>
 #include <common/texture.h>
+#include <common/texture_cache.h>
 #include <common/transforms.h>
 #include <common/quaternion.h>
 #include <common/hashtable.h>
@@ -109,15 +110,22 @@ struct render_tile decodeTile(const cJSON *json) {
 
 cJSON *serialize_texture(const struct texture *t) {
 	if (!t) return NULL;
+	if (t->paged) {
+		// Workers get the pixels, they may not see our texture cache
+		struct texture *copy = tex_paged_copy(t);
+		cJSON *json = serialize_texture(copy);
+		tex_destroy(copy);
+		return json;
+	}
 	cJSON *json = cJSON_CreateObject();
 	cJSON_AddNumberToObject(json, "width", t->width);
 	cJSON_AddNumberToObject(json, "height", t->height);
 	cJSON_AddNumberToObject(json, "channels", t->channels);
-	size_t primSize = t->precision == char_p ? sizeof(char) : sizeof(float);
-	size_t bytes = t->width * t->height * t->channels * primSize;
-	char *encoded = b64encode(t->data.byte_p, bytes);
+	char *encoded = b64encode(t->data.byte_p, tex_data_size(t));
 	cJSON_AddStringToObject(json, "data", encoded);
 	cJSON_AddBoolToObject(json, "isFloatPrecision", t->precision == float_p);
+	cJSON_AddBoolToObject(json, "tiled", t->tiled);
+	cJSON_AddBoolToObject(json, "decodeSRGB", t->decode_srgb);
 	free(encoded);
 	return json;
 }
@@ -132,6 +140,8 @@ struct texture *deserialize_texture(const cJSON *json) {
 	tex->height = cJSON_GetNumberValue(cJSON_GetObjectItem(json, "height"));
 	tex->channels = cJSON_GetNumberValue(cJSON_GetObjectItem(json, "channels"));
 	tex->precision = cJSON_IsTrue(cJSON_GetObjectItem(json, "isFloatPrecision")) ? float_p : char_p;
+	tex->tiled = cJSON_IsTrue(cJSON_GetObjectItem(json, "tiled"));
+	tex->decode_srgb = cJSON_IsTrue(cJSON_GetObjectItem(json, "decodeSRGB"));
 	return tex;
 }
 
@@ -717,6 +727,8 @@ static cJSON *serialize_scene(const struct world *in) {
 
 	cJSON_AddItemToObject(out, "background", serialize_shader_node(in->bg_desc));
 
+	// Decode tasks tile their textures, swapping the pixel buffer out from under us
+	thread_pool_wait(in->bg_worker);
 	cJSON *textures = cJSON_CreateArray();
 	for (size_t i = 0; i < in->textures.count; ++i) {
 		cJSON *asset = cJSON_CreateObject();
@@ -784,9 +796,12 @@ struct world *deserialize_scene(const cJSON *in) {
 	if (cJSON_IsArray(textures)) {
 		cJSON *texture = NULL;
 		cJSON_ArrayForEach(texture, textures) {
+			struct texture *t = deserialize_texture(cJSON_GetObjectItem(texture, "t"));
+			// MIP levels aren't sent, they're cheaper to build again here
+			tex_build_mips(t);
 			texture_asset_arr_add(&out->textures, (struct texture_asset){
 				.path = stringCopy(cJSON_GetStringValue(cJSON_GetObjectItem(texture, "p"))),
-				.t = deserialize_texture(cJSON_GetObjectItem(texture, "t"))
+				.t = t
 			});
 		}
 	}
@@ -869,6 +884,8 @@ static cJSON *serialize_prefs(const struct prefs in) {
 	cJSON_AddItemToObject(out, "tileWidth", cJSON_CreateNumber(in.tileWidth));
 	cJSON_AddItemToObject(out, "tileHeight", cJSON_CreateNumber(in.tileHeight));
 	cJSON_AddItemToObject(out, "tileOrder", cJSON_CreateNumber(in.tileOrder));
+	cJSON_AddItemToObject(out, "pixelOrder", cJSON_CreateNumber(in.pixelOrder));
+	cJSON_AddItemToObject(out, "pinThreads", cJSON_CreateBool(in.pin_threads));
 	cJSON_AddItemToObject(out, "width", cJSON_CreateNumber(in.override_width));
 	cJSON_AddItemToObject(out, "height", cJSON_CreateNumber(in.override_height));
 	cJSON_AddItemToObject(out, "selected_camera", cJSON_CreateNumber(in.selected_camera));
@@ -883,6 +900,9 @@ struct prefs deserialize_prefs(const cJSON *in) {
 	p.tileWidth = cJSON_GetNumberValue(cJSON_GetObjectItem(in, "tileWidth"));
 	p.tileHeight = cJSON_GetNumberValue(cJSON_GetObjectItem(in, "tileHeight"));
 	p.tileOrder = cJSON_GetNumberValue(cJSON_GetObjectItem(in, "tileOrder"));
+	const cJSON *pixel_order = cJSON_GetObjectItem(in, "pixelOrder");
+	if (cJSON_IsNumber(pixel_order)) p.pixelOrder = pixel_order->valueint;
+	p.pin_threads = cJSON_IsTrue(cJSON_GetObjectItem(in, "pinThreads"));
 	p.override_width = cJSON_GetNumberValue(cJSON_GetObjectItem(in, "width"));
 	p.override_height = cJSON_GetNumberValue(cJSON_GetObjectItem(in, "height"));
 	p.selected_camera = cJSON_GetNumberValue(cJSON_GetObjectItem(in, "selected_camera"));
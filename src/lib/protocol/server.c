@@ -219,7 +219,11 @@ void *client_connection_thread(void *arg) {
 	}
 	
 	// Set this worker into render mode
-	if (!sendJSON(client->socket, newAction("startRender"), NULL)) {
+	// Tile dimensions may have been picked automatically after sync, so send them along
+	cJSON *start = newAction("startRender");
+	cJSON_AddItemToObject(start, "tileWidth", cJSON_CreateNumber(r->prefs.tileWidth));
+	cJSON_AddItemToObject(start, "tileHeight", cJSON_CreateNumber(r->prefs.tileHeight));
+	if (!sendJSON(client->socket, start, NULL)) {
 		logr(warning, "Client disconnected? Stopping for %i\n", client->id);
 		state->thread_complete = true;
 		return 0;
@@ -33,6 +33,7 @@
 #include <common/timer.h>
 #include <common/platform/signal.h>
 #include <common/platform/thread_pool.h>
+#include <common/platform/capabilities.h>
 #include <accelerators/bvh.h>
 #include <stdio.h>
 #include <inttypes.h>
@@ -49,6 +50,7 @@ struct command workerCommands[] = {
 
 struct workerThreadState {
 	int thread_num;
+	int core; // -1 to not pin
 	int connectionSocket;
 	struct cr_mutex *socketMutex;
 	struct camera *cam;
@@ -120,6 +122,8 @@ static bool submitWork(int sock, struct texture *work, struct render_tile *forTi
 static void *workerThread(void *arg) {
 	block_signals();
 	struct workerThreadState *thread = arg;
+	if (thread->core >= 0 && thread_pin_current(thread->core))
+		logr(debug, "Failed to pin render thread to core %i\n", thread->core);
 	struct renderer *r = thread->renderer;
 	int sock = thread->connectionSocket;
 	struct cr_mutex *sockMutex = thread->socketMutex;
@@ -131,6 +135,7 @@ static void *workerThread(void *arg) {
 	sampler *sampler = sampler_new();
 
 	struct camera *cam = thread->cam;
+	struct tile_set *set = thread->tiles;
 	
 	struct timeval timer = { 0 };
 	thread->completedSamples = 1;
@@ -146,27 +151,28 @@ static void *workerThread(void *arg) {
 		
 		while (thread->completedSamples < r->prefs.sampleCount+1 && r->state.s == r_rendering) {
 			timer_start(&timer);
-			for (int y = thread->current->end.y - 1; y > thread->current->begin.y - 1; --y) {
-				for (int x = thread->current->begin.x; x < thread->current->end.x; ++x) {
-					if (r->state.s != r_rendering || !g_running) goto bail;
-					uint32_t pixIdx = (uint32_t)(y * cam->width + x);
-					sampler_init(sampler, SAMPLING_STRATEGY, thread->completedSamples - 1, r->prefs.sampleCount, pixIdx);
-					
-					int local_x = x - thread->current->begin.x;
-					int local_y = y - thread->current->begin.y;
-					struct color output = tex_get_px(tileBuffer, local_x, local_y, false);
-					struct color sample = path_trace(cam_get_ray(cam, x, y, sampler), r->scene, r->prefs.bounces, sampler);
+			for (size_t p = 0; p < set->pixel_count; ++p) {
+				const int local_x = set->pixels[p].x;
+				const int local_y = set->pixels[p].y;
+				const int x = thread->current->begin.x + local_x;
+				const int y = thread->current->begin.y + local_y;
+				if (x >= thread->current->end.x || y >= thread->current->end.y) continue;
+				if (r->state.s != r_rendering || !g_running) goto bail;
+				uint32_t pixIdx = (uint32_t)(y * cam->width + x);
+				sampler_init(sampler, SAMPLING_STRATEGY, thread->completedSamples - 1, r->prefs.sampleCount, pixIdx);
+				
+				struct color output = tex_get_px(tileBuffer, local_x, local_y, false);
+				struct color sample = path_trace(cam_get_ray(cam, x, y, sampler), r->scene, r->prefs.bounces, sampler, NULL, NULL);
 
-					nan_clamp(&sample, &output);
-					
-					//And process the running average
-					output = colorCoef((float)(thread->completedSamples - 1), output);
-					output = colorAdd(output, sample);
-					float t = 1.0f / thread->completedSamples;
-					output = colorCoef(t, output);
-					
-					tex_set_px(tileBuffer, output, local_x, local_y);
-				}
+				nan_clamp(&sample, &output);
+				
+				//And process the running average
+				output = colorCoef((float)(thread->completedSamples - 1), output);
+				output = colorAdd(output, sample);
+				float t = 1.0f / thread->completedSamples;
+				output = colorCoef(t, output);
+				
+				tex_set_px(tileBuffer, output, local_x, local_y);
 			}
 			//For performance metrics
 			samples++;
@@ -206,8 +212,14 @@ bail:
 
 #define active_msec  16
 
-static cJSON *startRender(int connectionSocket, size_t thread_limit) {
+static cJSON *startRender(int connectionSocket, const cJSON *json, size_t thread_limit) {
 	g_worker_renderer->state.s = r_rendering;
+	const cJSON *tile_width = cJSON_GetObjectItem(json, "tileWidth");
+	const cJSON *tile_height = cJSON_GetObjectItem(json, "tileHeight");
+	if (cJSON_IsNumber(tile_width) && cJSON_IsNumber(tile_height) && tile_width->valueint > 0 && tile_height->valueint > 0) {
+		g_worker_renderer->prefs.tileWidth = tile_width->valueint;
+		g_worker_renderer->prefs.tileHeight = tile_height->valueint;
+	}
 	logr(info, "Starting network render job\n");
 	
 	size_t threadCount = thread_limit ? thread_limit : g_worker_renderer->prefs.threads;
@@ -228,16 +240,14 @@ static cJSON *startRender(int connectionSocket, size_t thread_limit) {
 		KNRM,
 		PLURAL(r->prefs.threads));
 	//Quantize image into renderTiles
-	struct tile_set set = {
-		.tile_mutex = mutex_create(),
-		.tiles = tile_quantize(
-			selected_cam.width,
-			selected_cam.height,
-			r->prefs.tileWidth,
-			r->prefs.tileHeight,
-			r->prefs.tileOrder
-		),
-	};
+	struct tile_set set;
+	tile_set_init(&set, tile_quantize(
+		selected_cam.width,
+		selected_cam.height,
+		r->prefs.tileWidth,
+		r->prefs.tileHeight,
+		r->prefs.tileOrder
+	), r->prefs.pixelOrder);
 	r->state.current_set = &set;
 
 	logr(info, "%u x %u tiles\n", r->prefs.tileWidth, r->prefs.tileHeight);
@@ -246,6 +256,7 @@ static cJSON *startRender(int connectionSocket, size_t thread_limit) {
 
 	// And then compute a single top-level BVH that contains all the objects
 	update_toplevel_bvh(r->scene);
+	update_light_list(r->scene);
 
 	for (size_t i = 0; i < set.tiles.count; ++i)
 		set.tiles.items[i].total_samples = r->prefs.sampleCount;
@@ -257,10 +268,17 @@ static cJSON *startRender(int connectionSocket, size_t thread_limit) {
 		r->prefs.threads = set.tiles.count;
 	}
 
+	int *cores = NULL;
+	if (r->prefs.pin_threads) {
+		cores = calloc(threadCount, sizeof(*cores));
+		sys_get_spread_cores(cores, threadCount);
+	}
+
 	//Create render threads (Nonblocking)
 	for (size_t t = 0; t < threadCount; ++t) {
 		workerThreadStates[t] = (struct workerThreadState){
 				.thread_num = t,
+				.core = cores ? cores[t] : -1,
 				.connectionSocket = connectionSocket,
 				.socketMutex = g_worker_socket_mutex,
 				.renderer = g_worker_renderer,
@@ -270,6 +288,7 @@ static cJSON *startRender(int connectionSocket, size_t thread_limit) {
 		if (thread_start(&worker_threads[t]))
 			logr(error, "Failed to create a crThread.\n");
 	}
+	if (cores) free(cores);
 	
 	int pauser = 0;
 	while (g_worker_renderer->state.s == r_rendering) {
@@ -340,7 +359,7 @@ static cJSON *processCommand(int connectionSocket, cJSON *json, size_t thread_li
 			break;
 		case 3:
 			// startRender contains worker event loop and blocks until render completion.
-			return startRender(connectionSocket, thread_limit);
+			return startRender(connectionSocket, json, thread_limit);
 			break;
 		default:
 			return errorResponse("Unknown command");
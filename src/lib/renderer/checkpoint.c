@@ -0,0 +1,316 @@
+//
+//  checkpoint.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../../includes.h"
+#include "checkpoint.h"
+
+#include "renderer.h"
+#include "instance.h"
+#include <datatypes/tile.h>
+#include <datatypes/scene.h>
+#include <datatypes/mesh.h>
+#include <datatypes/sphere.h>
+#include <datatypes/camera.h>
+#include <common/hashtable.h>
+#include <common/node_parse.h>
+#include <common/texture.h>
+#include <common/fileio.h>
+#include <common/logging.h>
+#include <common/cr_string.h>
+#include <common/platform/mutex.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#define CHECKPOINT_MAGIC "CRCP"
+#define CHECKPOINT_VERSION 3
+
+struct checkpoint_header {
+	char magic[4];
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t channels;
+	uint32_t tile_width;
+	uint32_t tile_height;
+	uint32_t tile_count;
+	uint32_t scene_hash;
+	uint32_t aov_mask; // AOV buffers stored after the color buffer, in enum cr_aov order
+	uint64_t sample_count;
+};
+
+struct checkpoint_tile {
+	int32_t begin_x;
+	int32_t begin_y;
+	int32_t end_x;
+	int32_t end_y;
+	uint64_t completed_samples;
+};
+
+#define HASH(h, x) hashBytes(h, &(x), sizeof(x))
+
+uint32_t checkpoint_scene_hash(const struct renderer *r) {
+	uint32_t h = hashInit();
+	// Settings that change what ends up in the accumulation buffer. Sample count
+	// isn't one of them, it can be raised or lowered when resuming.
+	h = HASH(h, r->prefs.bounces);
+	h = HASH(h, r->prefs.path_guiding);
+	h = HASH(h, r->prefs.selected_camera);
+	const struct world *scene = r->scene;
+	if (!scene) return h;
+
+	if (r->prefs.selected_camera < scene->cameras.count) {
+		const struct camera *cam = &scene->cameras.items[r->prefs.selected_camera];
+		h = HASH(h, cam->FOV);
+		h = HASH(h, cam->focal_length);
+		h = HASH(h, cam->focus_distance);
+		h = HASH(h, cam->fstops);
+		h = HASH(h, cam->aperture);
+		h = HASH(h, cam->sensor_size);
+		h = HASH(h, cam->composite);
+		h = HASH(h, cam->time);
+		h = HASH(h, cam->is_blender);
+	}
+
+	for (size_t m = 0; m < scene->meshes.count; ++m) {
+		const struct mesh *mesh = &scene->meshes.items[m];
+		h = hashBytes(h, mesh->vbuf.vertices.items, mesh->vbuf.vertices.count * sizeof(*mesh->vbuf.vertices.items));
+		h = hashBytes(h, mesh->vbuf.normals.items, mesh->vbuf.normals.count * sizeof(*mesh->vbuf.normals.items));
+		h = hashBytes(h, mesh->vbuf.texture_coords.items, mesh->vbuf.texture_coords.count * sizeof(*mesh->vbuf.texture_coords.items));
+		for (size_t p = 0; p < mesh->polygons.count; ++p) {
+			const struct poly *poly = &mesh->polygons.items[p];
+			const unsigned material = poly->materialIndex;
+			h = HASH(h, poly->vertexIndex);
+			h = HASH(h, poly->normalIndex);
+			h = HASH(h, poly->textureIndex);
+			h = HASH(h, material);
+			h = HASH(h, poly->hasNormals);
+		}
+	}
+	for (size_t s = 0; s < scene->spheres.count; ++s) {
+		h = HASH(h, scene->spheres.items[s].radius);
+	}
+	for (size_t i = 0; i < scene->instances.count; ++i) {
+		const struct instance *instance = &scene->instances.items[i];
+		const bool is_mesh = instance_type(instance) == CR_I_MESH;
+		h = HASH(h, instance->composite);
+		h = HASH(h, instance->object_idx);
+		h = HASH(h, instance->bbuf_idx);
+		h = HASH(h, is_mesh);
+	}
+	for (size_t b = 0; b < scene->shader_buffers.count; ++b) {
+		const struct bsdf_buffer *buf = &scene->shader_buffers.items[b];
+		h = HASH(h, buf->descriptions.count);
+		for (size_t d = 0; d < buf->descriptions.count; ++d) {
+			h = cr_shader_node_hash(h, buf->descriptions.items[d]);
+		}
+	}
+	h = cr_shader_node_hash(h, scene->bg_desc);
+	return h;
+}
+
+#undef HASH
+
+// AOVs accumulate alongside the color buffer, and the denoiser guides are AOVs too,
+// so every allocated one is saved. Returns the total amount of floats they hold.
+static size_t aov_float_count(const struct renderer *r, const struct texture *buf) {
+	size_t count = 0;
+	for (size_t i = 0; i < cr_aov_count; ++i) {
+		if (!(r->state.aov_mask & (1 << i))) continue;
+		const struct texture *aov = r->state.aovs[i];
+		if (!aov || aov->precision != float_p || aov->width != buf->width || aov->height != buf->height) return SIZE_MAX;
+		count += aov->width * aov->height * aov->channels;
+	}
+	return count;
+}
+
+bool checkpoint_save(const char *path, const struct renderer *r, struct tile_set *set, const struct texture *buf, uint32_t scene_hash) {
+	if (!path || !r || !set || !buf || buf->precision != float_p) return false;
+	if (aov_float_count(r, buf) == SIZE_MAX) return false;
+
+	struct checkpoint_header header = {
+		.magic = CHECKPOINT_MAGIC,
+		.version = CHECKPOINT_VERSION,
+		.width = buf->width,
+		.height = buf->height,
+		.channels = buf->channels,
+		.tile_width = r->prefs.tileWidth,
+		.tile_height = r->prefs.tileHeight,
+		.scene_hash = scene_hash,
+		.aov_mask = r->state.aov_mask,
+		.sample_count = r->prefs.sampleCount,
+	};
+
+	// Snapshot tile states. Only finished tiles are stable, the rest will be redone.
+	mutex_lock(set->tile_mutex);
+	header.tile_count = set->tiles.count;
+	struct checkpoint_tile *tiles = calloc(set->tiles.count, sizeof(*tiles));
+	for (size_t t = 0; t < set->tiles.count; ++t) {
+		const struct render_tile *tile = &set->tiles.items[t];
+		tiles[t] = (struct checkpoint_tile){
+			.begin_x = tile->begin.x,
+			.begin_y = tile->begin.y,
+			.end_x = tile->end.x,
+			.end_y = tile->end.y,
+			.completed_samples = tile->state == finished ? tile->completed_samples : 0,
+		};
+	}
+	mutex_release(set->tile_mutex);
+
+	char *temp_path = stringConcat(path, ".tmp");
+	FILE *f = fopen(temp_path, "wb");
+	if (!f) {
+		logr(warning, "Couldn't open '%s' for writing a checkpoint\n", temp_path);
+		free(temp_path);
+		free(tiles);
+		return false;
+	}
+	const size_t px_count = buf->width * buf->height * buf->channels;
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	ok = ok && fwrite(tiles, sizeof(*tiles), header.tile_count, f) == header.tile_count;
+	ok = ok && fwrite(buf->data.float_p, sizeof(float), px_count, f) == px_count;
+	for (size_t i = 0; i < cr_aov_count; ++i) {
+		if (!(header.aov_mask & (1 << i))) continue;
+		const struct texture *aov = r->state.aovs[i];
+		const size_t aov_count = aov->width * aov->height * aov->channels;
+		ok = ok && fwrite(aov->data.float_p, sizeof(float), aov_count, f) == aov_count;
+	}
+	ok = !fclose(f) && ok;
+	free(tiles);
+
+	if (ok) {
+#ifdef WINDOWS
+		remove(path);
+#endif
+		ok = !rename(temp_path, path);
+	}
+	if (!ok) {
+		logr(warning, "Failed to write checkpoint to '%s'\n", path);
+		remove(temp_path);
+	}
+	free(temp_path);
+	return ok;
+}
+
+bool checkpoint_load(const char *path, struct renderer *r, struct tile_set *set, struct texture *buf, uint32_t scene_hash) {
+	if (!path || !r || !set || !buf || buf->precision != float_p) return false;
+	file_data file = file_load(path);
+	if (!file.count) {
+		logr(warning, "Couldn't load checkpoint '%s'\n", path);
+		return false;
+	}
+	bool ok = false;
+	struct render_tile **grid = NULL;
+	struct render_tile **matched = NULL;
+	struct checkpoint_header header;
+	if (file.count < sizeof(header)) goto done;
+	memcpy(&header, file.items, sizeof(header));
+	if (memcmp(header.magic, CHECKPOINT_MAGIC, 4) || header.version != CHECKPOINT_VERSION) {
+		logr(warning, "'%s' is not a c-ray checkpoint\n", path);
+		goto done;
+	}
+	if (header.width != buf->width || header.height != buf->height || header.channels != buf->channels) {
+		logr(warning, "Checkpoint is for a %ux%u render, can't resume a %zux%zu one\n", header.width, header.height, buf->width, buf->height);
+		goto done;
+	}
+	if (header.scene_hash != scene_hash) {
+		logr(warning, "Checkpoint '%s' was rendered from a different scene or settings\n", path);
+		goto done;
+	}
+	if (header.aov_mask != r->state.aov_mask) {
+		logr(warning, "Checkpoint was rendered with different AOV or denoiser settings\n");
+		goto done;
+	}
+	const size_t aov_count = aov_float_count(r, buf);
+	if (aov_count == SIZE_MAX) goto done;
+	const size_t px_count = buf->width * buf->height * buf->channels;
+	const size_t expected = sizeof(header) + header.tile_count * sizeof(struct checkpoint_tile) + (px_count + aov_count) * sizeof(float);
+	if (file.count != expected || !header.tile_width || !header.tile_height) {
+		logr(warning, "Checkpoint '%s' is truncated or corrupt\n", path);
+		goto done;
+	}
+	if (header.sample_count != r->prefs.sampleCount) {
+		logr(warning, "Checkpoint was rendered with %" PRIu64 " samples, continuing with %zu\n", header.sample_count, r->prefs.sampleCount);
+	}
+	if (header.tile_width != r->prefs.tileWidth || header.tile_height != r->prefs.tileHeight) {
+		logr(info, "Using %ux%u tiles from checkpoint\n", header.tile_width, header.tile_height);
+		r->prefs.tileWidth = header.tile_width;
+		r->prefs.tileHeight = header.tile_height;
+		r->prefs.tile_auto = false;
+		tile_set_retile(set, tile_quantize(buf->width, buf->height, r->prefs.tileWidth, r->prefs.tileHeight, r->prefs.tileOrder));
+		for (size_t t = 0; t < set->tiles.count; ++t)
+			set->tiles.items[t].total_samples = r->prefs.sampleCount;
+	}
+	if (header.tile_count != set->tiles.count) {
+		logr(warning, "Checkpoint has %u tiles, expected %zu\n", header.tile_count, set->tiles.count);
+		goto done;
+	}
+
+	// Tile order may differ between runs (random order, for instance), so match tiles by position
+	const size_t tiles_x = (buf->width + header.tile_width - 1) / header.tile_width;
+	const size_t tiles_y = (buf->height + header.tile_height - 1) / header.tile_height;
+	grid = calloc(tiles_x * tiles_y, sizeof(*grid));
+	for (size_t t = 0; t < set->tiles.count; ++t) {
+		struct render_tile *tile = &set->tiles.items[t];
+		grid[(tile->begin.y / header.tile_height) * tiles_x + tile->begin.x / header.tile_width] = tile;
+	}
+	// Match everything up front, so we don't leave the set half-modified if something is off.
+	const byte *records = file.items + sizeof(header);
+	matched = calloc(header.tile_count, sizeof(*matched));
+	for (size_t t = 0; t < header.tile_count; ++t) {
+		struct checkpoint_tile rec;
+		memcpy(&rec, records + t * sizeof(rec), sizeof(rec));
+		const size_t gx = rec.begin_x >= 0 ? rec.begin_x / header.tile_width : tiles_x;
+		const size_t gy = rec.begin_y >= 0 ? rec.begin_y / header.tile_height : tiles_y;
+		struct render_tile *tile = gx < tiles_x && gy < tiles_y ? grid[gy * tiles_x + gx] : NULL;
+		if (!tile || tile->begin.x != rec.begin_x || tile->begin.y != rec.begin_y || tile->end.x != rec.end_x || tile->end.y != rec.end_y) {
+			logr(warning, "Checkpoint tiles don't match the current render\n");
+			goto done;
+		}
+		matched[t] = tile;
+	}
+	for (size_t t = 0; t < header.tile_count; ++t) {
+		struct checkpoint_tile rec;
+		memcpy(&rec, records + t * sizeof(rec), sizeof(rec));
+		matched[t]->completed_samples = min(rec.completed_samples, r->prefs.sampleCount);
+	}
+	const byte *pixels = file.items + sizeof(header) + header.tile_count * sizeof(struct checkpoint_tile);
+	memcpy(buf->data.float_p, pixels, px_count * sizeof(float));
+	pixels += px_count * sizeof(float);
+	for (size_t i = 0; i < cr_aov_count; ++i) {
+		if (!(header.aov_mask & (1 << i))) continue;
+		struct texture *aov = r->state.aovs[i];
+		const size_t count = aov->width * aov->height * aov->channels;
+		memcpy(aov->data.float_p, pixels, count * sizeof(float));
+		pixels += count * sizeof(float);
+	}
+
+	// Move completed tiles to the front, tile_next() hands out the rest in order.
+	struct render_tile_arr reordered = { 0 };
+	for (int pass = 0; pass < 2; ++pass) {
+		for (size_t t = 0; t < set->tiles.count; ++t) {
+			struct render_tile tile = set->tiles.items[t];
+			const bool done = tile.completed_samples >= r->prefs.sampleCount;
+			if (done != (pass == 0)) continue;
+			tile.state = done ? finished : ready_to_render;
+			tile.index = reordered.count;
+			render_tile_arr_add(&reordered, tile);
+		}
+	}
+	render_tile_arr_free(&set->tiles);
+	set->tiles = reordered;
+	set->finished = 0;
+	while (set->finished < set->tiles.count && set->tiles.items[set->finished].state == finished) set->finished++;
+	logr(info, "Resuming from checkpoint '%s', %zu/%zu tiles done\n", path, set->finished, set->tiles.count);
+	ok = true;
+done:
+	if (grid) free(grid);
+	if (matched) free(matched);
+	file_free(&file);
+	return ok;
+}
@@ -0,0 +1,38 @@
+//
+//  checkpoint.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct renderer;
+struct tile_set;
+struct texture;
+
+// Checkpoints hold the float accumulation buffer, the AOV buffers (including the
+// denoiser guides), and the amount of completed samples for every tile, so a long
+// offline render can pick up where it left off.
+// Tiles that were in flight are stored as not started, since some of their pixels
+// may already hold the next sample.
+
+/// Hash the scene contents and the settings that affect the rendered image.
+/// Stored in checkpoints, so a render isn't resumed on top of a different scene.
+/// Walks all geometry, so compute it once per render.
+uint32_t checkpoint_scene_hash(const struct renderer *r);
+
+/// Write a checkpoint of the current render state to path.
+/// The file is written next to path first, and then renamed over it.
+/// @return true on success
+bool checkpoint_save(const char *path, const struct renderer *r, struct tile_set *set, const struct texture *buf, uint32_t scene_hash);
+
+/// Restore render state from a checkpoint written by checkpoint_save()
+/// If the tile dimensions in the checkpoint differ from the current prefs,
+/// set is quantized again to match it.
+/// @return true if the checkpoint matched the current render and scene_hash, and was loaded
+bool checkpoint_load(const char *path, struct renderer *r, struct tile_set *set, struct texture *buf, uint32_t scene_hash);
@@ -0,0 +1,145 @@
+//
+//  denoise.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../../includes.h"
+#include "denoise.h"
+
+#include <common/texture.h>
+#include <common/logging.h>
+#include <common/timer.h>
+#include <common/platform/thread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define DENOISE_ITERATIONS 5
+#define SIGMA_COLOR  0.5f
+#define SIGMA_NORMAL 0.3f
+#define SIGMA_ALBEDO 0.1f
+// Albedo is clamped to this before dividing it out, so emitters and black surfaces stay sane
+#define MIN_ALBEDO   0.01f
+
+static const float kernel[5] = { 1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f };
+
+struct denoise_pass {
+	const float *in;
+	float *out;
+	const float *albedo;
+	const float *normal;
+	size_t width;
+	size_t height;
+	int step;
+	float inv_sigma_color_sq;
+	size_t y_begin;
+	size_t y_end;
+};
+
+static inline float dist_sq(const float *a, const float *b) {
+	const float d0 = a[0] - b[0];
+	const float d1 = a[1] - b[1];
+	const float d2 = a[2] - b[2];
+	return d0 * d0 + d1 * d1 + d2 * d2;
+}
+
+// One à-trous iteration over rows [y_begin, y_end). Buffers hold demodulated color.
+static void *filter_rows(void *arg) {
+	const struct denoise_pass *p = arg;
+	const float inv_sigma_normal_sq = 1.0f / (SIGMA_NORMAL * SIGMA_NORMAL);
+	const float inv_sigma_albedo_sq = 1.0f / (SIGMA_ALBEDO * SIGMA_ALBEDO);
+	for (size_t y = p->y_begin; y < p->y_end; ++y) {
+		for (size_t x = 0; x < p->width; ++x) {
+			const size_t center = (y * p->width + x) * 4;
+			// Edge-stopping on color compares remodulated values, the demodulated ones blow up on dark albedo
+			float c_center[3];
+			for (int c = 0; c < 3; ++c) c_center[c] = p->in[center + c] * p->albedo[center + c];
+			float sum[3] = { 0.0f, 0.0f, 0.0f };
+			float weight_sum = 0.0f;
+			for (int ky = -2; ky <= 2; ++ky) {
+				const long sy = (long)y + ky * p->step;
+				if (sy < 0 || sy >= (long)p->height) continue;
+				for (int kx = -2; kx <= 2; ++kx) {
+					const long sx = (long)x + kx * p->step;
+					if (sx < 0 || sx >= (long)p->width) continue;
+					const size_t other = ((size_t)sy * p->width + (size_t)sx) * 4;
+					float c_other[3];
+					for (int c = 0; c < 3; ++c) c_other[c] = p->in[other + c] * p->albedo[other + c];
+					const float w_color = dist_sq(c_center, c_other) * p->inv_sigma_color_sq;
+					const float w_normal = dist_sq(&p->normal[center], &p->normal[other]) * inv_sigma_normal_sq;
+					const float w_albedo = dist_sq(&p->albedo[center], &p->albedo[other]) * inv_sigma_albedo_sq;
+					const float w = kernel[kx + 2] * kernel[ky + 2] * expf(-(w_color + w_normal + w_albedo));
+					for (int c = 0; c < 3; ++c) sum[c] += p->in[other + c] * w;
+					weight_sum += w;
+				}
+			}
+			for (int c = 0; c < 3; ++c) p->out[center + c] = sum[c] / weight_sum;
+			p->out[center + 3] = p->in[center + 3];
+		}
+	}
+	return NULL;
+}
+
+void denoise(struct texture *out, const struct texture *color, const struct texture *albedo, const struct texture *normal, size_t threads) {
+	if (!out || !color || !albedo || !normal) return;
+	const size_t width = color->width;
+	const size_t height = color->height;
+	const size_t count = width * height * 4;
+	if (!count) return;
+	if (threads < 1) threads = 1;
+	if (threads > height) threads = height;
+	struct timeval timer;
+	timer_start(&timer);
+
+	// Demodulate. The clamped albedo is kept around for remodulation and color weights.
+	float *clamped_albedo = malloc(count * sizeof(float));
+	float *ping = malloc(count * sizeof(float));
+	float *pong = malloc(count * sizeof(float));
+	for (size_t i = 0; i < count; ++i) {
+		clamped_albedo[i] = max(albedo->data.float_p[i], MIN_ALBEDO);
+		ping[i] = (i & 3) == 3 ? color->data.float_p[i] : color->data.float_p[i] / clamped_albedo[i];
+	}
+
+	struct denoise_pass *passes = calloc(threads, sizeof(*passes));
+	struct cr_thread *workers = calloc(threads, sizeof(*workers));
+	float sigma_color = SIGMA_COLOR;
+	for (int i = 0; i < DENOISE_ITERATIONS; ++i) {
+		for (size_t t = 0; t < threads; ++t) {
+			passes[t] = (struct denoise_pass){
+				.in = ping,
+				.out = pong,
+				.albedo = clamped_albedo,
+				.normal = normal->data.float_p,
+				.width = width,
+				.height = height,
+				.step = 1 << i,
+				.inv_sigma_color_sq = 1.0f / (sigma_color * sigma_color),
+				.y_begin = height * t / threads,
+				.y_end = height * (t + 1) / threads,
+			};
+			workers[t] = (struct cr_thread){ .thread_fn = filter_rows, .user_data = &passes[t] };
+			if (t) thread_start(&workers[t]);
+		}
+		// The calling thread takes the first band
+		filter_rows(&passes[0]);
+		for (size_t t = 1; t < threads; ++t) thread_wait(&workers[t]);
+		float *tmp = ping;
+		ping = pong;
+		pong = tmp;
+		// Coarser scales only smooth what's left over, so tighten the color term as we go
+		sigma_color *= 0.5f;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		out->data.float_p[i] = (i & 3) == 3 ? ping[i] : ping[i] * clamped_albedo[i];
+	}
+	free(workers);
+	free(passes);
+	free(ping);
+	free(pong);
+	free(clamped_albedo);
+	logr(debug, "Denoised %zux%zu in %lums\n", width, height, timer_get_ms(timer));
+}
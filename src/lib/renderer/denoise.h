@@ -0,0 +1,21 @@
+//
+//  denoise.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stddef.h>
+
+struct texture;
+
+/// Edge-avoiding à-trous wavelet filter (Dammertz et al. 2010), guided by first hit
+/// albedo and normal buffers. Color is divided by albedo before filtering, so texture
+/// detail survives, and multiplied back in afterwards.
+/// All buffers have to be 4 channel float textures of the same size.
+/// @param out Receives the filtered image
+/// @param threads Amount of threads to filter with
+void denoise(struct texture *out, const struct texture *color, const struct texture *albedo, const struct texture *normal, size_t threads);
@@ -0,0 +1,142 @@
+//
+//  envmap.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../../includes.h"
+#include "envmap.h"
+
+#include <c-ray/c-ray.h>
+#include <datatypes/scene.h>
+#include <datatypes/hitrecord.h>
+#include <nodes/bsdfnode.h>
+#include <common/logging.h>
+
+// Image backgrounds may have a small, very bright sun in them, so those get a finer table.
+#define ENV_IMAGE_WIDTH 1024
+#define ENV_IMAGE_HEIGHT 512
+#define ENV_PROCEDURAL_WIDTH 128
+#define ENV_PROCEDURAL_HEIGHT 64
+
+// The table has its own lat-long mapping, with theta measured from +Y. It doesn't
+// have to match whatever mapping the background uses, since radiance is always
+// evaluated through the background node.
+static inline struct vector uv_to_dir(float u, float v) {
+	const float phi = u * 2.0f * PI;
+	const float theta = v * PI;
+	const float sin_theta = sinf(theta);
+	return (struct vector){ sin_theta * cosf(phi), cosf(theta), sin_theta * sinf(phi) };
+}
+
+static inline float luminance(const struct color c) {
+	return 0.2126f * c.red + 0.7152f * c.green + 0.0722f * c.blue;
+}
+
+static bool is_image_background(const struct cr_shader_node *desc) {
+	return desc && desc->type == cr_bsdf_background && desc->arg.background.color && desc->arg.background.color->type == cr_cn_image;
+}
+
+// Builds a normalized cdf with count + 1 entries from func, returns the integral of func over [0,1]
+static float build_cdf(const float *func, size_t count, float *cdf) {
+	cdf[0] = 0.0f;
+	for (size_t i = 1; i < count + 1; ++i) {
+		cdf[i] = cdf[i - 1] + func[i - 1] / (float)count;
+	}
+	const float integral = cdf[count];
+	if (integral <= 0.0f) {
+		for (size_t i = 1; i < count + 1; ++i) cdf[i] = (float)i / (float)count;
+	} else {
+		for (size_t i = 1; i < count + 1; ++i) cdf[i] /= integral;
+	}
+	return integral;
+}
+
+// Returns the continuous coordinate in [0,1), and the cell it falls into in idx
+static float sample_cdf(const float *cdf, size_t count, float u, size_t *idx) {
+	size_t lo = 0, hi = count;
+	while (lo + 1 < hi) {
+		const size_t mid = (lo + hi) / 2;
+		if (cdf[mid] <= u) lo = mid;
+		else hi = mid;
+	}
+	*idx = lo;
+	const float width = cdf[lo + 1] - cdf[lo];
+	const float du = width > 0.0f ? (u - cdf[lo]) / width : 0.0f;
+	return min(((float)lo + du) / (float)count, 0.99999994f);
+}
+
+bool env_map_build(struct env_map *env, const struct world *scene) {
+	*env = (struct env_map){ 0 };
+	if (!scene->background) return false;
+	const bool image = is_image_background(scene->bg_desc);
+	env->width = image ? ENV_IMAGE_WIDTH : ENV_PROCEDURAL_WIDTH;
+	env->height = image ? ENV_IMAGE_HEIGHT : ENV_PROCEDURAL_HEIGHT;
+	env->source = scene->background;
+	env->func = calloc(env->width * env->height, sizeof(*env->func));
+	env->conditional_cdf = calloc((env->width + 1) * env->height, sizeof(*env->conditional_cdf));
+	env->marginal_cdf = calloc(env->height + 1, sizeof(*env->marginal_cdf));
+	float *marginal_func = calloc(env->height, sizeof(*marginal_func));
+
+	sampler *sampler = sampler_new();
+	sampler_init(sampler, Random, 0, 1, 0);
+	for (size_t y = 0; y < env->height; ++y) {
+		const float sin_theta = sinf(((float)y + 0.5f) / (float)env->height * PI);
+		for (size_t x = 0; x < env->width; ++x) {
+			// Average a few points per cell, so small features between cell centers aren't missed
+			float sum = 0.0f;
+			for (int s = 0; s < 4; ++s) {
+				const float u = ((float)x + 0.25f + 0.5f * (s & 1)) / (float)env->width;
+				const float v = ((float)y + 0.25f + 0.5f * (s >> 1)) / (float)env->height;
+				struct lightRay ray = { .direction = uv_to_dir(u, v) };
+				const struct hitRecord record = { .incident = &ray, .instIndex = -1 };
+				sum += luminance(scene->background->sample(scene->background, sampler, &record).weight);
+			}
+			env->func[y * env->width + x] = max(sum / 4.0f, 0.0f) * sin_theta;
+		}
+		marginal_func[y] = build_cdf(&env->func[y * env->width], env->width, &env->conditional_cdf[y * (env->width + 1)]);
+	}
+	sampler_destroy(sampler);
+	env->integral = build_cdf(marginal_func, env->height, env->marginal_cdf);
+	free(marginal_func);
+	if (env->integral <= 0.0f) {
+		env_map_free(env);
+		return false;
+	}
+	logr(debug, "Built %zux%zu environment sampling table\n", env->width, env->height);
+	return true;
+}
+
+void env_map_free(struct env_map *env) {
+	if (!env) return;
+	if (env->func) free(env->func);
+	if (env->conditional_cdf) free(env->conditional_cdf);
+	if (env->marginal_cdf) free(env->marginal_cdf);
+	*env = (struct env_map){ 0 };
+}
+
+float env_map_sample(const struct env_map *env, sampler *sampler, struct vector *dir) {
+	if (!env->func) return 0.0f;
+	size_t x, y;
+	const float v = sample_cdf(env->marginal_cdf, env->height, sampler_dimension(sampler), &y);
+	const float u = sample_cdf(&env->conditional_cdf[y * (env->width + 1)], env->width, sampler_dimension(sampler), &x);
+	const float sin_theta = sinf(v * PI);
+	if (sin_theta <= 0.0f) return 0.0f;
+	*dir = uv_to_dir(u, v);
+	return env->func[y * env->width + x] / env->integral / (2.0f * PI * PI * sin_theta);
+}
+
+float env_map_pdf(const struct env_map *env, const struct vector dir) {
+	if (!env->func) return 0.0f;
+	const struct vector d = vec_normalize(dir);
+	const float theta = acosf(clamp(d.y, -1.0f, 1.0f));
+	float phi = atan2f(d.z, d.x);
+	if (phi < 0.0f) phi += 2.0f * PI;
+	const float sin_theta = sinf(theta);
+	if (sin_theta <= 0.0f) return 0.0f;
+	const size_t x = min((size_t)(phi / (2.0f * PI) * env->width), env->width - 1);
+	const size_t y = min((size_t)(theta / PI * env->height), env->height - 1);
+	return env->func[y * env->width + x] / env->integral / (2.0f * PI * PI * sin_theta);
+}
@@ -0,0 +1,44 @@
+//
+//  envmap.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <common/vector.h>
+#include "samplers/sampler.h"
+
+struct bsdfNode;
+struct world;
+
+// Piecewise constant distribution over a lat-long table of the background,
+// used to importance sample environment lighting.
+// The table is filled by evaluating the background node itself, so pose,
+// strength and any color graph are taken into account, whatever it is made of.
+struct env_map {
+	const struct bsdfNode *source; // Background node this was tabulated from
+	size_t width;
+	size_t height;
+	float *func; // Luminance * sin(theta) for each cell
+	float *conditional_cdf; // (width + 1) entries per row
+	float *marginal_cdf; // height + 1 entries
+	float integral;
+};
+
+/// Tabulate scene->background. Image backgrounds get a finer table than procedural ones.
+/// @return false if the background is black everywhere, nothing to sample then.
+bool env_map_build(struct env_map *env, const struct world *scene);
+
+void env_map_free(struct env_map *env);
+
+/// Pick a direction proportional to background luminance
+/// @return Solid angle pdf of dir, 0 if nothing could be sampled
+float env_map_sample(const struct env_map *env, sampler *sampler, struct vector *dir);
+
+/// Solid angle pdf of env_map_sample() picking direction dir
+float env_map_pdf(const struct env_map *env, const struct vector dir);
@@ -0,0 +1,271 @@
+//
+//  guiding.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../../includes.h"
+#include "guiding.h"
+
+#include <common/logging.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Quadrants holding more than this fraction of a quadtree's energy get subdivided
+#define DTREE_SPLIT_FRACTION 0.01f
+#define DTREE_MAX_DEPTH 16
+// Spatial leaves that recorded more than this many vertices in an iteration get split in half
+#define STREE_SPLIT_SAMPLES 4000
+#define STREE_MAX_DEPTH 24
+
+// Cylindrical mapping: x follows cos(theta) around +Y, y follows phi
+static inline struct coord dir_to_square(const struct vector dir) {
+	const float u = clamp((dir.y + 1.0f) * 0.5f, 0.0f, 0.99999994f);
+	float v = (atan2f(dir.z, dir.x) + PI) * (1.0f / (2.0f * PI));
+	v = clamp(v, 0.0f, 0.99999994f);
+	return (struct coord){ u, v };
+}
+
+static inline struct vector square_to_dir(const struct coord c) {
+	const float cos_theta = 2.0f * c.x - 1.0f;
+	const float sin_theta = sqrtf(max(0.0f, 1.0f - cos_theta * cos_theta));
+	const float phi = 2.0f * PI * c.y - PI;
+	return (struct vector){ sin_theta * cosf(phi), cos_theta, sin_theta * sinf(phi) };
+}
+
+// Pick the quadrant c falls into, and rescale c into it
+static inline int quadrant(struct coord *c) {
+	int q = 0;
+	if (c->x >= 0.5f) { q |= 1; c->x -= 0.5f; }
+	if (c->y >= 0.5f) { q |= 2; c->y -= 0.5f; }
+	c->x *= 2.0f;
+	c->y *= 2.0f;
+	return q;
+}
+
+struct path_guide *guide_new(const struct boundingBox bounds) {
+	struct path_guide *guide = calloc(1, sizeof(*guide));
+	guide_dnode_arr_add(&guide->dnodes, (struct guide_dnode){ 0 }); // Placeholder
+	const uint32_t root = guide_dnode_arr_add(&guide->dnodes, (struct guide_dnode){ 0 });
+	guide_snode_arr_add(&guide->snodes, (struct guide_snode){ .bbox = bounds, .droot = root });
+	return guide;
+}
+
+void guide_destroy(struct path_guide *guide) {
+	if (!guide) return;
+	guide_dnode_arr_free(&guide->dnodes);
+	guide_snode_arr_free(&guide->snodes);
+	free(guide);
+}
+
+void guide_splats_reset(struct guide_splats *splats, const struct path_guide *guide) {
+	if (splats->dnode_count != guide->dnodes.count) {
+		free(splats->energy);
+		splats->energy = malloc(guide->dnodes.count * 4 * sizeof(*splats->energy));
+		splats->dnode_count = guide->dnodes.count;
+	}
+	if (splats->snode_count != guide->snodes.count) {
+		free(splats->counts);
+		splats->counts = malloc(guide->snodes.count * sizeof(*splats->counts));
+		splats->snode_count = guide->snodes.count;
+	}
+	memset(splats->energy, 0, splats->dnode_count * 4 * sizeof(*splats->energy));
+	memset(splats->counts, 0, splats->snode_count * sizeof(*splats->counts));
+}
+
+void guide_splats_free(struct guide_splats *splats) {
+	free(splats->energy);
+	free(splats->counts);
+	*splats = (struct guide_splats){ 0 };
+}
+
+static uint32_t find_leaf(const struct path_guide *guide, const struct vector p) {
+	uint32_t idx = 0;
+	const struct guide_snode *node = &guide->snodes.items[idx];
+	while (node->child[0]) {
+		idx = node->child[vec_component(&p, node->axis) < node->split ? 0 : 1];
+		node = &guide->snodes.items[idx];
+	}
+	return idx;
+}
+
+void guide_record(const struct path_guide *guide, struct guide_splats *splats, const struct vector p, const struct vector dir, float radiance, float pdf) {
+	const uint32_t leaf = find_leaf(guide, p);
+	splats->counts[leaf]++;
+	if (!(radiance > 0.0f) || !(pdf > 0.0f) || isinf(radiance)) return;
+	struct coord c = dir_to_square(dir);
+	uint32_t idx = guide->snodes.items[leaf].droot;
+	for (;;) {
+		const int q = quadrant(&c);
+		const uint32_t child = guide->dnodes.items[idx].child[q];
+		if (!child) {
+			splats->energy[idx * 4 + q] += radiance / pdf;
+			return;
+		}
+		idx = child;
+	}
+}
+
+// Sum recorded energy into each quadrant of the subtree at idx
+static float quadrant_totals(const struct path_guide *guide, const float *energy, float *totals, uint32_t idx) {
+	float sum = 0.0f;
+	for (int q = 0; q < 4; ++q) {
+		const uint32_t child = guide->dnodes.items[idx].child[q];
+		totals[idx * 4 + q] = child ? quadrant_totals(guide, energy, totals, child) : energy[idx * 4 + q];
+		sum += totals[idx * 4 + q];
+	}
+	return sum;
+}
+
+// Rebuild the quadtree at old_idx into out, refining quadrants with a lot of energy and collapsing the rest
+static uint32_t rebuild_dtree(const struct path_guide *guide, const float *totals, float total, uint32_t old_idx, unsigned depth, struct guide_dnode_arr *out) {
+	const uint32_t idx = guide_dnode_arr_add(out, (struct guide_dnode){ 0 });
+	for (int q = 0; q < 4; ++q) {
+		const float energy = totals[old_idx * 4 + q];
+		out->items[idx].sum[q] = energy;
+		if (energy / total <= DTREE_SPLIT_FRACTION || depth >= DTREE_MAX_DEPTH) continue;
+		const uint32_t old_child = guide->dnodes.items[old_idx].child[q];
+		uint32_t child;
+		if (old_child) {
+			child = rebuild_dtree(guide, totals, total, old_child, depth + 1, out);
+		} else {
+			// New node, spread the energy evenly until the next iteration tells us more
+			child = guide_dnode_arr_add(out, (struct guide_dnode){ .sum = { energy / 4, energy / 4, energy / 4, energy / 4 } });
+		}
+		out->items[idx].child[q] = child;
+	}
+	return idx;
+}
+
+// Copy the quadtree at idx in src to out. src may be out, so two spatial leaves can diverge.
+static uint32_t copy_dtree(const struct guide_dnode_arr *src, uint32_t idx, struct guide_dnode_arr *out) {
+	const uint32_t new = guide_dnode_arr_add(out, src->items[idx]);
+	for (int q = 0; q < 4; ++q) {
+		if (!src->items[idx].child[q]) continue;
+		const uint32_t child = copy_dtree(src, src->items[idx].child[q], out);
+		out->items[new].child[q] = child;
+	}
+	return new;
+}
+
+void guide_update(struct path_guide *guide, struct guide_splats *splats, size_t splat_count) {
+	const size_t dcount = guide->dnodes.count;
+	const size_t scount = guide->snodes.count;
+	float *energy = calloc(dcount * 4, sizeof(*energy));
+	uint64_t *counts = calloc(scount, sizeof(*counts));
+	for (size_t s = 0; s < splat_count; ++s) {
+		for (size_t i = 0; i < dcount * 4; ++i) energy[i] += splats[s].energy[i];
+		for (size_t i = 0; i < scount; ++i) counts[i] += splats[s].counts[i];
+	}
+	float *totals = calloc(dcount * 4, sizeof(*totals));
+
+	struct guide_dnode_arr new_dnodes = { 0 };
+	guide_dnode_arr_add(&new_dnodes, (struct guide_dnode){ 0 }); // Placeholder
+	size_t splits = 0;
+	// Nodes split off in this loop are visited too, so busy regions can split several times per iteration
+	for (uint32_t s = 0; s < guide->snodes.count; ++s) {
+		struct guide_snode *leaf = &guide->snodes.items[s];
+		if (leaf->child[0]) continue;
+		if (s < scount) {
+			const float total = quadrant_totals(guide, energy, totals, leaf->droot);
+			// Hold on to what we had if nothing was recorded here
+			leaf->droot = total > 0.0f ?
+				rebuild_dtree(guide, totals, total, leaf->droot, 0, &new_dnodes) :
+				copy_dtree(&guide->dnodes, leaf->droot, &new_dnodes);
+		}
+		const uint32_t root = leaf->droot;
+
+		if (counts[s] <= STREE_SPLIT_SAMPLES || leaf->depth >= STREE_MAX_DEPTH) continue;
+		const struct boundingBox bbox = leaf->bbox;
+		const struct vector extent = vec_sub(bbox.max, bbox.min);
+		const int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+		const float split = vec_component(&bbox.min, axis) + vec_component(&extent, axis) * 0.5f;
+		struct boundingBox lo = bbox, hi = bbox;
+		switch (axis) {
+			case 0: lo.max.x = split; hi.min.x = split; break;
+			case 1: lo.max.y = split; hi.min.y = split; break;
+			default: lo.max.z = split; hi.min.z = split; break;
+		}
+		// Both halves start out with the parent's distribution
+		const uint32_t lo_root = root;
+		const uint32_t hi_root = copy_dtree(&new_dnodes, root, &new_dnodes);
+		const unsigned depth = leaf->depth + 1;
+		const uint32_t lo_idx = guide_snode_arr_add(&guide->snodes, (struct guide_snode){ .bbox = lo, .droot = lo_root, .depth = depth });
+		const uint32_t hi_idx = guide_snode_arr_add(&guide->snodes, (struct guide_snode){ .bbox = hi, .droot = hi_root, .depth = depth });
+		// Assume the samples were spread evenly between the halves
+		counts = realloc(counts, guide->snodes.count * sizeof(*counts));
+		counts[lo_idx] = counts[hi_idx] = counts[s] / 2;
+		leaf = &guide->snodes.items[s]; // May have moved
+		leaf->child[0] = lo_idx;
+		leaf->child[1] = hi_idx;
+		leaf->axis = axis;
+		leaf->split = split;
+		leaf->droot = 0;
+		splits++;
+	}
+	guide_dnode_arr_free(&guide->dnodes);
+	guide->dnodes = new_dnodes;
+	guide->iterations++;
+	logr(debug, "Path guiding iteration %zu: %zu spatial nodes (%zu new), %zu directional nodes\n",
+		guide->iterations, guide->snodes.count, splits * 2, guide->dnodes.count);
+	free(totals);
+	free(counts);
+	free(energy);
+}
+
+uint32_t guide_lookup(const struct path_guide *guide, const struct vector p) {
+	const uint32_t root = guide->snodes.items[find_leaf(guide, p)].droot;
+	const float *sum = guide->dnodes.items[root].sum;
+	return sum[0] + sum[1] + sum[2] + sum[3] > 0.0f ? root : 0;
+}
+
+float guide_sample(const struct path_guide *guide, uint32_t droot, sampler *sampler, struct vector *dir) {
+	float u = sampler_dimension(sampler);
+	struct coord origin = { 0.0f, 0.0f };
+	float size = 1.0f;
+	float pdf = 1.0f;
+	uint32_t idx = droot;
+	for (;;) {
+		const struct guide_dnode *node = &guide->dnodes.items[idx];
+		const float total = node->sum[0] + node->sum[1] + node->sum[2] + node->sum[3];
+		if (!(total > 0.0f)) return 0.0f;
+		// Reuse u for every level, like the light tree does
+		int q = 0;
+		float cdf = 0.0f;
+		for (; q < 3; ++q) {
+			if (u < cdf + node->sum[q] / total) break;
+			cdf += node->sum[q] / total;
+		}
+		const float p = node->sum[q] / total;
+		if (!(p > 0.0f)) return 0.0f;
+		u = min((u - cdf) / p, 0.99999994f);
+		pdf *= 4.0f * p;
+		size *= 0.5f;
+		if (q & 1) origin.x += size;
+		if (q & 2) origin.y += size;
+		if (!node->child[q]) break;
+		idx = node->child[q];
+	}
+	const struct coord c = { origin.x + size * sampler_dimension(sampler), origin.y + size * sampler_dimension(sampler) };
+	*dir = square_to_dir(c);
+	return pdf * (1.0f / (4.0f * PI));
+}
+
+float guide_pdf(const struct path_guide *guide, uint32_t droot, const struct vector dir) {
+	struct coord c = dir_to_square(dir);
+	float pdf = 1.0f;
+	uint32_t idx = droot;
+	for (;;) {
+		const struct guide_dnode *node = &guide->dnodes.items[idx];
+		const float total = node->sum[0] + node->sum[1] + node->sum[2] + node->sum[3];
+		if (!(total > 0.0f)) return 0.0f;
+		const int q = quadrant(&c);
+		pdf *= 4.0f * node->sum[q] / total;
+		if (!node->child[q]) break;
+		idx = node->child[q];
+	}
+	return pdf * (1.0f / (4.0f * PI));
+}
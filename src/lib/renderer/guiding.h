@@ -0,0 +1,80 @@
+//
+//  guiding.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <common/vector.h>
+#include <common/dyn_array.h>
+#include <datatypes/bbox.h>
+#include "samplers/sampler.h"
+
+// Path guiding after Müller et al. "Practical Path Guiding for Efficient Light-Transport
+// Simulation" (2017). Incident radiance is learned in an SD-tree: a binary tree that splits
+// space, with a directional quadtree in every leaf. The quadtrees live on the cylindrical
+// mapping of the sphere, which preserves area, so densities just differ by a factor of 4π.
+
+// Directional quadtree node. A quadrant either has a child node, or is a leaf.
+struct guide_dnode {
+	float sum[4]; // Learned energy per quadrant, for sampling
+	uint32_t child[4]; // 0 for leaf quadrants. Node 0 is a placeholder, so no real node is ever 0.
+};
+
+typedef struct guide_dnode guide_dnode;
+dyn_array_def(guide_dnode)
+
+struct guide_snode {
+	struct boundingBox bbox;
+	uint32_t child[2]; // 0 for leaves
+	uint32_t droot; // Directional quadtree root, leaves only
+	int axis; // Split plane, inner nodes only
+	float split;
+	unsigned depth;
+};
+
+typedef struct guide_snode guide_snode;
+dyn_array_def(guide_snode)
+
+struct path_guide {
+	struct guide_snode_arr snodes;
+	struct guide_dnode_arr dnodes;
+	size_t iterations; // Completed training iterations
+};
+
+// Per-thread recording buffers, merged into the guide between iterations,
+// so render threads don't have to synchronize while learning
+struct guide_splats {
+	float *energy; // Per directional node quadrant
+	uint32_t *counts; // Per spatial node
+	size_t dnode_count;
+	size_t snode_count;
+};
+
+struct path_guide *guide_new(const struct boundingBox bounds);
+void guide_destroy(struct path_guide *guide);
+
+/// Size splats for the current topology of guide, and zero them
+void guide_splats_reset(struct guide_splats *splats, const struct path_guide *guide);
+void guide_splats_free(struct guide_splats *splats);
+
+/// Record radiance arriving at p from direction dir, picked with density pdf
+void guide_record(const struct path_guide *guide, struct guide_splats *splats, const struct vector p, const struct vector dir, float radiance, float pdf);
+
+/// Fold the per-thread recordings into the sampling distribution, and refine the trees
+void guide_update(struct path_guide *guide, struct guide_splats *splats, size_t splat_count);
+
+/// Directional quadtree for shading point p, or 0 if nothing was learned there yet
+uint32_t guide_lookup(const struct path_guide *guide, const struct vector p);
+
+/// Draw a direction from the distribution rooted at droot, returns its solid angle density
+float guide_sample(const struct path_guide *guide, uint32_t droot, sampler *sampler, struct vector *dir);
+
+/// Solid angle density of guide_sample() picking dir
+float guide_pdf(const struct path_guide *guide, uint32_t droot, const struct vector dir);
@@ -38,6 +38,18 @@ static inline struct coord getTexMapSphere(const struct hitRecord *isect) {
 	return (struct coord){ u, v };
 }
 
+// Width of the incident ray cone at the hit, in texture space, given how many uv units a unit of world distance spans there.
+static inline float getUVFootprint(const struct lightRay *ray, const struct hitRecord *isect, float uv_per_unit) {
+	const float width = ray->cone_width + ray->cone_spread * vec_distance_to(ray->start, isect->hitPoint);
+	// The footprint stretches out at grazing angles. Clamp that, one isotropic lookup would blur it all.
+	const float cosine = max(fabsf(vec_dot(ray->direction, vec_normalize(isect->surfaceNormal))), 0.2f);
+	return width * uv_per_unit / cosine;
+}
+
+static inline bool hasCone(const struct lightRay *ray) {
+	return ray->cone_width > 0.0f || ray->cone_spread > 0.0f;
+}
+
 static bool intersectSphere(const struct instance *instance, const struct lightRay *ray, struct hitRecord *isect, sampler *sampler) {
 	(void)sampler;
 	struct lightRay copy = *ray;
@@ -50,6 +62,13 @@ static bool intersectSphere(const struct instance *instance, const struct lightR
 		isect->bsdf = instance->bbuf->bsdfs.items[0];
 		tform_point(&isect->hitPoint, instance->composite.A);
 		tform_vector_transpose(&isect->surfaceNormal, instance->composite.Ainv);
+		isect->uv_footprint = 0.0f;
+		if (hasCone(ray)) {
+			// v spans half a great circle. u spans more the closer to the poles we get, but stick to the smaller rate.
+			struct vector radius = { sphere->radius, 0.0f, 0.0f };
+			tform_vector(&radius, instance->composite.A);
+			isect->uv_footprint = getUVFootprint(ray, isect, 1.0f / (PI * vec_length(radius)));
+		}
 		return true;
 	}
 	return false;
@@ -152,6 +171,24 @@ static struct coord getTexMapMesh(const struct mesh *mesh, const struct hitRecor
 	return coord_add(coord_add(ucomponent, vcomponent), wcomponent);
 }
 
+// How many uv units a unit of world distance spans on the polygon that was hit, 0.0f without texture coordinates
+static float getUVDensityMesh(const struct instance *instance, const struct mesh *mesh, const struct hitRecord *isect) {
+	const struct poly *p = isect->polygon;
+	if (mesh->vbuf.texture_coords.count == 0 || p->textureIndex[0] == -1) return 0.0f;
+	const struct vector *verts = mesh->vbuf.vertices.items;
+	struct vector e1 = vec_sub(verts[p->vertexIndex[1]], verts[p->vertexIndex[0]]);
+	struct vector e2 = vec_sub(verts[p->vertexIndex[2]], verts[p->vertexIndex[0]]);
+	tform_vector(&e1, instance->composite.A);
+	tform_vector(&e2, instance->composite.A);
+	const struct coord *tex = mesh->vbuf.texture_coords.items;
+	const struct coord t1 = coord_add(tex[p->textureIndex[1]], coord_scale(-1.0f, tex[p->textureIndex[0]]));
+	const struct coord t2 = coord_add(tex[p->textureIndex[2]], coord_scale(-1.0f, tex[p->textureIndex[0]]));
+	const float world_area = vec_length(vec_cross(e1, e2));
+	const float uv_area = fabsf(t1.x * t2.y - t1.y * t2.x);
+	if (world_area <= 0.0f) return 0.0f;
+	return sqrtf(uv_area / world_area);
+}
+
 static bool intersectMesh(const struct instance *instance, const struct lightRay *ray, struct hitRecord *isect, sampler *sampler) {
 	struct lightRay copy = *ray;
 	tform_ray(&copy, instance->composite.Ainv);
@@ -164,6 +201,7 @@ static bool intersectMesh(const struct instance *instance, const struct lightRay
 		tform_point(&isect->hitPoint, instance->composite.A);
 		tform_vector_transpose(&isect->surfaceNormal, instance->composite.Ainv);
 		isect->surfaceNormal = vec_normalize(isect->surfaceNormal);
+		isect->uv_footprint = hasCone(ray) ? getUVFootprint(ray, isect, getUVDensityMesh(instance, mesh, isect)) : 0.0f;
 		return true;
 	}
 	return false;
@@ -0,0 +1,312 @@
+//
+//  lights.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../../includes.h"
+#include "lights.h"
+
+#include <c-ray/c-ray.h>
+#include <datatypes/scene.h>
+#include <datatypes/mesh.h>
+#include <datatypes/poly.h>
+#include <datatypes/sphere.h>
+#include <datatypes/hitrecord.h>
+#include <renderer/instance.h>
+#include <renderer/samplers/vec.h>
+#include <common/logging.h>
+#include <float.h>
+
+// Rough power estimate of a shader graph. Only constant inputs are considered,
+// everything else is assumed to be 1. This only steers sampling, so it doesn't
+// have to be exact.
+static float color_power(const struct cr_color_node *color) {
+	if (!color) return 0.0f;
+	if (color->type != cr_cn_constant) return 1.0f;
+	const struct cr_color c = color->arg.constant;
+	return 0.2126f * c.r + 0.7152f * c.g + 0.0722f * c.b;
+}
+
+static float value_or(const struct cr_value_node *value, float fallback) {
+	if (!value || value->type != cr_vn_constant) return fallback;
+	return value->arg.constant;
+}
+
+static float shader_power(const struct cr_shader_node *desc) {
+	if (!desc) return 0.0f;
+	switch (desc->type) {
+		case cr_bsdf_emissive:
+			return color_power(desc->arg.emissive.color) * value_or(desc->arg.emissive.strength, 1.0f);
+		case cr_bsdf_mix: {
+			const float factor = value_or(desc->arg.mix.factor, 0.5f);
+			return (1.0f - factor) * shader_power(desc->arg.mix.A) + factor * shader_power(desc->arg.mix.B);
+		}
+		case cr_bsdf_add:
+			return shader_power(desc->arg.add.A) + shader_power(desc->arg.add.B);
+		default:
+			return 0.0f;
+	}
+}
+
+static inline struct mesh *instance_mesh(const struct instance *inst) {
+	return &((struct mesh_arr *)inst->object_arr)->items[inst->object_idx];
+}
+
+static inline struct sphere *instance_sphere(const struct instance *inst) {
+	return &((struct sphere_arr *)inst->object_arr)->items[inst->object_idx];
+}
+
+static void world_triangle(const struct instance *inst, const struct poly *p, struct vector v[3]) {
+	const struct mesh *mesh = instance_mesh(inst);
+	for (int i = 0; i < 3; ++i) {
+		v[i] = mesh->vbuf.vertices.items[p->vertexIndex[i]];
+		tform_point(&v[i], inst->composite.A);
+	}
+}
+
+// Spheres are assumed to be uniformly scaled
+static float world_sphere_radius(const struct instance *inst) {
+	struct vector r = { instance_sphere(inst)->radius, 0.0f, 0.0f };
+	tform_vector(&r, inst->composite.A);
+	return vec_length(r);
+}
+
+static float emitter_area(const struct instance *inst, const struct emitter *e) {
+	if (e->polygon < 0) {
+		const float r = world_sphere_radius(inst);
+		return 4.0f * PI * r * r;
+	}
+	struct vector v[3];
+	world_triangle(inst, &instance_mesh(inst)->polygons.items[e->polygon], v);
+	return 0.5f * vec_length(vec_cross(vec_sub(v[1], v[0]), vec_sub(v[2], v[0])));
+}
+
+// Two-sided normal cone and bounds of an emitter
+static struct light_bounds emitter_bounds(const struct instance *inst, const struct emitter *e, float power) {
+	if (e->polygon < 0) {
+		struct vector center = vec_zero();
+		tform_point(&center, inst->composite.A);
+		const float r = world_sphere_radius(inst);
+		const struct vector extent = { r, r, r };
+		return (struct light_bounds){
+			.bbox = { vec_sub(center, extent), vec_add(center, extent) },
+			.axis = { 0.0f, 1.0f, 0.0f },
+			.cos_theta_o = -1.0f,
+			.power = power,
+		};
+	}
+	struct vector v[3];
+	world_triangle(inst, &instance_mesh(inst)->polygons.items[e->polygon], v);
+	return (struct light_bounds){
+		.bbox = { vec_min(v[0], vec_min(v[1], v[2])), vec_max(v[0], vec_max(v[1], v[2])) },
+		.axis = vec_normalize(vec_cross(vec_sub(v[1], v[0]), vec_sub(v[2], v[0]))),
+		.cos_theta_o = 1.0f,
+		.power = power,
+	};
+}
+
+struct light_list light_list_build(const struct world *scene, const struct light_list *prev) {
+	struct light_list lights = { 0 };
+	// Estimated power of each material, indexed by shader buffer and material index
+	float **material_power = calloc(scene->shader_buffers.count ? scene->shader_buffers.count : 1, sizeof(*material_power));
+	for (size_t b = 0; b < scene->shader_buffers.count; ++b) {
+		const struct bsdf_buffer *buf = &scene->shader_buffers.items[b];
+		bool emissive = false;
+		float *power = calloc(buf->bsdfs.count ? buf->bsdfs.count : 1, sizeof(*power));
+		for (size_t m = 0; m < buf->bsdfs.count && m < buf->descriptions.count; ++m) {
+			power[m] = max(shader_power(buf->descriptions.items[m]), 0.0f);
+			emissive |= power[m] > 0.0f;
+		}
+		if (!emissive) {
+			free(power);
+			continue;
+		}
+		material_power[b] = power;
+	}
+
+	struct float_arr powers = { 0 };
+	struct int_arr lookup = { 0 };
+	lights.instance_first = malloc((scene->instances.count ? scene->instances.count : 1) * sizeof(*lights.instance_first));
+	for (size_t i = 0; i < scene->instances.count; ++i) {
+		const struct instance *inst = &scene->instances.items[i];
+		lights.instance_first[i] = SIZE_MAX;
+		const enum cr_instance_type type = instance_type(inst);
+		if (type == CR_I_UNKNOWN || inst->bbuf_idx >= scene->shader_buffers.count || !material_power[inst->bbuf_idx]) continue;
+		const float *power = material_power[inst->bbuf_idx];
+		lights.instance_first[i] = lookup.count;
+		const size_t prim_count = type == CR_I_MESH ? instance_mesh(inst)->polygons.count : 1;
+		for (size_t p = 0; p < prim_count; ++p) {
+			struct emitter e = { .instance = i, .polygon = type == CR_I_MESH ? (int)p : -1 };
+			const unsigned material = type == CR_I_MESH ? instance_mesh(inst)->polygons.items[p].materialIndex : 0;
+			e.area = emitter_area(inst, &e);
+			const float weight = material < inst->bbuf->bsdfs.count ? power[material] * e.area : 0.0f;
+			if (!(weight > 0.0f)) {
+				int_arr_add(&lookup, -1);
+				continue;
+			}
+			int_arr_add(&lookup, (int)lights.emitters.count);
+			float_arr_add(&powers, weight);
+			emitter_arr_add(&lights.emitters, e);
+		}
+	}
+	lights.emitter_lookup = lookup.items;
+	for (size_t b = 0; b < scene->shader_buffers.count; ++b) {
+		if (material_power[b]) free(material_power[b]);
+	}
+	free(material_power);
+
+	if (lights.emitters.count) {
+		lights.bounds = malloc(lights.emitters.count * sizeof(*lights.bounds));
+		for (size_t i = 0; i < lights.emitters.count; ++i) {
+			const struct emitter *e = &lights.emitters.items[i];
+			lights.bounds[i] = emitter_bounds(&scene->instances.items[e->instance], e, powers.items[i]);
+		}
+		lights.tree = light_tree_build(lights.bounds, lights.emitters.count);
+		logr(debug, "Built light tree with %zu emitters\n", lights.emitters.count);
+	}
+	float_arr_free(&powers);
+
+	// Tabulating the background is slow, so reuse the previous table if it didn't change.
+	if (prev && prev->env.source && prev->env.source == scene->background) {
+		lights.env = prev->env;
+	} else {
+		env_map_build(&lights.env, scene);
+	}
+	if (lights.env.func) lights.env_probability = lights.emitters.count ? 0.5f : 1.0f;
+	return lights;
+}
+
+void light_list_free(struct light_list *lights) {
+	if (!lights) return;
+	emitter_arr_free(&lights->emitters);
+	if (lights->bounds) free(lights->bounds);
+	light_tree_destroy(lights->tree);
+	if (lights->instance_first) free(lights->instance_first);
+	if (lights->emitter_lookup) free(lights->emitter_lookup);
+	env_map_free(&lights->env);
+	*lights = (struct light_list){ 0 };
+}
+
+// Same mapping as getTexMapMesh() in instance.c
+static struct coord triangle_uv(const struct mesh *mesh, const struct poly *p, float u, float v) {
+	if (mesh->vbuf.texture_coords.count == 0 || p->textureIndex[0] == -1) return (struct coord){ -1.0f, -1.0f };
+	const float w = 1.0f - u - v;
+	const struct coord ucomponent = coord_scale(u, mesh->vbuf.texture_coords.items[p->textureIndex[1]]);
+	const struct coord vcomponent = coord_scale(v, mesh->vbuf.texture_coords.items[p->textureIndex[2]]);
+	const struct coord wcomponent = coord_scale(w, mesh->vbuf.texture_coords.items[p->textureIndex[0]]);
+	return coord_add(coord_add(ucomponent, vcomponent), wcomponent);
+}
+
+// Same mapping as getTexMapSphere() in instance.c
+static struct coord sphere_uv(const struct vector n) {
+	const float phi = atan2f(n.z, n.x);
+	const float theta = asinf(n.y);
+	return (struct coord){
+		wrap_min_max(1.0f - (phi + PI) / (PI * 2.0f), 0.0f, 1.0f),
+		wrap_min_max((theta + PI / 2.0f) / PI, 0.0f, 1.0f)
+	};
+}
+
+static bool sample_env(const struct light_list *lights, const struct world *scene, sampler *sampler, struct light_sample *out) {
+	const float pdf = env_map_sample(&lights->env, sampler, &out->direction);
+	if (pdf <= 0.0f) return false;
+	out->pdf = lights->env_probability * pdf;
+	out->distance = FLT_MAX;
+	out->point = out->normal = vec_zero();
+	struct lightRay ray = { .direction = out->direction, .type = rt_shadow };
+	const struct hitRecord record = { .incident = &ray, .instIndex = -1 };
+	out->emitted = scene->background->sample(scene->background, sampler, &record).weight;
+	return true;
+}
+
+bool light_list_sample(const struct light_list *lights, const struct world *scene, const struct vector p, sampler *sampler, struct light_sample *out) {
+	if (lights->env_probability > 0.0f && sampler_dimension(sampler) < lights->env_probability) {
+		return sample_env(lights, scene, sampler, out);
+	}
+	if (!lights->emitters.count) return false;
+	float pmf = 0.0f;
+	const int64_t idx = light_tree_sample(lights->tree, lights->bounds, p, sampler_dimension(sampler), &pmf);
+	if (idx < 0) return false;
+	const struct emitter *e = &lights->emitters.items[idx];
+	const struct instance *inst = &scene->instances.items[e->instance];
+
+	struct hitRecord record = { .instIndex = e->instance };
+	if (e->polygon >= 0) {
+		struct mesh *mesh = instance_mesh(inst);
+		struct poly *poly = &mesh->polygons.items[e->polygon];
+		struct vector v[3];
+		world_triangle(inst, poly, v);
+		const float su = sqrtf(sampler_dimension(sampler));
+		const float b1 = (1.0f - su);
+		const float b2 = sampler_dimension(sampler) * su;
+		const float b0 = 1.0f - b1 - b2;
+		out->point = vec_add(vec_add(vec_scale(v[0], b0), vec_scale(v[1], b1)), vec_scale(v[2], b2));
+		out->normal = vec_normalize(vec_cross(vec_sub(v[1], v[0]), vec_sub(v[2], v[0])));
+		record.uv = triangle_uv(mesh, poly, b1, b2);
+		record.polygon = poly;
+		record.bsdf = inst->bbuf->bsdfs.items[poly->materialIndex];
+	} else {
+		const struct vector n = vec_on_unit_sphere(sampler);
+		out->point = vec_scale(n, instance_sphere(inst)->radius);
+		tform_point(&out->point, inst->composite.A);
+		out->normal = n;
+		tform_vector_transpose(&out->normal, inst->composite.Ainv);
+		out->normal = vec_normalize(out->normal);
+		record.uv = sphere_uv(n);
+		record.bsdf = inst->bbuf->bsdfs.items[0];
+	}
+
+	const struct vector to_light = vec_sub(out->point, p);
+	const float dist_sq = vec_length_squared(to_light);
+	if (dist_sq <= 0.0f) return false;
+	out->distance = sqrtf(dist_sq);
+	out->direction = vec_scale(to_light, 1.0f / out->distance);
+	// Emitters are two-sided, like they are when hit with BSDF samples.
+	const float cos_light = fabsf(vec_dot(out->normal, out->direction));
+	if (cos_light <= 0.0f) return false;
+
+	// The point is uniform over the emitter's area, convert that to solid angle
+	out->pdf = (1.0f - lights->env_probability) * pmf / e->area * dist_sq / cos_light;
+
+	struct lightRay incident = { .start = p, .direction = out->direction, .type = rt_shadow };
+	record.incident = &incident;
+	record.hitPoint = out->point;
+	record.surfaceNormal = out->normal;
+	record.distance = out->distance;
+	out->emitted = record.bsdf->sample(record.bsdf, sampler, &record).emitted;
+	return true;
+}
+
+float light_list_pdf(const struct light_list *lights, const struct world *scene, const struct hitRecord *isect) {
+	if (!lights->emitters.count || isect->instIndex < 0) return 0.0f;
+	const size_t first = lights->instance_first[isect->instIndex];
+	if (first == SIZE_MAX) return 0.0f;
+	const struct instance *inst = &scene->instances.items[isect->instIndex];
+	const size_t prim = isect->polygon ? (size_t)(isect->polygon - instance_mesh(inst)->polygons.items) : 0;
+	const int idx = lights->emitter_lookup[first + prim];
+	if (idx < 0) return 0.0f;
+	const struct emitter *e = &lights->emitters.items[idx];
+	struct vector normal;
+	if (isect->polygon) {
+		// Use the geometric normal, same as light_list_sample()
+		struct vector v[3];
+		world_triangle(inst, isect->polygon, v);
+		normal = vec_normalize(vec_cross(vec_sub(v[1], v[0]), vec_sub(v[2], v[0])));
+	} else {
+		normal = vec_normalize(isect->surfaceNormal);
+	}
+	const struct vector to_light = vec_sub(isect->hitPoint, isect->incident->start);
+	const float dist_sq = vec_length_squared(to_light);
+	const float cos_light = fabsf(vec_dot(normal, vec_normalize(to_light)));
+	if (cos_light <= 0.0f) return 0.0f;
+	const float pmf = light_tree_pmf(lights->tree, lights->bounds, isect->incident->start, idx);
+	return (1.0f - lights->env_probability) * pmf / e->area * dist_sq / cos_light;
+}
+
+float light_list_env_pdf(const struct light_list *lights, const struct vector dir) {
+	if (lights->env_probability <= 0.0f) return 0.0f;
+	return lights->env_probability * env_map_pdf(&lights->env, dir);
+}
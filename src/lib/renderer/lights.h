@@ -0,0 +1,71 @@
+//
+//  lights.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <common/vector.h>
+#include <common/color.h>
+#include <common/dyn_array.h>
+#include "samplers/sampler.h"
+#include "envmap.h"
+#include <accelerators/lighttree.h>
+
+struct world;
+struct hitRecord;
+
+// A single emissive triangle or sphere
+struct emitter {
+	int instance;
+	int polygon; // -1 for spheres
+	float area;
+};
+
+typedef struct emitter emitter;
+dyn_array_def(emitter)
+
+struct light_list {
+	struct emitter_arr emitters;
+	struct light_bounds *bounds; // Per emitter, power is estimated material power * area
+	struct light_tree *tree;
+	// Maps instance primitives back to emitters, for pdf lookups on BSDF hits.
+	// instance_first is SIZE_MAX for instances that don't emit, emitter_lookup is -1 for primitives that don't.
+	size_t *instance_first;
+	int *emitter_lookup;
+	struct env_map env;
+	// Probability of sampling the environment instead of an emitter
+	float env_probability;
+};
+
+struct light_sample {
+	struct vector point;
+	struct vector normal;
+	struct vector direction; // Normalized, from the shading point towards point
+	float distance; // FLT_MAX for the environment
+	float pdf; // Solid angle pdf at the shading point
+	struct color emitted;
+};
+
+/// Collect emissive triangles and spheres from the scene, and build a light tree
+/// over them, with power estimated from their materials. The background is tabulated
+/// for importance sampling too, unless prev already has a table for the same background.
+/// The top-level BVH has to be up to date, so instances have their shader buffers bound.
+struct light_list light_list_build(const struct world *scene, const struct light_list *prev);
+
+void light_list_free(struct light_list *lights);
+
+/// Pick a point on an emitter, as seen from shading point p
+/// @return false if nothing could be sampled
+bool light_list_sample(const struct light_list *lights, const struct world *scene, const struct vector p, sampler *sampler, struct light_sample *out);
+
+/// Solid angle pdf of light_list_sample() picking the point in isect, as seen from its incident ray origin
+float light_list_pdf(const struct light_list *lights, const struct world *scene, const struct hitRecord *isect);
+
+/// Solid angle pdf of light_list_sample() picking the environment in direction dir
+float light_list_env_pdf(const struct light_list *lights, const struct vector dir);
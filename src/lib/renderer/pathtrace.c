@@ -17,6 +17,9 @@
 #include <common/transforms.h>
 #include "samplers/sampler.h"
 #include "sky.h"
+#include "lights.h"
+#include "guiding.h"
+#include <nodes/memo.h>
 
 static inline struct hitRecord getClosestIsect(struct lightRay *incidentRay, const struct world *scene, sampler *sampler) {
 	//TODO: Consider passing in last instance idx + polygon to detect self-intersections?
@@ -25,38 +28,328 @@ static inline struct hitRecord getClosestIsect(struct lightRay *incidentRay, con
 	return isect;
 }
 
-struct color path_trace(struct lightRay incident, const struct world *scene, int max_bounces, sampler *sampler) {
-	struct color path_weight = g_white_color;
-	struct color path_radiance = g_black_color; // Final path contribution "color"
-	struct lightRay currentRay = incident;
+static inline bool is_black(const struct color c) {
+	return c.red == 0.0f && c.green == 0.0f && c.blue == 0.0f;
+}
+
+static inline struct color clamp_albedo(const struct color c) {
+	return (struct color){ clamp(c.red, 0.0f, 1.0f), clamp(c.green, 0.0f, 1.0f), clamp(c.blue, 0.0f, 1.0f), 1.0f };
+}
+
+static inline float power_heuristic(float a, float b) {
+	return (a * a) / (a * a + b * b);
+}
+
+// Probability of drawing a direction from the learned guiding distribution instead of the BSDF
+#define GUIDE_FRACTION 0.5f
+#define GUIDE_MAX_VERTICES 32
+
+// Density of scattering towards dir at isect, with guiding mixed in if guide_root is set
+static inline float scatter_pdf(const struct world *scene, uint32_t guide_root, const struct hitRecord *isect, sampler *sampler, const struct vector dir) {
+	const float pdf = bsdf_pdf(isect->bsdf, sampler, isect, dir);
+	if (!guide_root) return pdf;
+	return GUIDE_FRACTION * guide_pdf(scene->guide, guide_root, dir) + (1.0f - GUIDE_FRACTION) * pdf;
+}
+
+// Next event estimation: pick a point on an emitter or a direction towards the environment, and return its contribution if it's visible from isect.
+// Alpha is left at 0, so this doesn't affect path alpha. from_env is set if the environment was sampled.
+static struct color sample_lights(const struct world *scene, const struct hitRecord *isect, uint32_t guide_root, sampler *sampler, bool *from_env) {
+	struct light_sample light;
+	if (!light_list_sample(&scene->lights, scene, isect->hitPoint, sampler, &light)) return g_clear_color;
+	*from_env = light.distance == FLT_MAX;
+	if (is_black(light.emitted)) return g_clear_color;
+	const struct color f = bsdf_eval(isect->bsdf, sampler, isect, light.direction);
+	if (is_black(f)) return g_clear_color;
+
+	struct lightRay shadow = { .start = isect->hitPoint, .direction = light.direction, .type = rt_shadow };
+	const struct hitRecord occluder = getClosestIsect(&shadow, scene, sampler);
+	if (occluder.instIndex >= 0 && vec_distance_to(isect->hitPoint, occluder.hitPoint) < light.distance * 0.999f)
+		return g_clear_color;
+
+	const float weight = power_heuristic(light.pdf, scatter_pdf(scene, guide_root, isect, sampler, light.direction)) / light.pdf;
+	const struct color contribution = colorMul(f, light.emitted);
+	return (struct color){ weight * contribution.red, weight * contribution.green, weight * contribution.blue, 0.0f };
+}
+
+// A scattering vertex, remembered so the radiance that eventually arrives there can be taught to the guide
+struct guide_vertex {
+	struct vector position;
+	struct vector direction;
+	struct color throughput; // Path weight for light arriving along direction
+	struct color radiance; // Arrived so far, in path_radiance units
+	float pdf;
+};
+
+static inline void add_to_vertices(struct guide_vertex *vertices, int count, const struct color c) {
+	for (int i = 0; i < count; ++i) vertices[i].radiance = colorAdd(vertices[i].radiance, c);
+}
+
+static void record_vertices(const struct world *scene, struct guide_splats *splats, const struct guide_vertex *vertices, int count) {
+	for (int i = 0; i < count; ++i) {
+		const struct guide_vertex *v = &vertices[i];
+		// Incident radiance is what arrived, without the path weight up to here. Guide on the channel average.
+		float radiance = 0.0f;
+		if (v->throughput.red > 0.0f) radiance += v->radiance.red / v->throughput.red;
+		if (v->throughput.green > 0.0f) radiance += v->radiance.green / v->throughput.green;
+		if (v->throughput.blue > 0.0f) radiance += v->radiance.blue / v->throughput.blue;
+		guide_record(scene->guide, splats, v->position, v->direction, radiance / 3.0f, v->pdf);
+	}
+}
+
+// A path in flight. Kept between bounces, so paths can also be traced side by side.
+struct path_state {
+	struct lightRay ray;
+	struct vector origin; // Where the camera ray started, for the depth AOV
+	struct color weight;
+	struct color radiance; // Final path contribution "color"
+	// Pdf of the scattering sample that produced ray, 0 if lights couldn't have been sampled for it
+	float last_bsdf_pdf;
+	// The part of radiance that came from the background, for light group AOVs
+	struct color env_radiance;
+	int bounce;
+	sampler *sampler;
+	struct path_aux *aux;
+	struct guide_vertex *vertices; // Only set when recording for path guiding
+	int vertex_count;
+};
+
+static void path_start(struct path_state *path, struct lightRay incident, sampler *sampler, struct path_aux *aux, struct guide_vertex *vertices) {
+	*path = (struct path_state){
+		.ray = incident,
+		.origin = incident.start,
+		.weight = g_white_color,
+		.radiance = g_black_color,
+		.env_radiance = g_clear_color,
+		.sampler = sampler,
+		.aux = aux,
+		.vertices = vertices,
+	};
+	if (aux) *aux = (struct path_aux){ 0 };
+}
+
+static inline struct hitRecord path_intersect(struct path_state *path, const struct world *scene) {
+	sampler_start_bounce(path->sampler, path->bounce);
+	return getClosestIsect(&path->ray, scene, path->sampler);
+}
+
+// Shade a hit with the bsdf sample drawn for it, and set up the next bounce. Returns false once the path is done.
+static bool path_scatter(struct path_state *path, const struct hitRecord *isect, const struct bsdfSample *sample, const struct world *scene, int max_bounces) {
+	sampler *sampler = path->sampler;
+	struct path_aux *aux = path->aux;
+	const int bounce = path->bounce;
+	if (aux && bounce == 0) {
+		// Emitters don't reflect much, but they still shouldn't get demodulated to black
+		const bool emitter_only = is_black(sample->weight) && !is_black(sample->emitted);
+		aux->albedo = emitter_only ? g_white_color : clamp_albedo(sample->weight);
+		aux->normal = isect->surfaceNormal;
+		// isect->distance is in object space for transformed instances
+		aux->depth = vec_length(vec_sub(isect->hitPoint, path->origin));
+		aux->instance = isect->instIndex + 1;
+	}
+	struct color emitted = sample->emitted;
+	if (path->last_bsdf_pdf > 0.0f && !is_black(emitted)) {
+		// This emitter may have been light sampled at the previous vertex already, so weigh with MIS
+		const float mis_weight = power_heuristic(path->last_bsdf_pdf, light_list_pdf(&scene->lights, scene, isect));
+		emitted = (struct color){ mis_weight * emitted.red, mis_weight * emitted.green, mis_weight * emitted.blue, emitted.alpha };
+	}
+	const struct color emitted_contribution = colorMul(path->weight, emitted);
+	path->radiance = colorAdd(path->radiance, emitted_contribution);
+	if (path->vertices) add_to_vertices(path->vertices, path->vertex_count, emitted_contribution);
+	if (bounce == max_bounces) return false;
+
+	// Only guide where the BSDF can be evaluated, otherwise we couldn't weigh the guided samples
+	const uint32_t guide_root = scene->guide && isect->bsdf->eval ? guide_lookup(scene->guide, isect->hitPoint) : 0;
+
+	if ((scene->lights.emitters.count || scene->lights.env_probability > 0.0f) && isect->bsdf->eval) {
+		bool from_env = false;
+		const struct color contribution = colorMul(path->weight, sample_lights(scene, isect, guide_root, sampler, &from_env));
+		path->radiance = colorAdd(path->radiance, contribution);
+		if (from_env) path->env_radiance = colorAdd(path->env_radiance, contribution);
+		// Light sampled radiance still arrived through the earlier vertices, the guide has to learn it too
+		if (path->vertices) add_to_vertices(path->vertices, path->vertex_count, contribution);
+	}
+
+	// The cone keeps widening at the same rate past this bounce
+	const float cone_width = path->ray.cone_width + path->ray.cone_spread * vec_distance_to(path->ray.start, isect->hitPoint);
+	const float cone_spread = path->ray.cone_spread;
+	path->ray = sample->out;
+	struct color attenuation = sample->weight;
+	if (!guide_root) {
+		path->last_bsdf_pdf = sample->pdf > 0.0f ? bsdf_pdf(isect->bsdf, sampler, isect, sample->out.direction) : 0.0f;
+	} else if (sampler_dimension(sampler) < GUIDE_FRACTION) {
+		struct vector dir;
+		if (!(guide_sample(scene->guide, guide_root, sampler, &dir) > 0.0f)) return false;
+		path->ray = (struct lightRay){ .start = isect->hitPoint, .direction = dir, .type = rt_reflection | rt_diffuse };
+		path->last_bsdf_pdf = scatter_pdf(scene, guide_root, isect, sampler, dir);
+		const struct color f = bsdf_eval(isect->bsdf, sampler, isect, dir);
+		if (!(path->last_bsdf_pdf > 0.0f) || is_black(f)) return false;
+		attenuation = (struct color){ f.red / path->last_bsdf_pdf, f.green / path->last_bsdf_pdf, f.blue / path->last_bsdf_pdf, 1.0f };
+	} else if (sample->pdf > 0.0f) {
+		// One-sample MIS between the BSDF and the guide, weigh with the mixture density
+		path->last_bsdf_pdf = scatter_pdf(scene, guide_root, isect, sampler, sample->out.direction);
+		const struct color f = bsdf_eval(isect->bsdf, sampler, isect, sample->out.direction);
+		if (!(path->last_bsdf_pdf > 0.0f) || is_black(f)) return false;
+		attenuation = (struct color){ f.red / path->last_bsdf_pdf, f.green / path->last_bsdf_pdf, f.blue / path->last_bsdf_pdf, sample->weight.alpha };
+	} else {
+		// Singular lobes are only reachable through the BSDF
+		path->last_bsdf_pdf = 0.0f;
+		attenuation = colorCoef(1.0f / (1.0f - GUIDE_FRACTION), sample->weight);
+	}
+	path->ray.cone_width = cone_width;
+	path->ray.cone_spread = cone_spread;
+	if (path->vertices && path->last_bsdf_pdf > 0.0f && path->vertex_count < GUIDE_MAX_VERTICES) {
+		path->vertices[path->vertex_count++] = (struct guide_vertex){
+			.position = isect->hitPoint,
+			.direction = path->ray.direction,
+			.throughput = colorMul(attenuation, path->weight),
+			.radiance = g_clear_color,
+			.pdf = path->last_bsdf_pdf,
+		};
+	}
+	
+	// Russian Roulette - Abort a path early if it won't contribute much to the final image
+	float rr_continue_probability = 1.0f;
+	if (bounce >= 4) {
+		// Guided samples may weigh more than 1
+		rr_continue_probability = min(max(attenuation.red, max(attenuation.green, attenuation.blue)), 1.0f);
+		if (sampler_dimension(sampler) > rr_continue_probability)
+			return false;
+	}
+	
+	path->weight = colorCoef(1.0f / rr_continue_probability, colorMul(attenuation, path->weight));
+	return ++path->bounce <= max_bounces;
+}
+
+// Shade the hit found by path_intersect(), and set up the next bounce. Returns false once the path is done.
+static bool path_shade(struct path_state *path, struct hitRecord *isect, const struct world *scene, int max_bounces, struct node_memo *memo) {
+	sampler *sampler = path->sampler;
+	struct path_aux *aux = path->aux;
+	const int bounce = path->bounce;
+	// New shading point, only set now so alpha tests during traversal don't get cached
+	node_memo_reset(memo);
+	isect->memo = memo;
+	if (isect->instIndex < 0) {
+		struct color background = scene->background->sample(scene->background, sampler, isect).weight;
+		if (path->last_bsdf_pdf > 0.0f) {
+			const float mis_weight = power_heuristic(path->last_bsdf_pdf, light_list_env_pdf(&scene->lights, path->ray.direction));
+			background = (struct color){ mis_weight * background.red, mis_weight * background.green, mis_weight * background.blue, background.alpha };
+		}
+		if (aux && bounce == 0) aux->albedo = clamp_albedo(background);
+		const struct color contribution = colorMul(path->weight, background);
+		path->radiance = colorAdd(path->radiance, contribution);
+		path->env_radiance = colorAdd(path->env_radiance, contribution);
+		if (path->vertices) add_to_vertices(path->vertices, path->vertex_count, contribution);
+		return false;
+	}
+	
+	const struct bsdfSample sample = isect->bsdf->sample(isect->bsdf, sampler, isect);
+	return path_scatter(path, isect, &sample, scene, max_bounces);
+}
 
-	for (int bounce = 0; bounce <= max_bounces; ++bounce) {
-		const struct hitRecord isect = getClosestIsect(&currentRay, scene, sampler);
-		if (isect.instIndex < 0) {
-			path_radiance = colorAdd(path_radiance, colorMul(path_weight, scene->background->sample(scene->background, sampler, &isect).weight));
-			break;
+static struct color path_finish(const struct path_state *path, const struct world *scene, struct guide_splats *splats) {
+	if (path->vertices) record_vertices(scene, splats, path->vertices, path->vertex_count);
+	if (path->aux) {
+		const struct color radiance = path->radiance, env = path->env_radiance;
+		path->aux->light_environment = (struct color){ env.red, env.green, env.blue, 1.0f };
+		path->aux->light_emitters = (struct color){
+			radiance.red - env.red,
+			radiance.green - env.green,
+			radiance.blue - env.blue,
+			1.0f
+		};
+	}
+	return path->radiance;
+}
+
+struct color path_trace(struct lightRay incident, const struct world *scene, int max_bounces, sampler *sampler, struct path_aux *aux, struct guide_splats *splats) {
+	if (!scene->guide) splats = NULL;
+	struct guide_vertex vertices[GUIDE_MAX_VERTICES];
+	struct path_state path;
+	path_start(&path, incident, sampler, aux, splats ? vertices : NULL);
+	struct node_memo memo;
+	if (max_bounces >= 0) {
+		while (true) {
+			struct hitRecord isect = path_intersect(&path, scene);
+			if (!path_shade(&path, &isect, scene, max_bounces, &memo)) break;
+		}
+	}
+	return path_finish(&path, scene, splats);
+}
+
+struct shading_order {
+	uintptr_t material;
+	size_t path;
+};
+
+static int compare_shading_order(const void *A, const void *B) {
+	const struct shading_order *a = A;
+	const struct shading_order *b = B;
+	if (a->material != b->material) return a->material < b->material ? -1 : 1;
+	return a->path < b->path ? -1 : a->path > b->path;
+}
+
+void path_trace_sorted(struct path_query *queries, size_t count, const struct world *scene, int max_bounces) {
+	struct path_state *paths = malloc(count * sizeof(*paths));
+	struct hitRecord *hits = malloc(count * sizeof(*hits));
+	struct shading_order *order = malloc(count * sizeof(*order));
+	bool *alive = malloc(count * sizeof(*alive));
+	// Paths still going, in query order, so traversal stays as coherent as the queries were
+	size_t *live = malloc(count * sizeof(*live));
+	size_t live_count = 0;
+	for (size_t i = 0; i < count; ++i) {
+		path_start(&paths[i], queries[i].incident, queries[i].sampler, queries[i].aux, NULL);
+		if (max_bounces >= 0) live[live_count++] = i;
+	}
+	// A memo per lane, batched points are all in flight at once
+	struct node_memo *memos = malloc(NODE_BATCH_SIZE * sizeof(*memos));
+	while (live_count) {
+		for (size_t i = 0; i < live_count; ++i) {
+			const size_t p = live[i];
+			hits[p] = path_intersect(&paths[p], scene);
+			// Misses all shade the same background, so they go first
+			order[i] = (struct shading_order){ hits[p].instIndex < 0 ? 0 : (uintptr_t)hits[p].bsdf, p };
+		}
+		qsort(order, live_count, sizeof(*order), compare_shading_order);
+		for (size_t i = 0; i < live_count;) {
+			const size_t p = order[i].path;
+			if (!order[i].material) {
+				alive[p] = path_shade(&paths[p], &hits[p], scene, max_bounces, &memos[0]);
+				++i;
+				continue;
+			}
+			// Hits on the same bsdf get sampled as a batch, then go on one by one
+			size_t n = 1;
+			while (n < NODE_BATCH_SIZE && i + n < live_count && order[i + n].material == order[i].material) ++n;
+			sampler *samplers[NODE_BATCH_SIZE];
+			const struct hitRecord *records[NODE_BATCH_SIZE];
+			for (size_t l = 0; l < n; ++l) {
+				const size_t q = order[i + l].path;
+				node_memo_reset(&memos[l]);
+				hits[q].memo = &memos[l];
+				samplers[l] = paths[q].sampler;
+				records[l] = &hits[q];
+			}
+			struct node_batch batch;
+			node_batch_init(&batch, samplers, records, n);
+			struct bsdfSample samples[NODE_BATCH_SIZE];
+			bsdf_sample_batch(hits[p].bsdf, &batch, samples);
+			for (size_t l = 0; l < n; ++l) {
+				const size_t q = order[i + l].path;
+				alive[q] = path_scatter(&paths[q], &hits[q], &samples[l], scene, max_bounces);
+			}
+			i += n;
 		}
-		
-		const struct bsdfSample sample = isect.bsdf->sample(isect.bsdf, sampler, &isect);
-		//TODO: emission contribution needs to be adjusted down by probability of randomly hitting it
-		//FIXME: emits_light only gets set if the root node of a shader graph is emissive, so maybe fix that
-		// if (true || scene->instances[isect.instIndex].emits_light) {
-			path_radiance = colorAdd(path_radiance, colorMul(path_weight, sample.emitted));
-		// }
-		if (bounce == max_bounces) break;
-
-		currentRay = sample.out;
-		const struct color attenuation = sample.weight;
-		
-		// Russian Roulette - Abort a path early if it won't contribute much to the final image
-		float rr_continue_probability = 1.0f;
-		if (bounce >= 4) {
-			rr_continue_probability = max(attenuation.red, max(attenuation.green, attenuation.blue));
-			if (sampler_dimension(sampler) > rr_continue_probability)
-				break;
+		size_t next = 0;
+		for (size_t i = 0; i < live_count; ++i) {
+			if (alive[live[i]]) live[next++] = live[i];
 		}
-		
-		path_weight = colorCoef(1.0f / rr_continue_probability, colorMul(attenuation, path_weight));
+		live_count = next;
 	}
-	return path_radiance;
+	for (size_t i = 0; i < count; ++i) queries[i].result = path_finish(&paths[i], scene, NULL);
+	free(memos);
+	free(live);
+	free(alive);
+	free(order);
+	free(hits);
+	free(paths);
 }
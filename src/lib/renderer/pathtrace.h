@@ -12,5 +12,32 @@
 #include <nodes/bsdfnode.h>
 
 struct world;
+struct guide_splats;
 
-struct color path_trace(struct lightRay incident, const struct world *scene, int max_bounces, sampler *sampler);
+// Auxiliary per-path outputs, for the denoiser and AOVs
+struct path_aux {
+	struct color albedo; // First hit
+	struct vector normal; // First hit
+	float depth; // First hit distance, 0 on a miss
+	int instance; // First hit instance index + 1, 0 on a miss
+	// Light groups, these add up to the returned color
+	struct color light_emitters;
+	struct color light_environment;
+};
+
+/// Trace one path. aux is optional, and receives auxiliary outputs if set.
+/// If splats is set, the radiance found along the path is recorded there for path guiding.
+struct color path_trace(struct lightRay incident, const struct world *scene, int max_bounces, sampler *sampler, struct path_aux *aux, struct guide_splats *splats);
+
+struct path_query {
+	struct lightRay incident;
+	sampler *sampler; // One per path, they can't be shared
+	struct path_aux *aux; // Optional
+	struct color result;
+};
+
+/// Trace a batch of paths side by side, one bounce at a time. The hits of each bounce are shaded
+/// grouped by material, so the same shader code and textures stay in cache, and runs of the same
+/// bsdf get sampled as one node batch. Every path comes out exactly like path_trace() would have
+/// traced it. Guiding splats aren't recorded.
+void path_trace_sorted(struct path_query *queries, size_t count, const struct world *scene, int max_bounces);
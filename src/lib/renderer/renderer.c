@@ -28,6 +28,10 @@
 #include <protocol/server.h>
 #include <accelerators/bvh.h>
 #include "samplers/sampler.h"
+#include "checkpoint.h"
+#include "denoise.h"
+#include "reproject.h"
+#include "guiding.h"
 
 //Main thread loop speeds
 #define paused_msec 100
@@ -40,7 +44,7 @@ static bool g_aborted = false;
 void sigHandler(int sig) {
 	if (sig == 2) { //SIGINT
 		logr(plain, "\n");
-		logr(info, "Received ^C, aborting render without saving\n");
+		logr(info, "Received ^C, aborting render without saving the image\n");
 		g_aborted = true;
 	}
 }
@@ -75,15 +79,23 @@ void update_cb_info(struct renderer *r, struct tile_set *set, struct cr_renderer
 	static uint64_t ctr = 1;
 	static uint64_t avg_per_sample_us = 0;
 	static uint64_t avg_tile_pass_us = 0;
+	mutex_lock(set->tile_mutex);
+	if (i->tiles_count != set->tiles.count) {
+		// Tiles were quantized again, interactive mode resize or tile size change
+		// Notice: Casting away const here
+		i->tiles = realloc((struct cr_tile *)i->tiles, sizeof(*i->tiles) * set->tiles.count);
+		i->tiles_count = set->tiles.count;
+	}
 	// Notice: Casting away const here
 	memcpy((struct cr_tile *)i->tiles, set->tiles.items, sizeof(*i->tiles) * i->tiles_count);
+	mutex_release(set->tile_mutex);
 	if (!r->state.workers.count) return;
 	//Gather and maintain this average constantly.
 	size_t remote_threads = 0;
 	for (size_t i = 0; i < r->state.clients.count; ++i) {
 		remote_threads += r->state.clients.items[i].available_threads;
 	}
-	if (!r->state.workers.items[0].paused) { // FIXME: Use renderer state instead
+	if (!r->state.paused) {
 		for (size_t t = 0; t < r->state.workers.count; ++t) {
 			avg_per_sample_us += r->state.workers.items[t].avg_per_sample_us; // FIXME: Not updated from remote nodes
 		}
@@ -100,7 +112,7 @@ void update_cb_info(struct renderer *r, struct tile_set *set, struct cr_renderer
 	eta_ms_till_done /= (r->prefs.threads + remote_threads);
 	uint64_t sps = (1000000 / avg_per_ray_us) * (r->prefs.threads + remote_threads);
 
-	i->paused = r->state.workers.items[0].paused;
+	i->paused = r->state.paused;
 	i->avg_per_ray_us = avg_per_ray_us;
 	i->samples_per_sec = sps;
 	i->eta_ms = eta_ms_till_done;
@@ -144,6 +156,265 @@ void update_toplevel_bvh(struct world *s) {
 	s->top_level_dirty = false;
 }
 
+// Materials may change without touching the top-level BVH, so this has a dirty flag of its own.
+void update_light_list(struct world *s) {
+	if (!s->lights_dirty && s->lights.instance_first) return;
+	struct light_list new = light_list_build(s, &s->lights);
+	thread_rwlock_wrlock(&s->bvh_lock);
+	struct light_list old = s->lights;
+	s->lights = new;
+	thread_rwlock_unlock(&s->bvh_lock);
+	// The environment table may have been carried over
+	if (old.env.func == new.env.func) old.env = (struct env_map){ 0 };
+	light_list_free(&old);
+	s->lights_dirty = false;
+}
+
+#define GUIDE_TRAINING_ITERATIONS 4
+
+struct guide_training {
+	struct renderer *r;
+	const struct camera *cam;
+	struct guide_splats *splats;
+	int first_row;
+	int end_row;
+	size_t iteration;
+};
+
+static void *guide_training_thread(void *arg) {
+	block_signals();
+	struct guide_training *t = arg;
+	struct renderer *r = t->r;
+	sampler *sampler = sampler_new();
+	thread_rwlock_rdlock(&r->scene->bvh_lock);
+	for (int y = t->first_row; y < t->end_row; ++y) {
+		for (int x = 0; x < t->cam->width; ++x) {
+			sampler_init(sampler, SAMPLING_STRATEGY, t->iteration, GUIDE_TRAINING_ITERATIONS, (uint32_t)(y * t->cam->width + x));
+			path_trace(cam_get_ray(t->cam, x, y, sampler), r->scene, r->prefs.bounces, sampler, NULL, t->splats);
+		}
+	}
+	thread_rwlock_unlock(&r->scene->bvh_lock);
+	sampler_destroy(sampler);
+	return NULL;
+}
+
+// Learn the incident radiance distribution with a few 1spp passes over the image.
+// The training samples are thrown away, they were taken with a half-learned guide.
+static void update_path_guide(struct renderer *r, const struct camera *cam) {
+	struct world *s = r->scene;
+	struct path_guide *guide = NULL;
+	if (r->prefs.path_guiding && s->topLevel) {
+		struct boundingBox bounds;
+		size_t first, count;
+		bvh_get_node(s->topLevel, 0, &bounds, &first, &count);
+		guide = guide_new(bounds);
+	}
+	thread_rwlock_wrlock(&s->bvh_lock);
+	struct path_guide *old = s->guide;
+	s->guide = guide;
+	thread_rwlock_unlock(&s->bvh_lock);
+	guide_destroy(old);
+	if (!guide) return;
+
+	struct timeval timer = { 0 };
+	timer_start(&timer);
+	const size_t threads = r->prefs.threads ? r->prefs.threads : 1;
+	struct guide_training *jobs = calloc(threads, sizeof(*jobs));
+	struct cr_thread *workers = calloc(threads, sizeof(*workers));
+	struct guide_splats *splats = calloc(threads, sizeof(*splats));
+	for (size_t i = 0; i < GUIDE_TRAINING_ITERATIONS && !g_aborted; ++i) {
+		for (size_t t = 0; t < threads; ++t) {
+			guide_splats_reset(&splats[t], guide);
+			jobs[t] = (struct guide_training){
+				.r = r,
+				.cam = cam,
+				.splats = &splats[t],
+				.first_row = (int)(cam->height * t / threads),
+				.end_row = (int)(cam->height * (t + 1) / threads),
+				.iteration = i,
+			};
+			workers[t] = (struct cr_thread){ .thread_fn = guide_training_thread, .user_data = &jobs[t] };
+			thread_start(&workers[t]);
+		}
+		for (size_t t = 0; t < threads; ++t) thread_wait(&workers[t]);
+		// Only this thread touches the guide topology, and render threads aren't running yet
+		guide_update(guide, splats, threads);
+	}
+	for (size_t t = 0; t < threads; ++t) guide_splats_free(&splats[t]);
+	free(splats);
+	free(workers);
+	free(jobs);
+	logr(info, "Trained path guide in %zu iterations (%zu spatial nodes), took %lums\n",
+		guide->iterations, guide->snodes.count, timer_get_ms(timer));
+}
+
+static void resize_or_clear(struct texture **t, size_t width, size_t height) {
+	if (*t && (*t)->width == width && (*t)->height == height) {
+		tex_clear(*t);
+		return;
+	}
+	if (*t) tex_destroy(*t);
+	*t = tex_new(float_p, width, height, 4);
+}
+
+static void free_buf(struct texture **t) {
+	if (*t) tex_destroy(*t);
+	*t = NULL;
+}
+
+void renderer_update_aov_buffers(struct renderer *r) {
+	uint32_t mask = r->prefs.aovs;
+	// The denoiser is guided by albedo & normals
+	if (r->prefs.denoise) mask |= (1 << cr_aov_albedo) | (1 << cr_aov_normal);
+	// Reprojection needs to know where the first hits were
+	if (r->prefs.iterative && r->prefs.reproject) mask |= (1 << cr_aov_depth);
+	if (!r->state.result_buf) mask = 0;
+	const size_t width = r->state.result_buf ? r->state.result_buf->width : 0;
+	const size_t height = r->state.result_buf ? r->state.result_buf->height : 0;
+	for (size_t i = 0; i < cr_aov_count; ++i) {
+		if (mask & (1 << i)) {
+			resize_or_clear(&r->state.aovs[i], width, height);
+		} else {
+			free_buf(&r->state.aovs[i]);
+		}
+	}
+	r->state.aov_mask = mask;
+	if (r->prefs.denoise && r->state.result_buf) {
+		resize_or_clear(&r->state.denoised_buf, width, height);
+	} else {
+		free_buf(&r->state.denoised_buf);
+	}
+	r->state.denoised_valid = false;
+	if (r->prefs.iterative && r->prefs.reproject && r->state.result_buf) {
+		resize_or_clear(&r->state.weight_buf, width, height);
+	} else {
+		free_buf(&r->state.weight_buf);
+		reproject_scratch_free(&r->state.reproject_scratch);
+	}
+}
+
+void renderer_clear_aov_buffers(struct renderer *r) {
+	for (size_t i = 0; i < cr_aov_count; ++i) {
+		if (r->state.aovs[i]) tex_clear(r->state.aovs[i]);
+	}
+}
+
+void renderer_reset_accumulation(struct renderer *r, const struct camera *cam, bool carry_over) {
+	if (carry_over && r->state.weight_buf && r->state.aovs[cr_aov_depth]) {
+		reproject(&r->state.reproject_scratch, &r->state.result_buf, &r->state.aovs[cr_aov_depth], &r->state.weight_buf, &r->state.prev_cam, cam, r->prefs.threads);
+		// Depth is kept too, in case the camera moves again before every pixel got traced
+		for (size_t i = 0; i < cr_aov_count; ++i) {
+			if (r->state.aovs[i] && i != cr_aov_depth) tex_clear(r->state.aovs[i]);
+		}
+	} else {
+		tex_clear(r->state.result_buf);
+		if (r->state.weight_buf) tex_clear(r->state.weight_buf);
+		renderer_clear_aov_buffers(r);
+	}
+	r->state.prev_cam = *cam;
+	r->state.denoised_valid = false;
+}
+
+void renderer_denoise(struct renderer *r) {
+	if (!r->state.denoised_buf) return;
+	denoise(r->state.denoised_buf, r->state.result_buf, r->state.aovs[cr_aov_albedo], r->state.aovs[cr_aov_normal], r->prefs.threads);
+	r->state.denoised_valid = true;
+}
+
+static bool all_tiles_finished(const struct tile_set *set) {
+	for (size_t t = 0; t < set->tiles.count; ++t) {
+		if (set->tiles.items[t].state != finished) return false;
+	}
+	return true;
+}
+
+static inline void running_average(struct texture *t, int x, int y, size_t samples, const struct color value) {
+	if (!t) return;
+	const struct color prev = tex_get_px(t, x, y, false);
+	tex_set_px(t, colorCoef(1.0f / samples, colorAdd(colorCoef((float)(samples - 1), prev), value)), x, y);
+}
+
+static inline float welford(float var, float x, float prev_mean, float mean, size_t samples) {
+	return ((float)(samples - 1) * var + (x - prev_mean) * (x - mean)) / (float)samples;
+}
+
+// Fold a path's auxiliary outputs into the AOV buffers. prev_mean and mean are the pixel's color before and after adding sample.
+static inline void accumulate_aovs(struct renderer *r, int x, int y, size_t samples, const struct path_aux *aux, const struct color sample, const struct color prev_mean, const struct color mean) {
+	struct texture **aovs = r->state.aovs;
+	running_average(aovs[cr_aov_albedo], x, y, samples, aux->albedo);
+	running_average(aovs[cr_aov_normal], x, y, samples, (struct color){ aux->normal.x, aux->normal.y, aux->normal.z, 1.0f });
+	running_average(aovs[cr_aov_light_emitters], x, y, samples, aux->light_emitters);
+	running_average(aovs[cr_aov_light_environment], x, y, samples, aux->light_environment);
+	if (aovs[cr_aov_depth] && aux->depth > 0.0f) {
+		const float nearest = tex_get_px(aovs[cr_aov_depth], x, y, false).red;
+		if (nearest == 0.0f || aux->depth < nearest)
+			tex_set_px(aovs[cr_aov_depth], (struct color){ aux->depth, aux->depth, aux->depth, 1.0f }, x, y);
+	}
+	if (aovs[cr_aov_instance_id] && samples == 1) {
+		const float id = (float)aux->instance;
+		tex_set_px(aovs[cr_aov_instance_id], (struct color){ id, id, id, 1.0f }, x, y);
+	}
+	if (aovs[cr_aov_sample_count]) {
+		const float n = (float)samples;
+		tex_set_px(aovs[cr_aov_sample_count], (struct color){ n, n, n, 1.0f }, x, y);
+	}
+	if (aovs[cr_aov_variance]) {
+		const struct color var = tex_get_px(aovs[cr_aov_variance], x, y, false);
+		tex_set_px(aovs[cr_aov_variance], (struct color){
+			welford(var.red, sample.red, prev_mean.red, mean.red, samples),
+			welford(var.green, sample.green, prev_mean.green, mean.green, samples),
+			welford(var.blue, sample.blue, prev_mean.blue, mean.blue, samples),
+			1.0f
+		}, x, y);
+	}
+}
+
+// Average cost of a single pixel sample on local render threads, 0 if nothing was measured yet
+static double measured_us_per_px_sample(const struct renderer *r) {
+	long total_us = 0;
+	size_t measured = 0;
+	for (size_t w = 0; w < r->state.workers.count; ++w) {
+		const struct worker *worker = &r->state.workers.items[w];
+		if (worker->client || worker->avg_per_sample_us <= 0) continue;
+		total_us += worker->avg_per_sample_us;
+		measured++;
+	}
+	if (!measured) return 0.0;
+	return ((double)total_us / (double)measured) / (double)(r->prefs.tileWidth * r->prefs.tileHeight);
+}
+
+// If tile_auto is set, pick tile dimensions based on resolution, local and remote
+// thread counts and measured per-tile timings. Returns true if the dimensions changed.
+// With hysteresis set, the current size is kept unless the new pick is at least 2x off,
+// so small resizes and noisy timings don't keep flipping it.
+bool renderer_auto_tile_dims(struct renderer *r, unsigned width, unsigned height, bool hysteresis) {
+	if (!r->prefs.tile_auto) return false;
+	size_t threads = r->prefs.threads;
+	for (size_t c = 0; c < r->state.clients.count; ++c) {
+		threads += max(r->state.clients.items[c].available_threads, 0);
+	}
+	double us_per_px_sample = measured_us_per_px_sample(r);
+	if (us_per_px_sample <= 0.0) us_per_px_sample = r->state.us_per_px_sample;
+	unsigned tile_w = 0, tile_h = 0;
+	tile_auto_dims(width, height, threads, us_per_px_sample, &tile_w, &tile_h);
+	if (tile_w == r->prefs.tileWidth && tile_h == r->prefs.tileHeight) return false;
+	if (hysteresis && r->prefs.tileWidth && r->prefs.tileHeight) {
+		const unsigned cur_w = min(r->prefs.tileWidth, max(width, 1));
+		const unsigned cur_h = min(r->prefs.tileHeight, max(height, 1));
+		const bool w_off = tile_w >= 2 * cur_w || 2 * tile_w <= cur_w;
+		const bool h_off = tile_h >= 2 * cur_h || 2 * tile_h <= cur_h;
+		if (!w_off && !h_off) return false;
+	}
+	logr(debug, "Auto tile size %ux%u -> %ux%u (%zu threads, %.3fus/px)\n", r->prefs.tileWidth, r->prefs.tileHeight, tile_w, tile_h, threads, us_per_px_sample);
+	r->prefs.tileWidth = tile_w;
+	r->prefs.tileHeight = tile_h;
+	// Timings were measured with the old tile size, don't mix them with new ones.
+	for (size_t w = 0; w < r->state.workers.count; ++w) {
+		r->state.workers.items[w].avg_per_sample_us = 0;
+	}
+	return true;
+}
+
 // TODO: Clean this up, it's ugly.
 void renderer_render(struct renderer *r) {
 	//Check for CTRL-C
@@ -169,16 +440,19 @@ void renderer_render(struct renderer *r) {
 		r->scene->background = newBackground(&r->scene->storage, NULL, NULL, NULL, r->scene->use_blender_coordinates);
 	}
 	
-	struct tile_set set = {
-		.tile_mutex = mutex_create(),
-		.tiles = tile_quantize(
-			camera->width,
-			camera->height,
-			r->prefs.tileWidth,
-			r->prefs.tileHeight,
-			r->prefs.tileOrder
-		),
-	};
+	if (r->prefs.tile_auto) {
+		renderer_auto_tile_dims(r, camera->width, camera->height, false);
+		logr(info, "Using automatic tile size %ux%u\n", r->prefs.tileWidth, r->prefs.tileHeight);
+	}
+
+	struct tile_set set;
+	tile_set_init(&set, tile_quantize(
+		camera->width,
+		camera->height,
+		r->prefs.tileWidth,
+		r->prefs.tileHeight,
+		r->prefs.tileOrder
+	), r->prefs.pixelOrder);
 
 	r->state.current_set = &set;
 
@@ -196,6 +470,8 @@ void renderer_render(struct renderer *r) {
 
 	// And compute an initial top-level BVH.
 	update_toplevel_bvh(r->scene);
+	update_light_list(r->scene);
+	update_path_guide(r, camera);
 
 	print_stats(r->scene);
 
@@ -217,16 +493,34 @@ void renderer_render(struct renderer *r) {
 		// Resize
 		if (r->state.result_buf) tex_destroy(r->state.result_buf);
 		r->state.result_buf = tex_new(float_p, camera->width, camera->height, 4);
+	} else if (r->prefs.pin_threads && sys_get_numa_nodes() > 1) {
+		// Reallocate instead of clearing, so pages get first touched by the
+		// pinned render threads, and end up on their local NUMA nodes
+		tex_destroy(r->state.result_buf);
+		r->state.result_buf = tex_new(float_p, camera->width, camera->height, 4);
 	} else {
 		// Clear
 		tex_clear(r->state.result_buf);
 	}
 
 	struct texture **result = &r->state.result_buf;
+	renderer_update_aov_buffers(r);
+	r->state.prev_cam = *camera;
+	r->scene->samples_stale = false;
+
+	const bool checkpoints = r->prefs.checkpoint_path && !r->prefs.iterative;
+	if ((r->prefs.checkpoint_path || r->prefs.resume_path) && r->prefs.iterative) {
+		logr(warning, "Checkpoints aren't supported in iterative mode, ignoring\n");
+	}
+	const uint32_t scene_hash = (checkpoints || r->prefs.resume_path) && !r->prefs.iterative ? checkpoint_scene_hash(r) : 0;
+	if (r->prefs.resume_path && !r->prefs.iterative) {
+		if (!checkpoint_load(r->prefs.resume_path, r, &set, *result, scene_hash)) {
+			logr(warning, "Not resuming, starting from scratch\n");
+		}
+	}
 
-	struct cr_tile *info_tiles = calloc(set.tiles.count, sizeof(*info_tiles));
 	struct cr_renderer_cb_info cb_info = {
-		.tiles = info_tiles,
+		.tiles = calloc(set.tiles.count, sizeof(struct cr_tile)),
 		.tiles_count = set.tiles.count,
 		.fb = (const struct cr_bitmap **)result,
 	};
@@ -247,7 +541,16 @@ void renderer_render(struct renderer *r) {
 	void *(*local_render_thread)(void *) = render_thread;
 	// Iterative mode is incompatible with network rendering at the moment
 	if (r->prefs.iterative && !r->state.clients.count) local_render_thread = render_thread_interactive;
+	timer_start(&r->state.pass_timer);
 	
+	int *cores = NULL;
+	if (r->prefs.pin_threads) {
+		const int nodes = sys_get_numa_nodes();
+		logr(info, "Pinning render threads to cores across %i NUMA node%s\n", nodes, PLURAL(nodes));
+		cores = calloc(max(r->prefs.threads, 1), sizeof(*cores));
+		sys_get_spread_cores(cores, r->prefs.threads);
+	}
+
 	// Create & boot workers (Nonblocking)
 	// Local render threads + one thread for every client
 	for (size_t t = 0; t < r->prefs.threads; ++t) {
@@ -255,14 +558,17 @@ void renderer_render(struct renderer *r) {
 			.renderer = r,
 			.buf = result,
 			.cam = camera,
+			.core = cores ? cores[t] : -1,
 			.thread = (struct cr_thread){
 				.thread_fn = local_render_thread,
 			}
 		});
 	}
+	if (cores) free(cores);
 	for (size_t c = 0; c < r->state.clients.count; ++c) {
 		worker_arr_add(&r->state.workers, (struct worker){
 			.client = &r->state.clients.items[c],
+			.core = -1,
 			.renderer = r,
 			.buf = result,
 			.cam = camera,
@@ -278,6 +584,9 @@ void renderer_render(struct renderer *r) {
 			logr(error, "Failed to start worker %zu\n", w);
 	}
 
+	struct timeval checkpoint_timer;
+	timer_start(&checkpoint_timer);
+
 	//Start main thread loop to handle renderer feedback and state management
 	while (r->state.s == r_rendering) {
 		size_t inactive = 0;
@@ -292,16 +601,41 @@ void renderer_render(struct renderer *r) {
 			status.fn(&cb_info, status.user_data);
 		}
 
-		timer_sleep_ms(r->state.workers.items[0].paused ? paused_msec : active_msec);
+		if (checkpoints && timer_get_ms(checkpoint_timer) / 1000 >= r->prefs.checkpoint_interval) {
+			if (checkpoint_save(r->prefs.checkpoint_path, r, &set, *result, scene_hash))
+				logr(debug, "Saved checkpoint to '%s'\n", r->prefs.checkpoint_path);
+			timer_start(&checkpoint_timer);
+		}
+
+		timer_sleep_ms(r->state.paused ? paused_msec : active_msec);
 	}
 
+	mutex_lock(set.tile_mutex);
 	r->state.s = r_exiting;
+	tile_set_wake(&set);
+	mutex_release(set.tile_mutex);
+	mutex_lock(r->state.stop_lock);
 	r->state.current_set = NULL;
+	mutex_release(r->state.stop_lock);
 	
 	//Make sure render threads are terminated before continuing (This blocks)
 	for (size_t w = 0; w < r->state.workers.count; ++w)
 		thread_wait(&r->state.workers.items[w].thread);
 
+	const double us_per_px_sample = measured_us_per_px_sample(r);
+	if (us_per_px_sample > 0.0) r->state.us_per_px_sample = us_per_px_sample;
+
+	if (r->prefs.denoise && !r->prefs.iterative && !g_aborted && all_tiles_finished(&set)) {
+		logr(info, "Denoising\n");
+		renderer_denoise(r);
+	}
+
+	// Save progress if we were interrupted, so we can pick up from here with a resume
+	if (checkpoints && !all_tiles_finished(&set)) {
+		if (checkpoint_save(r->prefs.checkpoint_path, r, &set, *result, scene_hash))
+			logr(info, "Saved checkpoint to '%s'\n", r->prefs.checkpoint_path);
+	}
+
 	struct callback stop = r->state.callbacks[cr_cb_on_stop];
 	if (stop.fn) {
 		update_cb_info(r, &set, &cb_info);
@@ -309,10 +643,54 @@ void renderer_render(struct renderer *r) {
 			cb_info.aborted = true;
 		stop.fn(&cb_info, stop.user_data);
 	}
-	if (info_tiles) free(info_tiles);
+	if (cb_info.tiles) free((struct cr_tile *)cb_info.tiles);
 	tile_set_free(&set);
 	logr(info, "Renderer exiting\n");
+	mutex_lock(r->state.stop_lock);
 	r->state.s = r_idle;
+	thread_cond_broadcast(&r->state.stopped);
+	mutex_release(r->state.stop_lock);
+}
+
+static void pin_worker(const struct worker *w) {
+	if (w->core < 0) return;
+	if (thread_pin_current(w->core)) logr(debug, "Failed to pin render thread to core %i\n", w->core);
+}
+
+// Refinement level at which pixel (x, y) gets traced in the first interactive pass.
+// Pixels on the 2^n grid belong to level n, capped to the top level.
+static inline unsigned preview_level_of(int x, int y, unsigned top) {
+	unsigned level = 0;
+	while (level < top && !((x | y) & (1 << level))) level++;
+	return level;
+}
+
+void renderer_start_preview(struct renderer *r) {
+	unsigned top = PREVIEW_LEVELS;
+	if (r->prefs.target_frame_ms && r->state.pass_us) {
+		// Each level traces a quarter of the pixels of the one below it, so go
+		// coarse enough for the top level to fit in the frame time.
+		const long target_us = (long)r->prefs.target_frame_ms * 1000;
+		top = 0;
+		while (top < MAX_PREVIEW_LEVELS && (r->state.pass_us >> (2 * top)) > target_us) top++;
+		logr(debug, "Last pass took %lims, previewing at 1/%u resolution\n", r->state.pass_us / 1000, 1 << top);
+	}
+	r->state.preview_top = r->state.preview_level = top;
+	timer_start(&r->state.pass_timer);
+}
+
+// Fill the 2^level block at (x, y) with a preview sample. The block only covers
+// pixels of finer levels, which get traced later on in the same pass.
+static void fill_preview_block(struct texture *buf, const struct texture *weights, int x, int y, unsigned level, const struct color c) {
+	const int x_end = min(x + (1 << level), (int)buf->width);
+	const int y_end = min(y + (1 << level), (int)buf->height);
+	for (int by = y; by < y_end; ++by) {
+		for (int bx = x; bx < x_end; ++bx) {
+			// Leave reprojected samples alone, they're better than a blown up one
+			if (weights && tex_get_px(weights, bx, by, false).red > 0.0f) continue;
+			tex_set_px(buf, c, bx, by);
+		}
+	}
 }
 
 // An interactive render thread that progressively
@@ -320,69 +698,83 @@ void renderer_render(struct renderer *r) {
 void *render_thread_interactive(void *arg) {
 	block_signals();
 	struct worker *threadState = arg;
-	threadState->in_pause_loop = false;
+	pin_worker(threadState);
 	struct renderer *r = threadState->renderer;
 	struct texture **buf = threadState->buf;
+	struct tile_set *set = threadState->tiles;
 	sampler *sampler = sampler_new();
 
 	struct camera *cam = threadState->cam;
 	
 	//First time setup for each thread
-	struct render_tile *tile = tile_next_interactive(r, threadState->tiles);
+	struct render_tile *tile = tile_next_interactive(r, set);
 	threadState->currentTile = tile;
 	
 	struct timeval timer = {0};
 	
 	while (tile && r->state.s == r_rendering) {
 		long total_us = 0;
+		// Only the first pass is progressively refined
+		const bool preview = r->state.finishedPasses == 1;
+		const unsigned level = r->state.preview_level;
+		const unsigned top = r->state.preview_top;
+		bool dropped = false;
 
 		timer_start(&timer);
-		for (int y = tile->end.y - 1; y > tile->begin.y - 1; --y) {
-			for (int x = tile->begin.x; x < tile->end.x; ++x) {
-				if (r->state.s != r_rendering) goto exit;
-				uint32_t pixIdx = (uint32_t)(y * (*buf)->width + x);
-				//FIXME: This does not converge to the same result as with regular renderThread.
-				//I assume that's because we'd have to init the sampler differently when we render all
-				//the tiles in one go per sample, instead of the other way around.
-				sampler_init(sampler, SAMPLING_STRATEGY, r->state.finishedPasses, r->prefs.sampleCount, pixIdx);
-				
-				struct color output = tex_get_px(*buf, x, y, false);
-				thread_rwlock_rdlock(&r->scene->bvh_lock);
-				struct color sample = path_trace(cam_get_ray(cam, x, y, sampler), r->scene, r->prefs.bounces, sampler);
-				thread_rwlock_unlock(&r->scene->bvh_lock);
-
-				nan_clamp(&sample, &output);
-				
-				//And process the running average
-				output = colorCoef((float)(r->state.finishedPasses - 1), output);
-				output = colorAdd(output, sample);
-				float t = 1.0f / r->state.finishedPasses;
-				output = colorCoef(t, output);
-				
-				//Store internal render buffer (float precision)
+		for (size_t p = 0; p < set->pixel_count; ++p) {
+			const int x = tile->begin.x + set->pixels[p].x;
+			const int y = tile->begin.y + set->pixels[p].y;
+			if (x >= tile->end.x || y >= tile->end.y) continue;
+			if (preview && preview_level_of(x, y, top) != level) continue;
+			if (r->state.s != r_rendering) goto exit;
+			if (r->state.restarting) {
+				dropped = true;
+				break;
+			}
+			uint32_t pixIdx = (uint32_t)(y * (*buf)->width + x);
+			//FIXME: This does not converge to the same result as with regular renderThread.
+			//I assume that's because we'd have to init the sampler differently when we render all
+			//the tiles in one go per sample, instead of the other way around.
+			sampler_init(sampler, SAMPLING_STRATEGY, r->state.finishedPasses, r->prefs.sampleCount, pixIdx);
+			
+			struct color output = tex_get_px(*buf, x, y, false);
+			struct path_aux aux;
+			thread_rwlock_rdlock(&r->scene->bvh_lock);
+			struct color sample = path_trace(cam_get_ray(cam, x, y, sampler), r->scene, r->prefs.bounces, sampler, r->state.aov_mask ? &aux : NULL, NULL);
+			thread_rwlock_unlock(&r->scene->bvh_lock);
+
+			nan_clamp(&sample, &output);
+			const struct color prev_mean = output;
+			
+			//And process the running average. Reprojected pixels start out with some weight already.
+			struct texture *weights = r->state.weight_buf;
+			const float weight = weights ? tex_get_px(weights, x, y, false).red : (float)(r->state.finishedPasses - 1);
+			output = colorCoef(weight, output);
+			output = colorAdd(output, sample);
+			float t = 1.0f / (weight + 1.0f);
+			output = colorCoef(t, output);
+			if (weights) tex_set_px(weights, (struct color){ weight + 1.0f, weight + 1.0f, weight + 1.0f, 1.0f }, x, y);
+			if (r->state.aov_mask) accumulate_aovs(r, x, y, r->state.finishedPasses, &aux, sample, prev_mean, output);
+			
+			//Store internal render buffer (float precision)
+			if (preview && level) {
+				fill_preview_block(*buf, weights, x, y, level, output);
+			} else {
 				tex_set_px(*buf, output, x, y);
 			}
 		}
-		//For performance metrics
-		total_us += timer_get_us(timer);
-		threadState->totalSamples++;
-		threadState->avg_per_sample_us = total_us / r->state.finishedPasses;
+		//For performance metrics. Coarse refinement levels only trace a fraction of the tile.
+		if ((!preview || !level) && !dropped) {
+			total_us += timer_get_us(timer);
+			threadState->totalSamples++;
+			threadState->avg_per_sample_us = total_us;
+		}
 		
 		//Tile has finished rendering, get a new one and start rendering it.
+		//This blocks while paused, and at pass boundaries until the pass is done.
 		tile->state = finished;
 		threadState->currentTile = NULL;
 		tile = tile_next_interactive(r, threadState->tiles);
-		//Pause rendering when bool is set
-		while (threadState->paused && r->state.s == r_rendering) {
-			threadState->in_pause_loop = true;
-			timer_sleep_ms(100);
-		}
-		if (threadState->in_pause_loop) {
-			tile = tile_next_interactive(r, threadState->tiles);
-			threadState->in_pause_loop = false;
-		}
-		// In case we got NULL back because we were paused:
-		if (!tile) tile = tile_next_interactive(r, threadState->tiles);
 		threadState->currentTile = tile;
 	}
 exit:
@@ -393,6 +785,85 @@ exit:
 	return 0;
 }
 
+// Fold a sample traced for pixel (x, y) into the running average in output
+static inline struct color fold_sample(struct renderer *r, int x, int y, size_t samples, struct color output, struct color sample, const struct path_aux *aux) {
+	// Clamp out fireflies - This is probably not a good way to do that.
+	nan_clamp(&sample, &output);
+	const struct color prev_mean = output;
+
+	//And process the running average
+	output = colorCoef((float)(samples - 1), output);
+	output = colorAdd(output, sample);
+	float t = 1.0f / samples;
+	output = colorCoef(t, output);
+	if (r->state.aov_mask) accumulate_aovs(r, x, y, samples, aux, sample, prev_mean, output);
+	return output;
+}
+
+// Trace one sample for pixel (x, y), and fold it into the running average in output
+static inline struct color accumulate_sample(struct renderer *r, const struct camera *cam, sampler *sampler, size_t width, int x, int y, size_t samples, struct color output) {
+	uint32_t pixIdx = (uint32_t)(y * width + x);
+	sampler_init(sampler, SAMPLING_STRATEGY, samples - 1, r->prefs.sampleCount, pixIdx);
+
+	struct path_aux aux;
+	thread_rwlock_rdlock(&r->scene->bvh_lock);
+	struct color sample = path_trace(cam_get_ray(cam, x, y, sampler), r->scene, r->prefs.bounces, sampler, r->state.aov_mask ? &aux : NULL, NULL);
+	thread_rwlock_unlock(&r->scene->bvh_lock);
+
+	return fold_sample(r, x, y, samples, output, sample, &aux);
+}
+
+// Per-thread buffers for tracing a whole tile at once with path_trace_sorted()
+struct tile_paths {
+	struct sampler *samplers;
+	struct path_query *queries;
+	struct path_aux *aux;
+};
+
+static struct tile_paths tile_paths_new(size_t pixel_count) {
+	return (struct tile_paths){
+		.samplers = calloc(pixel_count, sizeof(struct sampler)),
+		.queries = calloc(pixel_count, sizeof(struct path_query)),
+		.aux = calloc(pixel_count, sizeof(struct path_aux)),
+	};
+}
+
+static void tile_paths_destroy(struct tile_paths *paths) {
+	free(paths->samplers);
+	free(paths->queries);
+	free(paths->aux);
+}
+
+// Trace one sample for every pixel in tile, and fold them into buf
+static void accumulate_tile_sorted(struct renderer *r, const struct camera *cam, const struct render_tile *tile, const struct tile_set *set, struct texture *buf, size_t samples, struct tile_paths *paths) {
+	size_t count = 0;
+	for (size_t p = 0; p < set->pixel_count; ++p) {
+		const int x = tile->begin.x + set->pixels[p].x;
+		const int y = tile->begin.y + set->pixels[p].y;
+		if (x >= tile->end.x || y >= tile->end.y) continue;
+		sampler *sampler = &paths->samplers[count];
+		sampler_init(sampler, SAMPLING_STRATEGY, samples - 1, r->prefs.sampleCount, (uint32_t)(y * buf->width + x));
+		paths->queries[count] = (struct path_query){
+			.incident = cam_get_ray(cam, x, y, sampler),
+			.sampler = sampler,
+			.aux = r->state.aov_mask ? &paths->aux[count] : NULL,
+		};
+		count++;
+	}
+	thread_rwlock_rdlock(&r->scene->bvh_lock);
+	path_trace_sorted(paths->queries, count, r->scene, r->prefs.bounces);
+	thread_rwlock_unlock(&r->scene->bvh_lock);
+	count = 0;
+	for (size_t p = 0; p < set->pixel_count; ++p) {
+		const int x = tile->begin.x + set->pixels[p].x;
+		const int y = tile->begin.y + set->pixels[p].y;
+		if (x >= tile->end.x || y >= tile->end.y) continue;
+		const struct path_query *query = &paths->queries[count++];
+		const struct color output = tex_get_px(buf, x, y, false);
+		tex_set_px(buf, fold_sample(r, x, y, samples, output, query->result, query->aux), x, y);
+	}
+}
+
 /**
  A render thread
  
@@ -402,14 +873,19 @@ exit:
 void *render_thread(void *arg) {
 	block_signals();
 	struct worker *threadState = arg;
+	pin_worker(threadState);
 	struct renderer *r = threadState->renderer;
 	struct texture **buf = threadState->buf;
+	struct tile_set *set = threadState->tiles;
 	sampler *sampler = sampler_new();
 
 	struct camera *cam = threadState->cam;
+	// Samples go through a tile at a time, so pixel major renders trace paths one by one
+	const bool sorted = r->prefs.sort_hits && !r->prefs.pixel_major;
+	struct tile_paths paths = sorted ? tile_paths_new(set->pixel_count) : (struct tile_paths){ 0 };
 
 	//First time setup for each thread
-	struct render_tile *tile = tile_next(threadState->tiles);
+	struct render_tile *tile = tile_next(set);
 	threadState->currentTile = tile;
 	
 	struct timeval timer = { 0 };
@@ -417,52 +893,62 @@ void *render_thread(void *arg) {
 	
 	while (tile && r->state.s == r_rendering) {
 		long total_us = 0;
+		// Tiles restored from a checkpoint may already have samples in them
+		samples = tile->completed_samples + 1;
 		
-		while (samples < r->prefs.sampleCount + 1 && r->state.s == r_rendering) {
+		if (r->prefs.pixel_major) {
+			// Render all samples for a pixel before moving on to the next one.
 			timer_start(&timer);
-			for (int y = tile->end.y - 1; y > tile->begin.y - 1; --y) {
-				for (int x = tile->begin.x; x < tile->end.x; ++x) {
+			for (size_t p = 0; p < set->pixel_count; ++p) {
+				const int x = tile->begin.x + set->pixels[p].x;
+				const int y = tile->begin.y + set->pixels[p].y;
+				if (x >= tile->end.x || y >= tile->end.y) continue;
+				struct color output = tex_get_px(*buf, x, y, false);
+				for (samples = tile->completed_samples + 1; samples < r->prefs.sampleCount + 1; ++samples) {
 					if (r->state.s != r_rendering) goto exit;
-					uint32_t pixIdx = (uint32_t)(y * (*buf)->width + x);
-					sampler_init(sampler, SAMPLING_STRATEGY, samples - 1, r->prefs.sampleCount, pixIdx);
-					
-					struct color output = tex_get_px(*buf, x, y, false);
-					thread_rwlock_rdlock(&r->scene->bvh_lock);
-					struct color sample = path_trace(cam_get_ray(cam, x, y, sampler), r->scene, r->prefs.bounces, sampler);
-					thread_rwlock_unlock(&r->scene->bvh_lock);
-					
-					// Clamp out fireflies - This is probably not a good way to do that.
-					nan_clamp(&sample, &output);
-
-					//And process the running average
-					output = colorCoef((float)(samples - 1), output);
-					output = colorAdd(output, sample);
-					float t = 1.0f / samples;
-					output = colorCoef(t, output);
-					
-					//Store internal render buffer (float precision)
-					tex_set_px(*buf, output, x, y);
+					output = accumulate_sample(r, cam, sampler, (*buf)->width, x, y, samples, output);
 				}
+				//Store internal render buffer (float precision)
+				tex_set_px(*buf, output, x, y);
+				if (unlikely(r->state.paused)) tile_wait_while_paused(r, set);
+			}
+			total_us += timer_get_us(timer);
+			threadState->totalSamples += r->prefs.sampleCount;
+			tile->completed_samples = r->prefs.sampleCount;
+			threadState->avg_per_sample_us = total_us / max(r->prefs.sampleCount, 1);
+		}
+
+		while (samples < r->prefs.sampleCount + 1 && r->state.s == r_rendering) {
+			timer_start(&timer);
+			if (sorted) accumulate_tile_sorted(r, cam, tile, set, *buf, samples, &paths);
+			for (size_t p = 0; p < set->pixel_count && !sorted; ++p) {
+				const int x = tile->begin.x + set->pixels[p].x;
+				const int y = tile->begin.y + set->pixels[p].y;
+				if (x >= tile->end.x || y >= tile->end.y) continue;
+				if (r->state.s != r_rendering) goto exit;
+				struct color output = tex_get_px(*buf, x, y, false);
+				output = accumulate_sample(r, cam, sampler, (*buf)->width, x, y, samples, output);
+				//Store internal render buffer (float precision)
+				tex_set_px(*buf, output, x, y);
 			}
 			//For performance metrics
 			total_us += timer_get_us(timer);
 			threadState->totalSamples++;
 			samples++;
 			tile->completed_samples++;
-			//Pause rendering when bool is set
-			while (threadState->paused && r->state.s == r_rendering) {
-				timer_sleep_ms(100);
-			}
+			//Pause rendering when requested
+			tile_wait_while_paused(r, set);
 			threadState->avg_per_sample_us = total_us / samples;
 		}
 		//Tile has finished rendering, get a new one and start rendering it.
 		tile->state = finished;
 		threadState->currentTile = NULL;
 		samples = 1;
-		tile = tile_next(threadState->tiles);
+		tile = tile_next(set);
 		threadState->currentTile = tile;
 	}
 exit:
+	tile_paths_destroy(&paths);
 	sampler_destroy(sampler);
 	//No more tiles to render, exit thread. (render done)
 	threadState->thread_complete = true;
@@ -478,6 +964,8 @@ struct prefs default_prefs(void) {
 			.bounces = 20,
 			.tileWidth = 32,
 			.tileHeight = 32,
+			.checkpoint_interval = 120,
+			.texture_cache_mb = 1024,
 	};
 }
 
@@ -485,6 +973,9 @@ struct renderer *renderer_new(void) {
 	struct renderer *r = calloc(1, sizeof(*r));
 	r->prefs = default_prefs();
 	r->state.finishedPasses = 1;
+	r->state.preview_top = r->state.preview_level = PREVIEW_LEVELS;
+	r->state.stop_lock = mutex_create();
+	thread_cond_init(&r->state.stopped);
 	
 	// Move these elsewhere
 	r->scene = calloc(1, sizeof(*r->scene));
@@ -503,6 +994,16 @@ void renderer_destroy(struct renderer *r) {
 	worker_arr_free(&r->state.workers);
 	render_client_arr_free(&r->state.clients);
 	if (r->prefs.node_list) free(r->prefs.node_list);
+	if (r->prefs.checkpoint_path) free(r->prefs.checkpoint_path);
+	if (r->prefs.resume_path) free(r->prefs.resume_path);
 	if (r->state.result_buf) tex_destroy(r->state.result_buf);
+	for (size_t i = 0; i < cr_aov_count; ++i) free_buf(&r->state.aovs[i]);
+	free_buf(&r->state.denoised_buf);
+	free_buf(&r->state.weight_buf);
+	reproject_scratch_free(&r->state.reproject_scratch);
+	if (r->state.stop_lock) {
+		thread_cond_destroy(&r->state.stopped);
+		mutex_destroy(r->state.stop_lock);
+	}
 	free(r);
 }
@@ -10,22 +10,23 @@
 
 #include <c-ray/c-ray.h>
 #include <datatypes/tile.h>
+#include <datatypes/camera.h>
 #include <common/platform/thread.h>
+#include <common/timer.h>
 #include <protocol/server.h>
+#include "reproject.h"
 
 struct worker {
 	struct cr_thread thread;
 	bool thread_complete;
 	
-	bool paused; //SDL listens for P key pressed, which sets these, one for each thread.
-	bool in_pause_loop;
-	
 	//Share info about the current tile with main thread
 	struct tile_set *tiles;
 	struct render_tile *currentTile;
 	uint64_t totalSamples;
 	
 	long avg_per_sample_us; //Single tile pass
+	int core; //Logical core to pin to, -1 to let the OS schedule
 
 	struct camera *cam;
 	struct renderer *renderer;
@@ -47,10 +48,27 @@ enum renderer_state {
 	r_exiting,
 };
 
+// The first interactive pass after a (re)start is split into refinement levels. The top
+// level traces one pixel per 2^level block and fills the block in, each following level
+// traces the pixels on the next finer grid, and level 0 completes the pass.
+// The top level is PREVIEW_LEVELS, or picked to hit prefs.target_frame_ms.
+#define PREVIEW_LEVELS 3
+#define MAX_PREVIEW_LEVELS 5
+
 /// Renderer state data
 struct state {
 	size_t finishedPasses; // For interactive mode
+	unsigned preview_top; // Coarsest refinement level of the first interactive pass, see PREVIEW_LEVELS
+	unsigned preview_level; // Current refinement level
+	struct timeval pass_timer; // Started on every interactive pass boundary
+	long pass_us; // Duration of the last full interactive pass, 0 if not measured yet
 	enum renderer_state s;
+	// Broadcast under stop_lock when renderer_render() returns to r_idle, for cr_renderer_stop().
+	// current_set is only cleared with stop_lock held, so stopping can't race with the set going away.
+	struct cr_mutex *stop_lock;
+	struct cr_cond stopped;
+	bool paused; // Guarded by current_set->tile_mutex while rendering
+	bool restarting; // Interactive render threads drop their tiles, the samples would be thrown out anyway
 	struct worker_arr workers;
 	struct render_client_arr clients;
 	// TODO: Single callback that has event type as first arg
@@ -59,18 +77,29 @@ struct state {
 	struct callback callbacks[5];
 
 	struct texture *result_buf;
+	// Indexed by enum cr_aov, only the ones in aov_mask are allocated
+	struct texture *aovs[cr_aov_count];
+	uint32_t aov_mask;
+	struct texture *denoised_buf;
+	bool denoised_valid; // denoised_buf was filtered from what's currently in result_buf
+	struct texture *weight_buf; // Samples accumulated per pixel, only kept when reprojecting
+	struct camera prev_cam; // Pose the accumulated samples were rendered from, for reprojection
+	struct reproject_scratch reproject_scratch;
 	struct tile_set *current_set;
+	double us_per_px_sample; // Measured in the previous render, for tile size tuning
 };
 
 /// Preferences data (Set by user)
 struct prefs {
 	enum render_order tileOrder;
+	enum pixel_order pixelOrder; //Pixel traversal order within a tile
 	
 	size_t threads; //Amount of threads to render with
 	size_t sampleCount;
 	size_t bounces;
 	unsigned tileWidth;
 	unsigned tileHeight;
+	bool tile_auto; //Pick tileWidth & tileHeight automatically
 	
 	//Output prefs
 	unsigned override_width;
@@ -79,6 +108,20 @@ struct prefs {
 	char *node_list;
 	bool iterative;
 	bool blender_mode;
+	bool pixel_major; //Render all samples of a pixel before moving to the next one
+	bool pin_threads; //Pin render threads to cores, spread across NUMA nodes
+	bool denoise; //Run the built-in denoiser after rendering, or periodically in iterative mode
+	uint32_t aovs; //Bitmask of enum cr_aov to render
+	bool path_guiding; //Learn the incident light distribution before rendering, and sample from it
+	unsigned target_frame_ms; //Interactive mode: lower the first pass resolution to show something within this time, 0 to disable
+	bool reproject; //Interactive mode: carry accumulated samples over to the new view when the camera moves
+	bool sort_hits; //Trace a tile's paths side by side, and shade the hits of each bounce grouped by material
+	size_t texture_cache_mb; //Memory budget for texture pages, when a texture cache is in use
+
+	//Checkpointing, offline renders only
+	char *checkpoint_path; //Periodically save progress here
+	char *resume_path; //Continue from this checkpoint
+	unsigned checkpoint_interval; //Seconds
 };
 
 struct renderer {
@@ -89,10 +132,24 @@ struct renderer {
 
 struct renderer *renderer_new(void);
 void renderer_render(struct renderer *r);
+bool renderer_auto_tile_dims(struct renderer *r, unsigned width, unsigned height, bool hysteresis);
 void renderer_start_interactive(struct renderer *r);
 void renderer_destroy(struct renderer *r);
 
 // Exposed for now, so API calls can synchronously ensure the BVH is up to date
 void update_toplevel_bvh(struct world *s);
+void update_light_list(struct world *s);
+
+// (Re)allocate or clear AOV & denoiser buffers to match result_buf, and free the ones no longer needed.
+// Render threads must not be running.
+void renderer_update_aov_buffers(struct renderer *r);
+void renderer_clear_aov_buffers(struct renderer *r);
+// Filter result_buf into denoised_buf
+void renderer_denoise(struct renderer *r);
+// Start over with progressive refinement of the first interactive pass
+void renderer_start_preview(struct renderer *r);
+// Start accumulating samples over for the current pose of cam. With carry_over, the samples so far
+// are reprojected to it instead of being discarded, and render threads must not be running.
+void renderer_reset_accumulation(struct renderer *r, const struct camera *cam, bool carry_over);
 
 struct prefs default_prefs(void); // TODO: Remove
@@ -0,0 +1,228 @@
+//
+//  reproject.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../../includes.h"
+#include "reproject.h"
+
+#include <common/texture.h>
+#include <common/logging.h>
+#include <common/timer.h>
+#include <common/platform/thread.h>
+#include <datatypes/camera.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define REPROJECT_WEIGHT 0.5f // Fraction of the sample weight carried over per camera move
+#define REPROJECT_MAX_WEIGHT 16.0f // So view dependent shading catches up quickly
+#define REPROJECT_DEPTH_TOLERANCE 0.05f // Relative
+
+// Distance 0 is a miss, so infinitely far away
+static inline bool nearer(float a, float b) {
+	return a > 0.0f && (b <= 0.0f || a * (1.0f + REPROJECT_DEPTH_TOLERANCE) < b);
+}
+
+static inline bool covered(const struct texture *weight, int x, int y) {
+	if (x < 0 || y < 0 || x >= (int)weight->width || y >= (int)weight->height) return false;
+	return tex_get_px(weight, x, y, false).red > 0.0f;
+}
+
+// When a surface gets closer, it covers more pixels than it had samples for, and whatever
+// was behind it shows through the gaps. Those pixels have nearer neighbours on both sides.
+static bool leaks_through(const struct texture *depth, const struct texture *weight, int x, int y) {
+	static const int axes[4][2] = { { 1, 0 }, { 0, 1 }, { 1, 1 }, { 1, -1 } };
+	const float d = tex_get_px(depth, x, y, false).red;
+	for (size_t a = 0; a < 4; ++a) {
+		const int ax = x + axes[a][0], ay = y + axes[a][1];
+		const int bx = x - axes[a][0], by = y - axes[a][1];
+		if (!covered(weight, ax, ay) || !covered(weight, bx, by)) continue;
+		if (nearer(tex_get_px(depth, ax, ay, false).red, d) && nearer(tex_get_px(depth, bx, by, false).red, d)) return true;
+	}
+	return false;
+}
+
+struct reproject_job {
+	struct reproject_scratch *s;
+	const struct texture *color;
+	const struct texture *depth;
+	const struct texture *weight;
+	const struct camera *from;
+	const struct camera *to;
+	size_t y_begin;
+	size_t y_end;
+	size_t kept;
+};
+
+// Where each source pixel in rows [y_begin, y_end) lands in the new view
+static void *project_rows(void *arg) {
+	struct reproject_job *j = arg;
+	const size_t width = j->s->width, height = j->s->height;
+	for (size_t y = j->y_begin; y < j->y_end; ++y) {
+		for (size_t x = 0; x < width; ++x) {
+			const size_t i = y * width + x;
+			j->s->target[i] = -1;
+			const float w = tex_get_px(j->weight, x, y, false).red;
+			if (w <= 0.0f) continue;
+			const float d = tex_get_px(j->depth, x, y, false).red;
+			const struct vector p = cam_unproject(j->from, x, y, d);
+			float new_x, new_y, new_d;
+			if (!cam_project(j->to, p, d, &new_x, &new_y, &new_d)) continue;
+			const int px = (int)floorf(new_x + 0.5f);
+			const int py = (int)floorf(new_y + 0.5f);
+			if (px < 0 || py < 0 || px >= (int)width || py >= (int)height) continue;
+			j->s->target[i] = py * (int32_t)width + px;
+			j->s->target_depth[i] = new_d;
+		}
+	}
+	return NULL;
+}
+
+// Fill rows [y_begin, y_end) of the new buffers from the source pixels picked for them
+static void *gather_rows(void *arg) {
+	struct reproject_job *j = arg;
+	struct reproject_scratch *s = j->s;
+	const size_t width = s->width;
+	for (size_t y = j->y_begin; y < j->y_end; ++y) {
+		for (size_t x = 0; x < width; ++x) {
+			const int32_t src = s->source[y * width + x];
+			if (src < 0) {
+				tex_set_px(s->color, (struct color){ 0 }, x, y);
+				tex_set_px(s->depth, (struct color){ 0 }, x, y);
+				tex_set_px(s->weight, (struct color){ 0 }, x, y);
+				continue;
+			}
+			const size_t sx = (size_t)src % width, sy = (size_t)src / width;
+			const float new_d = s->target_depth[src];
+			const float new_w = min(tex_get_px(j->weight, sx, sy, false).red * REPROJECT_WEIGHT, REPROJECT_MAX_WEIGHT);
+			tex_set_px(s->color, tex_get_px(j->color, sx, sy, false), x, y);
+			tex_set_px(s->depth, (struct color){ new_d, new_d, new_d, 1.0f }, x, y);
+			tex_set_px(s->weight, (struct color){ new_w, new_w, new_w, 1.0f }, x, y);
+		}
+	}
+	return NULL;
+}
+
+static void *find_leaks_rows(void *arg) {
+	struct reproject_job *j = arg;
+	struct reproject_scratch *s = j->s;
+	for (size_t y = j->y_begin; y < j->y_end; ++y) {
+		for (size_t x = 0; x < s->width; ++x) {
+			s->reject[y * s->width + x] = covered(s->weight, x, y) && leaks_through(s->depth, s->weight, x, y);
+		}
+	}
+	return NULL;
+}
+
+static void *drop_leaks_rows(void *arg) {
+	struct reproject_job *j = arg;
+	struct reproject_scratch *s = j->s;
+	for (size_t y = j->y_begin; y < j->y_end; ++y) {
+		for (size_t x = 0; x < s->width; ++x) {
+			if (s->reject[y * s->width + x]) {
+				tex_set_px(s->color, (struct color){ 0 }, x, y);
+				tex_set_px(s->depth, (struct color){ 0 }, x, y);
+				tex_set_px(s->weight, (struct color){ 0 }, x, y);
+			} else if (covered(s->weight, x, y)) {
+				j->kept++;
+			}
+		}
+	}
+	return NULL;
+}
+
+// Split the rows into bands, the calling thread takes the first one
+static void run_rows(struct reproject_job *jobs, struct cr_thread *workers, size_t threads, void *(*fn)(void *)) {
+	for (size_t t = 1; t < threads; ++t) {
+		workers[t] = (struct cr_thread){ .thread_fn = fn, .user_data = &jobs[t] };
+		thread_start(&workers[t]);
+	}
+	fn(&jobs[0]);
+	for (size_t t = 1; t < threads; ++t) thread_wait(&workers[t]);
+}
+
+static void scratch_resize(struct reproject_scratch *s, size_t width, size_t height) {
+	if (s->color && s->width == width && s->height == height) return;
+	reproject_scratch_free(s);
+	s->width = width;
+	s->height = height;
+	s->color = tex_new(float_p, width, height, 4);
+	s->depth = tex_new(float_p, width, height, 4);
+	s->weight = tex_new(float_p, width, height, 4);
+	s->target = malloc(width * height * sizeof(*s->target));
+	s->target_depth = malloc(width * height * sizeof(*s->target_depth));
+	s->source = malloc(width * height * sizeof(*s->source));
+	s->reject = malloc(width * height * sizeof(*s->reject));
+}
+
+void reproject_scratch_free(struct reproject_scratch *s) {
+	if (!s) return;
+	if (s->color) tex_destroy(s->color);
+	if (s->depth) tex_destroy(s->depth);
+	if (s->weight) tex_destroy(s->weight);
+	if (s->target) free(s->target);
+	if (s->target_depth) free(s->target_depth);
+	if (s->source) free(s->source);
+	if (s->reject) free(s->reject);
+	*s = (struct reproject_scratch){ 0 };
+}
+
+static void swap_tex(struct texture **a, struct texture **b) {
+	struct texture *tmp = *a;
+	*a = *b;
+	*b = tmp;
+}
+
+void reproject(struct reproject_scratch *scratch, struct texture **color, struct texture **depth, struct texture **weight, const struct camera *from, const struct camera *to, size_t threads) {
+	struct timeval timer;
+	timer_start(&timer);
+	const size_t width = (*color)->width;
+	const size_t height = (*color)->height;
+	if (!width || !height) return;
+	scratch_resize(scratch, width, height);
+	if (threads < 1) threads = 1;
+	if (threads > height) threads = height;
+	struct reproject_job *jobs = calloc(threads, sizeof(*jobs));
+	struct cr_thread *workers = calloc(threads, sizeof(*workers));
+	for (size_t t = 0; t < threads; ++t) {
+		jobs[t] = (struct reproject_job){
+			.s = scratch,
+			.color = *color,
+			.depth = *depth,
+			.weight = *weight,
+			.from = from,
+			.to = to,
+			.y_begin = height * t / threads,
+			.y_end = height * (t + 1) / threads,
+		};
+	}
+
+	run_rows(jobs, workers, threads, project_rows);
+	// Resolve pixels several samples land on in source order, so the result doesn't depend on the thread count.
+	// This is a plain pass over two arrays, the projections above are the expensive part.
+	for (size_t i = 0; i < width * height; ++i) scratch->source[i] = -1;
+	for (size_t i = 0; i < width * height; ++i) {
+		const int32_t t = scratch->target[i];
+		if (t < 0) continue;
+		const int32_t prev = scratch->source[t];
+		if (prev >= 0 && !nearer(scratch->target_depth[i], scratch->target_depth[prev])) continue;
+		scratch->source[t] = (int32_t)i;
+	}
+	run_rows(jobs, workers, threads, gather_rows);
+	// Leaks are found on the complete new buffers, and dropped once they're all known
+	run_rows(jobs, workers, threads, find_leaks_rows);
+	run_rows(jobs, workers, threads, drop_leaks_rows);
+	size_t kept = 0;
+	for (size_t t = 0; t < threads; ++t) kept += jobs[t].kept;
+	free(workers);
+	free(jobs);
+
+	// The old buffers are the scratch ones next time
+	swap_tex(color, &scratch->color);
+	swap_tex(depth, &scratch->depth);
+	swap_tex(weight, &scratch->weight);
+	logr(debug, "Reprojected %.1f%% of pixels, took %lums\n", 100.0 * (double)kept / (double)(width * height), timer_get_ms(timer));
+}
@@ -0,0 +1,43 @@
+//
+//  reproject.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct texture;
+struct camera;
+
+// Kept between calls, so moving the camera around doesn't allocate full frame buffers every time.
+// The textures get swapped with the ones passed to reproject(), so they're always the previous frame's.
+struct reproject_scratch {
+	struct texture *color;
+	struct texture *depth;
+	struct texture *weight;
+	int32_t *target; // Per source pixel, the pixel it lands on, -1 if none
+	float *target_depth; // Per source pixel, its distance from the new camera
+	int32_t *source; // Per target pixel, the source pixel kept there, -1 if none
+	uint8_t *reject;
+	size_t width;
+	size_t height;
+};
+
+void reproject_scratch_free(struct reproject_scratch *s);
+
+/// Carry accumulated samples over to a new camera pose. Every pixel with a known first hit is
+/// moved to where that hit lands in the new view, keeping the nearest one if several land on
+/// the same pixel. Its sample weight is reduced, so stale shading fades out as new samples come in.
+/// Pixels nothing lands on, such as ones uncovered from behind an edge, are left empty.
+/// All buffers have to be 4 channel float textures of the same size, and are swapped with scratch ones.
+/// @param scratch Reused between calls, resized as needed
+/// @param color Accumulated color
+/// @param depth First hit distance per pixel, 0 for misses
+/// @param weight Samples accumulated per pixel
+/// @param threads Amount of threads to split the rows between
+void reproject(struct reproject_scratch *scratch, struct texture **color, struct texture **depth, struct texture **weight, const struct camera *from, const struct camera *to, size_t threads);
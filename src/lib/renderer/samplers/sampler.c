@@ -3,26 +3,14 @@
 //  c-ray
 //
 //  Created by Valtteri on 28.4.2020.
-//  Copyright © 2020-2022 Valtteri Koskivuori. All rights reserved.
+//  Copyright © 2020-2026 Valtteri Koskivuori. All rights reserved.
 //
 
 #include <stdint.h>
 #include <stdlib.h>
-#include "halton.h"
-#include "hammersley.h"
-#include "random.h"
 #include "sampler.h"
 #include "common.h"
 
-struct sampler {
-	enum samplerType type;
-	union {
-		hammersleySampler hammersley;
-		haltonSampler halton;
-		randomSampler random;
-	} sampler;
-};
-
 struct sampler *sampler_new(void) {
 	return calloc(1, sizeof(struct sampler));
 }
@@ -41,10 +29,18 @@ void sampler_init(sampler *sampler, enum samplerType type, int pass, int maxPass
 			initRandom(&sampler->sampler.random, hash64(pixelIndex * maxPasses + pass));
 			sampler->type = Random;
 			break;
+		case Sobol:
+			initSobol(&sampler->sampler.sobol, pass, hash(pixelIndex));
+			sampler->type = Sobol;
+			break;
 	}
 }
 
-float sampler_dimension(struct sampler *sampler) {
+void sampler_start_bounce(struct sampler *sampler, unsigned bounce) {
+	if (sampler->type == Sobol) sobolStartBounce(&sampler->sampler.sobol, bounce);
+}
+
+float sampler_dimension_generic(struct sampler *sampler) {
 	switch (sampler->type) {
 		case Hammersley:
 			return getHammersley(&sampler->sampler.hammersley);
@@ -52,6 +48,8 @@ float sampler_dimension(struct sampler *sampler) {
 			return getHalton(&sampler->sampler.halton);
 		case Random:
 			return getRandom(&sampler->sampler.random);
+		case Sobol:
+			return getSobol(&sampler->sampler.sobol);
 	}
 	return 0;
 }
@@ -3,26 +3,52 @@
 //  c-ray
 //
 //  Created by Valtteri on 28.4.2020.
-//  Copyright © 2020-2021 Valtteri Koskivuori. All rights reserved.
+//  Copyright © 2020-2026 Valtteri Koskivuori. All rights reserved.
 //
 
 #pragma once
 
 #include <stdint.h>
-
-struct sampler;
-typedef struct sampler sampler;
+#include "../../../includes.h"
+#include "halton.h"
+#include "hammersley.h"
+#include "random.h"
+#include "sobol.h"
 
 enum samplerType {
 	Halton = 0,
 	Hammersley,
-	Random
+	Random,
+	Sobol
 };
 
+// Exposed so sampler_dimension() can be inlined into the hot loop
+struct sampler {
+	enum samplerType type;
+	union {
+		hammersleySampler hammersley;
+		haltonSampler halton;
+		randomSampler random;
+		sobolSampler sobol;
+	} sampler;
+};
+typedef struct sampler sampler;
+
 struct sampler *sampler_new(void);
 
 void sampler_init(struct sampler *sampler, enum samplerType type, int pass, int maxPasses, uint32_t pixelIndex);
 
-float sampler_dimension(struct sampler *sampler);
+// Call at the start of each bounce, so samplers that support it can
+// give every bounce the same set of dimensions, no matter how many the
+// previous bounces consumed.
+void sampler_start_bounce(struct sampler *sampler, unsigned bounce);
+
+float sampler_dimension_generic(struct sampler *sampler);
+
+static inline float sampler_dimension(struct sampler *sampler) {
+	// Skip the type switch for the default strategy
+	if (likely(sampler->type == Sobol)) return getSobol(&sampler->sampler.sobol);
+	return sampler_dimension_generic(sampler);
+}
 
 void sampler_destroy(struct sampler *sampler);
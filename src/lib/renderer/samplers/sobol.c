@@ -0,0 +1,624 @@
+//
+//  sobol.c
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include <stdint.h>
+#include "sobol.h"
+
+// Generator matrices for the first 4 Sobol dimensions. The first one is the van der Corput
+// sequence, the rest are from Joe & Kuo's new-joe-kuo-6.21201 direction numbers.
+const uint32_t sobol_matrices[SOBOL_DIMENSIONS][32] = {
+	{
+		0x80000000, 0x40000000, 0x20000000, 0x10000000,
+		0x08000000, 0x04000000, 0x02000000, 0x01000000,
+		0x00800000, 0x00400000, 0x00200000, 0x00100000,
+		0x00080000, 0x00040000, 0x00020000, 0x00010000,
+		0x00008000, 0x00004000, 0x00002000, 0x00001000,
+		0x00000800, 0x00000400, 0x00000200, 0x00000100,
+		0x00000080, 0x00000040, 0x00000020, 0x00000010,
+		0x00000008, 0x00000004, 0x00000002, 0x00000001,
+	},
+	{
+		0x80000000, 0xc0000000, 0xa0000000, 0xf0000000,
+		0x88000000, 0xcc000000, 0xaa000000, 0xff000000,
+		0x80800000, 0xc0c00000, 0xa0a00000, 0xf0f00000,
+		0x88880000, 0xcccc0000, 0xaaaa0000, 0xffff0000,
+		0x80008000, 0xc000c000, 0xa000a000, 0xf000f000,
+		0x88008800, 0xcc00cc00, 0xaa00aa00, 0xff00ff00,
+		0x80808080, 0xc0c0c0c0, 0xa0a0a0a0, 0xf0f0f0f0,
+		0x88888888, 0xcccccccc, 0xaaaaaaaa, 0xffffffff,
+	},
+	{
+		0x80000000, 0xc0000000, 0x60000000, 0x90000000,
+		0xe8000000, 0x5c000000, 0x8e000000, 0xc5000000,
+		0x68800000, 0x9cc00000, 0xee600000, 0x55900000,
+		0x80680000, 0xc09c0000, 0x60ee0000, 0x90550000,
+		0xe8808000, 0x5cc0c000, 0x8e606000, 0xc5909000,
+		0x6868e800, 0x9c9c5c00, 0xeeee8e00, 0x5555c500,
+		0x8000e880, 0xc0005cc0, 0x60008e60, 0x9000c590,
+		0xe8006868, 0x5c009c9c, 0x8e00eeee, 0xc5005555,
+	},
+	{
+		0x80000000, 0xc0000000, 0x20000000, 0x50000000,
+		0xf8000000, 0x74000000, 0xa2000000, 0x93000000,
+		0xd8800000, 0x25400000, 0x59e00000, 0xe6d00000,
+		0x78080000, 0xb40c0000, 0x82020000, 0xc3050000,
+		0x208f8000, 0x51474000, 0xfbea2000, 0x75d93000,
+		0xa0858800, 0x914e5400, 0xdbe79e00, 0x25db6d00,
+		0x58800080, 0xe54000c0, 0x79e00020, 0xb6d00050,
+		0x800800f8, 0xc00c0074, 0x200200a2, 0x50050093,
+	},
+};
+
+// sobol_matrices multiplied out for every possible value of each byte of the index,
+// so sobol_sample() takes 4 lookups instead of 32 steps. Generated from the above.
+const uint32_t sobol_byte_tables[SOBOL_DIMENSIONS][4][256] = {
+	{
+		{
+			0x00000000, 0x80000000, 0x40000000, 0xc0000000, 0x20000000, 0xa0000000, 0x60000000, 0xe0000000,
+			0x10000000, 0x90000000, 0x50000000, 0xd0000000, 0x30000000, 0xb0000000, 0x70000000, 0xf0000000,
+			0x08000000, 0x88000000, 0x48000000, 0xc8000000, 0x28000000, 0xa8000000, 0x68000000, 0xe8000000,
+			0x18000000, 0x98000000, 0x58000000, 0xd8000000, 0x38000000, 0xb8000000, 0x78000000, 0xf8000000,
+			0x04000000, 0x84000000, 0x44000000, 0xc4000000, 0x24000000, 0xa4000000, 0x64000000, 0xe4000000,
+			0x14000000, 0x94000000, 0x54000000, 0xd4000000, 0x34000000, 0xb4000000, 0x74000000, 0xf4000000,
+			0x0c000000, 0x8c000000, 0x4c000000, 0xcc000000, 0x2c000000, 0xac000000, 0x6c000000, 0xec000000,
+			0x1c000000, 0x9c000000, 0x5c000000, 0xdc000000, 0x3c000000, 0xbc000000, 0x7c000000, 0xfc000000,
+			0x02000000, 0x82000000, 0x42000000, 0xc2000000, 0x22000000, 0xa2000000, 0x62000000, 0xe2000000,
+			0x12000000, 0x92000000, 0x52000000, 0xd2000000, 0x32000000, 0xb2000000, 0x72000000, 0xf2000000,
+			0x0a000000, 0x8a000000, 0x4a000000, 0xca000000, 0x2a000000, 0xaa000000, 0x6a000000, 0xea000000,
+			0x1a000000, 0x9a000000, 0x5a000000, 0xda000000, 0x3a000000, 0xba000000, 0x7a000000, 0xfa000000,
+			0x06000000, 0x86000000, 0x46000000, 0xc6000000, 0x26000000, 0xa6000000, 0x66000000, 0xe6000000,
+			0x16000000, 0x96000000, 0x56000000, 0xd6000000, 0x36000000, 0xb6000000, 0x76000000, 0xf6000000,
+			0x0e000000, 0x8e000000, 0x4e000000, 0xce000000, 0x2e000000, 0xae000000, 0x6e000000, 0xee000000,
+			0x1e000000, 0x9e000000, 0x5e000000, 0xde000000, 0x3e000000, 0xbe000000, 0x7e000000, 0xfe000000,
+			0x01000000, 0x81000000, 0x41000000, 0xc1000000, 0x21000000, 0xa1000000, 0x61000000, 0xe1000000,
+			0x11000000, 0x91000000, 0x51000000, 0xd1000000, 0x31000000, 0xb1000000, 0x71000000, 0xf1000000,
+			0x09000000, 0x89000000, 0x49000000, 0xc9000000, 0x29000000, 0xa9000000, 0x69000000, 0xe9000000,
+			0x19000000, 0x99000000, 0x59000000, 0xd9000000, 0x39000000, 0xb9000000, 0x79000000, 0xf9000000,
+			0x05000000, 0x85000000, 0x45000000, 0xc5000000, 0x25000000, 0xa5000000, 0x65000000, 0xe5000000,
+			0x15000000, 0x95000000, 0x55000000, 0xd5000000, 0x35000000, 0xb5000000, 0x75000000, 0xf5000000,
+			0x0d000000, 0x8d000000, 0x4d000000, 0xcd000000, 0x2d000000, 0xad000000, 0x6d000000, 0xed000000,
+			0x1d000000, 0x9d000000, 0x5d000000, 0xdd000000, 0x3d000000, 0xbd000000, 0x7d000000, 0xfd000000,
+			0x03000000, 0x83000000, 0x43000000, 0xc3000000, 0x23000000, 0xa3000000, 0x63000000, 0xe3000000,
+			0x13000000, 0x93000000, 0x53000000, 0xd3000000, 0x33000000, 0xb3000000, 0x73000000, 0xf3000000,
+			0x0b000000, 0x8b000000, 0x4b000000, 0xcb000000, 0x2b000000, 0xab000000, 0x6b000000, 0xeb000000,
+			0x1b000000, 0x9b000000, 0x5b000000, 0xdb000000, 0x3b000000, 0xbb000000, 0x7b000000, 0xfb000000,
+			0x07000000, 0x87000000, 0x47000000, 0xc7000000, 0x27000000, 0xa7000000, 0x67000000, 0xe7000000,
+			0x17000000, 0x97000000, 0x57000000, 0xd7000000, 0x37000000, 0xb7000000, 0x77000000, 0xf7000000,
+			0x0f000000, 0x8f000000, 0x4f000000, 0xcf000000, 0x2f000000, 0xaf000000, 0x6f000000, 0xef000000,
+			0x1f000000, 0x9f000000, 0x5f000000, 0xdf000000, 0x3f000000, 0xbf000000, 0x7f000000, 0xff000000,
+		},
+		{
+			0x00000000, 0x00800000, 0x00400000, 0x00c00000, 0x00200000, 0x00a00000, 0x00600000, 0x00e00000,
+			0x00100000, 0x00900000, 0x00500000, 0x00d00000, 0x00300000, 0x00b00000, 0x00700000, 0x00f00000,
+			0x00080000, 0x00880000, 0x00480000, 0x00c80000, 0x00280000, 0x00a80000, 0x00680000, 0x00e80000,
+			0x00180000, 0x00980000, 0x00580000, 0x00d80000, 0x00380000, 0x00b80000, 0x00780000, 0x00f80000,
+			0x00040000, 0x00840000, 0x00440000, 0x00c40000, 0x00240000, 0x00a40000, 0x00640000, 0x00e40000,
+			0x00140000, 0x00940000, 0x00540000, 0x00d40000, 0x00340000, 0x00b40000, 0x00740000, 0x00f40000,
+			0x000c0000, 0x008c0000, 0x004c0000, 0x00cc0000, 0x002c0000, 0x00ac0000, 0x006c0000, 0x00ec0000,
+			0x001c0000, 0x009c0000, 0x005c0000, 0x00dc0000, 0x003c0000, 0x00bc0000, 0x007c0000, 0x00fc0000,
+			0x00020000, 0x00820000, 0x00420000, 0x00c20000, 0x00220000, 0x00a20000, 0x00620000, 0x00e20000,
+			0x00120000, 0x00920000, 0x00520000, 0x00d20000, 0x00320000, 0x00b20000, 0x00720000, 0x00f20000,
+			0x000a0000, 0x008a0000, 0x004a0000, 0x00ca0000, 0x002a0000, 0x00aa0000, 0x006a0000, 0x00ea0000,
+			0x001a0000, 0x009a0000, 0x005a0000, 0x00da0000, 0x003a0000, 0x00ba0000, 0x007a0000, 0x00fa0000,
+			0x00060000, 0x00860000, 0x00460000, 0x00c60000, 0x00260000, 0x00a60000, 0x00660000, 0x00e60000,
+			0x00160000, 0x00960000, 0x00560000, 0x00d60000, 0x00360000, 0x00b60000, 0x00760000, 0x00f60000,
+			0x000e0000, 0x008e0000, 0x004e0000, 0x00ce0000, 0x002e0000, 0x00ae0000, 0x006e0000, 0x00ee0000,
+			0x001e0000, 0x009e0000, 0x005e0000, 0x00de0000, 0x003e0000, 0x00be0000, 0x007e0000, 0x00fe0000,
+			0x00010000, 0x00810000, 0x00410000, 0x00c10000, 0x00210000, 0x00a10000, 0x00610000, 0x00e10000,
+			0x00110000, 0x00910000, 0x00510000, 0x00d10000, 0x00310000, 0x00b10000, 0x00710000, 0x00f10000,
+			0x00090000, 0x00890000, 0x00490000, 0x00c90000, 0x00290000, 0x00a90000, 0x00690000, 0x00e90000,
+			0x00190000, 0x00990000, 0x00590000, 0x00d90000, 0x00390000, 0x00b90000, 0x00790000, 0x00f90000,
+			0x00050000, 0x00850000, 0x00450000, 0x00c50000, 0x00250000, 0x00a50000, 0x00650000, 0x00e50000,
+			0x00150000, 0x00950000, 0x00550000, 0x00d50000, 0x00350000, 0x00b50000, 0x00750000, 0x00f50000,
+			0x000d0000, 0x008d0000, 0x004d0000, 0x00cd0000, 0x002d0000, 0x00ad0000, 0x006d0000, 0x00ed0000,
+			0x001d0000, 0x009d0000, 0x005d0000, 0x00dd0000, 0x003d0000, 0x00bd0000, 0x007d0000, 0x00fd0000,
+			0x00030000, 0x00830000, 0x00430000, 0x00c30000, 0x00230000, 0x00a30000, 0x00630000, 0x00e30000,
+			0x00130000, 0x00930000, 0x00530000, 0x00d30000, 0x00330000, 0x00b30000, 0x00730000, 0x00f30000,
+			0x000b0000, 0x008b0000, 0x004b0000, 0x00cb0000, 0x002b0000, 0x00ab0000, 0x006b0000, 0x00eb0000,
+			0x001b0000, 0x009b0000, 0x005b0000, 0x00db0000, 0x003b0000, 0x00bb0000, 0x007b0000, 0x00fb0000,
+			0x00070000, 0x00870000, 0x00470000, 0x00c70000, 0x00270000, 0x00a70000, 0x00670000, 0x00e70000,
+			0x00170000, 0x00970000, 0x00570000, 0x00d70000, 0x00370000, 0x00b70000, 0x00770000, 0x00f70000,
+			0x000f0000, 0x008f0000, 0x004f0000, 0x00cf0000, 0x002f0000, 0x00af0000, 0x006f0000, 0x00ef0000,
+			0x001f0000, 0x009f0000, 0x005f0000, 0x00df0000, 0x003f0000, 0x00bf0000, 0x007f0000, 0x00ff0000,
+		},
+		{
+			0x00000000, 0x00008000, 0x00004000, 0x0000c000, 0x00002000, 0x0000a000, 0x00006000, 0x0000e000,
+			0x00001000, 0x00009000, 0x00005000, 0x0000d000, 0x00003000, 0x0000b000, 0x00007000, 0x0000f000,
+			0x00000800, 0x00008800, 0x00004800, 0x0000c800, 0x00002800, 0x0000a800, 0x00006800, 0x0000e800,
+			0x00001800, 0x00009800, 0x00005800, 0x0000d800, 0x00003800, 0x0000b800, 0x00007800, 0x0000f800,
+			0x00000400, 0x00008400, 0x00004400, 0x0000c400, 0x00002400, 0x0000a400, 0x00006400, 0x0000e400,
+			0x00001400, 0x00009400, 0x00005400, 0x0000d400, 0x00003400, 0x0000b400, 0x00007400, 0x0000f400,
+			0x00000c00, 0x00008c00, 0x00004c00, 0x0000cc00, 0x00002c00, 0x0000ac00, 0x00006c00, 0x0000ec00,
+			0x00001c00, 0x00009c00, 0x00005c00, 0x0000dc00, 0x00003c00, 0x0000bc00, 0x00007c00, 0x0000fc00,
+			0x00000200, 0x00008200, 0x00004200, 0x0000c200, 0x00002200, 0x0000a200, 0x00006200, 0x0000e200,
+			0x00001200, 0x00009200, 0x00005200, 0x0000d200, 0x00003200, 0x0000b200, 0x00007200, 0x0000f200,
+			0x00000a00, 0x00008a00, 0x00004a00, 0x0000ca00, 0x00002a00, 0x0000aa00, 0x00006a00, 0x0000ea00,
+			0x00001a00, 0x00009a00, 0x00005a00, 0x0000da00, 0x00003a00, 0x0000ba00, 0x00007a00, 0x0000fa00,
+			0x00000600, 0x00008600, 0x00004600, 0x0000c600, 0x00002600, 0x0000a600, 0x00006600, 0x0000e600,
+			0x00001600, 0x00009600, 0x00005600, 0x0000d600, 0x00003600, 0x0000b600, 0x00007600, 0x0000f600,
+			0x00000e00, 0x00008e00, 0x00004e00, 0x0000ce00, 0x00002e00, 0x0000ae00, 0x00006e00, 0x0000ee00,
+			0x00001e00, 0x00009e00, 0x00005e00, 0x0000de00, 0x00003e00, 0x0000be00, 0x00007e00, 0x0000fe00,
+			0x00000100, 0x00008100, 0x00004100, 0x0000c100, 0x00002100, 0x0000a100, 0x00006100, 0x0000e100,
+			0x00001100, 0x00009100, 0x00005100, 0x0000d100, 0x00003100, 0x0000b100, 0x00007100, 0x0000f100,
+			0x00000900, 0x00008900, 0x00004900, 0x0000c900, 0x00002900, 0x0000a900, 0x00006900, 0x0000e900,
+			0x00001900, 0x00009900, 0x00005900, 0x0000d900, 0x00003900, 0x0000b900, 0x00007900, 0x0000f900,
+			0x00000500, 0x00008500, 0x00004500, 0x0000c500, 0x00002500, 0x0000a500, 0x00006500, 0x0000e500,
+			0x00001500, 0x00009500, 0x00005500, 0x0000d500, 0x00003500, 0x0000b500, 0x00007500, 0x0000f500,
+			0x00000d00, 0x00008d00, 0x00004d00, 0x0000cd00, 0x00002d00, 0x0000ad00, 0x00006d00, 0x0000ed00,
+			0x00001d00, 0x00009d00, 0x00005d00, 0x0000dd00, 0x00003d00, 0x0000bd00, 0x00007d00, 0x0000fd00,
+			0x00000300, 0x00008300, 0x00004300, 0x0000c300, 0x00002300, 0x0000a300, 0x00006300, 0x0000e300,
+			0x00001300, 0x00009300, 0x00005300, 0x0000d300, 0x00003300, 0x0000b300, 0x00007300, 0x0000f300,
+			0x00000b00, 0x00008b00, 0x00004b00, 0x0000cb00, 0x00002b00, 0x0000ab00, 0x00006b00, 0x0000eb00,
+			0x00001b00, 0x00009b00, 0x00005b00, 0x0000db00, 0x00003b00, 0x0000bb00, 0x00007b00, 0x0000fb00,
+			0x00000700, 0x00008700, 0x00004700, 0x0000c700, 0x00002700, 0x0000a700, 0x00006700, 0x0000e700,
+			0x00001700, 0x00009700, 0x00005700, 0x0000d700, 0x00003700, 0x0000b700, 0x00007700, 0x0000f700,
+			0x00000f00, 0x00008f00, 0x00004f00, 0x0000cf00, 0x00002f00, 0x0000af00, 0x00006f00, 0x0000ef00,
+			0x00001f00, 0x00009f00, 0x00005f00, 0x0000df00, 0x00003f00, 0x0000bf00, 0x00007f00, 0x0000ff00,
+		},
+		{
+			0x00000000, 0x00000080, 0x00000040, 0x000000c0, 0x00000020, 0x000000a0, 0x00000060, 0x000000e0,
+			0x00000010, 0x00000090, 0x00000050, 0x000000d0, 0x00000030, 0x000000b0, 0x00000070, 0x000000f0,
+			0x00000008, 0x00000088, 0x00000048, 0x000000c8, 0x00000028, 0x000000a8, 0x00000068, 0x000000e8,
+			0x00000018, 0x00000098, 0x00000058, 0x000000d8, 0x00000038, 0x000000b8, 0x00000078, 0x000000f8,
+			0x00000004, 0x00000084, 0x00000044, 0x000000c4, 0x00000024, 0x000000a4, 0x00000064, 0x000000e4,
+			0x00000014, 0x00000094, 0x00000054, 0x000000d4, 0x00000034, 0x000000b4, 0x00000074, 0x000000f4,
+			0x0000000c, 0x0000008c, 0x0000004c, 0x000000cc, 0x0000002c, 0x000000ac, 0x0000006c, 0x000000ec,
+			0x0000001c, 0x0000009c, 0x0000005c, 0x000000dc, 0x0000003c, 0x000000bc, 0x0000007c, 0x000000fc,
+			0x00000002, 0x00000082, 0x00000042, 0x000000c2, 0x00000022, 0x000000a2, 0x00000062, 0x000000e2,
+			0x00000012, 0x00000092, 0x00000052, 0x000000d2, 0x00000032, 0x000000b2, 0x00000072, 0x000000f2,
+			0x0000000a, 0x0000008a, 0x0000004a, 0x000000ca, 0x0000002a, 0x000000aa, 0x0000006a, 0x000000ea,
+			0x0000001a, 0x0000009a, 0x0000005a, 0x000000da, 0x0000003a, 0x000000ba, 0x0000007a, 0x000000fa,
+			0x00000006, 0x00000086, 0x00000046, 0x000000c6, 0x00000026, 0x000000a6, 0x00000066, 0x000000e6,
+			0x00000016, 0x00000096, 0x00000056, 0x000000d6, 0x00000036, 0x000000b6, 0x00000076, 0x000000f6,
+			0x0000000e, 0x0000008e, 0x0000004e, 0x000000ce, 0x0000002e, 0x000000ae, 0x0000006e, 0x000000ee,
+			0x0000001e, 0x0000009e, 0x0000005e, 0x000000de, 0x0000003e, 0x000000be, 0x0000007e, 0x000000fe,
+			0x00000001, 0x00000081, 0x00000041, 0x000000c1, 0x00000021, 0x000000a1, 0x00000061, 0x000000e1,
+			0x00000011, 0x00000091, 0x00000051, 0x000000d1, 0x00000031, 0x000000b1, 0x00000071, 0x000000f1,
+			0x00000009, 0x00000089, 0x00000049, 0x000000c9, 0x00000029, 0x000000a9, 0x00000069, 0x000000e9,
+			0x00000019, 0x00000099, 0x00000059, 0x000000d9, 0x00000039, 0x000000b9, 0x00000079, 0x000000f9,
+			0x00000005, 0x00000085, 0x00000045, 0x000000c5, 0x00000025, 0x000000a5, 0x00000065, 0x000000e5,
+			0x00000015, 0x00000095, 0x00000055, 0x000000d5, 0x00000035, 0x000000b5, 0x00000075, 0x000000f5,
+			0x0000000d, 0x0000008d, 0x0000004d, 0x000000cd, 0x0000002d, 0x000000ad, 0x0000006d, 0x000000ed,
+			0x0000001d, 0x0000009d, 0x0000005d, 0x000000dd, 0x0000003d, 0x000000bd, 0x0000007d, 0x000000fd,
+			0x00000003, 0x00000083, 0x00000043, 0x000000c3, 0x00000023, 0x000000a3, 0x00000063, 0x000000e3,
+			0x00000013, 0x00000093, 0x00000053, 0x000000d3, 0x00000033, 0x000000b3, 0x00000073, 0x000000f3,
+			0x0000000b, 0x0000008b, 0x0000004b, 0x000000cb, 0x0000002b, 0x000000ab, 0x0000006b, 0x000000eb,
+			0x0000001b, 0x0000009b, 0x0000005b, 0x000000db, 0x0000003b, 0x000000bb, 0x0000007b, 0x000000fb,
+			0x00000007, 0x00000087, 0x00000047, 0x000000c7, 0x00000027, 0x000000a7, 0x00000067, 0x000000e7,
+			0x00000017, 0x00000097, 0x00000057, 0x000000d7, 0x00000037, 0x000000b7, 0x00000077, 0x000000f7,
+			0x0000000f, 0x0000008f, 0x0000004f, 0x000000cf, 0x0000002f, 0x000000af, 0x0000006f, 0x000000ef,
+			0x0000001f, 0x0000009f, 0x0000005f, 0x000000df, 0x0000003f, 0x000000bf, 0x0000007f, 0x000000ff,
+		},
+	},
+	{
+		{
+			0x00000000, 0x80000000, 0xc0000000, 0x40000000, 0xa0000000, 0x20000000, 0x60000000, 0xe0000000,
+			0xf0000000, 0x70000000, 0x30000000, 0xb0000000, 0x50000000, 0xd0000000, 0x90000000, 0x10000000,
+			0x88000000, 0x08000000, 0x48000000, 0xc8000000, 0x28000000, 0xa8000000, 0xe8000000, 0x68000000,
+			0x78000000, 0xf8000000, 0xb8000000, 0x38000000, 0xd8000000, 0x58000000, 0x18000000, 0x98000000,
+			0xcc000000, 0x4c000000, 0x0c000000, 0x8c000000, 0x6c000000, 0xec000000, 0xac000000, 0x2c000000,
+			0x3c000000, 0xbc000000, 0xfc000000, 0x7c000000, 0x9c000000, 0x1c000000, 0x5c000000, 0xdc000000,
+			0x44000000, 0xc4000000, 0x84000000, 0x04000000, 0xe4000000, 0x64000000, 0x24000000, 0xa4000000,
+			0xb4000000, 0x34000000, 0x74000000, 0xf4000000, 0x14000000, 0x94000000, 0xd4000000, 0x54000000,
+			0xaa000000, 0x2a000000, 0x6a000000, 0xea000000, 0x0a000000, 0x8a000000, 0xca000000, 0x4a000000,
+			0x5a000000, 0xda000000, 0x9a000000, 0x1a000000, 0xfa000000, 0x7a000000, 0x3a000000, 0xba000000,
+			0x22000000, 0xa2000000, 0xe2000000, 0x62000000, 0x82000000, 0x02000000, 0x42000000, 0xc2000000,
+			0xd2000000, 0x52000000, 0x12000000, 0x92000000, 0x72000000, 0xf2000000, 0xb2000000, 0x32000000,
+			0x66000000, 0xe6000000, 0xa6000000, 0x26000000, 0xc6000000, 0x46000000, 0x06000000, 0x86000000,
+			0x96000000, 0x16000000, 0x56000000, 0xd6000000, 0x36000000, 0xb6000000, 0xf6000000, 0x76000000,
+			0xee000000, 0x6e000000, 0x2e000000, 0xae000000, 0x4e000000, 0xce000000, 0x8e000000, 0x0e000000,
+			0x1e000000, 0x9e000000, 0xde000000, 0x5e000000, 0xbe000000, 0x3e000000, 0x7e000000, 0xfe000000,
+			0xff000000, 0x7f000000, 0x3f000000, 0xbf000000, 0x5f000000, 0xdf000000, 0x9f000000, 0x1f000000,
+			0x0f000000, 0x8f000000, 0xcf000000, 0x4f000000, 0xaf000000, 0x2f000000, 0x6f000000, 0xef000000,
+			0x77000000, 0xf7000000, 0xb7000000, 0x37000000, 0xd7000000, 0x57000000, 0x17000000, 0x97000000,
+			0x87000000, 0x07000000, 0x47000000, 0xc7000000, 0x27000000, 0xa7000000, 0xe7000000, 0x67000000,
+			0x33000000, 0xb3000000, 0xf3000000, 0x73000000, 0x93000000, 0x13000000, 0x53000000, 0xd3000000,
+			0xc3000000, 0x43000000, 0x03000000, 0x83000000, 0x63000000, 0xe3000000, 0xa3000000, 0x23000000,
+			0xbb000000, 0x3b000000, 0x7b000000, 0xfb000000, 0x1b000000, 0x9b000000, 0xdb000000, 0x5b000000,
+			0x4b000000, 0xcb000000, 0x8b000000, 0x0b000000, 0xeb000000, 0x6b000000, 0x2b000000, 0xab000000,
+			0x55000000, 0xd5000000, 0x95000000, 0x15000000, 0xf5000000, 0x75000000, 0x35000000, 0xb5000000,
+			0xa5000000, 0x25000000, 0x65000000, 0xe5000000, 0x05000000, 0x85000000, 0xc5000000, 0x45000000,
+			0xdd000000, 0x5d000000, 0x1d000000, 0x9d000000, 0x7d000000, 0xfd000000, 0xbd000000, 0x3d000000,
+			0x2d000000, 0xad000000, 0xed000000, 0x6d000000, 0x8d000000, 0x0d000000, 0x4d000000, 0xcd000000,
+			0x99000000, 0x19000000, 0x59000000, 0xd9000000, 0x39000000, 0xb9000000, 0xf9000000, 0x79000000,
+			0x69000000, 0xe9000000, 0xa9000000, 0x29000000, 0xc9000000, 0x49000000, 0x09000000, 0x89000000,
+			0x11000000, 0x91000000, 0xd1000000, 0x51000000, 0xb1000000, 0x31000000, 0x71000000, 0xf1000000,
+			0xe1000000, 0x61000000, 0x21000000, 0xa1000000, 0x41000000, 0xc1000000, 0x81000000, 0x01000000,
+		},
+		{
+			0x00000000, 0x80800000, 0xc0c00000, 0x40400000, 0xa0a00000, 0x20200000, 0x60600000, 0xe0e00000,
+			0xf0f00000, 0x70700000, 0x30300000, 0xb0b00000, 0x50500000, 0xd0d00000, 0x90900000, 0x10100000,
+			0x88880000, 0x08080000, 0x48480000, 0xc8c80000, 0x28280000, 0xa8a80000, 0xe8e80000, 0x68680000,
+			0x78780000, 0xf8f80000, 0xb8b80000, 0x38380000, 0xd8d80000, 0x58580000, 0x18180000, 0x98980000,
+			0xcccc0000, 0x4c4c0000, 0x0c0c0000, 0x8c8c0000, 0x6c6c0000, 0xecec0000, 0xacac0000, 0x2c2c0000,
+			0x3c3c0000, 0xbcbc0000, 0xfcfc0000, 0x7c7c0000, 0x9c9c0000, 0x1c1c0000, 0x5c5c0000, 0xdcdc0000,
+			0x44440000, 0xc4c40000, 0x84840000, 0x04040000, 0xe4e40000, 0x64640000, 0x24240000, 0xa4a40000,
+			0xb4b40000, 0x34340000, 0x74740000, 0xf4f40000, 0x14140000, 0x94940000, 0xd4d40000, 0x54540000,
+			0xaaaa0000, 0x2a2a0000, 0x6a6a0000, 0xeaea0000, 0x0a0a0000, 0x8a8a0000, 0xcaca0000, 0x4a4a0000,
+			0x5a5a0000, 0xdada0000, 0x9a9a0000, 0x1a1a0000, 0xfafa0000, 0x7a7a0000, 0x3a3a0000, 0xbaba0000,
+			0x22220000, 0xa2a20000, 0xe2e20000, 0x62620000, 0x82820000, 0x02020000, 0x42420000, 0xc2c20000,
+			0xd2d20000, 0x52520000, 0x12120000, 0x92920000, 0x72720000, 0xf2f20000, 0xb2b20000, 0x32320000,
+			0x66660000, 0xe6e60000, 0xa6a60000, 0x26260000, 0xc6c60000, 0x46460000, 0x06060000, 0x86860000,
+			0x96960000, 0x16160000, 0x56560000, 0xd6d60000, 0x36360000, 0xb6b60000, 0xf6f60000, 0x76760000,
+			0xeeee0000, 0x6e6e0000, 0x2e2e0000, 0xaeae0000, 0x4e4e0000, 0xcece0000, 0x8e8e0000, 0x0e0e0000,
+			0x1e1e0000, 0x9e9e0000, 0xdede0000, 0x5e5e0000, 0xbebe0000, 0x3e3e0000, 0x7e7e0000, 0xfefe0000,
+			0xffff0000, 0x7f7f0000, 0x3f3f0000, 0xbfbf0000, 0x5f5f0000, 0xdfdf0000, 0x9f9f0000, 0x1f1f0000,
+			0x0f0f0000, 0x8f8f0000, 0xcfcf0000, 0x4f4f0000, 0xafaf0000, 0x2f2f0000, 0x6f6f0000, 0xefef0000,
+			0x77770000, 0xf7f70000, 0xb7b70000, 0x37370000, 0xd7d70000, 0x57570000, 0x17170000, 0x97970000,
+			0x87870000, 0x07070000, 0x47470000, 0xc7c70000, 0x27270000, 0xa7a70000, 0xe7e70000, 0x67670000,
+			0x33330000, 0xb3b30000, 0xf3f30000, 0x73730000, 0x93930000, 0x13130000, 0x53530000, 0xd3d30000,
+			0xc3c30000, 0x43430000, 0x03030000, 0x83830000, 0x63630000, 0xe3e30000, 0xa3a30000, 0x23230000,
+			0xbbbb0000, 0x3b3b0000, 0x7b7b0000, 0xfbfb0000, 0x1b1b0000, 0x9b9b0000, 0xdbdb0000, 0x5b5b0000,
+			0x4b4b0000, 0xcbcb0000, 0x8b8b0000, 0x0b0b0000, 0xebeb0000, 0x6b6b0000, 0x2b2b0000, 0xabab0000,
+			0x55550000, 0xd5d50000, 0x95950000, 0x15150000, 0xf5f50000, 0x75750000, 0x35350000, 0xb5b50000,
+			0xa5a50000, 0x25250000, 0x65650000, 0xe5e50000, 0x05050000, 0x85850000, 0xc5c50000, 0x45450000,
+			0xdddd0000, 0x5d5d0000, 0x1d1d0000, 0x9d9d0000, 0x7d7d0000, 0xfdfd0000, 0xbdbd0000, 0x3d3d0000,
+			0x2d2d0000, 0xadad0000, 0xeded0000, 0x6d6d0000, 0x8d8d0000, 0x0d0d0000, 0x4d4d0000, 0xcdcd0000,
+			0x99990000, 0x19190000, 0x59590000, 0xd9d90000, 0x39390000, 0xb9b90000, 0xf9f90000, 0x79790000,
+			0x69690000, 0xe9e90000, 0xa9a90000, 0x29290000, 0xc9c90000, 0x49490000, 0x09090000, 0x89890000,
+			0x11110000, 0x91910000, 0xd1d10000, 0x51510000, 0xb1b10000, 0x31310000, 0x71710000, 0xf1f10000,
+			0xe1e10000, 0x61610000, 0x21210000, 0xa1a10000, 0x41410000, 0xc1c10000, 0x81810000, 0x01010000,
+		},
+		{
+			0x00000000, 0x80008000, 0xc000c000, 0x40004000, 0xa000a000, 0x20002000, 0x60006000, 0xe000e000,
+			0xf000f000, 0x70007000, 0x30003000, 0xb000b000, 0x50005000, 0xd000d000, 0x90009000, 0x10001000,
+			0x88008800, 0x08000800, 0x48004800, 0xc800c800, 0x28002800, 0xa800a800, 0xe800e800, 0x68006800,
+			0x78007800, 0xf800f800, 0xb800b800, 0x38003800, 0xd800d800, 0x58005800, 0x18001800, 0x98009800,
+			0xcc00cc00, 0x4c004c00, 0x0c000c00, 0x8c008c00, 0x6c006c00, 0xec00ec00, 0xac00ac00, 0x2c002c00,
+			0x3c003c00, 0xbc00bc00, 0xfc00fc00, 0x7c007c00, 0x9c009c00, 0x1c001c00, 0x5c005c00, 0xdc00dc00,
+			0x44004400, 0xc400c400, 0x84008400, 0x04000400, 0xe400e400, 0x64006400, 0x24002400, 0xa400a400,
+			0xb400b400, 0x34003400, 0x74007400, 0xf400f400, 0x14001400, 0x94009400, 0xd400d400, 0x54005400,
+			0xaa00aa00, 0x2a002a00, 0x6a006a00, 0xea00ea00, 0x0a000a00, 0x8a008a00, 0xca00ca00, 0x4a004a00,
+			0x5a005a00, 0xda00da00, 0x9a009a00, 0x1a001a00, 0xfa00fa00, 0x7a007a00, 0x3a003a00, 0xba00ba00,
+			0x22002200, 0xa200a200, 0xe200e200, 0x62006200, 0x82008200, 0x02000200, 0x42004200, 0xc200c200,
+			0xd200d200, 0x52005200, 0x12001200, 0x92009200, 0x72007200, 0xf200f200, 0xb200b200, 0x32003200,
+			0x66006600, 0xe600e600, 0xa600a600, 0x26002600, 0xc600c600, 0x46004600, 0x06000600, 0x86008600,
+			0x96009600, 0x16001600, 0x56005600, 0xd600d600, 0x36003600, 0xb600b600, 0xf600f600, 0x76007600,
+			0xee00ee00, 0x6e006e00, 0x2e002e00, 0xae00ae00, 0x4e004e00, 0xce00ce00, 0x8e008e00, 0x0e000e00,
+			0x1e001e00, 0x9e009e00, 0xde00de00, 0x5e005e00, 0xbe00be00, 0x3e003e00, 0x7e007e00, 0xfe00fe00,
+			0xff00ff00, 0x7f007f00, 0x3f003f00, 0xbf00bf00, 0x5f005f00, 0xdf00df00, 0x9f009f00, 0x1f001f00,
+			0x0f000f00, 0x8f008f00, 0xcf00cf00, 0x4f004f00, 0xaf00af00, 0x2f002f00, 0x6f006f00, 0xef00ef00,
+			0x77007700, 0xf700f700, 0xb700b700, 0x37003700, 0xd700d700, 0x57005700, 0x17001700, 0x97009700,
+			0x87008700, 0x07000700, 0x47004700, 0xc700c700, 0x27002700, 0xa700a700, 0xe700e700, 0x67006700,
+			0x33003300, 0xb300b300, 0xf300f300, 0x73007300, 0x93009300, 0x13001300, 0x53005300, 0xd300d300,
+			0xc300c300, 0x43004300, 0x03000300, 0x83008300, 0x63006300, 0xe300e300, 0xa300a300, 0x23002300,
+			0xbb00bb00, 0x3b003b00, 0x7b007b00, 0xfb00fb00, 0x1b001b00, 0x9b009b00, 0xdb00db00, 0x5b005b00,
+			0x4b004b00, 0xcb00cb00, 0x8b008b00, 0x0b000b00, 0xeb00eb00, 0x6b006b00, 0x2b002b00, 0xab00ab00,
+			0x55005500, 0xd500d500, 0x95009500, 0x15001500, 0xf500f500, 0x75007500, 0x35003500, 0xb500b500,
+			0xa500a500, 0x25002500, 0x65006500, 0xe500e500, 0x05000500, 0x85008500, 0xc500c500, 0x45004500,
+			0xdd00dd00, 0x5d005d00, 0x1d001d00, 0x9d009d00, 0x7d007d00, 0xfd00fd00, 0xbd00bd00, 0x3d003d00,
+			0x2d002d00, 0xad00ad00, 0xed00ed00, 0x6d006d00, 0x8d008d00, 0x0d000d00, 0x4d004d00, 0xcd00cd00,
+			0x99009900, 0x19001900, 0x59005900, 0xd900d900, 0x39003900, 0xb900b900, 0xf900f900, 0x79007900,
+			0x69006900, 0xe900e900, 0xa900a900, 0x29002900, 0xc900c900, 0x49004900, 0x09000900, 0x89008900,
+			0x11001100, 0x91009100, 0xd100d100, 0x51005100, 0xb100b100, 0x31003100, 0x71007100, 0xf100f100,
+			0xe100e100, 0x61006100, 0x21002100, 0xa100a100, 0x41004100, 0xc100c100, 0x81008100, 0x01000100,
+		},
+		{
+			0x00000000, 0x80808080, 0xc0c0c0c0, 0x40404040, 0xa0a0a0a0, 0x20202020, 0x60606060, 0xe0e0e0e0,
+			0xf0f0f0f0, 0x70707070, 0x30303030, 0xb0b0b0b0, 0x50505050, 0xd0d0d0d0, 0x90909090, 0x10101010,
+			0x88888888, 0x08080808, 0x48484848, 0xc8c8c8c8, 0x28282828, 0xa8a8a8a8, 0xe8e8e8e8, 0x68686868,
+			0x78787878, 0xf8f8f8f8, 0xb8b8b8b8, 0x38383838, 0xd8d8d8d8, 0x58585858, 0x18181818, 0x98989898,
+			0xcccccccc, 0x4c4c4c4c, 0x0c0c0c0c, 0x8c8c8c8c, 0x6c6c6c6c, 0xecececec, 0xacacacac, 0x2c2c2c2c,
+			0x3c3c3c3c, 0xbcbcbcbc, 0xfcfcfcfc, 0x7c7c7c7c, 0x9c9c9c9c, 0x1c1c1c1c, 0x5c5c5c5c, 0xdcdcdcdc,
+			0x44444444, 0xc4c4c4c4, 0x84848484, 0x04040404, 0xe4e4e4e4, 0x64646464, 0x24242424, 0xa4a4a4a4,
+			0xb4b4b4b4, 0x34343434, 0x74747474, 0xf4f4f4f4, 0x14141414, 0x94949494, 0xd4d4d4d4, 0x54545454,
+			0xaaaaaaaa, 0x2a2a2a2a, 0x6a6a6a6a, 0xeaeaeaea, 0x0a0a0a0a, 0x8a8a8a8a, 0xcacacaca, 0x4a4a4a4a,
+			0x5a5a5a5a, 0xdadadada, 0x9a9a9a9a, 0x1a1a1a1a, 0xfafafafa, 0x7a7a7a7a, 0x3a3a3a3a, 0xbabababa,
+			0x22222222, 0xa2a2a2a2, 0xe2e2e2e2, 0x62626262, 0x82828282, 0x02020202, 0x42424242, 0xc2c2c2c2,
+			0xd2d2d2d2, 0x52525252, 0x12121212, 0x92929292, 0x72727272, 0xf2f2f2f2, 0xb2b2b2b2, 0x32323232,
+			0x66666666, 0xe6e6e6e6, 0xa6a6a6a6, 0x26262626, 0xc6c6c6c6, 0x46464646, 0x06060606, 0x86868686,
+			0x96969696, 0x16161616, 0x56565656, 0xd6d6d6d6, 0x36363636, 0xb6b6b6b6, 0xf6f6f6f6, 0x76767676,
+			0xeeeeeeee, 0x6e6e6e6e, 0x2e2e2e2e, 0xaeaeaeae, 0x4e4e4e4e, 0xcececece, 0x8e8e8e8e, 0x0e0e0e0e,
+			0x1e1e1e1e, 0x9e9e9e9e, 0xdededede, 0x5e5e5e5e, 0xbebebebe, 0x3e3e3e3e, 0x7e7e7e7e, 0xfefefefe,
+			0xffffffff, 0x7f7f7f7f, 0x3f3f3f3f, 0xbfbfbfbf, 0x5f5f5f5f, 0xdfdfdfdf, 0x9f9f9f9f, 0x1f1f1f1f,
+			0x0f0f0f0f, 0x8f8f8f8f, 0xcfcfcfcf, 0x4f4f4f4f, 0xafafafaf, 0x2f2f2f2f, 0x6f6f6f6f, 0xefefefef,
+			0x77777777, 0xf7f7f7f7, 0xb7b7b7b7, 0x37373737, 0xd7d7d7d7, 0x57575757, 0x17171717, 0x97979797,
+			0x87878787, 0x07070707, 0x47474747, 0xc7c7c7c7, 0x27272727, 0xa7a7a7a7, 0xe7e7e7e7, 0x67676767,
+			0x33333333, 0xb3b3b3b3, 0xf3f3f3f3, 0x73737373, 0x93939393, 0x13131313, 0x53535353, 0xd3d3d3d3,
+			0xc3c3c3c3, 0x43434343, 0x03030303, 0x83838383, 0x63636363, 0xe3e3e3e3, 0xa3a3a3a3, 0x23232323,
+			0xbbbbbbbb, 0x3b3b3b3b, 0x7b7b7b7b, 0xfbfbfbfb, 0x1b1b1b1b, 0x9b9b9b9b, 0xdbdbdbdb, 0x5b5b5b5b,
+			0x4b4b4b4b, 0xcbcbcbcb, 0x8b8b8b8b, 0x0b0b0b0b, 0xebebebeb, 0x6b6b6b6b, 0x2b2b2b2b, 0xabababab,
+			0x55555555, 0xd5d5d5d5, 0x95959595, 0x15151515, 0xf5f5f5f5, 0x75757575, 0x35353535, 0xb5b5b5b5,
+			0xa5a5a5a5, 0x25252525, 0x65656565, 0xe5e5e5e5, 0x05050505, 0x85858585, 0xc5c5c5c5, 0x45454545,
+			0xdddddddd, 0x5d5d5d5d, 0x1d1d1d1d, 0x9d9d9d9d, 0x7d7d7d7d, 0xfdfdfdfd, 0xbdbdbdbd, 0x3d3d3d3d,
+			0x2d2d2d2d, 0xadadadad, 0xedededed, 0x6d6d6d6d, 0x8d8d8d8d, 0x0d0d0d0d, 0x4d4d4d4d, 0xcdcdcdcd,
+			0x99999999, 0x19191919, 0x59595959, 0xd9d9d9d9, 0x39393939, 0xb9b9b9b9, 0xf9f9f9f9, 0x79797979,
+			0x69696969, 0xe9e9e9e9, 0xa9a9a9a9, 0x29292929, 0xc9c9c9c9, 0x49494949, 0x09090909, 0x89898989,
+			0x11111111, 0x91919191, 0xd1d1d1d1, 0x51515151, 0xb1b1b1b1, 0x31313131, 0x71717171, 0xf1f1f1f1,
+			0xe1e1e1e1, 0x61616161, 0x21212121, 0xa1a1a1a1, 0x41414141, 0xc1c1c1c1, 0x81818181, 0x01010101,
+		},
+	},
+	{
+		{
+			0x00000000, 0x80000000, 0xc0000000, 0x40000000, 0x60000000, 0xe0000000, 0xa0000000, 0x20000000,
+			0x90000000, 0x10000000, 0x50000000, 0xd0000000, 0xf0000000, 0x70000000, 0x30000000, 0xb0000000,
+			0xe8000000, 0x68000000, 0x28000000, 0xa8000000, 0x88000000, 0x08000000, 0x48000000, 0xc8000000,
+			0x78000000, 0xf8000000, 0xb8000000, 0x38000000, 0x18000000, 0x98000000, 0xd8000000, 0x58000000,
+			0x5c000000, 0xdc000000, 0x9c000000, 0x1c000000, 0x3c000000, 0xbc000000, 0xfc000000, 0x7c000000,
+			0xcc000000, 0x4c000000, 0x0c000000, 0x8c000000, 0xac000000, 0x2c000000, 0x6c000000, 0xec000000,
+			0xb4000000, 0x34000000, 0x74000000, 0xf4000000, 0xd4000000, 0x54000000, 0x14000000, 0x94000000,
+			0x24000000, 0xa4000000, 0xe4000000, 0x64000000, 0x44000000, 0xc4000000, 0x84000000, 0x04000000,
+			0x8e000000, 0x0e000000, 0x4e000000, 0xce000000, 0xee000000, 0x6e000000, 0x2e000000, 0xae000000,
+			0x1e000000, 0x9e000000, 0xde000000, 0x5e000000, 0x7e000000, 0xfe000000, 0xbe000000, 0x3e000000,
+			0x66000000, 0xe6000000, 0xa6000000, 0x26000000, 0x06000000, 0x86000000, 0xc6000000, 0x46000000,
+			0xf6000000, 0x76000000, 0x36000000, 0xb6000000, 0x96000000, 0x16000000, 0x56000000, 0xd6000000,
+			0xd2000000, 0x52000000, 0x12000000, 0x92000000, 0xb2000000, 0x32000000, 0x72000000, 0xf2000000,
+			0x42000000, 0xc2000000, 0x82000000, 0x02000000, 0x22000000, 0xa2000000, 0xe2000000, 0x62000000,
+			0x3a000000, 0xba000000, 0xfa000000, 0x7a000000, 0x5a000000, 0xda000000, 0x9a000000, 0x1a000000,
+			0xaa000000, 0x2a000000, 0x6a000000, 0xea000000, 0xca000000, 0x4a000000, 0x0a000000, 0x8a000000,
+			0xc5000000, 0x45000000, 0x05000000, 0x85000000, 0xa5000000, 0x25000000, 0x65000000, 0xe5000000,
+			0x55000000, 0xd5000000, 0x95000000, 0x15000000, 0x35000000, 0xb5000000, 0xf5000000, 0x75000000,
+			0x2d000000, 0xad000000, 0xed000000, 0x6d000000, 0x4d000000, 0xcd000000, 0x8d000000, 0x0d000000,
+			0xbd000000, 0x3d000000, 0x7d000000, 0xfd000000, 0xdd000000, 0x5d000000, 0x1d000000, 0x9d000000,
+			0x99000000, 0x19000000, 0x59000000, 0xd9000000, 0xf9000000, 0x79000000, 0x39000000, 0xb9000000,
+			0x09000000, 0x89000000, 0xc9000000, 0x49000000, 0x69000000, 0xe9000000, 0xa9000000, 0x29000000,
+			0x71000000, 0xf1000000, 0xb1000000, 0x31000000, 0x11000000, 0x91000000, 0xd1000000, 0x51000000,
+			0xe1000000, 0x61000000, 0x21000000, 0xa1000000, 0x81000000, 0x01000000, 0x41000000, 0xc1000000,
+			0x4b000000, 0xcb000000, 0x8b000000, 0x0b000000, 0x2b000000, 0xab000000, 0xeb000000, 0x6b000000,
+			0xdb000000, 0x5b000000, 0x1b000000, 0x9b000000, 0xbb000000, 0x3b000000, 0x7b000000, 0xfb000000,
+			0xa3000000, 0x23000000, 0x63000000, 0xe3000000, 0xc3000000, 0x43000000, 0x03000000, 0x83000000,
+			0x33000000, 0xb3000000, 0xf3000000, 0x73000000, 0x53000000, 0xd3000000, 0x93000000, 0x13000000,
+			0x17000000, 0x97000000, 0xd7000000, 0x57000000, 0x77000000, 0xf7000000, 0xb7000000, 0x37000000,
+			0x87000000, 0x07000000, 0x47000000, 0xc7000000, 0xe7000000, 0x67000000, 0x27000000, 0xa7000000,
+			0xff000000, 0x7f000000, 0x3f000000, 0xbf000000, 0x9f000000, 0x1f000000, 0x5f000000, 0xdf000000,
+			0x6f000000, 0xef000000, 0xaf000000, 0x2f000000, 0x0f000000, 0x8f000000, 0xcf000000, 0x4f000000,
+		},
+		{
+			0x00000000, 0x68800000, 0x9cc00000, 0xf4400000, 0xee600000, 0x86e00000, 0x72a00000, 0x1a200000,
+			0x55900000, 0x3d100000, 0xc9500000, 0xa1d00000, 0xbbf00000, 0xd3700000, 0x27300000, 0x4fb00000,
+			0x80680000, 0xe8e80000, 0x1ca80000, 0x74280000, 0x6e080000, 0x06880000, 0xf2c80000, 0x9a480000,
+			0xd5f80000, 0xbd780000, 0x49380000, 0x21b80000, 0x3b980000, 0x53180000, 0xa7580000, 0xcfd80000,
+			0xc09c0000, 0xa81c0000, 0x5c5c0000, 0x34dc0000, 0x2efc0000, 0x467c0000, 0xb23c0000, 0xdabc0000,
+			0x950c0000, 0xfd8c0000, 0x09cc0000, 0x614c0000, 0x7b6c0000, 0x13ec0000, 0xe7ac0000, 0x8f2c0000,
+			0x40f40000, 0x28740000, 0xdc340000, 0xb4b40000, 0xae940000, 0xc6140000, 0x32540000, 0x5ad40000,
+			0x15640000, 0x7de40000, 0x89a40000, 0xe1240000, 0xfb040000, 0x93840000, 0x67c40000, 0x0f440000,
+			0x60ee0000, 0x086e0000, 0xfc2e0000, 0x94ae0000, 0x8e8e0000, 0xe60e0000, 0x124e0000, 0x7ace0000,
+			0x357e0000, 0x5dfe0000, 0xa9be0000, 0xc13e0000, 0xdb1e0000, 0xb39e0000, 0x47de0000, 0x2f5e0000,
+			0xe0860000, 0x88060000, 0x7c460000, 0x14c60000, 0x0ee60000, 0x66660000, 0x92260000, 0xfaa60000,
+			0xb5160000, 0xdd960000, 0x29d60000, 0x41560000, 0x5b760000, 0x33f60000, 0xc7b60000, 0xaf360000,
+			0xa0720000, 0xc8f20000, 0x3cb20000, 0x54320000, 0x4e120000, 0x26920000, 0xd2d20000, 0xba520000,
+			0xf5e20000, 0x9d620000, 0x69220000, 0x01a20000, 0x1b820000, 0x73020000, 0x87420000, 0xefc20000,
+			0x201a0000, 0x489a0000, 0xbcda0000, 0xd45a0000, 0xce7a0000, 0xa6fa0000, 0x52ba0000, 0x3a3a0000,
+			0x758a0000, 0x1d0a0000, 0xe94a0000, 0x81ca0000, 0x9bea0000, 0xf36a0000, 0x072a0000, 0x6faa0000,
+			0x90550000, 0xf8d50000, 0x0c950000, 0x64150000, 0x7e350000, 0x16b50000, 0xe2f50000, 0x8a750000,
+			0xc5c50000, 0xad450000, 0x59050000, 0x31850000, 0x2ba50000, 0x43250000, 0xb7650000, 0xdfe50000,
+			0x103d0000, 0x78bd0000, 0x8cfd0000, 0xe47d0000, 0xfe5d0000, 0x96dd0000, 0x629d0000, 0x0a1d0000,
+			0x45ad0000, 0x2d2d0000, 0xd96d0000, 0xb1ed0000, 0xabcd0000, 0xc34d0000, 0x370d0000, 0x5f8d0000,
+			0x50c90000, 0x38490000, 0xcc090000, 0xa4890000, 0xbea90000, 0xd6290000, 0x22690000, 0x4ae90000,
+			0x05590000, 0x6dd90000, 0x99990000, 0xf1190000, 0xeb390000, 0x83b90000, 0x77f90000, 0x1f790000,
+			0xd0a10000, 0xb8210000, 0x4c610000, 0x24e10000, 0x3ec10000, 0x56410000, 0xa2010000, 0xca810000,
+			0x85310000, 0xedb10000, 0x19f10000, 0x71710000, 0x6b510000, 0x03d10000, 0xf7910000, 0x9f110000,
+			0xf0bb0000, 0x983b0000, 0x6c7b0000, 0x04fb0000, 0x1edb0000, 0x765b0000, 0x821b0000, 0xea9b0000,
+			0xa52b0000, 0xcdab0000, 0x39eb0000, 0x516b0000, 0x4b4b0000, 0x23cb0000, 0xd78b0000, 0xbf0b0000,
+			0x70d30000, 0x18530000, 0xec130000, 0x84930000, 0x9eb30000, 0xf6330000, 0x02730000, 0x6af30000,
+			0x25430000, 0x4dc30000, 0xb9830000, 0xd1030000, 0xcb230000, 0xa3a30000, 0x57e30000, 0x3f630000,
+			0x30270000, 0x58a70000, 0xace70000, 0xc4670000, 0xde470000, 0xb6c70000, 0x42870000, 0x2a070000,
+			0x65b70000, 0x0d370000, 0xf9770000, 0x91f70000, 0x8bd70000, 0xe3570000, 0x17170000, 0x7f970000,
+			0xb04f0000, 0xd8cf0000, 0x2c8f0000, 0x440f0000, 0x5e2f0000, 0x36af0000, 0xc2ef0000, 0xaa6f0000,
+			0xe5df0000, 0x8d5f0000, 0x791f0000, 0x119f0000, 0x0bbf0000, 0x633f0000, 0x977f0000, 0xffff0000,
+		},
+		{
+			0x00000000, 0xe8808000, 0x5cc0c000, 0xb4404000, 0x8e606000, 0x66e0e000, 0xd2a0a000, 0x3a202000,
+			0xc5909000, 0x2d101000, 0x99505000, 0x71d0d000, 0x4bf0f000, 0xa3707000, 0x17303000, 0xffb0b000,
+			0x6868e800, 0x80e86800, 0x34a82800, 0xdc28a800, 0xe6088800, 0x0e880800, 0xbac84800, 0x5248c800,
+			0xadf87800, 0x4578f800, 0xf138b800, 0x19b83800, 0x23981800, 0xcb189800, 0x7f58d800, 0x97d85800,
+			0x9c9c5c00, 0x741cdc00, 0xc05c9c00, 0x28dc1c00, 0x12fc3c00, 0xfa7cbc00, 0x4e3cfc00, 0xa6bc7c00,
+			0x590ccc00, 0xb18c4c00, 0x05cc0c00, 0xed4c8c00, 0xd76cac00, 0x3fec2c00, 0x8bac6c00, 0x632cec00,
+			0xf4f4b400, 0x1c743400, 0xa8347400, 0x40b4f400, 0x7a94d400, 0x92145400, 0x26541400, 0xced49400,
+			0x31642400, 0xd9e4a400, 0x6da4e400, 0x85246400, 0xbf044400, 0x5784c400, 0xe3c48400, 0x0b440400,
+			0xeeee8e00, 0x066e0e00, 0xb22e4e00, 0x5aaece00, 0x608eee00, 0x880e6e00, 0x3c4e2e00, 0xd4ceae00,
+			0x2b7e1e00, 0xc3fe9e00, 0x77bede00, 0x9f3e5e00, 0xa51e7e00, 0x4d9efe00, 0xf9debe00, 0x115e3e00,
+			0x86866600, 0x6e06e600, 0xda46a600, 0x32c62600, 0x08e60600, 0xe0668600, 0x5426c600, 0xbca64600,
+			0x4316f600, 0xab967600, 0x1fd63600, 0xf756b600, 0xcd769600, 0x25f61600, 0x91b65600, 0x7936d600,
+			0x7272d200, 0x9af25200, 0x2eb21200, 0xc6329200, 0xfc12b200, 0x14923200, 0xa0d27200, 0x4852f200,
+			0xb7e24200, 0x5f62c200, 0xeb228200, 0x03a20200, 0x39822200, 0xd102a200, 0x6542e200, 0x8dc26200,
+			0x1a1a3a00, 0xf29aba00, 0x46dafa00, 0xae5a7a00, 0x947a5a00, 0x7cfada00, 0xc8ba9a00, 0x203a1a00,
+			0xdf8aaa00, 0x370a2a00, 0x834a6a00, 0x6bcaea00, 0x51eaca00, 0xb96a4a00, 0x0d2a0a00, 0xe5aa8a00,
+			0x5555c500, 0xbdd54500, 0x09950500, 0xe1158500, 0xdb35a500, 0x33b52500, 0x87f56500, 0x6f75e500,
+			0x90c55500, 0x7845d500, 0xcc059500, 0x24851500, 0x1ea53500, 0xf625b500, 0x4265f500, 0xaae57500,
+			0x3d3d2d00, 0xd5bdad00, 0x61fded00, 0x897d6d00, 0xb35d4d00, 0x5bddcd00, 0xef9d8d00, 0x071d0d00,
+			0xf8adbd00, 0x102d3d00, 0xa46d7d00, 0x4cedfd00, 0x76cddd00, 0x9e4d5d00, 0x2a0d1d00, 0xc28d9d00,
+			0xc9c99900, 0x21491900, 0x95095900, 0x7d89d900, 0x47a9f900, 0xaf297900, 0x1b693900, 0xf3e9b900,
+			0x0c590900, 0xe4d98900, 0x5099c900, 0xb8194900, 0x82396900, 0x6ab9e900, 0xdef9a900, 0x36792900,
+			0xa1a17100, 0x4921f100, 0xfd61b100, 0x15e13100, 0x2fc11100, 0xc7419100, 0x7301d100, 0x9b815100,
+			0x6431e100, 0x8cb16100, 0x38f12100, 0xd071a100, 0xea518100, 0x02d10100, 0xb6914100, 0x5e11c100,
+			0xbbbb4b00, 0x533bcb00, 0xe77b8b00, 0x0ffb0b00, 0x35db2b00, 0xdd5bab00, 0x691beb00, 0x819b6b00,
+			0x7e2bdb00, 0x96ab5b00, 0x22eb1b00, 0xca6b9b00, 0xf04bbb00, 0x18cb3b00, 0xac8b7b00, 0x440bfb00,
+			0xd3d3a300, 0x3b532300, 0x8f136300, 0x6793e300, 0x5db3c300, 0xb5334300, 0x01730300, 0xe9f38300,
+			0x16433300, 0xfec3b300, 0x4a83f300, 0xa2037300, 0x98235300, 0x70a3d300, 0xc4e39300, 0x2c631300,
+			0x27271700, 0xcfa79700, 0x7be7d700, 0x93675700, 0xa9477700, 0x41c7f700, 0xf587b700, 0x1d073700,
+			0xe2b78700, 0x0a370700, 0xbe774700, 0x56f7c700, 0x6cd7e700, 0x84576700, 0x30172700, 0xd897a700,
+			0x4f4fff00, 0xa7cf7f00, 0x138f3f00, 0xfb0fbf00, 0xc12f9f00, 0x29af1f00, 0x9def5f00, 0x756fdf00,
+			0x8adf6f00, 0x625fef00, 0xd61faf00, 0x3e9f2f00, 0x04bf0f00, 0xec3f8f00, 0x587fcf00, 0xb0ff4f00,
+		},
+		{
+			0x00000000, 0x8000e880, 0xc0005cc0, 0x4000b440, 0x60008e60, 0xe00066e0, 0xa000d2a0, 0x20003a20,
+			0x9000c590, 0x10002d10, 0x50009950, 0xd00071d0, 0xf0004bf0, 0x7000a370, 0x30001730, 0xb000ffb0,
+			0xe8006868, 0x680080e8, 0x280034a8, 0xa800dc28, 0x8800e608, 0x08000e88, 0x4800bac8, 0xc8005248,
+			0x7800adf8, 0xf8004578, 0xb800f138, 0x380019b8, 0x18002398, 0x9800cb18, 0xd8007f58, 0x580097d8,
+			0x5c009c9c, 0xdc00741c, 0x9c00c05c, 0x1c0028dc, 0x3c0012fc, 0xbc00fa7c, 0xfc004e3c, 0x7c00a6bc,
+			0xcc00590c, 0x4c00b18c, 0x0c0005cc, 0x8c00ed4c, 0xac00d76c, 0x2c003fec, 0x6c008bac, 0xec00632c,
+			0xb400f4f4, 0x34001c74, 0x7400a834, 0xf40040b4, 0xd4007a94, 0x54009214, 0x14002654, 0x9400ced4,
+			0x24003164, 0xa400d9e4, 0xe4006da4, 0x64008524, 0x4400bf04, 0xc4005784, 0x8400e3c4, 0x04000b44,
+			0x8e00eeee, 0x0e00066e, 0x4e00b22e, 0xce005aae, 0xee00608e, 0x6e00880e, 0x2e003c4e, 0xae00d4ce,
+			0x1e002b7e, 0x9e00c3fe, 0xde0077be, 0x5e009f3e, 0x7e00a51e, 0xfe004d9e, 0xbe00f9de, 0x3e00115e,
+			0x66008686, 0xe6006e06, 0xa600da46, 0x260032c6, 0x060008e6, 0x8600e066, 0xc6005426, 0x4600bca6,
+			0xf6004316, 0x7600ab96, 0x36001fd6, 0xb600f756, 0x9600cd76, 0x160025f6, 0x560091b6, 0xd6007936,
+			0xd2007272, 0x52009af2, 0x12002eb2, 0x9200c632, 0xb200fc12, 0x32001492, 0x7200a0d2, 0xf2004852,
+			0x4200b7e2, 0xc2005f62, 0x8200eb22, 0x020003a2, 0x22003982, 0xa200d102, 0xe2006542, 0x62008dc2,
+			0x3a001a1a, 0xba00f29a, 0xfa0046da, 0x7a00ae5a, 0x5a00947a, 0xda007cfa, 0x9a00c8ba, 0x1a00203a,
+			0xaa00df8a, 0x2a00370a, 0x6a00834a, 0xea006bca, 0xca0051ea, 0x4a00b96a, 0x0a000d2a, 0x8a00e5aa,
+			0xc5005555, 0x4500bdd5, 0x05000995, 0x8500e115, 0xa500db35, 0x250033b5, 0x650087f5, 0xe5006f75,
+			0x550090c5, 0xd5007845, 0x9500cc05, 0x15002485, 0x35001ea5, 0xb500f625, 0xf5004265, 0x7500aae5,
+			0x2d003d3d, 0xad00d5bd, 0xed0061fd, 0x6d00897d, 0x4d00b35d, 0xcd005bdd, 0x8d00ef9d, 0x0d00071d,
+			0xbd00f8ad, 0x3d00102d, 0x7d00a46d, 0xfd004ced, 0xdd0076cd, 0x5d009e4d, 0x1d002a0d, 0x9d00c28d,
+			0x9900c9c9, 0x19002149, 0x59009509, 0xd9007d89, 0xf90047a9, 0x7900af29, 0x39001b69, 0xb900f3e9,
+			0x09000c59, 0x8900e4d9, 0xc9005099, 0x4900b819, 0x69008239, 0xe9006ab9, 0xa900def9, 0x29003679,
+			0x7100a1a1, 0xf1004921, 0xb100fd61, 0x310015e1, 0x11002fc1, 0x9100c741, 0xd1007301, 0x51009b81,
+			0xe1006431, 0x61008cb1, 0x210038f1, 0xa100d071, 0x8100ea51, 0x010002d1, 0x4100b691, 0xc1005e11,
+			0x4b00bbbb, 0xcb00533b, 0x8b00e77b, 0x0b000ffb, 0x2b0035db, 0xab00dd5b, 0xeb00691b, 0x6b00819b,
+			0xdb007e2b, 0x5b0096ab, 0x1b0022eb, 0x9b00ca6b, 0xbb00f04b, 0x3b0018cb, 0x7b00ac8b, 0xfb00440b,
+			0xa300d3d3, 0x23003b53, 0x63008f13, 0xe3006793, 0xc3005db3, 0x4300b533, 0x03000173, 0x8300e9f3,
+			0x33001643, 0xb300fec3, 0xf3004a83, 0x7300a203, 0x53009823, 0xd30070a3, 0x9300c4e3, 0x13002c63,
+			0x17002727, 0x9700cfa7, 0xd7007be7, 0x57009367, 0x7700a947, 0xf70041c7, 0xb700f587, 0x37001d07,
+			0x8700e2b7, 0x07000a37, 0x4700be77, 0xc70056f7, 0xe7006cd7, 0x67008457, 0x27003017, 0xa700d897,
+			0xff004f4f, 0x7f00a7cf, 0x3f00138f, 0xbf00fb0f, 0x9f00c12f, 0x1f0029af, 0x5f009def, 0xdf00756f,
+			0x6f008adf, 0xef00625f, 0xaf00d61f, 0x2f003e9f, 0x0f0004bf, 0x8f00ec3f, 0xcf00587f, 0x4f00b0ff,
+		},
+	},
+	{
+		{
+			0x00000000, 0x80000000, 0xc0000000, 0x40000000, 0x20000000, 0xa0000000, 0xe0000000, 0x60000000,
+			0x50000000, 0xd0000000, 0x90000000, 0x10000000, 0x70000000, 0xf0000000, 0xb0000000, 0x30000000,
+			0xf8000000, 0x78000000, 0x38000000, 0xb8000000, 0xd8000000, 0x58000000, 0x18000000, 0x98000000,
+			0xa8000000, 0x28000000, 0x68000000, 0xe8000000, 0x88000000, 0x08000000, 0x48000000, 0xc8000000,
+			0x74000000, 0xf4000000, 0xb4000000, 0x34000000, 0x54000000, 0xd4000000, 0x94000000, 0x14000000,
+			0x24000000, 0xa4000000, 0xe4000000, 0x64000000, 0x04000000, 0x84000000, 0xc4000000, 0x44000000,
+			0x8c000000, 0x0c000000, 0x4c000000, 0xcc000000, 0xac000000, 0x2c000000, 0x6c000000, 0xec000000,
+			0xdc000000, 0x5c000000, 0x1c000000, 0x9c000000, 0xfc000000, 0x7c000000, 0x3c000000, 0xbc000000,
+			0xa2000000, 0x22000000, 0x62000000, 0xe2000000, 0x82000000, 0x02000000, 0x42000000, 0xc2000000,
+			0xf2000000, 0x72000000, 0x32000000, 0xb2000000, 0xd2000000, 0x52000000, 0x12000000, 0x92000000,
+			0x5a000000, 0xda000000, 0x9a000000, 0x1a000000, 0x7a000000, 0xfa000000, 0xba000000, 0x3a000000,
+			0x0a000000, 0x8a000000, 0xca000000, 0x4a000000, 0x2a000000, 0xaa000000, 0xea000000, 0x6a000000,
+			0xd6000000, 0x56000000, 0x16000000, 0x96000000, 0xf6000000, 0x76000000, 0x36000000, 0xb6000000,
+			0x86000000, 0x06000000, 0x46000000, 0xc6000000, 0xa6000000, 0x26000000, 0x66000000, 0xe6000000,
+			0x2e000000, 0xae000000, 0xee000000, 0x6e000000, 0x0e000000, 0x8e000000, 0xce000000, 0x4e000000,
+			0x7e000000, 0xfe000000, 0xbe000000, 0x3e000000, 0x5e000000, 0xde000000, 0x9e000000, 0x1e000000,
+			0x93000000, 0x13000000, 0x53000000, 0xd3000000, 0xb3000000, 0x33000000, 0x73000000, 0xf3000000,
+			0xc3000000, 0x43000000, 0x03000000, 0x83000000, 0xe3000000, 0x63000000, 0x23000000, 0xa3000000,
+			0x6b000000, 0xeb000000, 0xab000000, 0x2b000000, 0x4b000000, 0xcb000000, 0x8b000000, 0x0b000000,
+			0x3b000000, 0xbb000000, 0xfb000000, 0x7b000000, 0x1b000000, 0x9b000000, 0xdb000000, 0x5b000000,
+			0xe7000000, 0x67000000, 0x27000000, 0xa7000000, 0xc7000000, 0x47000000, 0x07000000, 0x87000000,
+			0xb7000000, 0x37000000, 0x77000000, 0xf7000000, 0x97000000, 0x17000000, 0x57000000, 0xd7000000,
+			0x1f000000, 0x9f000000, 0xdf000000, 0x5f000000, 0x3f000000, 0xbf000000, 0xff000000, 0x7f000000,
+			0x4f000000, 0xcf000000, 0x8f000000, 0x0f000000, 0x6f000000, 0xef000000, 0xaf000000, 0x2f000000,
+			0x31000000, 0xb1000000, 0xf1000000, 0x71000000, 0x11000000, 0x91000000, 0xd1000000, 0x51000000,
+			0x61000000, 0xe1000000, 0xa1000000, 0x21000000, 0x41000000, 0xc1000000, 0x81000000, 0x01000000,
+			0xc9000000, 0x49000000, 0x09000000, 0x89000000, 0xe9000000, 0x69000000, 0x29000000, 0xa9000000,
+			0x99000000, 0x19000000, 0x59000000, 0xd9000000, 0xb9000000, 0x39000000, 0x79000000, 0xf9000000,
+			0x45000000, 0xc5000000, 0x85000000, 0x05000000, 0x65000000, 0xe5000000, 0xa5000000, 0x25000000,
+			0x15000000, 0x95000000, 0xd5000000, 0x55000000, 0x35000000, 0xb5000000, 0xf5000000, 0x75000000,
+			0xbd000000, 0x3d000000, 0x7d000000, 0xfd000000, 0x9d000000, 0x1d000000, 0x5d000000, 0xdd000000,
+			0xed000000, 0x6d000000, 0x2d000000, 0xad000000, 0xcd000000, 0x4d000000, 0x0d000000, 0x8d000000,
+		},
+		{
+			0x00000000, 0xd8800000, 0x25400000, 0xfdc00000, 0x59e00000, 0x81600000, 0x7ca00000, 0xa4200000,
+			0xe6d00000, 0x3e500000, 0xc3900000, 0x1b100000, 0xbf300000, 0x67b00000, 0x9a700000, 0x42f00000,
+			0x78080000, 0xa0880000, 0x5d480000, 0x85c80000, 0x21e80000, 0xf9680000, 0x04a80000, 0xdc280000,
+			0x9ed80000, 0x46580000, 0xbb980000, 0x63180000, 0xc7380000, 0x1fb80000, 0xe2780000, 0x3af80000,
+			0xb40c0000, 0x6c8c0000, 0x914c0000, 0x49cc0000, 0xedec0000, 0x356c0000, 0xc8ac0000, 0x102c0000,
+			0x52dc0000, 0x8a5c0000, 0x779c0000, 0xaf1c0000, 0x0b3c0000, 0xd3bc0000, 0x2e7c0000, 0xf6fc0000,
+			0xcc040000, 0x14840000, 0xe9440000, 0x31c40000, 0x95e40000, 0x4d640000, 0xb0a40000, 0x68240000,
+			0x2ad40000, 0xf2540000, 0x0f940000, 0xd7140000, 0x73340000, 0xabb40000, 0x56740000, 0x8ef40000,
+			0x82020000, 0x5a820000, 0xa7420000, 0x7fc20000, 0xdbe20000, 0x03620000, 0xfea20000, 0x26220000,
+			0x64d20000, 0xbc520000, 0x41920000, 0x99120000, 0x3d320000, 0xe5b20000, 0x18720000, 0xc0f20000,
+			0xfa0a0000, 0x228a0000, 0xdf4a0000, 0x07ca0000, 0xa3ea0000, 0x7b6a0000, 0x86aa0000, 0x5e2a0000,
+			0x1cda0000, 0xc45a0000, 0x399a0000, 0xe11a0000, 0x453a0000, 0x9dba0000, 0x607a0000, 0xb8fa0000,
+			0x360e0000, 0xee8e0000, 0x134e0000, 0xcbce0000, 0x6fee0000, 0xb76e0000, 0x4aae0000, 0x922e0000,
+			0xd0de0000, 0x085e0000, 0xf59e0000, 0x2d1e0000, 0x893e0000, 0x51be0000, 0xac7e0000, 0x74fe0000,
+			0x4e060000, 0x96860000, 0x6b460000, 0xb3c60000, 0x17e60000, 0xcf660000, 0x32a60000, 0xea260000,
+			0xa8d60000, 0x70560000, 0x8d960000, 0x55160000, 0xf1360000, 0x29b60000, 0xd4760000, 0x0cf60000,
+			0xc3050000, 0x1b850000, 0xe6450000, 0x3ec50000, 0x9ae50000, 0x42650000, 0xbfa50000, 0x67250000,
+			0x25d50000, 0xfd550000, 0x00950000, 0xd8150000, 0x7c350000, 0xa4b50000, 0x59750000, 0x81f50000,
+			0xbb0d0000, 0x638d0000, 0x9e4d0000, 0x46cd0000, 0xe2ed0000, 0x3a6d0000, 0xc7ad0000, 0x1f2d0000,
+			0x5ddd0000, 0x855d0000, 0x789d0000, 0xa01d0000, 0x043d0000, 0xdcbd0000, 0x217d0000, 0xf9fd0000,
+			0x77090000, 0xaf890000, 0x52490000, 0x8ac90000, 0x2ee90000, 0xf6690000, 0x0ba90000, 0xd3290000,
+			0x91d90000, 0x49590000, 0xb4990000, 0x6c190000, 0xc8390000, 0x10b90000, 0xed790000, 0x35f90000,
+			0x0f010000, 0xd7810000, 0x2a410000, 0xf2c10000, 0x56e10000, 0x8e610000, 0x73a10000, 0xab210000,
+			0xe9d10000, 0x31510000, 0xcc910000, 0x14110000, 0xb0310000, 0x68b10000, 0x95710000, 0x4df10000,
+			0x41070000, 0x99870000, 0x64470000, 0xbcc70000, 0x18e70000, 0xc0670000, 0x3da70000, 0xe5270000,
+			0xa7d70000, 0x7f570000, 0x82970000, 0x5a170000, 0xfe370000, 0x26b70000, 0xdb770000, 0x03f70000,
+			0x390f0000, 0xe18f0000, 0x1c4f0000, 0xc4cf0000, 0x60ef0000, 0xb86f0000, 0x45af0000, 0x9d2f0000,
+			0xdfdf0000, 0x075f0000, 0xfa9f0000, 0x221f0000, 0x863f0000, 0x5ebf0000, 0xa37f0000, 0x7bff0000,
+			0xf50b0000, 0x2d8b0000, 0xd04b0000, 0x08cb0000, 0xaceb0000, 0x746b0000, 0x89ab0000, 0x512b0000,
+			0x13db0000, 0xcb5b0000, 0x369b0000, 0xee1b0000, 0x4a3b0000, 0x92bb0000, 0x6f7b0000, 0xb7fb0000,
+			0x8d030000, 0x55830000, 0xa8430000, 0x70c30000, 0xd4e30000, 0x0c630000, 0xf1a30000, 0x29230000,
+			0x6bd30000, 0xb3530000, 0x4e930000, 0x96130000, 0x32330000, 0xeab30000, 0x17730000, 0xcff30000,
+		},
+		{
+			0x00000000, 0x208f8000, 0x51474000, 0x71c8c000, 0xfbea2000, 0xdb65a000, 0xaaad6000, 0x8a22e000,
+			0x75d93000, 0x5556b000, 0x249e7000, 0x0411f000, 0x8e331000, 0xaebc9000, 0xdf745000, 0xfffbd000,
+			0xa0858800, 0x800a0800, 0xf1c2c800, 0xd14d4800, 0x5b6fa800, 0x7be02800, 0x0a28e800, 0x2aa76800,
+			0xd55cb800, 0xf5d33800, 0x841bf800, 0xa4947800, 0x2eb69800, 0x0e391800, 0x7ff1d800, 0x5f7e5800,
+			0x914e5400, 0xb1c1d400, 0xc0091400, 0xe0869400, 0x6aa47400, 0x4a2bf400, 0x3be33400, 0x1b6cb400,
+			0xe4976400, 0xc418e400, 0xb5d02400, 0x955fa400, 0x1f7d4400, 0x3ff2c400, 0x4e3a0400, 0x6eb58400,
+			0x31cbdc00, 0x11445c00, 0x608c9c00, 0x40031c00, 0xca21fc00, 0xeaae7c00, 0x9b66bc00, 0xbbe93c00,
+			0x4412ec00, 0x649d6c00, 0x1555ac00, 0x35da2c00, 0xbff8cc00, 0x9f774c00, 0xeebf8c00, 0xce300c00,
+			0xdbe79e00, 0xfb681e00, 0x8aa0de00, 0xaa2f5e00, 0x200dbe00, 0x00823e00, 0x714afe00, 0x51c57e00,
+			0xae3eae00, 0x8eb12e00, 0xff79ee00, 0xdff66e00, 0x55d48e00, 0x755b0e00, 0x0493ce00, 0x241c4e00,
+			0x7b621600, 0x5bed9600, 0x2a255600, 0x0aaad600, 0x80883600, 0xa007b600, 0xd1cf7600, 0xf140f600,
+			0x0ebb2600, 0x2e34a600, 0x5ffc6600, 0x7f73e600, 0xf5510600, 0xd5de8600, 0xa4164600, 0x8499c600,
+			0x4aa9ca00, 0x6a264a00, 0x1bee8a00, 0x3b610a00, 0xb143ea00, 0x91cc6a00, 0xe004aa00, 0xc08b2a00,
+			0x3f70fa00, 0x1fff7a00, 0x6e37ba00, 0x4eb83a00, 0xc49ada00, 0xe4155a00, 0x95dd9a00, 0xb5521a00,
+			0xea2c4200, 0xcaa3c200, 0xbb6b0200, 0x9be48200, 0x11c66200, 0x3149e200, 0x40812200, 0x600ea200,
+			0x9ff57200, 0xbf7af200, 0xceb23200, 0xee3db200, 0x641f5200, 0x4490d200, 0x35581200, 0x15d79200,
+			0x25db6d00, 0x0554ed00, 0x749c2d00, 0x5413ad00, 0xde314d00, 0xfebecd00, 0x8f760d00, 0xaff98d00,
+			0x50025d00, 0x708ddd00, 0x01451d00, 0x21ca9d00, 0xabe87d00, 0x8b67fd00, 0xfaaf3d00, 0xda20bd00,
+			0x855ee500, 0xa5d16500, 0xd419a500, 0xf4962500, 0x7eb4c500, 0x5e3b4500, 0x2ff38500, 0x0f7c0500,
+			0xf087d500, 0xd0085500, 0xa1c09500, 0x814f1500, 0x0b6df500, 0x2be27500, 0x5a2ab500, 0x7aa53500,
+			0xb4953900, 0x941ab900, 0xe5d27900, 0xc55df900, 0x4f7f1900, 0x6ff09900, 0x1e385900, 0x3eb7d900,
+			0xc14c0900, 0xe1c38900, 0x900b4900, 0xb084c900, 0x3aa62900, 0x1a29a900, 0x6be16900, 0x4b6ee900,
+			0x1410b100, 0x349f3100, 0x4557f100, 0x65d87100, 0xeffa9100, 0xcf751100, 0xbebdd100, 0x9e325100,
+			0x61c98100, 0x41460100, 0x308ec100, 0x10014100, 0x9a23a100, 0xbaac2100, 0xcb64e100, 0xebeb6100,
+			0xfe3cf300, 0xdeb37300, 0xaf7bb300, 0x8ff43300, 0x05d6d300, 0x25595300, 0x54919300, 0x741e1300,
+			0x8be5c300, 0xab6a4300, 0xdaa28300, 0xfa2d0300, 0x700fe300, 0x50806300, 0x2148a300, 0x01c72300,
+			0x5eb97b00, 0x7e36fb00, 0x0ffe3b00, 0x2f71bb00, 0xa5535b00, 0x85dcdb00, 0xf4141b00, 0xd49b9b00,
+			0x2b604b00, 0x0befcb00, 0x7a270b00, 0x5aa88b00, 0xd08a6b00, 0xf005eb00, 0x81cd2b00, 0xa142ab00,
+			0x6f72a700, 0x4ffd2700, 0x3e35e700, 0x1eba6700, 0x94988700, 0xb4170700, 0xc5dfc700, 0xe5504700,
+			0x1aab9700, 0x3a241700, 0x4becd700, 0x6b635700, 0xe141b700, 0xc1ce3700, 0xb006f700, 0x90897700,
+			0xcff72f00, 0xef78af00, 0x9eb06f00, 0xbe3fef00, 0x341d0f00, 0x14928f00, 0x655a4f00, 0x45d5cf00,
+			0xba2e1f00, 0x9aa19f00, 0xeb695f00, 0xcbe6df00, 0x41c43f00, 0x614bbf00, 0x10837f00, 0x300cff00,
+		},
+		{
+			0x00000000, 0x58800080, 0xe54000c0, 0xbdc00040, 0x79e00020, 0x216000a0, 0x9ca000e0, 0xc4200060,
+			0xb6d00050, 0xee5000d0, 0x53900090, 0x0b100010, 0xcf300070, 0x97b000f0, 0x2a7000b0, 0x72f00030,
+			0x800800f8, 0xd8880078, 0x65480038, 0x3dc800b8, 0xf9e800d8, 0xa1680058, 0x1ca80018, 0x44280098,
+			0x36d800a8, 0x6e580028, 0xd3980068, 0x8b1800e8, 0x4f380088, 0x17b80008, 0xaa780048, 0xf2f800c8,
+			0xc00c0074, 0x988c00f4, 0x254c00b4, 0x7dcc0034, 0xb9ec0054, 0xe16c00d4, 0x5cac0094, 0x042c0014,
+			0x76dc0024, 0x2e5c00a4, 0x939c00e4, 0xcb1c0064, 0x0f3c0004, 0x57bc0084, 0xea7c00c4, 0xb2fc0044,
+			0x4004008c, 0x1884000c, 0xa544004c, 0xfdc400cc, 0x39e400ac, 0x6164002c, 0xdca4006c, 0x842400ec,
+			0xf6d400dc, 0xae54005c, 0x1394001c, 0x4b14009c, 0x8f3400fc, 0xd7b4007c, 0x6a74003c, 0x32f400bc,
+			0x200200a2, 0x78820022, 0xc5420062, 0x9dc200e2, 0x59e20082, 0x01620002, 0xbca20042, 0xe42200c2,
+			0x96d200f2, 0xce520072, 0x73920032, 0x2b1200b2, 0xef3200d2, 0xb7b20052, 0x0a720012, 0x52f20092,
+			0xa00a005a, 0xf88a00da, 0x454a009a, 0x1dca001a, 0xd9ea007a, 0x816a00fa, 0x3caa00ba, 0x642a003a,
+			0x16da000a, 0x4e5a008a, 0xf39a00ca, 0xab1a004a, 0x6f3a002a, 0x37ba00aa, 0x8a7a00ea, 0xd2fa006a,
+			0xe00e00d6, 0xb88e0056, 0x054e0016, 0x5dce0096, 0x99ee00f6, 0xc16e0076, 0x7cae0036, 0x242e00b6,
+			0x56de0086, 0x0e5e0006, 0xb39e0046, 0xeb1e00c6, 0x2f3e00a6, 0x77be0026, 0xca7e0066, 0x92fe00e6,
+			0x6006002e, 0x388600ae, 0x854600ee, 0xddc6006e, 0x19e6000e, 0x4166008e, 0xfca600ce, 0xa426004e,
+			0xd6d6007e, 0x8e5600fe, 0x339600be, 0x6b16003e, 0xaf36005e, 0xf7b600de, 0x4a76009e, 0x12f6001e,
+			0x50050093, 0x08850013, 0xb5450053, 0xedc500d3, 0x29e500b3, 0x71650033, 0xcca50073, 0x942500f3,
+			0xe6d500c3, 0xbe550043, 0x03950003, 0x5b150083, 0x9f3500e3, 0xc7b50063, 0x7a750023, 0x22f500a3,
+			0xd00d006b, 0x888d00eb, 0x354d00ab, 0x6dcd002b, 0xa9ed004b, 0xf16d00cb, 0x4cad008b, 0x142d000b,
+			0x66dd003b, 0x3e5d00bb, 0x839d00fb, 0xdb1d007b, 0x1f3d001b, 0x47bd009b, 0xfa7d00db, 0xa2fd005b,
+			0x900900e7, 0xc8890067, 0x75490027, 0x2dc900a7, 0xe9e900c7, 0xb1690047, 0x0ca90007, 0x54290087,
+			0x26d900b7, 0x7e590037, 0xc3990077, 0x9b1900f7, 0x5f390097, 0x07b90017, 0xba790057, 0xe2f900d7,
+			0x1001001f, 0x4881009f, 0xf54100df, 0xadc1005f, 0x69e1003f, 0x316100bf, 0x8ca100ff, 0xd421007f,
+			0xa6d1004f, 0xfe5100cf, 0x4391008f, 0x1b11000f, 0xdf31006f, 0x87b100ef, 0x3a7100af, 0x62f1002f,
+			0x70070031, 0x288700b1, 0x954700f1, 0xcdc70071, 0x09e70011, 0x51670091, 0xeca700d1, 0xb4270051,
+			0xc6d70061, 0x9e5700e1, 0x239700a1, 0x7b170021, 0xbf370041, 0xe7b700c1, 0x5a770081, 0x02f70001,
+			0xf00f00c9, 0xa88f0049, 0x154f0009, 0x4dcf0089, 0x89ef00e9, 0xd16f0069, 0x6caf0029, 0x342f00a9,
+			0x46df0099, 0x1e5f0019, 0xa39f0059, 0xfb1f00d9, 0x3f3f00b9, 0x67bf0039, 0xda7f0079, 0x82ff00f9,
+			0xb00b0045, 0xe88b00c5, 0x554b0085, 0x0dcb0005, 0xc9eb0065, 0x916b00e5, 0x2cab00a5, 0x742b0025,
+			0x06db0015, 0x5e5b0095, 0xe39b00d5, 0xbb1b0055, 0x7f3b0035, 0x27bb00b5, 0x9a7b00f5, 0xc2fb0075,
+			0x300300bd, 0x6883003d, 0xd543007d, 0x8dc300fd, 0x49e3009d, 0x1163001d, 0xaca3005d, 0xf42300dd,
+			0x86d300ed, 0xde53006d, 0x6393002d, 0x3b1300ad, 0xff3300cd, 0xa7b3004d, 0x1a73000d, 0x42f3008d,
+		},
+	},
+};
+
+void initSobol(sobolSampler *s, uint32_t index, uint32_t seed) {
+	s->index = index;
+	s->seed = seed;
+	s->bounce_seed = seed;
+	s->dimension = 0;
+}
+
+void sobolStartBounce(sobolSampler *s, unsigned bounce) {
+	s->bounce_seed = sobol_hash(s->seed ^ sobol_hash(bounce + 1));
+	s->dimension = 0;
+}
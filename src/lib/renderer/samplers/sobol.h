@@ -0,0 +1,85 @@
+//
+//  sobol.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 16/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+// Owen-scrambled Sobol sampler, after Burley's "Practical Hash-based Owen Scrambling" (JCGT 2020).
+// Dimensions are handed out in padded groups of 4. Each group shuffles the sample index with its
+// own seed, so groups don't correlate with each other, while dimensions within a group stay
+// stratified against each other. Dimension numbering restarts every bounce, with a per-bounce
+// seed, so a given bounce always draws from the same dimensions regardless of what came before.
+
+#define SOBOL_DIMENSIONS 4
+
+extern const uint32_t sobol_matrices[SOBOL_DIMENSIONS][32];
+extern const uint32_t sobol_byte_tables[SOBOL_DIMENSIONS][4][256];
+
+struct sobolSampler {
+	uint32_t index; // Sample index within the pixel
+	uint32_t seed; // Per pixel
+	uint32_t bounce_seed; // Per pixel & bounce
+	uint32_t dimension; // Within the current bounce
+	// Scrambled index & seed for the current group of dimensions, so they're only computed once per group
+	uint32_t group_index;
+	uint32_t group_seed;
+};
+
+typedef struct sobolSampler sobolSampler;
+
+void initSobol(sobolSampler *s, uint32_t index, uint32_t seed);
+void sobolStartBounce(sobolSampler *s, unsigned bounce);
+
+static inline uint32_t sobol_hash(uint32_t x) {
+	// lowbias32 by Chris Wellons
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+static inline uint32_t sobol_reverse_bits(uint32_t x) {
+	x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+	x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+	x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+	x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+	return (x >> 16) | (x << 16);
+}
+
+// Hash-based nested uniform scramble, an Owen scramble of the bits of x
+static inline uint32_t sobol_owen_scramble(uint32_t x, uint32_t seed) {
+	x = sobol_reverse_bits(x);
+	// Laine-Karras style permutation, with Burley's improved constants
+	x += seed;
+	x ^= x * 0x6c50b47cu;
+	x ^= x * 0xb82f1e52u;
+	x ^= x * 0xc7afe638u;
+	x ^= x * 0x8d22f6e6u;
+	return sobol_reverse_bits(x);
+}
+
+static inline uint32_t sobol_sample(uint32_t index, unsigned dim) {
+	// The scrambled index has random bits all the way up, so this would
+	// be 32 steps of mispredicted branches without the byte tables.
+	const uint32_t (*t)[256] = sobol_byte_tables[dim];
+	return t[0][index & 0xff] ^ t[1][(index >> 8) & 0xff] ^ t[2][(index >> 16) & 0xff] ^ t[3][index >> 24];
+}
+
+static inline float getSobol(sobolSampler *s) {
+	const uint32_t dim = s->dimension++;
+	if (dim % SOBOL_DIMENSIONS == 0) {
+		s->group_seed = sobol_hash(s->bounce_seed + dim / SOBOL_DIMENSIONS);
+		s->group_index = sobol_owen_scramble(s->index, s->group_seed);
+	}
+	const uint32_t x = sobol_owen_scramble(sobol_sample(s->group_index, dim % SOBOL_DIMENSIONS), sobol_hash(s->group_seed ^ (dim + 1)));
+	// Top 24 bits, so the result stays below 1.0f
+	return (float)(x >> 8) * (1.0f / 16777216.0f);
+}
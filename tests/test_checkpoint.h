@@ -0,0 +1,86 @@
+//
+//  test_checkpoint.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../src/lib/renderer/checkpoint.h"
+#include "../src/lib/renderer/renderer.h"
+#include "../src/lib/datatypes/tile.h"
+
+bool checkpoint_roundtrip(void) {
+	const char *path = "/tmp/c-ray-test-checkpoint.crcp";
+	struct renderer r = { 0 };
+	r.prefs.sampleCount = 4;
+	r.prefs.tileWidth = 8;
+	r.prefs.tileHeight = 8;
+	r.prefs.tileOrder = ro_top_to_bottom;
+
+	struct texture *saved = tex_new(float_p, 20, 12, 4);
+	for (size_t i = 0; i < 20 * 12 * 4; ++i) saved->data.float_p[i] = (float)i * 0.25f - 17.0f;
+	// Denoiser guide, saved along with the color
+	struct texture *saved_albedo = tex_new(float_p, 20, 12, 4);
+	for (size_t i = 0; i < 20 * 12 * 4; ++i) saved_albedo->data.float_p[i] = (float)(i % 17) * 0.125f;
+	r.state.aovs[cr_aov_albedo] = saved_albedo;
+	r.state.aov_mask = 1 << cr_aov_albedo;
+	struct tile_set set;
+	tile_set_init(&set, tile_quantize(20, 12, 8, 8, ro_top_to_bottom), po_scanline);
+	test_assert(set.tiles.count == 6);
+	for (size_t t = 0; t < set.tiles.count; ++t) {
+		set.tiles.items[t].total_samples = r.prefs.sampleCount;
+		// Tiles 0, 2 and 5 are done, 1 is in flight with some samples in it
+		const bool done = t == 0 || t == 2 || t == 5;
+		set.tiles.items[t].state = done ? finished : t == 1 ? rendering : ready_to_render;
+		set.tiles.items[t].completed_samples = done ? 4 : t == 1 ? 2 : 0;
+	}
+	test_assert(checkpoint_save(path, &r, &set, saved, 1234));
+
+	struct texture *loaded = tex_new(float_p, 20, 12, 4);
+	struct texture *loaded_albedo = tex_new(float_p, 20, 12, 4);
+	r.state.aovs[cr_aov_albedo] = loaded_albedo;
+	struct tile_set resumed;
+	tile_set_init(&resumed, tile_quantize(20, 12, 8, 8, ro_top_to_bottom), po_scanline);
+	// Checkpoints for some other scene are refused, and leave everything as it was
+	test_assert(!checkpoint_load(path, &r, &resumed, loaded, 4321));
+	test_assert(loaded->data.float_p[1] == 0.0f);
+	// Same with different AOVs, the guides would be missing
+	r.state.aov_mask = 0;
+	test_assert(!checkpoint_load(path, &r, &resumed, loaded, 1234));
+	r.state.aov_mask = 1 << cr_aov_albedo;
+	for (size_t t = 0; t < resumed.tiles.count; ++t) {
+		test_assert(resumed.tiles.items[t].completed_samples == 0);
+	}
+
+	test_assert(checkpoint_load(path, &r, &resumed, loaded, 1234));
+	test_assert(!memcmp(saved->data.float_p, loaded->data.float_p, 20 * 12 * 4 * sizeof(float)));
+	test_assert(!memcmp(saved_albedo->data.float_p, loaded_albedo->data.float_p, 20 * 12 * 4 * sizeof(float)));
+	// Finished tiles come first, the in-flight one gets redone from scratch
+	test_assert(resumed.finished == 3);
+	for (size_t t = 0; t < resumed.tiles.count; ++t) {
+		const struct render_tile *tile = &resumed.tiles.items[t];
+		const struct render_tile *orig = NULL;
+		for (size_t o = 0; o < set.tiles.count; ++o) {
+			if (set.tiles.items[o].begin.x == tile->begin.x && set.tiles.items[o].begin.y == tile->begin.y) orig = &set.tiles.items[o];
+		}
+		test_assert(orig);
+		test_assert(tile->index == (int)t);
+		if (orig->state == finished) {
+			test_assert(t < 3);
+			test_assert(tile->state == finished && tile->completed_samples == 4);
+		} else {
+			test_assert(t >= 3);
+			test_assert(tile->state == ready_to_render && tile->completed_samples == 0);
+		}
+	}
+
+	tile_set_free(&resumed);
+	tile_set_free(&set);
+	tex_destroy(loaded_albedo);
+	tex_destroy(saved_albedo);
+	tex_destroy(loaded);
+	tex_destroy(saved);
+	remove(path);
+	return true;
+}
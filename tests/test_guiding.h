@@ -0,0 +1,72 @@
+//
+//  test_guiding.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../src/lib/renderer/guiding.h"
+#include "../src/lib/renderer/samplers/sampler.h"
+
+bool guiding_pdf(void) {
+	const struct boundingBox bounds = { { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } };
+	struct path_guide *guide = guide_new(bounds);
+	test_assert(guide);
+	sampler *sampler = sampler_new();
+	sampler_init(sampler, Random, 0, 1, 0);
+
+	// Most of the light comes from a small bright spot, so the quadtree refines around it
+	const struct vector p = { 0.1f, 0.2f, 0.3f };
+	const struct vector spot = vec_normalize((struct vector){ 0.3f, 0.8f, -0.5f });
+	for (size_t iteration = 0; iteration < 6; ++iteration) {
+		struct guide_splats splats = { 0 };
+		guide_splats_reset(&splats, guide);
+		for (size_t i = 0; i < 20000; ++i) {
+			const struct vector dir = vec_on_unit_sphere(sampler);
+			const float radiance = 0.1f + (vec_dot(dir, spot) > 0.95f ? 50.0f : 0.0f);
+			guide_record(guide, &splats, p, dir, radiance, 1.0f / (4.0f * PI));
+		}
+		guide_update(guide, &splats, 1);
+		guide_splats_free(&splats);
+	}
+	const uint32_t root = guide_lookup(guide, p);
+	test_assert(root);
+
+	// guide_sample() returns the same density guide_pdf() gives for the sampled direction
+	const size_t count = 1 << 16;
+	size_t mismatches = 0;
+	size_t near_spot = 0;
+	for (size_t i = 0; i < count; ++i) {
+		struct vector dir;
+		const float pdf = guide_sample(guide, root, sampler, &dir);
+		test_assert(pdf > 0.0f);
+		roughly_equals(vec_length(dir), 1.0f);
+		// Directions right on a quadrant edge may get looked up in the neighbouring one
+		if (fabsf(guide_pdf(guide, root, dir) - pdf) > 1e-4f * pdf) mismatches++;
+		if (vec_dot(dir, spot) > 0.95f) near_spot++;
+	}
+	test_assert(mismatches < count / 1000);
+	// The spot covers 2.5% of the sphere, but most samples should head there
+	test_assert(near_spot > count / 2);
+
+	// And guide_pdf() integrates to one over the sphere. The cylindrical mapping
+	// preserves area, so that's 4π times its mean over the unit square.
+	const size_t res = 1024;
+	double sum = 0.0;
+	for (size_t y = 0; y < res; ++y) {
+		for (size_t x = 0; x < res; ++x) {
+			const float cos_theta = 2.0f * ((float)x + 0.5f) / (float)res - 1.0f;
+			const float sin_theta = sqrtf(max(0.0f, 1.0f - cos_theta * cos_theta));
+			const float phi = 2.0f * PI * ((float)y + 0.5f) / (float)res - PI;
+			const struct vector dir = { sin_theta * cosf(phi), cos_theta, sin_theta * sinf(phi) };
+			sum += guide_pdf(guide, root, dir);
+		}
+	}
+	const double integral = sum / (double)(res * res) * 4.0 * PI;
+	test_assert(fabs(integral - 1.0) < 1e-3);
+
+	sampler_destroy(sampler);
+	guide_destroy(guide);
+	return true;
+}
@@ -0,0 +1,139 @@
+//
+//  test_lights.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../src/lib/renderer/envmap.h"
+#include "../src/lib/accelerators/lighttree.h"
+#include "../src/lib/renderer/samplers/sampler.h"
+#include "../src/lib/datatypes/scene.h"
+#include "../src/lib/datatypes/hitrecord.h"
+#include "../src/lib/nodes/bsdfnode.h"
+
+// Dim sky, brighter towards +Y, with a small bright sun
+static struct bsdfSample test_env_sample(const struct bsdfNode *bsdf, sampler *sampler, const struct hitRecord *record) {
+	(void)bsdf; (void)sampler;
+	const struct vector d = vec_normalize(record->incident->direction);
+	const struct vector sun = vec_normalize((struct vector){ 1.0f, 0.3f, 0.2f });
+	const float s = powf(max(vec_dot(d, sun), 0.0f), 32.0f);
+	const float v = 0.1f + 0.5f * max(d.y, 0.0f) + 20.0f * s;
+	return (struct bsdfSample){ .weight = { v, v, v, 1.0f } };
+}
+
+#define ENV_TEST_PHI 16
+#define ENV_TEST_THETA 8
+
+// Probability of env_map_sample() landing in each coarse (phi, theta) cell, integrated from env_map_pdf()
+static void env_cell_probabilities(const struct env_map *env, double *cells) {
+	const size_t sub = 32;
+	for (size_t cy = 0; cy < ENV_TEST_THETA; ++cy) {
+		for (size_t cx = 0; cx < ENV_TEST_PHI; ++cx) {
+			double sum = 0.0;
+			for (size_t sy = 0; sy < sub; ++sy) {
+				const double theta = ((double)cy + ((double)sy + 0.5) / sub) / ENV_TEST_THETA * PI;
+				for (size_t sx = 0; sx < sub; ++sx) {
+					const double phi = ((double)cx + ((double)sx + 0.5) / sub) / ENV_TEST_PHI * 2.0 * PI;
+					const struct vector dir = { sin(theta) * cos(phi), cos(theta), sin(theta) * sin(phi) };
+					sum += env_map_pdf(env, dir) * sin(theta);
+				}
+			}
+			const double cell_area = (PI / ENV_TEST_THETA) * (2.0 * PI / ENV_TEST_PHI) / (double)(sub * sub);
+			cells[cy * ENV_TEST_PHI + cx] = sum * cell_area;
+		}
+	}
+}
+
+bool lights_env_pdf(void) {
+	struct bsdfNode background = { .sample = test_env_sample };
+	struct world scene = { .background = &background };
+	struct env_map env;
+	test_assert(env_map_build(&env, &scene));
+
+	double expected[ENV_TEST_PHI * ENV_TEST_THETA];
+	env_cell_probabilities(&env, expected);
+	double total = 0.0;
+	for (size_t i = 0; i < ENV_TEST_PHI * ENV_TEST_THETA; ++i) total += expected[i];
+	// The pdf integrates to one over the sphere
+	test_assert(fabs(total - 1.0) < 1e-3);
+
+	const size_t count = 1 << 19;
+	size_t hits[ENV_TEST_PHI * ENV_TEST_THETA] = { 0 };
+	size_t pdf_mismatches = 0;
+	sampler *sampler = sampler_new();
+	sampler_init(sampler, Random, 0, 1, 0);
+	for (size_t i = 0; i < count; ++i) {
+		struct vector dir;
+		const float pdf = env_map_sample(&env, sampler, &dir);
+		test_assert(pdf > 0.0f);
+		// Samples right on a cell edge may get looked up in the neighbouring cell
+		const float lookup = env_map_pdf(&env, dir);
+		if (fabsf(lookup - pdf) > 1e-3f * pdf) pdf_mismatches++;
+		const double theta = acos(clamp(dir.y, -1.0f, 1.0f));
+		double phi = atan2(dir.z, dir.x);
+		if (phi < 0.0) phi += 2.0 * PI;
+		const size_t cx = min((size_t)(phi / (2.0 * PI) * ENV_TEST_PHI), ENV_TEST_PHI - 1);
+		const size_t cy = min((size_t)(theta / PI * ENV_TEST_THETA), ENV_TEST_THETA - 1);
+		hits[cy * ENV_TEST_PHI + cx]++;
+	}
+	sampler_destroy(sampler);
+	test_assert(pdf_mismatches < count / 1000);
+
+	// Sampling frequencies follow the pdf, within a few standard deviations
+	for (size_t i = 0; i < ENV_TEST_PHI * ENV_TEST_THETA; ++i) {
+		const double freq = (double)hits[i] / (double)count;
+		const double sigma = sqrt(expected[i] * (1.0 - expected[i]) / (double)count);
+		test_assert(fabs(freq - expected[i]) <= 5.0 * sigma + 1e-4);
+	}
+	env_map_free(&env);
+	return true;
+}
+
+bool lights_tree_pmf(void) {
+	// Small emitters scattered around, facing all sorts of ways
+	const size_t count = 57;
+	struct light_bounds prims[57];
+	sampler *sampler = sampler_new();
+	sampler_init(sampler, Random, 0, 1, 0);
+	for (size_t i = 0; i < count; ++i) {
+		const struct vector c = { sampler_dimension(sampler) * 20.0f - 10.0f, sampler_dimension(sampler) * 20.0f - 10.0f, sampler_dimension(sampler) * 20.0f - 10.0f };
+		const struct vector e = { 0.1f + sampler_dimension(sampler), 0.1f + sampler_dimension(sampler), 0.1f + sampler_dimension(sampler) };
+		prims[i] = (struct light_bounds){
+			.bbox = { vec_sub(c, e), vec_add(c, e) },
+			.axis = vec_on_unit_sphere(sampler),
+			.cos_theta_o = i % 5 ? cosf(0.1f * (float)(i % 7)) : -1.0f,
+			.power = 0.01f + 10.0f * sampler_dimension(sampler),
+		};
+	}
+	struct light_tree *tree = light_tree_build(prims, count);
+	test_assert(tree);
+
+	const struct vector points[] = {
+		{ 0.0f, 0.0f, 0.0f },
+		{ 15.0f, -3.0f, 2.0f },
+		{ -9.5f, 9.5f, -9.5f },
+		{ 100.0f, 50.0f, -70.0f },
+	};
+	for (size_t p = 0; p < sizeof(points) / sizeof(*points); ++p) {
+		double total = 0.0;
+		float pmfs[57];
+		for (size_t i = 0; i < count; ++i) {
+			pmfs[i] = light_tree_pmf(tree, prims, points[p], i);
+			test_assert(pmfs[i] >= 0.0f);
+			total += pmfs[i];
+		}
+		test_assert(fabs(total - 1.0) < 1e-4);
+		// And light_tree_sample() agrees with it
+		for (size_t s = 0; s < 256; ++s) {
+			float pmf = 0.0f;
+			const int64_t picked = light_tree_sample(tree, prims, points[p], sampler_dimension(sampler), &pmf);
+			test_assert(picked >= 0 && picked < (int64_t)count);
+			test_assert(fabsf(pmf - pmfs[picked]) <= 1e-5f * pmfs[picked]);
+		}
+	}
+	light_tree_destroy(tree);
+	sampler_destroy(sampler);
+	return true;
+}
@@ -16,7 +16,22 @@
 #include "../src/lib/nodes/vectornode.h"
 #include "../src/lib/nodes/converter/math.h"
 #include "../src/lib/nodes/converter/map_range.h"
+#include "../src/lib/nodes/converter/grayscale.h"
+#include "../src/lib/nodes/converter/combinergb.h"
+#include "../src/lib/nodes/textures/constant.h"
+#include "../src/lib/nodes/textures/colormix.h"
+#include "../src/lib/nodes/textures/hsv_transform.h"
+#include "../src/lib/nodes/program.h"
+#include "../src/lib/nodes/native.h"
+#include "../src/lib/nodes/memo.h"
+#include "../src/lib/nodes/bsdfnode.h"
+#include "../src/lib/nodes/converter/vectovalue.h"
+#include "../src/lib/nodes/converter/vectocolor.h"
+#include "../src/lib/nodes/input/uv.h"
+#include "../src/lib/datatypes/hitrecord.h"
 #include "../src/lib/renderer/samplers/sampler.h"
+#include <dirent.h>
+#include <sys/stat.h>
 
 struct node_storage *make_storage() {
 	struct node_storage *storage = calloc(1, sizeof(*storage));
@@ -28,6 +43,7 @@ struct node_storage *make_storage() {
 void delete_storage(struct node_storage *storage) {
 	destroyHashtable(storage->node_table);
 	destroyBlocks(storage->node_pool);
+	native_cache_destroy(storage->native);
 	free(storage);
 }
 
@@ -919,3 +935,309 @@ bool map_range(void) {
 	sampler_destroy(sampler);
 	return true;
 }
+
+bool node_fold(void) {
+	struct node_storage *s = make_storage();
+	
+	const struct valueNode *half = newConstantValue(s, 0.5f);
+	const struct valueNode *u = newVecToValue(s, newUV(s), U);
+	
+	// Constant subgraphs collapse into a single constant
+	const struct valueNode *math = newMath(s, newMath(s, half, newConstantValue(s, 3.0f), Add), half, Multiply);
+	test_assert(math == newConstantValue(s, 1.75f));
+	const struct valueNode *range = newMapRange(s, half, NULL, NULL, NULL, newConstantValue(s, 4.0f));
+	test_assert(range == newConstantValue(s, 2.0f));
+	const struct colorNode *rgb = newCombineRGB(s, half, range, math);
+	test_assert(rgb == newConstantTexture(s, (struct color){ 0.5f, 2.0f, 1.75f, 1.0f }));
+	test_assert(newGrayscaleConverter(s, rgb)->constant);
+	test_assert(newVecToValue(s, newVecMath(s, newConstantVector(s, (struct vector){ 1.0f, 2.0f, 2.0f }), NULL, NULL, NULL, VecLength), F) == newConstantValue(s, 3.0f));
+	
+	// Anything depending on the hit stays
+	test_assert(!newMath(s, u, half, Add)->constant);
+	
+	// Mixes with a constant factor at either end only ever pick one side
+	const struct colorNode *A = newVecToColor(s, newUV(s));
+	const struct colorNode *B = newConstantTexture(s, g_black_color);
+	test_assert(new_color_mix(s, A, B, newConstantValue(s, 0.0f)) == A);
+	test_assert(new_color_mix(s, A, B, newConstantValue(s, 1.0f)) == B);
+	test_assert(new_color_mix(s, A, B, half) != A);
+	test_assert(new_color_mix(s, A, B, u) != A);
+	
+	delete_storage(s);
+	return true;
+}
+
+bool node_program_math(void) {
+	struct node_storage *s = make_storage();
+	struct sampler *sampler = sampler_new();
+	sampler_init(sampler, Halton, 0, 16, 128);
+	
+	// Driven by UV, so nothing gets folded into a constant
+	const struct hitRecord record = { .uv = { 0.3f, 0.7f } };
+	const struct valueNode *u = newVecToValue(s, newUV(s), U);
+	const struct valueNode *half = newConstantValue(s, 0.5f);
+	const struct valueNode *three = newConstantValue(s, 3.0f);
+	const struct valueNode *sum = newMath(s, u, three, Add);
+	const struct valueNode *chain = newMath(s, newMath(s, sum, three, Multiply), half, Power);
+	const struct valueNode *graph = newMapRange(s, chain, newConstantValue(s, 0.0f), newConstantValue(s, 10.0f), half, sum);
+	
+	const struct valueNode *program = compile_value_node(s, graph);
+	test_assert(program != graph);
+	test_assert(program->eval(program, sampler, &record) == graph->eval(graph, sampler, &record));
+	// Compiling the same graph twice gives the same node
+	test_assert(compile_value_node(s, graph) == program);
+	// Nothing to gain for a lone constant
+	test_assert(compile_value_node(s, half) == half);
+	
+	delete_storage(s);
+	sampler_destroy(sampler);
+	return true;
+}
+
+bool node_program_mix(void) {
+	struct node_storage *s = make_storage();
+	struct sampler *A = sampler_new();
+	struct sampler *B = sampler_new();
+	
+	const struct hitRecord record = { .uv = { 0.3f, 0.7f } };
+	const struct colorNode *red = newConstantTexture(s, (struct color){ 1.0f, 0.0f, 0.0f, 1.0f });
+	const struct colorNode *uv = newVecToColor(s, newUV(s));
+	const struct colorNode *rgb = newCombineRGB(s, newConstantValue(s, 0.2f), newGrayscaleConverter(s, uv), newConstantValue(s, 0.7f));
+	// No compile hook, gets called from the program
+	const struct colorNode *hsv = newHSVTransform(s, rgb, newConstantValue(s, 0.3f), newConstantValue(s, 1.0f), newConstantValue(s, 1.0f), newConstantValue(s, 1.0f));
+	const struct colorNode *inner = new_color_mix(s, red, hsv, newConstantValue(s, 0.25f));
+	const struct colorNode *graph = new_color_mix(s, inner, rgb, newConstantValue(s, 0.5f));
+	
+	const struct colorNode *program = compile_color_node(s, graph);
+	test_assert(program != graph);
+	// Same picks for the same sample sequence, including the dimensions consumed afterwards
+	for (uint32_t px = 0; px < 64; ++px) {
+		sampler_init(A, Halton, 0, 16, px);
+		sampler_init(B, Halton, 0, 16, px);
+		const struct color expected = graph->eval(graph, A, &record);
+		const struct color result = program->eval(program, B, &record);
+		test_assert(!memcmp(&expected, &result, sizeof(result)));
+		test_assert(sampler_dimension(A) == sampler_dimension(B));
+	}
+	
+	delete_storage(s);
+	sampler_destroy(A);
+	sampler_destroy(B);
+	return true;
+}
+
+static bool check_native(const char *cache) {
+	struct node_storage *s = make_storage();
+	struct sampler *A = sampler_new();
+	struct sampler *B = sampler_new();
+	
+	struct hitRecord record = { .uv = { 0.3f, 0.7f } };
+	const struct valueNode *half = newConstantValue(s, 0.5f);
+	const struct valueNode *sum = newMath(s, newVecToValue(s, newUV(s), V), newConstantValue(s, 3.0f), Add);
+	const struct valueNode *value = newMapRange(s, newMath(s, sum, half, Power), newConstantValue(s, 0.0f), newConstantValue(s, 10.0f), half, sum);
+	const struct colorNode *rgb = newCombineRGB(s, value, newMath(s, value, half, InvSquareRoot), half);
+	const struct colorNode *mix = new_color_mix(s, rgb, newConstantTexture(s, (struct color){ 1.0f, 0.0f, 0.0f, 1.0f }), value);
+	struct ramp_element elements[] = {
+		{ .color = { 0.0f, 0.0f, 1.0f, 1.0f }, .position = 0.2f },
+		{ .color = { 1.0f, 0.5f, 0.0f, 1.0f }, .position = 0.8f },
+	};
+	const struct colorNode *ramp = new_color_ramp(s, newVecToValue(s, newUV(s), U), cr_mode_rgb, cr_linear, elements, 2);
+	const struct colorNode *graph = newCheckerBoardTexture(s, mix, ramp, sum);
+	
+	// Without a C compiler this just checks the fallback
+	s->native = native_cache_new(cache);
+	const struct colorNode *program = compile_color_node(s, graph);
+	test_assert(program != graph);
+	// Already compiled, so it's looked up instead of built and loaded again
+	test_assert(compile_color_node(s, graph) == program);
+	for (uint32_t px = 0; px < 64; ++px) {
+		sampler_init(A, Halton, 0, 16, px);
+		sampler_init(B, Halton, 0, 16, px);
+		// Walk across the checker squares too
+		record.uv.x = px / 64.0f;
+		const struct color expected = graph->eval(graph, A, &record);
+		const struct color result = program->eval(program, B, &record);
+		test_assert(!memcmp(&expected, &result, sizeof(result)));
+	}
+	
+	delete_storage(s);
+	sampler_destroy(A);
+	sampler_destroy(B);
+	return true;
+}
+
+bool node_program_native(void) {
+	// The path goes to the compiler as is, quotes and all
+	const char *cache = "/tmp/c-ray test's shaders";
+	test_assert(check_native(cache));
+	// Objects are only named by a hash, so one with a different source next to it mustn't be used
+	DIR *dir = opendir(cache);
+	if (dir) {
+		struct dirent *entry;
+		while ((entry = readdir(dir))) {
+			const size_t len = strlen(entry->d_name);
+			if (len < 2 || strcmp(entry->d_name + len - 2, ".c")) continue;
+			char path[1024];
+			snprintf(path, sizeof(path), "%s/%s", cache, entry->d_name);
+			FILE *f = fopen(path, "a");
+			if (f) {
+				fputs("// Some other program\n", f);
+				fclose(f);
+			}
+		}
+		closedir(dir);
+	}
+	test_assert(check_native(cache));
+	// Anyone could drop objects in a directory others can write to
+	test_assert(!chmod(cache, 0777));
+	test_assert(!native_cache_new(cache));
+	test_assert(!chmod(cache, 0755));
+	struct native_cache *ok = native_cache_new(cache);
+	test_assert(ok);
+	native_cache_destroy(ok);
+	return true;
+}
+
+bool node_memo(void) {
+	struct node_storage *s = make_storage();
+	struct sampler *sampler = sampler_new();
+	sampler_init(sampler, Halton, 0, 16, 128);
+	
+	const struct valueNode *half = newConstantValue(s, 0.5f);
+	test_assert(memo_value_node(s, half) == half);
+	const struct valueNode *u = newMath(s, newVecToValue(s, newUV(s), U), half, Add);
+	const struct valueNode *memo = memo_value_node(s, u);
+	test_assert(memo != u);
+	test_assert(memo_value_node(s, memo) == memo);
+	
+	struct node_memo cache;
+	node_memo_reset(&cache);
+	struct hitRecord record = { .uv = { 0.25f, 0.0f }, .memo = &cache };
+	test_assert(memo->eval(memo, sampler, &record) == 0.75f);
+	// Same shading point, so the first result sticks
+	record.uv.x = 0.0f;
+	test_assert(memo->eval(memo, sampler, &record) == 0.75f);
+	node_memo_reset(&cache);
+	test_assert(memo->eval(memo, sampler, &record) == 0.5f);
+	// No cache, no memoization
+	record.memo = NULL;
+	record.uv.x = 0.125f;
+	test_assert(memo->eval(memo, sampler, &record) == 0.625f);
+	
+	delete_storage(s);
+	sampler_destroy(sampler);
+	return true;
+}
+
+bool node_program_batch(void) {
+	struct node_storage *s = make_storage();
+	struct sampler *A[NODE_BATCH_SIZE];
+	struct sampler *B[NODE_BATCH_SIZE];
+	for (size_t l = 0; l < NODE_BATCH_SIZE; ++l) {
+		A[l] = sampler_new();
+		B[l] = sampler_new();
+	}
+	
+	const struct valueNode *u = newVecToValue(s, newUV(s), U);
+	const struct valueNode *v = newVecToValue(s, newUV(s), V);
+	struct ramp_element elements[] = {
+		{ .color = { 0.0f, 0.0f, 1.0f, 1.0f }, .position = 0.2f },
+		{ .color = { 1.0f, 0.5f, 0.0f, 1.0f }, .position = 0.8f },
+	};
+	const struct colorNode *ramp = new_color_ramp(s, newMath(s, u, v, Multiply), cr_mode_rgb, cr_linear, elements, 2);
+	const struct colorNode *uv = newVecToColor(s, newVecMath(s, newUV(s), newNormal(s), NULL, newConstantValue(s, 2.0f), VecScale));
+	// No compile hook, gets called lane by lane
+	const struct colorNode *hsv = newHSVTransform(s, uv, newConstantValue(s, 0.3f), newConstantValue(s, 1.0f), newConstantValue(s, 1.0f), newConstantValue(s, 1.0f));
+	const struct colorNode *mix = new_color_mix(s, uv, hsv, v);
+	const struct colorNode *graph = newCheckerBoardTexture(s, ramp, mix, newMath(s, u, newConstantValue(s, 4.0f), Add));
+	
+	const struct colorNode *program = compile_color_node(s, graph);
+	test_assert(program != graph);
+	
+	struct hitRecord records[NODE_BATCH_SIZE];
+	const struct hitRecord *lanes[NODE_BATCH_SIZE];
+	// A partial batch too, the idle lanes must not touch their samplers
+	for (size_t count = NODE_BATCH_SIZE; count >= NODE_BATCH_SIZE - 3; --count) {
+		for (size_t l = 0; l < count; ++l) {
+			records[l] = (struct hitRecord){
+				.uv = { (float)l / NODE_BATCH_SIZE, 1.0f - (float)(l * l) / (NODE_BATCH_SIZE * NODE_BATCH_SIZE) },
+				.surfaceNormal = { 0.0f, 1.0f, 0.0f },
+			};
+			lanes[l] = &records[l];
+			sampler_init(A[l], Halton, 0, 16, (uint32_t)l);
+			sampler_init(B[l], Halton, 0, 16, (uint32_t)l);
+		}
+		struct node_batch batch;
+		node_batch_init(&batch, B, lanes, count);
+		struct color result[NODE_BATCH_SIZE];
+		color_node_eval_batch(program, &batch, result);
+		for (size_t l = 0; l < count; ++l) {
+			const struct color expected = graph->eval(graph, A[l], &records[l]);
+			test_assert(!memcmp(&expected, &result[l], sizeof(expected)));
+			test_assert(sampler_dimension(A[l]) == sampler_dimension(B[l]));
+		}
+	}
+	
+	delete_storage(s);
+	for (size_t l = 0; l < NODE_BATCH_SIZE; ++l) {
+		sampler_destroy(A[l]);
+		sampler_destroy(B[l]);
+	}
+	return true;
+}
+
+bool node_program_sample_batch(void) {
+	struct node_storage *s = make_storage();
+	struct sampler *A[NODE_BATCH_SIZE];
+	struct sampler *B[NODE_BATCH_SIZE];
+	for (size_t l = 0; l < NODE_BATCH_SIZE; ++l) {
+		A[l] = sampler_new();
+		B[l] = sampler_new();
+	}
+	
+	// Same shape bsdfs get their inputs in, with a stochastic mix so sampler order matters
+	const struct valueNode *u = newVecToValue(s, newUV(s), U);
+	const struct colorNode *graph = new_color_mix(s, newConstantTexture(s, g_red_color), newVecToColor(s, newUV(s)), u);
+	const struct colorNode *color = memo_color_node(s, compile_color_node(s, graph));
+	const struct bsdfNode *diffuse = newDiffuse(s, color);
+	
+	struct hitRecord expected_records[NODE_BATCH_SIZE], records[NODE_BATCH_SIZE];
+	struct node_memo expected_memos[NODE_BATCH_SIZE], memos[NODE_BATCH_SIZE];
+	const struct hitRecord *lanes[NODE_BATCH_SIZE];
+	for (size_t l = 0; l < NODE_BATCH_SIZE; ++l) {
+		records[l] = (struct hitRecord){
+			.uv = { (float)l / NODE_BATCH_SIZE, 0.5f },
+			.surfaceNormal = { 0.0f, 1.0f, 0.0f },
+		};
+		expected_records[l] = records[l];
+		node_memo_reset(&expected_memos[l]);
+		node_memo_reset(&memos[l]);
+		expected_records[l].memo = &expected_memos[l];
+		records[l].memo = &memos[l];
+		lanes[l] = &records[l];
+		sampler_init(A[l], Halton, 0, 16, (uint32_t)l);
+		sampler_init(B[l], Halton, 0, 16, (uint32_t)l);
+		// Some lanes have the color cached already, the rest get evaluated as a smaller batch
+		if (l % 3) continue;
+		color->eval(color, A[l], &expected_records[l]);
+		color->eval(color, B[l], &records[l]);
+	}
+	struct node_batch batch;
+	node_batch_init(&batch, B, lanes, NODE_BATCH_SIZE);
+	struct bsdfSample result[NODE_BATCH_SIZE];
+	bsdf_sample_batch(diffuse, &batch, result);
+	for (size_t l = 0; l < NODE_BATCH_SIZE; ++l) {
+		const struct bsdfSample expected = diffuse->sample(diffuse, A[l], &expected_records[l]);
+		test_assert(!memcmp(&expected.out.direction, &result[l].out.direction, sizeof(expected.out.direction)));
+		test_assert(!memcmp(&expected.weight, &result[l].weight, sizeof(expected.weight)));
+		test_assert(expected.pdf == result[l].pdf);
+		test_assert(sampler_dimension(A[l]) == sampler_dimension(B[l]));
+	}
+	
+	delete_storage(s);
+	for (size_t l = 0; l < NODE_BATCH_SIZE; ++l) {
+		sampler_destroy(A[l]);
+		sampler_destroy(B[l]);
+	}
+	return true;
+}
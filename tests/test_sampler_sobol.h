@@ -0,0 +1,71 @@
+//
+//  test_sampler_sobol.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../src/lib/renderer/samplers/sobol.h"
+
+bool sobol_byte_tables_match(void) {
+	for (size_t dim = 0; dim < SOBOL_DIMENSIONS; ++dim) {
+		for (size_t byte = 0; byte < 4; ++byte) {
+			for (uint32_t value = 0; value < 256; ++value) {
+				uint32_t expected = 0;
+				for (size_t bit = 0; bit < 8; ++bit) {
+					if (value & (1u << bit)) expected ^= sobol_matrices[dim][byte * 8 + bit];
+				}
+				test_assert(sobol_byte_tables[dim][byte][value] == expected);
+			}
+		}
+	}
+	return true;
+}
+
+// Every 2^a by 2^(k - a) cell of the unit square has exactly one of the first 2^k points
+static bool sobol_is_stratified(const float *x, const float *y, unsigned k) {
+	const size_t count = 1u << k;
+	unsigned char hits[1 << 10];
+	for (unsigned a = 0; a <= k; ++a) {
+		memset(hits, 0, count);
+		for (size_t i = 0; i < count; ++i) {
+			const size_t cx = (size_t)(x[i] * (1u << a));
+			const size_t cy = (size_t)(y[i] * (1u << (k - a)));
+			if (hits[cy * (1u << a) + cx]++) return false;
+		}
+	}
+	return true;
+}
+
+bool sobol_stratification(void) {
+	float x[1 << 10], y[1 << 10];
+	for (unsigned k = 1; k <= 10; ++k) {
+		// Unscrambled
+		for (uint32_t i = 0; i < (1u << k); ++i) {
+			x[i] = (float)(sobol_sample(i, 0) >> 8) * (1.0f / 16777216.0f);
+			y[i] = (float)(sobol_sample(i, 1) >> 8) * (1.0f / 16777216.0f);
+		}
+		test_assert(sobol_is_stratified(x, y, k));
+		// Owen scrambling shuffles the points, but keeps them stratified
+		for (uint32_t i = 0; i < (1u << k); ++i) {
+			sobolSampler s;
+			initSobol(&s, i, 1234);
+			sobolStartBounce(&s, 3);
+			x[i] = getSobol(&s);
+			y[i] = getSobol(&s);
+		}
+		test_assert(sobol_is_stratified(x, y, k));
+		// Later dimensions don't pair up as well, but each one is stratified on its own
+		for (unsigned dim = 0; dim < SOBOL_DIMENSIONS; ++dim) {
+			unsigned char hits[1 << 10] = { 0 };
+			for (uint32_t i = 0; i < (1u << k); ++i) {
+				sobolSampler s;
+				initSobol(&s, i, 1234);
+				for (unsigned d = 0; d < dim; ++d) getSobol(&s);
+				test_assert(!hits[(size_t)(getSobol(&s) * (1u << k))]++);
+			}
+		}
+	}
+	return true;
+}
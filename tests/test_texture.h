@@ -0,0 +1,258 @@
+//
+//  test_texture.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../src/common/texture.h"
+#include "../src/common/texture_cache.h"
+#include "../src/common/fileio.h"
+#include "../src/common/loaders/textureloader.h"
+#include "../src/common/hashtable.h"
+#include <sys/stat.h>
+#include <utime.h>
+
+bool texture_mips(void) {
+	struct texture *t = tex_new(float_p, 4, 2, 3);
+	for (size_t y = 0; y < t->height; ++y) {
+		for (size_t x = 0; x < t->width; ++x) {
+			const float v = (float)(x + y * t->width);
+			tex_set_px(t, (struct color){ v, 2.0f * v, 0.5f, 1.0f }, x, y);
+		}
+	}
+	tex_build_mips(t);
+	// 4x2 -> 2x1 -> 1x1
+	test_assert(t->mip_count == 2);
+	test_assert(t->mips[0].width == 2 && t->mips[0].height == 1);
+	test_assert(t->mips[1].width == 1 && t->mips[1].height == 1);
+
+	// Average of 0, 1, 4, 5 and 2, 3, 6, 7
+	roughly_equals(tex_get_px(&t->mips[0], 0, 0, false).red, 2.5f);
+	roughly_equals(tex_get_px(&t->mips[0], 1, 0, false).red, 4.5f);
+	roughly_equals(tex_get_px(&t->mips[0], 1, 0, false).green, 9.0f);
+	roughly_equals(tex_get_px(&t->mips[1], 0, 0, false).red, 3.5f);
+	roughly_equals(tex_get_px(&t->mips[1], 0, 0, false).blue, 0.5f);
+
+	// The base level has to stay exactly what it was without mips
+	for (float u = 0.05f; u < 1.0f; u += 0.1f) {
+		const struct color a = tex_get_px(t, u, 0.3f, true);
+		const struct color b = tex_get_px_lod(t, u, 0.3f, 0.0f);
+		test_assert(a.red == b.red && a.green == b.green && a.blue == b.blue);
+	}
+	// Halfway between level 1 and 2, and clamped past the last one
+	roughly_equals(tex_get_px_lod(t, 0.25f, 0.5f, 1.5f).red, 0.5f * (2.5f + 3.5f));
+	roughly_equals(tex_get_px_lod(t, 0.1f, 0.9f, 10.0f).red, 3.5f);
+
+	tex_destroy(t);
+	return true;
+}
+
+bool texture_mips_byte(void) {
+	struct texture *t = tex_new(char_p, 3, 3, 4);
+	for (size_t y = 0; y < t->height; ++y) {
+		for (size_t x = 0; x < t->width; ++x) {
+			tex_set_px(t, (struct color){ 1.0f, (x + y) % 2 ? 1.0f : 0.0f, 0.0f, 1.0f }, x, y);
+		}
+	}
+	tex_build_mips(t);
+	// Odd sizes round down
+	test_assert(t->mip_count == 1);
+	test_assert(t->mips[0].width == 1 && t->mips[0].height == 1);
+	// The 1x1 level covers all nine texels, four of them green
+	const struct color c = tex_get_px(&t->mips[0], 0, 0, false);
+	roughly_equals(c.red, 1.0f);
+	test_assert(t->mips[0].data.byte_p[1] == (4 * 255 + 4) / 9);
+	roughly_equals(c.alpha, 1.0f);
+
+	tex_destroy(t);
+	return true;
+}
+
+bool texture_tiled(void) {
+	// Not a multiple of the tile size, so the edge tiles are padded
+	struct texture *a = tex_new(char_p, 21, 11, 4);
+	struct texture *b = tex_new(char_p, 21, 11, 4);
+	for (size_t y = 0; y < a->height; ++y) {
+		for (size_t x = 0; x < a->width; ++x) {
+			const struct color c = { (x * 12) / 255.0f, (y * 20) / 255.0f, ((x * y) % 256) / 255.0f, 1.0f };
+			tex_set_px(a, c, x, y);
+			tex_set_px(b, c, x, y);
+		}
+	}
+	tex_build_mips(a);
+	tex_tile(b);
+	tex_build_mips(b);
+	test_assert(b->tiled);
+	test_assert(tex_data_size(b) == 24 * 16 * 4);
+	test_assert(b->mip_count == a->mip_count);
+
+	for (size_t y = 0; y < a->height; ++y) {
+		for (size_t x = 0; x < a->width; ++x) {
+			test_assert(colorEquals(tex_get_px(a, x, y, false), tex_get_px(b, x, y, false)));
+		}
+	}
+	for (float v = 0.0f; v < 1.0f; v += 0.07f) {
+		for (float u = 0.0f; u < 1.0f; u += 0.05f) {
+			test_assert(colorEquals(tex_get_px(a, u, v, true), tex_get_px(b, u, v, true)));
+			test_assert(colorEquals(tex_get_px_lod(a, u, v, 1.3f), tex_get_px_lod(b, u, v, 1.3f)));
+		}
+	}
+
+	tex_destroy(a);
+	tex_destroy(b);
+	return true;
+}
+
+bool texture_srgb(void) {
+	struct texture *t = tex_new(char_p, 16, 2, 4);
+	t->colorspace = sRGB;
+	for (size_t y = 0; y < t->height; ++y) {
+		for (size_t x = 0; x < t->width; ++x) {
+			tex_set_px(t, (struct color){ x / 15.0f, y ? 1.0f : 0.0f, 0.5f, 0.5f }, x, y);
+		}
+	}
+	const unsigned char first = t->data.byte_p[0];
+	tex_from_srgb(t);
+	// Kept as is, decoded on lookup
+	test_assert(t->decode_srgb && t->colorspace == linear);
+	test_assert(t->data.byte_p[0] == first);
+	for (size_t x = 0; x < t->width; ++x) {
+		const struct color c = tex_get_px(t, x, 0, false);
+		const unsigned char b = (unsigned char)min((x / 15.0f) * 255.0f, 255.0f);
+		test_assert(c.red == SRGBToLinear(b / 255.0f));
+		test_assert(c.blue == SRGBToLinear(127 / 255.0f));
+		roughly_equals(c.alpha, 127 / 255.0f);
+	}
+	// Dark values keep their precision, instead of being rounded to the closest 1/255
+	const float dark = tex_get_px(t, 1, 0, false).red;
+	test_assert(fabsf(dark * 255.0f - roundf(dark * 255.0f)) > 0.1f);
+	// Filtering blends the decoded values
+	const struct color mid = tex_get_px(t, 1.0f / 16.0f, 0.5f, true);
+	roughly_equals(mid.red, 0.5f * (tex_get_px(t, 0, 0, false).red + tex_get_px(t, 1, 0, false).red));
+	roughly_equals(mid.green, 0.5f);
+	// Writes encode, so a round trip gets the same byte back
+	const struct color c = tex_get_px(t, 7, 1, false);
+	tex_set_px(t, c, 7, 1);
+	test_assert(colorEquals(c, tex_get_px(t, 7, 1, false)));
+
+	// MIP levels average the light
+	tex_build_mips(t);
+	test_assert(t->mips[0].decode_srgb);
+	very_roughly_equals(tex_get_px(&t->mips[0], 0, 0, false).green, 0.5f);
+
+	tex_to_srgb(t);
+	test_assert(!t->decode_srgb && t->colorspace == sRGB);
+	test_assert(t->data.byte_p[0] == first);
+	tex_destroy(t);
+	return true;
+}
+
+bool texture_cache(void) {
+	// Big enough to need more pages than the smallest budget keeps around
+	const char *path = "/tmp/c-ray-test-texture.ppm";
+	const size_t w = 1100, h = 1100;
+	FILE *f = fopen(path, "wb");
+	test_assert(f);
+	fprintf(f, "P6\n%zu %zu\n255\n", w, h);
+	for (size_t y = 0; y < h; ++y) {
+		for (size_t x = 0; x < w; ++x) {
+			const unsigned char px[3] = { x % 256, y % 256, (x * 7 + y * 3) % 256 };
+			fwrite(px, sizeof(px), 1, f);
+		}
+	}
+	fclose(f);
+
+	file_data data = file_load(path);
+	struct texture *ref = tex_new(none, 0, 0, 0);
+	test_assert(!load_texture(path, data, ref));
+	file_free(&data);
+	tex_tile(ref);
+	tex_build_mips(ref);
+
+	struct tex_cache *cache = tex_cache_new("/tmp/c-ray-test-textures", 0);
+	test_assert(cache);
+	// The second load reuses the file the first one wrote
+	struct texture a = { 0 }, b = { 0 };
+	test_assert(tex_cache_load(cache, path, 0, &a));
+	test_assert(tex_cache_load(cache, path, 0, &b));
+	test_assert(a.width == w && a.height == h && a.mip_count == ref->mip_count);
+
+	for (size_t pass = 0; pass < 2; ++pass) {
+		const struct texture *t = pass ? &b : &a;
+		for (size_t y = 0; y < h; y += 7) {
+			for (size_t x = 0; x < w; x += 5) {
+				test_assert(colorEquals(tex_get_px(ref, x, y, false), tex_get_px(t, x, y, false)));
+			}
+		}
+		for (float v = 0.0f; v < 1.0f; v += 0.031f) {
+			for (float u = 0.0f; u < 1.0f; u += 0.017f) {
+				test_assert(colorEquals(tex_get_px(ref, u, v, true), tex_get_px(t, u, v, true)));
+				test_assert(colorEquals(tex_get_px_lod(ref, u, v, 2.4f), tex_get_px_lod(t, u, v, 2.4f)));
+			}
+		}
+	}
+
+	// Converted separately, and decoded the same way as in memory
+	struct texture c = { 0 };
+	test_assert(tex_cache_load(cache, path, SRGB_TRANSFORM, &c));
+	test_assert(c.decode_srgb);
+	tex_from_srgb(ref);
+	for (size_t y = 0; y < h; y += 11) {
+		for (size_t x = 0; x < w; x += 13) {
+			test_assert(colorEquals(tex_get_px(ref, x, y, false), tex_get_px(&c, x, y, false)));
+		}
+	}
+	tex_paged_release(&c);
+	free(c.mips);
+
+	struct texture *copy = tex_paged_copy(&a);
+	test_assert(copy);
+	for (size_t y = 0; y < h; y += 3) {
+		for (size_t x = 0; x < w; x += 3) {
+			test_assert(!memcmp(tex_px_ptr(ref, x, y), tex_px_ptr(copy, x, y), tex_px_size(ref)));
+		}
+	}
+
+	// Cache files are only named by a hash of the path, so one made for another image that
+	// looks the same on disk must not be taken for ours
+	const char *other = "/tmp/c-ray-test-texture-other.ppm";
+	f = fopen(other, "wb");
+	test_assert(f);
+	fprintf(f, "P6\n%zu %zu\n255\n", w, h);
+	for (size_t i = 0; i < w * h * 3; ++i) fputc(0x7f, f);
+	fclose(f);
+	struct stat st;
+	test_assert(!stat(path, &st));
+	const struct utimbuf times = { st.st_atime, st.st_mtime };
+	test_assert(!utime(other, &times));
+	struct texture d = { 0 };
+	test_assert(tex_cache_load(cache, other, 0, &d));
+	tex_paged_release(&d);
+	free(d.mips);
+	char from[1024], to[1024];
+	snprintf(from, sizeof(from), "/tmp/c-ray-test-textures/tex_%08x_00.crtex", hashString(hashInit(), other));
+	snprintf(to, sizeof(to), "/tmp/c-ray-test-textures/tex_%08x_00.crtex", hashString(hashInit(), path));
+	test_assert(!rename(from, to));
+	struct texture e = { 0 };
+	test_assert(tex_cache_load(cache, path, 0, &e));
+	for (size_t y = 0; y < h; y += 17) {
+		for (size_t x = 0; x < w; x += 19) {
+			test_assert(colorEquals(tex_get_px(&a, x, y, false), tex_get_px(&e, x, y, false)));
+		}
+	}
+	tex_paged_release(&e);
+	free(e.mips);
+	remove(other);
+
+	tex_destroy(copy);
+	tex_paged_release(&a);
+	tex_paged_release(&b);
+	free(a.mips);
+	free(b.mips);
+	tex_cache_destroy(cache);
+	tex_destroy(ref);
+	remove(path);
+	return true;
+}
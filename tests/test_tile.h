@@ -0,0 +1,77 @@
+//
+//  test_tile.h
+//  c-ray
+//
+//  Created by Valtteri Koskivuori on 17/10/2026.
+//  Copyright © 2026 Valtteri Koskivuori. All rights reserved.
+//
+
+#include "../src/lib/datatypes/tile.h"
+
+// Odd sizes, so there are partial edge tiles and the curves don't fill a power of two square
+#define TILE_TEST_WIDTH 37
+#define TILE_TEST_HEIGHT 23
+
+static bool tiles_cover_image_once(const struct render_tile_arr *tiles) {
+	unsigned char seen[TILE_TEST_WIDTH * TILE_TEST_HEIGHT] = { 0 };
+	for (size_t t = 0; t < tiles->count; ++t) {
+		const struct render_tile *tile = &tiles->items[t];
+		for (int y = tile->begin.y; y < tile->end.y; ++y) {
+			for (int x = tile->begin.x; x < tile->end.x; ++x) {
+				if (seen[y * TILE_TEST_WIDTH + x]++) return false;
+			}
+		}
+	}
+	for (size_t i = 0; i < sizeof(seen); ++i) {
+		if (seen[i] != 1) return false;
+	}
+	return true;
+}
+
+bool tile_curve_orders(void) {
+	const enum render_order orders[] = { ro_morton, ro_hilbert };
+	for (size_t o = 0; o < sizeof(orders) / sizeof(*orders); ++o) {
+		struct render_tile_arr tiles = tile_quantize(TILE_TEST_WIDTH, TILE_TEST_HEIGHT, 4, 3, orders[o]);
+		test_assert(tiles.count == 10 * 8);
+		test_assert(tiles_cover_image_once(&tiles));
+		if (orders[o] == ro_hilbert) {
+			// The tiles that fill the 8x8 square in the corner are visited one neighbour at a time
+			size_t prev = tiles.count;
+			for (size_t t = 0; t < tiles.count; ++t) {
+				const struct render_tile *tile = &tiles.items[t];
+				if (tile->begin.x / 4 >= 8 || tile->begin.y / 3 >= 8) continue;
+				if (prev != tiles.count) {
+					const struct render_tile *last = &tiles.items[prev];
+					const int dx = abs(tile->begin.x / 4 - last->begin.x / 4), dy = abs(tile->begin.y / 3 - last->begin.y / 3);
+					test_assert(dx + dy == 1);
+				}
+				prev = t;
+			}
+		}
+		render_tile_arr_free(&tiles);
+	}
+	return true;
+}
+
+bool tile_pixel_orders(void) {
+	const enum pixel_order orders[] = { po_scanline, po_morton, po_hilbert };
+	for (size_t o = 0; o < sizeof(orders) / sizeof(*orders); ++o) {
+		struct tile_set set;
+		tile_set_init(&set, tile_quantize(TILE_TEST_WIDTH, TILE_TEST_HEIGHT, 16, 16, ro_top_to_bottom), orders[o]);
+		// Pixel offsets cover the largest tile, every offset exactly once
+		test_assert(set.pixel_count == 16 * 16);
+		unsigned char seen[16 * 16] = { 0 };
+		for (size_t i = 0; i < set.pixel_count; ++i) {
+			const struct intCoord p = set.pixels[i];
+			test_assert(p.x >= 0 && p.x < 16 && p.y >= 0 && p.y < 16);
+			test_assert(!seen[p.y * 16 + p.x]++);
+		}
+		if (orders[o] == po_hilbert) {
+			for (size_t i = 1; i < set.pixel_count; ++i) {
+				test_assert(abs(set.pixels[i].x - set.pixels[i - 1].x) + abs(set.pixels[i].y - set.pixels[i - 1].y) == 1);
+			}
+		}
+		tile_set_free(&set);
+	}
+	return true;
+}
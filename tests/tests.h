@@ -51,6 +51,12 @@ static char *failed_expression;
 #include "test_dyn_array.h"
 #include "test_serializer.h"
 #include "test_thread_pool.h"
+#include "test_texture.h"
+#include "test_sampler_sobol.h"
+#include "test_tile.h"
+#include "test_checkpoint.h"
+#include "test_lights.h"
+#include "test_guiding.h"
 
 typedef struct {
 	char *test_name;
@@ -169,6 +175,13 @@ static test tests[] = {
 	{"vecmath::vecScale", vecmath_vecScale},
 	
 	{"map_range::map", map_range},
+	{"node_fold::constants", node_fold},
+	{"node_program::math", node_program_math},
+	{"node_program::mix", node_program_mix},
+	{"node_program::native", node_program_native},
+	{"node_program::batch", node_program_batch},
+	{"node_program::sample_batch", node_program_sample_batch},
+	{"node_memo::shading_point", node_memo},
 
 	{"linked_list::basic", llist_basic},
 	{"linked_list::remove_cb", llist_remove_cb},
@@ -189,6 +202,20 @@ static test tests[] = {
 	{"serializer::serialize", serializer_serialize},
 
 	{"threadpool::basic", test_thread_pool},
+
+	{"texture::mips", texture_mips},
+	{"texture::mips_byte", texture_mips_byte},
+	{"texture::tiled", texture_tiled},
+	{"texture::srgb", texture_srgb},
+	{"texture::cache", texture_cache},
+	{"sobol::byte_tables", sobol_byte_tables_match},
+	{"sobol::stratification", sobol_stratification},
+	{"tile::curve_orders", tile_curve_orders},
+	{"tile::pixel_orders", tile_pixel_orders},
+	{"checkpoint::roundtrip", checkpoint_roundtrip},
+	{"lights::env_pdf", lights_env_pdf},
+	{"lights::tree_pmf", lights_tree_pmf},
+	{"guiding::pdf", guiding_pdf},
 };
 
 #define testCount (sizeof(tests) / sizeof(test))